@@ -493,6 +493,9 @@ namespace sbn::crt {
       } // for
     }
     bool const isRealData = e.isRealData();
+    // CRT hits sorted by time, shared by all the flashes
+    icarus::crt::CRTHitTimeTable const crtHitTable
+      { crtHitList, isRealData, fGlobalT0Offset, fMatchBottomCRT };
     int n_entering_matches = 0;
     int n_exiting_matches = 0;
     mf::LogTrace("CRTPMTMatchingProducer") << "is this real data? " << std::boolalpha << isRealData;
@@ -596,7 +599,7 @@ namespace sbn::crt {
         = thisRelGateTime > inBeamMin && thisRelGateTime < inBeamMax;
       
       icarus::crt::CRTMatches const crtMatches = icarus::crt::CRTHitmatched(
-        firstOpHitPeakTime, flash_pos, crtHitList, fTimeOfFlightInterval, isRealData, fGlobalT0Offset, fMatchBottomCRT);
+        firstOpHitPeakTime, flash_pos, crtHitTable, fTimeOfFlightInterval);
       
       std::vector<MatchedCRT> thisFlashCRTmatches;
         std::vector<art::Ptr<sbn::crt::CRTHit>> CRTPtrs; // same order as thisFlashCRTmatches
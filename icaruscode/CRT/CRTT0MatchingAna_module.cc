@@ -306,6 +306,9 @@ namespace icarus {
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
+    // CRT hits sorted by time, shared by all the tracks
+    icarus::CRTHitTimeIndex const crtHitIndex = t0Alg.MakeCRTHitIndex(crtHits, m_gate_start_timestamp, true);
+
     // if(fVerbose) std::cout<<"----------------- DCA Analysis -------------------"<<std::endl;
     for(const auto& trackLabel : fTPCTrackLabel)
       {
@@ -331,7 +334,7 @@ namespace icarus {
 	  //if(fVerbose) std::cout<<"----------------- line 315 -------------------"<<std::endl;
 	  std::cout << "new track " << trueTime << std::endl;
 	  // Calculate t0 from CRT Hit matching
-	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, m_gate_start_timestamp, true);
+	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
 	  // matchCand closest = t0Alg.GetClosestCRTHit(detProp, tpcTrack, crtHits, event);
 	  //std::vector <matchCand> closestvec = t0Alg.GetClosestCRTHit(detProp, tpcTrack, crtHits, event);
           //matchCand closest = closestvec.back();
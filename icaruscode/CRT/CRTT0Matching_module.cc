@@ -268,10 +268,8 @@ namespace icarus {
     if(event.getByLabel(fCrtHitModuleLabel, crtListHandle))
       art::fill_ptr_vector(crtList, crtListHandle);
 
-    std::vector<sbn::crt::CRTHit> crtHits;
-    for (auto const& crtHit : crtList){
-      crtHits.push_back(*crtHit);
-    }
+    // CRT hits sorted by time, shared by all the tracks
+    icarus::CRTHitTimeIndex const crtHitIndex = t0Alg.MakeCRTHitIndex(crtList, m_gate_start_timestamp, true);
 
     // Retrieve track list
     for(const auto& trackLabel : fTpcTrackModuleLabel){
@@ -328,7 +326,7 @@ namespace icarus {
 	  if (hits.size() == 0) continue;
 	  int const cryoNumber = hits[0]->WireID().Cryostat;
 	  // std::pair<double, double> matchedTime = t0Alg.T0AndDCAFromCRTHits(detProp, *trackList[track_i], crtHits, event);
-	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], hits, crtHits,  m_gate_start_timestamp, true);
+	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], hits, crtHitIndex);
 	  // std::vector <matchCand> closestvec = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], crtHits, event);
 	  // matchCand closest = closestvec.back();	  
 
@@ -291,6 +291,9 @@ void icarus::CRTTPCMatchingAna::analyze(const art::Event& event)
   mf::LogError("CRTTPCMatchingAna:") << "# of TPC tracks: " << fTPCTrackLabel.size()
 				     << " \t # of CRT Hits: " << crtHits.size() << "\n" ;
 
+  // CRT hits sorted by time, shared by all the tracks
+  icarus::CRTHitTimeIndex const crtHitIndex = t0Alg.MakeCRTHitIndex(crtHits, m_trigger_timestamp, true);
+
   //----------------------------------------------------------------------------------------------------------
   //                                DISTANCE OF CLOSEST APPROACH ANALYSIS
   //----------------------------------------------------------------------------------------------------------
@@ -361,7 +364,7 @@ void icarus::CRTTPCMatchingAna::analyze(const art::Event& event)
 	//	 << hits[0]->WireID().TPC << " , " << hits[hits.size()-1]->WireID().TPC
 	//       << " , " << cryoNumber << " , " << t0 << " ] "<< std::endl;
 
-	matchCand closest = t0Alg.GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, m_trigger_timestamp, true);
+	matchCand closest = t0Alg.GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
 	if(closest.dca >=0 )
           mf::LogInfo("CRTTPCMatchingAna")
 	    << "Track # " << idx  <<" Matched time = "<<closest.t0<<" [us] to track "<< tpcTrack.ID()<<" with DCA = "<<closest.dca 
@@ -328,6 +328,11 @@ namespace icarus {
 
     // Retrieve CRT hit list
     auto const& crtHits = event.getProduct<std::vector<sbn::crt::CRTHit>>(fCrtHitModuleLabel);
+
+    // CRT hits sorted by time, shared by all the tracks
+    // (the geometric matching uses the trigger time as reference)
+    icarus::CRTHitTimeIndex const crtHitIndex = t0Alg.MakeCRTHitIndex(crtHits, m_gate_start_timestamp, fIsData);
+    icarus::CRTHitTimeIndex const crtHitIndexGeo = t0Alg.MakeCRTHitIndex(crtHits, m_trigger_timestamp, fIsData);
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
 
     // Retrieve track list BEGIN LOOP OVER TRACKS IN EVENT
@@ -419,7 +424,7 @@ namespace icarus {
 	  }//end if(!fIsData)
 
 //	  int const cryoNumber = hits[0]->WireID().Cryostat;
-	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], hits, crtHits,  m_gate_start_timestamp, fIsData);
+	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], hits, crtHitIndex);
 
 	  if(closest.dca >=0 ){
 	    
@@ -476,7 +481,7 @@ namespace icarus {
 			}//end if(crthit_pes[i].size()>0)
 		}//end loop searching for FEBs connected to the hit
 
- 		std::vector<icarus::match_geometry> all_crt_candidates = t0Alg.GetClosestCRTHit_geo(detProp, *trackList[track_i], hits, crtHits, m_trigger_timestamp, fIsData);
+ 		std::vector<icarus::match_geometry> all_crt_candidates = t0Alg.GetClosestCRTHit_geo(detProp, *trackList[track_i], hits, crtHitIndexGeo);
 
 		if(!fIsData){
 			auto checkhit = closest.thishit;
@@ -4,6 +4,7 @@
 #include "icaruscode/CRT/CRTUtils/CRTCommonUtils.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 #include <fstream>
+#include <climits> // INT_MIN, INT_MAX
 
 using namespace icarus::crt;
 
@@ -12,6 +13,7 @@ CRTCommonUtils::CRTCommonUtils() {
   fGeoService  = lar::providerFrom<geo::Geometry>();
   FillFebMap();
   FillAuxDetMaps();
+  FillFebTopology();
 }
 
 //given an AuxDetGeo object, returns name of the CRT subsystem to which it belongs
@@ -281,6 +283,26 @@ size_t CRTCommonUtils::MacToAuxDetID(uint8_t mac, int chan)
     
 }
 
+//--------------------------------------------------------------------------------------
+CRTFebTopology const& CRTCommonUtils::MacToTopology(uint8_t mac) const
+{
+    CRTFebTopology const& feb = fFebTopology[mac];
+    if(!feb.valid) {
+        throw cet::exception("CRTCommonUtils::MacToTopology")
+          << "unknown mac passed to function";
+    }
+    return feb;
+}
+
+//--------------------------------------------------------------------------------------
+int CRTCommonUtils::MacToMINOSLayerID(uint8_t mac)
+{
+    // the layer needs the ROOT geometry navigation: it is computed once per FEB
+    int& layer = fFebMINOSLayer[mac];
+    if(layer == INT_MIN) layer = GetMINOSLayerID(MacToTopology(mac).auxDetID);
+    return layer;
+}
+
 //-----------------------------------------------------------------------
 //returns average 4-position in the scintillator strip
 //ROOT::Math::XYZTVector
@@ -594,6 +616,30 @@ void CRTCommonUtils::FillAuxDetMaps() {
 
 }
 
+//------------------------------------------------------------------------
+//precomputes what MacToAuxDetID(mac,0) and the type and region of that
+//module return for each mac5, for the lookups in the hit reconstruction
+void CRTCommonUtils::FillFebTopology() {
+
+    fFebMINOSLayer.fill(INT_MIN);
+
+    for(auto const& feb : fFebToAuxDetId){
+        CRTFebTopology& topology = fFebTopology[feb.first];
+        for(auto const& adid : feb.second){
+            auto const chanGroup = fAuxDetIdToChanGroup.find(adid);
+            if(chanGroup == fAuxDetIdToChanGroup.end() || chanGroup->second != 1)
+                continue; // not the module at channel 0
+            topology.valid      = true;
+            topology.auxDetID   = adid;
+            topology.type       = GetAuxDetType(adid);
+            topology.regionName = GetAuxDetRegion(adid);
+            topology.region     = AuxDetRegionNameToNum(topology.regionName);
+            break;
+        }
+    }
+
+}
+
 //--------------------------------------------------------------------
 string CRTCommonUtils::AuxDetNameToRegion(string name) {
 
@@ -27,6 +27,8 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <array>
+#include <cstdint>
 
 using std::string;
 using std::map;
@@ -36,6 +38,34 @@ using std::pair;
 namespace icarus{
  namespace crt {
     class CRTCommonUtils;
+
+    // numeric codes of the CRT regions, as from AuxDetRegionNameToNum()
+    enum CRTRegionCode : int {
+        kRegionTop        = 30,
+        kRegionRimWest    = 31,
+        kRegionRimEast    = 32,
+        kRegionRimSouth   = 33,
+        kRegionRimNorth   = 34,
+        kRegionWestSouth  = 40,
+        kRegionWestCenter = 41,
+        kRegionWestNorth  = 42,
+        kRegionEastSouth  = 43,
+        kRegionEastCenter = 44,
+        kRegionEastNorth  = 45,
+        kRegionSouth      = 46,
+        kRegionNorth      = 47,
+        kRegionBottom     = 50
+    };
+
+    // topology of the CRT module read by a FEB at its channel 0,
+    // precomputed for each mac5 address
+    struct CRTFebTopology {
+        bool   valid    = false; // whether the mac5 is in the FEB map
+        size_t auxDetID = 0;     // MacToAuxDetID(mac5, 0)
+        char   type     = 0;     // GetAuxDetType(auxDetID)
+        int    region   = 0;     // AuxDetRegionNameToNum(regionName)
+        string regionName;       // GetAuxDetRegion(auxDetID)
+    };
  }
 }
 
@@ -59,6 +89,10 @@ class icarus::crt::CRTCommonUtils {
     int            MacToTypeCode(uint8_t mac);
     int            ChannelToAuxDetSensitiveID(uint8_t mac, int chan);
     size_t         MacToAuxDetID(uint8_t mac, int chan);
+    // table lookups replacing MacToAuxDetID(mac, 0), GetAuxDetType(),
+    // GetAuxDetRegion() and GetMINOSLayerID() in per-hit loops
+    CRTFebTopology const& MacToTopology(uint8_t mac) const;
+    int            MacToMINOSLayerID(uint8_t mac);
     TLorentzVector AvgIDEPoint(sim::AuxDetIDE ide);
     double         LengthIDE(sim::AuxDetIDE ide);
     int            GetLayerID(sim::AuxDetSimChannel const& adsc);
@@ -91,9 +125,12 @@ class icarus::crt::CRTCommonUtils {
     map<size_t,string>          fAuxDetIdToRegion;
     map<string,size_t>          fNameToAuxDetId;
     map<size_t,int>             fAuxDetIdToChanGroup;
+    std::array<CRTFebTopology,256> fFebTopology;   // indexed by mac5
+    std::array<int,256>         fFebMINOSLayer;    // filled on demand
 
     void   FillFebMap();
     void   FillAuxDetMaps();
+    void   FillFebTopology();
     string AuxDetNameToRegion(string name);
 
 };//CRTCommonUtils
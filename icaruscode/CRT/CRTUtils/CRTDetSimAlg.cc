@@ -2,12 +2,13 @@
 #define IC_CRTDETSIMALG_CC
 
 #include "icaruscode/CRT/CRTUtils/CRTDetSimAlg.h"
+#include <algorithm> // std::sort(), std::partition_point()
 
 namespace icarus{
  namespace crt {
 
-    bool TimeOrderCRTData(std::pair<ChanData, AuxDetIDE> crtdat1, 
-                          std::pair<ChanData, AuxDetIDE> crtdat2) {
+    bool TimeOrderCRTData(std::pair<ChanData, AuxDetIDE> const& crtdat1, 
+                          std::pair<ChanData, AuxDetIDE> const& crtdat2) {
         return ( crtdat1.first.ts < crtdat2.first.ts );
     }//TimeOrderCRTData()
 
@@ -105,7 +106,12 @@ namespace icarus{
         // Front-end logic: For CERN or DC modules require at least one hit in each X-X layer.
         if (fUltraVerbose) std::cout << '\n' << "about to loop over taggers (size " << fTaggers.size() << " )" << std::endl;
 
-        for (auto trg : fTaggers) {
+        // MINOS signals from all the taggers sorted by time, to look for
+        // coincidences between modules within a time window
+        map<string, vector<MinosSignal>> const minosSignals
+          = fApplyCoincidenceM? SortMinosSignals(): map<string, vector<MinosSignal>>{};
+
+        for (auto& trg : fTaggers) {
             //if(trg.second.data.size()!=trg.second.ide.size())
             //    std::cout << "WARNING DATA AND INDEX VECTOR SIZE MISMATCH!" << std::endl;
 
@@ -194,27 +200,14 @@ namespace icarus{
               //for c and d modules, just need time stamps within tagger obj
               //for m modules, need to check coincidence with other tagger objs
               if (trg.second.type=='m' && !minosPairFound && fApplyCoincidenceM) {
-                  for (auto trg2 :fTaggers) {
-
-                      if( trg2.second.type!='m' || //is other mod 'm' type
-                        trg.second.modid == trg2.second.modid || //other mod not same as this one
-                        trg.second.reg != trg2.second.reg || //other mod is in same region
-                        *trg2.second.layerid.begin() == *trg.second.layerid.begin()) //modules are in adjacent layers
-                          continue;
-
-                      //find entry within coincidence window starting with this FEB's
-                      //triggering channel in coincidence candidate's FEB
-                      for ( size_t j=0; j< trg2.second.data.size(); j++ ) {
-                          uint64_t t2tmp = trg2.second.data[j].first.ts; //in us
-                          if ( lar::util::absDiff(t2tmp,ttrig) < fLayerCoincidenceWindowM) {
-                              minosPairFound = true;
-                              break;
-                          }
-                      }
-                      //we found a valid pair so move on to next step
-                      if (minosPairFound)
-                          break;
-                  }//inner loop over febs (taggers)
+                  //find entry within coincidence window starting with this FEB's
+                  //triggering channel in other 'm' modules of the same region
+                  //and in the adjacent layer
+                  auto const regSignals = minosSignals.find(trg.second.reg);
+                  if (regSignals != minosSignals.end()) {
+                      minosPairFound = HasMinosCoincidence(regSignals->second, ttrig,
+                        trg.second.modid, *trg.second.layerid.begin());
+                  }
 
                   //if no coincidence pairs found, reinitialize and move to next FEB
                   if(!minosPairFound) {
@@ -461,6 +454,49 @@ namespace icarus{
 
     }//end CreateData()
 
+    //-----------------------------------------------------------------------------
+    // collects the time stamps of the channel signals of all 'm' taggers,
+    // grouped by region and sorted by time, for the MINOS coincidence search
+    map<string, vector<CRTDetSimAlg::MinosSignal>> CRTDetSimAlg::SortMinosSignals() const
+    {
+        map<string, vector<MinosSignal>> signals;
+        for (auto const& trg : fTaggers) {
+            if (trg.second.type!='m') continue;
+            vector<MinosSignal>& regSignals = signals[trg.second.reg];
+            int const layer = *trg.second.layerid.begin();
+            for (auto const& data : trg.second.data)
+                regSignals.push_back({data.first.ts, trg.second.modid, layer});
+        }
+
+        for (auto& regSignals : signals) {
+            std::sort(regSignals.second.begin(), regSignals.second.end(),
+                [](MinosSignal const& a, MinosSignal const& b){ return a.ts < b.ts; });
+        }
+        return signals;
+    }//SortMinosSignals()
+
+    //-----------------------------------------------------------------------------
+    bool CRTDetSimAlg::HasMinosCoincidence(const vector<MinosSignal>& signals,
+                                           uint64_t ttrig, int modid, int layer) const
+    {
+        // the signals in the window are contiguous in time: find its edges
+        auto const inWindow = [this,ttrig](MinosSignal const& signal)
+          { return lar::util::absDiff(signal.ts,ttrig) < fLayerCoincidenceWindowM; };
+        auto const first = std::partition_point(signals.begin(), signals.end(),
+          [ttrig,&inWindow](MinosSignal const& signal)
+            { return signal.ts < ttrig && !inWindow(signal); });
+        auto const last = std::partition_point(first, signals.end(),
+          [ttrig,&inWindow](MinosSignal const& signal)
+            { return signal.ts <= ttrig || inWindow(signal); });
+
+        for (auto it = first; it != last; ++it) {
+            if (it->modid != modid && //other mod not same as this one
+                it->layer != layer)   //modules are in adjacent layers
+                return true;
+        }
+        return false;
+    }//HasMinosCoincidence()
+
     //-----------------------------------------------------------------------------
     // intented to be called within loop over AuxDetChannels and provided the 
     // AuxDetChannelID, AuxDetSensitiveChannelID, vector of AuxDetIDEs and 
@@ -138,6 +138,22 @@ class icarus::crt::CRTDetSimAlg {
     // A list of hit taggers, before any coincidence requirement (mac5 -> tagger)
     map<uint8_t, Tagger> fTaggers;
 
+    // Time stamp of a channel signal in a MINOS module, with the module and
+    // its layer, for the coincidence search between modules
+    struct MinosSignal {
+        uint64_t ts;
+        int modid;
+        int layer;
+    };
+
+    // MINOS channel signals of all the taggers, by region, sorted by time
+    map<string, vector<MinosSignal>> SortMinosSignals() const;
+
+    // Whether any of the signals (sorted by time) is from a module other than
+    // modid in a layer other than layer, within the MINOS coincidence window of ttrig
+    bool HasMinosCoincidence(const vector<MinosSignal>& signals,
+                             uint64_t ttrig, int modid, int layer) const;
+
     pair<double,double> GetTransAtten(const double pos); //only applies to CERN modules
     double GetLongAtten(const double dist); //MINOS model applied to all modules for now
 
@@ -11,7 +11,8 @@ CRTHitRecoAlg::CRTHitRecoAlg(const fhicl::ParameterSet& pset)
 CRTHitRecoAlg::CRTHitRecoAlg()
     : fGeometryService(lar::providerFrom<geo::Geometry>()),
       fChannelMap(
-          art::ServiceHandle<icarusDB::IICARUSChannelMap const>{}.get()) {}
+          art::ServiceHandle<icarusDB::IICARUSChannelMap const>{}.get()),
+      fFEBDelayMap(LoadFEBMap()) {}
 
 //---------------------------------------------------------------------
 void CRTHitRecoAlg::reconfigure(const fhicl::ParameterSet& pset) {
@@ -52,8 +53,7 @@ vector<art::Ptr<CRTData>> CRTHitRecoAlg::PreselectCRTData(
 
   for (size_t febdat_i = 0; febdat_i < crtList.size(); febdat_i++) {
     uint8_t mac = crtList[febdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);
-    char type = fCrtutils.GetAuxDetType(adid);
+    char type = fCrtutils.MacToTopology(mac).type;
 
     /// Looking for data within +/- 3ms within trigger time stamp
     /// Here t0 - trigger time -ve
@@ -112,9 +112,10 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
     mf::LogInfo("CRTHitRecoAlg: ")
         << "Found " << crtList.size() << " FEB events" << '\n';
 
-  map<string, int> regCounts;
-  std::set<string> regs;
-  map<string, vector<size_t>> sideRegionToIndices;
+  // CRT regions are identified by their code (CRTRegionCode)
+  map<int, int> regCounts;
+  std::set<int> regs;
+  map<int, vector<size_t>> sideRegionToIndices;
 
   // sort by the time
   std::sort(crtList.begin(), crtList.end(), compareBytime);
@@ -123,23 +124,20 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
   // TODO: Validate side CRT global trigger timestamp reconstruction to be used 
   // for the reference for side CRT hits, currently a couple ns off. -AH 01/19/2024
 
-  // Load Delays map for Top CRT
-  CRT_delay_map const FEB_delay_map = LoadFEBMap();
+  // Delays map for Top CRT (fFEBDelayMap) is loaded once at construction
   std::vector<std::pair<int, ULong64_t>> CRTReset;
   ULong64_t TriggerArray[305] = {0};
   
   for (size_t crtdat_i = 0; crtdat_i < crtList.size(); crtdat_i++) {
     uint8_t mac = crtList[crtdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);
-    char type = fCrtutils.GetAuxDetType(adid);
-    string region = fCrtutils.GetAuxDetRegion(adid);
+    char type = fCrtutils.MacToTopology(mac).type;
     
     // For the time being, Only Top CRT delays are loaded, nothing to do for
     // Side CRT yet
     if (type == 'c' && crtList[crtdat_i]->IsReference_TS1()) {
       ULong64_t Ts0T1ResetEvent = crtList[crtdat_i]->fTs0 +
-                                  FEB_delay_map.at((int)mac + 73).T0_delay -
-                                  FEB_delay_map.at((int)mac + 73).T1_delay;
+                                  fFEBDelayMap.at((int)mac + 73).T0_delay -
+                                  fFEBDelayMap.at((int)mac + 73).T1_delay;
       TriggerArray[(int)mac] = Ts0T1ResetEvent;
       CRTReset.emplace_back((int)mac, Ts0T1ResetEvent);  // single GT
     }
@@ -162,10 +160,10 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
   // loop over time-ordered CRTData
   for (size_t febdat_i = 0; febdat_i < crtList.size(); febdat_i++) {
     uint8_t mac = crtList[febdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);  // module ID
+    CRTFebTopology const& feb = fCrtutils.MacToTopology(mac);
 
-    string region = fCrtutils.GetAuxDetRegion(adid);
-    char type = fCrtutils.GetAuxDetType(adid);
+    int const region = feb.region;
+    char const type = feb.type;
     CRTHit hit;
 
     dataIds.clear();
@@ -209,19 +207,32 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
 
   }  // End loop over time-ordered CRTData products
 
+  // side CRT hits are produced region by region, in order of region name
+  vector<map<int, vector<size_t>>::const_iterator> sideRegions;
+  for (auto it = sideRegionToIndices.cbegin(); it != sideRegionToIndices.cend();
+       ++it)
+    sideRegions.push_back(it);
+  std::sort(sideRegions.begin(), sideRegions.end(),
+            [this](auto const& a, auto const& b) {
+              return fCrtutils.GetRegionNameFromNum(a->first) <
+                     fCrtutils.GetRegionNameFromNum(b->first);
+            });
+
   vector<size_t> unusedDataIndex;
-  for (auto const& regIndices : sideRegionToIndices) {
+  for (auto const& regionIt : sideRegions) {
+    auto const& regIndices = *regionIt;
     if (fVerbose)
       mf::LogInfo("CRTHitRecoAlg: ")
-          << "searching for side CRT hits in region, " << regIndices.first
-          << '\n';
+          << "searching for side CRT hits in region, "
+          << fCrtutils.GetRegionNameFromNum(regIndices.first) << '\n';
 
     vector<size_t> indices = regIndices.second;
 
     if (fVerbose)
       mf::LogInfo("CRTHitRecoAlg: ")  
 	<< "\n-------------------------\nCreateCRTHits: found " 
-	<< indices.size() << " side CRT hits in region " << regIndices.first 
+	<< indices.size() << " side CRT hits in region "
+	<< fCrtutils.GetRegionNameFromNum(regIndices.first)
 	<< "\n----------\n";
 
     for (size_t index_i = 0; index_i < indices.size(); index_i++) {
@@ -288,9 +299,6 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
             mf::LogInfo("CRTHitRecoAlg: ")
                 << "attempting to produce MINOS hit from " << coinData.size()
                 << " data products..." << '\n';
-          uint8_t imac = (int)crtList[indices[index_i]]->fMac5;
-          int adid = fCrtutils.MacToAuxDetID(imac, 0);
-          string region = fCrtutils.GetAuxDetRegion(adid);
           CRTHit hit = MakeSideHit(coinData, TriggerArray);  // using top CRT GT
 
           if (IsEmptyHit(hit)) {
@@ -327,7 +335,7 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
     auto cts = regCounts.begin();
     mf::LogInfo("CRT") << " CRT Hits by region" << '\n';
     while (cts != regCounts.end()) {
-      std::cout << "reg: " << (*cts).first
+      std::cout << "reg: " << fCrtutils.GetRegionNameFromNum((*cts).first)
 		<< " , hits: " << (*cts).second << '\n';
       cts++;
     }
@@ -367,9 +375,9 @@ sbn::crt::CRTHit CRTHitRecoAlg::FillCRTHit(
 }  // CRTHitRecoAlg::FillCRTHit()
 
 //------------------------------------------------------------------------------------------
-int64_t CRTHitRecoAlg::RegionDelay(std::string const& region) const {
+int64_t CRTHitRecoAlg::RegionDelay(int region) const {
   return fSiPMtoFEBdelay +
-         uint64_t(((region == "North" || region == "South") ? 200. : 400) *
+         uint64_t(((region == kRegionNorth || region == kRegionSouth) ? 200. : 400) *
                   fPropDelay);
 }
 //------------------------------------------------------------------------------------------
@@ -379,15 +387,16 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
     ULong64_t GlobalTrigger[305]) {  // single GT: GlobalTrigger[305], 3
                                      // seperate GT: GlobalTrigger[232]
   uint8_t mac = data->fMac5;
-  if (fCrtutils.MacToType(mac) != 'c')
+  CRTFebTopology const& feb = fCrtutils.MacToTopology(mac);
+  if (feb.type != 'c')
     mf::LogError("CRTHitRecoAlg::MakeTopHit")
         << "CRTUtils returned wrong type!" << '\n';
 
   map<uint8_t, vector<pair<int, float>>> pesmap;
-  int adid = fCrtutils.MacToAuxDetID(mac, 0);          // module ID
+  int adid = feb.auxDetID;                             // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);  // module
-  string region = fCrtutils.GetAuxDetRegion(adid);
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);
+  string const& region = feb.regionName;
+  int plane = feb.region;
   double hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
   float petot = 0., pemax = 0., pemaxx = 0., pemaxz = 0.;
@@ -509,10 +518,11 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
 sbn::crt::CRTHit CRTHitRecoAlg::MakeBottomHit(art::Ptr<CRTData> data) {
   uint8_t mac = data->fMac5;
   map<uint8_t, vector<pair<int, float>>> pesmap;
-  int adid = fCrtutils.MacToAuxDetID(mac, 0);          // module ID
+  CRTFebTopology const& feb = fCrtutils.MacToTopology(mac);
+  int adid = feb.auxDetID;                             // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);  // module
-  string region = fCrtutils.GetAuxDetRegion(adid);
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);
+  string const& region = feb.regionName;
+  int plane = feb.region;
   double hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
   float petot = 0., pemax = 0.;
@@ -587,10 +597,12 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   vector<info> informationA, informationB;
 
-  int adid = fCrtutils.MacToAuxDetID(coinData[0]->fMac5, 0);  // module ID
+  CRTFebTopology const& feb = fCrtutils.MacToTopology(coinData[0]->fMac5);
+  int adid = feb.auxDetID;                                    // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);         // module
-  string region = fCrtutils.GetAuxDetRegion(adid);            //region name
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);        //region code (ranges from 30-50)
+  string const& regionName = feb.regionName;                  //region name
+  int plane = feb.region;                                     //region code (ranges from 30-50)
+  int const region = plane;
   double hitpoint[3], hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
 
@@ -614,7 +626,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   // loop over coinData to group FEBs into inner or outer layers (febA or febB)
   for (auto const& data : coinData) {
-    if (adid == (int)fCrtutils.MacToAuxDetID((int)data->fMac5, 0)) {
+    if (adid == (int)fCrtutils.MacToTopology(data->fMac5).auxDetID) {
       febA.push_back(data->fMac5);
     } else {
       febB.push_back(data->fMac5);
@@ -629,9 +641,9 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   for (auto const& data : coinData) {
     // if(!(region=="South")) continue;
     macs.push_back(data->fMac5);
-    adid = fCrtutils.MacToAuxDetID(macs.back(), 0);
+    adid = fCrtutils.MacToTopology(macs.back()).auxDetID;
 
-    int layer = fCrtutils.GetMINOSLayerID(adid);
+    int layer = fCrtutils.MacToMINOSLayerID(macs.back());
     layID.push_back(layer);
 
     auto idx = &data - coinData.data();
@@ -751,7 +763,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       // East/West Walls (all strips along z-direction) or
       // North/South inner walls (all strips along x-direction)
       // All the horizontal layers measure Y first,
-      if (!(region == "South" && layer == 1)) {
+      if (!(region == kRegionSouth && layer == 1)) {
         // hitpos.SetY(pe*postmp.Y()+hitpos.Y());
         // southvertypos.SetX(pe*postmp.X()+southvertypos.X());
         hitpos.SetY(1.0 * postmp.Y() + hitpos.Y());
@@ -768,7 +780,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         // pey += pe; // unused
         if (postmp.Y() < ymin) ymin = postmp.Y();
         if (postmp.Y() > ymax) ymax = postmp.Y();
-        if (region != "South") {  // region is E/W/N
+        if (region != kRegionSouth) {  // region is E/W/N
           //    hitpos.SetX(pe*postmp.X()+hitpos.X());
           hitpos.SetX(1.0 * postmp.X() + hitpos.X());
           nx++;
@@ -801,7 +813,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       hitpos.SetZ(1.0 * postmp.Z() + hitpos.Z());
       nz++;
       if (fVerbose) {
-        if (region == "South")
+        if (region == kRegionSouth)
           mf::LogInfo("CRTHitRecoAlg: ")
               << " South wall z: \t"
               << " feb: " << (int)macs.back() << " ,chan : \t" << chan
@@ -843,12 +855,12 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " ,corrected time: "
           << data->fTs0 - uint64_t(adsGeo.HalfLength() * fPropDelay) << '\n';
 
-    if (region == "South" && layer == 1) {
+    if (region == kRegionSouth && layer == 1) {
       southt0_h = data->fTs0;
       if (fVerbose)
         mf::LogInfo("CRTHitRecoAlg: ")
             << "southt0_h : " << layer << "\t" << southt0_h << '\n';
-    } else if (region == "South" && layer != 1) {
+    } else if (region == kRegionSouth && layer != 1) {
       southt0_v = data->fTs0;
       if (fVerbose)
         mf::LogInfo("CRTHitRecoAlg: ")
@@ -1020,8 +1032,8 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   int crossfeb = std::abs(mac5_1 - mac5_2);
 
   // side crt and match the both layers
-  if (layer1 && layer2 && region != "South" &&
-      region != "North") {  //&& nx==4){
+  if (layer1 && layer2 && region != kRegionSouth &&
+      region != kRegionNorth) {  //&& nx==4){
     float avg = 0.5 * (posA.Z() + posB.Z());
     hitpos.SetZ(avg);
     hitpos.SetX(hitpos.X() * 1.0 / nx);
@@ -1036,8 +1048,8 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   } else if ((int)informationA.size() == 1 and
              (int) informationB.size() == 1 and
-             (crossfeb == 7 or crossfeb == 5) and region != "South" &&
-             region != "North") {
+             (crossfeb == 7 or crossfeb == 5) and region != kRegionSouth &&
+             region != kRegionNorth) {
     int z_pos = int64_t(t0_1 - t0_2) / (uint64_t(2 * fPropDelay));
     crossfebpos = center + geo::Zaxis() * z_pos;
 
@@ -1050,7 +1062,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       mf::LogInfo("CRTHitRecoAlg: ")
           << "hello hi namaskar,  hitpos z " << hitpos[2] << '\n';
     // side crt and only single layer match
-  } else if (layer1 && region != "South" && region != "North") {  // && nx==1){
+  } else if (layer1 && region != kRegionSouth && region != kRegionNorth) {  // && nx==1){
     hitpos.SetZ(posA.Z());
     hitpos.SetX(hitpos.X() * 1.0 / nx);
     hitpos.SetY(hitpos.Y() * 1.0 / nx);
@@ -1062,7 +1074,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " ,hitpos z " << hitpos[2] << '\n';
 
     // side crt and only single layer match
-  } else if (layer2 && region != "South" && region != "North") {  //&& nx==1){
+  } else if (layer2 && region != kRegionSouth && region != kRegionNorth) {  //&& nx==1){
     hitpos.SetZ(posB.Z());
     hitpos.SetX(hitpos.X() * 1.0 / nx);
     hitpos.SetY(hitpos.Y() * 1.0 / nx);
@@ -1073,7 +1085,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " same layer coincidence: z position in layer 2 " << posB.Z()
           << " ,hitpos z " << hitpos[2] << '\n';
 
-  } else if (region != "South" && region != "North") {  //&& nx==2){
+  } else if (region != kRegionSouth && region != kRegionNorth) {  //&& nx==2){
     hitpos *= 1.0 / nx;
     // hitpos.SetX(hitpos.X()*1.0/petot);
     // hitpos.SetY(hitpos.Y()*1.0/petot);
@@ -1089,7 +1101,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
    }*/
 
   // finish averaging and fill hit point array
-  if (region == "South") {
+  if (region == kRegionSouth) {
     /*
     hitpos.SetX(hitpos.X()*1.0/pex);
     hitpos.SetZ(hitpos.Z()*1.0/petot);
@@ -1102,7 +1114,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
     // }else
     // hitpos*=1.0/petot; //hit position weighted by deposited charge
 
-  } else if (region == "North") {
+  } else if (region == kRegionNorth) {
     // hitpos*=1.0/petot;
     hitpos *= 1.0 / nz;
 
@@ -1119,7 +1131,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   hitpoint[1] = hitpos.Y();
   hitpoint[2] = hitpos.Z();
 
-  if (region == "South" && hitpoint[0] >= 366. && hitpoint[1] > 200. &&
+  if (region == kRegionSouth && hitpoint[0] >= 366. && hitpoint[1] > 200. &&
       fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "I am looking for south wall :   macs " << (int)macs.back()
@@ -1127,7 +1139,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         << hitpoint[2] << '\n';
 
   if (fVerbose) {
-    if (region == "North")
+    if (region == kRegionNorth)
       mf::LogInfo("CRTHitRecoAlg: ")
           << "north wall x: \t" << hitpoint[0] << " ,y: \t" << hitpoint[1]
           << " ,z: \t" << hitpoint[2] << '\n';
@@ -1180,7 +1192,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   t1hit = t1hit / uint64_t(t1trigs.size());
 
-  if (region == "South" && fVerbose)
+  if (region == kRegionSouth && fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "..................... Hello ....Welcome to Beam............"
         << '\n';
@@ -1189,7 +1201,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         << " <time>: T0: \t" << thit << " T1 : " << t1hit << " size ttrig: \t"
         << ttrigs.size() << '\n';
 
-  if (region == "South" && fVerbose)
+  if (region == kRegionSouth && fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "southt0_h: " << southt0_h << " ,southt0_v : " << southt0_v
         << " ,deltaT: \t" << int64_t(southt0_h - southt0_v) << '\n';
@@ -1199,20 +1211,20 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   // error estimates (likely need to be revisted)
   auto const& adsGeo = adGeo.SensitiveVolume(adsid_max);
-  if (region != "North" && region != "South") {
+  if (region != kRegionNorth && region != kRegionSouth) {
     hitpointerr[0] = (xmax - xmin) / sqrt(12);
     hitpointerr[1] = (ymax - ymin) / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
     //      hitpointerr[2] = adsGeo.Length()/sqrt(12);
   }
 
-  if (region == "North") {
+  if (region == kRegionNorth) {
     hitpointerr[0] = (xmax - xmin) / sqrt(12);
     hitpointerr[1] = (ymax - ymin) / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
   }
 
-  if (region == "South") {
+  if (region == kRegionSouth) {
     hitpointerr[0] = adsGeo.HalfWidth1() * 2 / sqrt(12);
     hitpointerr[1] = adsGeo.HalfWidth1() * 2 / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
@@ -1226,7 +1238,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   // generate hit
   CRTHit hit = FillCRTHit(macs, pesmap, petot, thit, thit1, plane, hitpoint[0],
                           hitpointerr[0], hitpoint[1], hitpointerr[1],
-                          hitpoint[2], hitpointerr[2], region);
+                          hitpoint[2], hitpointerr[2], regionName);
 
   return hit;
 }
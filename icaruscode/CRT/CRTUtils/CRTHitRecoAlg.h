@@ -68,6 +68,19 @@ inline bool sortbytime(const pair<int, ULong64_t>& a,
                        const pair<int, ULong64_t>& b) {
   return (a.second < b.second);
 }
+
+struct FEB_delay {
+  int HW_mac = -1;
+  int SW_mac = -1;
+  int SW_modID = -1;
+  ULong64_t T0_delay = 0;  //[ns]
+  ULong64_t T1_delay = 0;  //[ns]
+};
+
+typedef int feb_index;
+typedef std::map<feb_index, FEB_delay> CRT_delay_map;
+
+CRT_delay_map LoadFEBMap();
 }  // namespace icarus::crt
 
 class icarus::crt::CRTHitRecoAlg {
@@ -123,6 +136,8 @@ class icarus::crt::CRTHitRecoAlg {
 
   const icarusDB::IICARUSChannelMap* fChannelMap = nullptr;
 
+  CRT_delay_map const fFEBDelayMap;  ///< Top CRT FEB delays, by module ID
+
   // Given top CRTData product, produce CRTHit
   CRTHit MakeTopHit(art::Ptr<CRTData> data, ULong64_t GlobalTrigger[]);
   // Given bottom CRTData product, produce CRTHit
@@ -133,8 +148,8 @@ class icarus::crt::CRTHitRecoAlg {
   // Check if a hit is empty
   bool IsEmptyHit(CRTHit hit);
   // function to appply appropriate prop delay for Side full vs cut modules
-  // (North and South walls are cut modules)
-  int64_t RegionDelay(std::string const& region) const;
+  // (North and South walls are cut modules); region is a CRTRegionCode
+  int64_t RegionDelay(int region) const;
 
   std::map<uint8_t, int32_t> FEB_T1delay_side;  //<mac5, delay in ns>
   std::map<uint8_t, int32_t> FEB_T0delay_side;  //<mac5, delay in ns>
@@ -155,19 +170,6 @@ class icarus::crt::CRTHitRecoAlg {
 
 namespace icarus::crt {
 ULong64_t GetMode(std::vector<std::pair<int, ULong64_t>> vector);
-
-struct FEB_delay {
-  int HW_mac = -1;
-  int SW_mac = -1;
-  int SW_modID = -1;
-  ULong64_t T0_delay = 0;  //[ns]
-  ULong64_t T1_delay = 0;  //[ns]
-};
-
-typedef int feb_index;
-typedef std::map<feb_index, FEB_delay> CRT_delay_map;
-
-CRT_delay_map LoadFEBMap();
 }  // namespace icarus::crt
 
 inline icarus::crt::CRT_delay_map icarus::crt::LoadFEBMap() {
@@ -16,6 +16,7 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 // C++ standard libraries
+#include <algorithm> // std::sort(), std::partition_point()
 #include <utility>
 #include <cmath>
 
@@ -46,27 +47,77 @@ double icarus::crt::CRTHitTime
 }
 
 
+// -----------------------------------------------------------------------------
+icarus::crt::CRTHitTimeTable::CRTHitTimeTable(
+  std::vector<art::Ptr<sbn::crt::CRTHit>> const& crtHits,
+  bool isRealData, double globalT0Offset, bool matchBottomCRT
+)
+  : fMatchBottomCRT{ matchBottomCRT }
+{
+  fHits.reserve(crtHits.size());
+  for (std::size_t index = 0; index < crtHits.size(); ++index) {
+    art::Ptr<sbn::crt::CRTHit> const& crtHit = crtHits[index];
+    if (!matchBottomCRT && crtHit->plane > 49) continue; // For now, we are skipping bottom CRT Hits as they are not present in data. 
+    // care with conversions: if either side of a subtraction is a `double`,
+    // the other side is also converted to `double` just before the subtraction,
+    // and in this conversion it may lose precision; subtraction itself must
+    // operate between 64-bit integers, then the conversion of the result may happen
+    fHits.push_back
+      ({ CRTHitTime(*crtHit, globalT0Offset, isRealData), index, crtHit });
+  }
+  std::sort(fHits.begin(), fHits.end(),
+    [](Entry const& a, Entry const& b){ return a.time < b.time; });
+}
+
+
+// -----------------------------------------------------------------------------
+auto icarus::crt::CRTHitTimeTable::inTime(double time, double interval) const
+  -> std::vector<Entry const*>
+{
+  // the time difference from `time` does not decrease along the table,
+  // so the matching hits are contiguous
+  auto const begin = std::partition_point(fHits.begin(), fHits.end(),
+    [time,interval](Entry const& entry){ return entry.time - time <= -interval; });
+  auto const end = std::partition_point(begin, fHits.end(),
+    [time,interval](Entry const& entry){ return entry.time - time < interval; });
+
+  std::vector<Entry const*> entries;
+  for (auto it = begin; it != end; ++it) entries.push_back(&*it);
+  std::sort(entries.begin(), entries.end(),
+    [](Entry const* a, Entry const* b){ return a->index < b->index; });
+  return entries;
+}
+
+
 // -----------------------------------------------------------------------------
 icarus::crt::CRTMatches icarus::crt::CRTHitmatched(
   double flashTime, geo::Point_t const& flashpos,
   std::vector<art::Ptr<sbn::crt::CRTHit>>& crtHits, double interval, bool isRealData, double globalT0Offset, bool MatchBottomCRT) {
 
+  return CRTHitmatched(flashTime, flashpos,
+    CRTHitTimeTable{ crtHits, isRealData, globalT0Offset, MatchBottomCRT },
+    interval);
+}
+
+
+// -----------------------------------------------------------------------------
+icarus::crt::CRTMatches icarus::crt::CRTHitmatched(
+  double flashTime, geo::Point_t const& flashpos,
+  CRTHitTimeTable const& crtHits, double interval) {
+
+  bool const MatchBottomCRT = crtHits.matchBottomCRT();
   std::vector<icarus::crt::CRTPMT> enteringCRTHits;
   std::vector<icarus::crt::CRTPMT> exitingCRTHits;
   MatchType flashType;
   uint topen = 0, topex = 0, sideen = 0, sideex = 0, bottomen = 0, bottomex = 0;
-  for (auto const& crtHit : crtHits) {
-    if (!MatchBottomCRT && crtHit->plane > 49) continue; // For now, we are skipping bottom CRT Hits as they are not present in data. 
-    // care with conversions: if either side of a subtraction is a `double`,
-    // the other side is also converted to `double` just before the subtraction,
-    // and in this conversion it may lose precision; subtraction itself must
-    // operate between 64-bit integers, then the conversion of the result may happen
-    double const CRTHitTime_ns = CRTHitTime(*crtHit, globalT0Offset, isRealData);
+  // hits in time with the flash, in their original order
+  for (CRTHitTimeTable::Entry const* entry : crtHits.inTime(flashTime * 1e3, interval)) {
+    art::Ptr<sbn::crt::CRTHit> const& crtHit = entry->hit;
+    double const CRTHitTime_ns = entry->time;
     double tof = CRTHitTime_ns - flashTime * 1e3;
     double distance =
       (flashpos - geo::Point_t{crtHit->x_pos, crtHit->y_pos, crtHit->z_pos})
       .R();
-    if (abs(tof) >= interval) continue;
     if (tof < 0) {
       if (MatchBottomCRT && crtHit->plane > 49) 
 	bottomen++;
@@ -17,6 +17,7 @@
 #include "canvas/Persistency/Common/Ptr.h" 
 
 #include <vector>
+#include <cstddef> // std::size_t
 
 namespace recob { class OpFlash; } // no need to know the details
 
@@ -72,6 +73,60 @@ namespace icarus::crt {
   double CRTHitTime
     (sbn::crt::CRTHit const& hit, double globalT0Offset, bool isRealData);
 
+  /**
+   * @brief CRT hits of an event sorted by time, for matching to flashes.
+   *
+   * The time of each hit (`CRTHitTime()`) is computed once, when the table is
+   * created, and the hits are sorted by it, so that the hits matching a flash
+   * are found by binary search rather than by scanning all of them.
+   * Bottom CRT hits are left out unless their matching is requested.
+   *
+   * The table is meant to be created once per event and used for all its
+   * flashes.
+   */
+  class CRTHitTimeTable {
+  public:
+
+    /// Information about a CRT hit in the table.
+    struct Entry {
+      double time; ///< Time of the hit [ns], as from `CRTHitTime()`.
+      std::size_t index; ///< Position of the hit in the original list.
+      art::Ptr<sbn::crt::CRTHit> hit; ///< Pointer to the CRT hit.
+    };
+
+    /**
+     * @brief Creates the table with the specified CRT hits.
+     * @param crtHits list of the CRT hits to consider
+     * @param isRealData `true` for detector data, `false` for simulation
+     * @param globalT0Offset CRT timing offset [ns]
+     * @param matchBottomCRT whether to include the hits from the bottom CRT
+     */
+    CRTHitTimeTable(
+      std::vector<art::Ptr<sbn::crt::CRTHit>> const& crtHits,
+      bool isRealData, double globalT0Offset, bool matchBottomCRT
+      );
+
+    /**
+     * @brief Returns the hits closer than `interval` to `time`.
+     * @param time the time to be matched [ns]
+     * @param interval maximum time difference from `time` [ns]
+     * @return pointers to the matching entries, in the original hit order
+     */
+    std::vector<Entry const*> inTime(double time, double interval) const;
+
+    /// Returns whether the hits from the bottom CRT are included.
+    bool matchBottomCRT() const { return fMatchBottomCRT; }
+
+    /// Returns the number of hits in the table.
+    std::size_t size() const { return fHits.size(); }
+
+  private:
+    std::vector<Entry> fHits; ///< All the hits, sorted by time.
+    bool fMatchBottomCRT; ///< Whether bottom CRT hits are included.
+
+  }; // CRTHitTimeTable
+
+
   /**
    * @brief Returns all the CRT hits matching the specified flash time.
    * @param flashTime the time of the flash to be matched [us]
@@ -90,6 +145,21 @@ namespace icarus::crt {
     double flashTime, geo::Point_t const& flashpos,
     std::vector<art::Ptr<sbn::crt::CRTHit>>& crtHits, double interval, bool isRealData, double globalT0Offset,  bool matchBottomCRT);
 
+  /**
+   * @brief Returns all the CRT hits matching the specified flash time.
+   * @param flashTime the time of the flash to be matched [us]
+   * @param flashpos nominal position of the flash source [cm]
+   * @param crtHits table of the CRT hits to consider
+   * @param interval time difference for matching flash and hit [ns]
+   * @return a `CRTMatches` record with information about all the matched hits
+   *
+   * This is the same as the version taking the list of hits, but the hits are
+   * looked up in a table which can be shared by all the flashes of the event.
+   */
+  CRTMatches CRTHitmatched(
+    double flashTime, geo::Point_t const& flashpos,
+    CRTHitTimeTable const& crtHits, double interval);
+
 
   //@{
   /**
@@ -1,6 +1,8 @@
 #include "CRTT0MatchAlg.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 
+#include <algorithm> // std::sort(), std::lower_bound(), std::upper_bound()
+
 namespace icarus{
 
 
@@ -328,6 +330,7 @@ namespace icarus{
 										 const art::Event& event, uint64_t trigger_timestamp) const{
     //    matchCand newmc = makeNULLmc();
     std::vector<std::pair<sbn::crt::CRTHit, double> > crthitpair;
+    CRTHitTimeIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
@@ -337,7 +340,8 @@ namespace icarus{
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
 	
-	crthitpair.push_back(ClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	matchCand bestmatch = GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
+	crthitpair.push_back(std::make_pair(bestmatch.thishit, bestmatch.dca));
 	//	return ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -379,6 +383,14 @@ namespace icarus{
 					    recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
 					    std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t trigger_timestamp, bool IsData) const{
 
+    return GetClosestCRTHit(detProp, tpcTrack, hits, MakeCRTHitIndex(crtHits, trigger_timestamp, IsData));
+
+  }
+
+  matchCand CRTT0MatchAlg::GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+					    CRTHitTimeIndex const& crtHitIndex) const{
+
     auto start = tpcTrack.Vertex();
     auto end   = tpcTrack.End();
 
@@ -392,7 +404,7 @@ namespace icarus{
     // Get the allowed t0 range
     std::pair<double, double> t0MinMax = TrackT0Range(detProp, start.X(), end.X(), driftDirection, xLimits);
 
-    return GetClosestCRTHit(detProp, tpcTrack, t0MinMax, crtHits, driftDirection, trigger_timestamp, IsData);
+    return GetClosestCRTHit(detProp, tpcTrack, t0MinMax, crtHitIndex, driftDirection);
 
   }
 
@@ -401,6 +413,7 @@ namespace icarus{
 							 const art::Event& event, uint64_t trigger_timestamp) const{
     //    matchCand nullmatch = makeNULLmc();
     std::vector<matchCand> matchcanvec;
+    CRTHitTimeIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     //std::vector<std::pair<sbn::crt::CRTHit, double> > matchedCan;
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
@@ -409,7 +422,7 @@ namespace icarus{
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-        matchcanvec.push_back(GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false));
+        matchcanvec.push_back(GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex));
 	//return ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
 	//matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits);
 
@@ -430,6 +443,14 @@ namespace icarus{
 					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
 					    std::vector<sbn::crt::CRTHit> const& crtHits, int driftDirection, uint64_t& trigger_timestamp, bool IsData) const {
 
+    return GetClosestCRTHit(detProp, tpcTrack, t0MinMax, MakeCRTHitIndex(crtHits, trigger_timestamp, IsData), driftDirection);
+
+  }
+
+  matchCand CRTT0MatchAlg::GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+					    CRTHitTimeIndex const& crtHitIndex, int driftDirection) const {
+
     auto start = tpcTrack.Vertex();
     auto end   = tpcTrack.End();
 
@@ -438,11 +459,13 @@ namespace icarus{
     //  std::vector<std::pair<sbn::crt::CRTHit, double>> t0Candidates;
     std::vector<matchCand> t0Candidates;
 
-    //    if (crtHits.size() == 0) continue;
-    // Loop over all the CRT hits
-    for(auto &crtHit : crtHits){
-      // Check if hit is within the allowed t0 range
-      double crtTime = GetCRTTime(crtHit,trigger_timestamp,IsData);  // units are us
+    if (tpcTrack.Length() < fMinTrackLength) return matchCand{};
+
+    // Loop over the CRT hits within the allowed t0 range (all of them if the track is stitched)
+    // which pass the quality cuts
+    for(CRTHitTimeIndex::Entry const* entry : CandidateCRTHits(crtHitIndex, t0MinMax)){
+      sbn::crt::CRTHit const& crtHit = *(entry->hit);
+      double crtTime = entry->time;  // units are us
 /*      
      if(IsData){
       if (fTSMode == 1) {
@@ -457,17 +480,6 @@ namespace icarus{
      else if(!IsData){	
 	crtTime = crtHit.ts0_ns/1e3;
      }//end else if(!IsData)*/
-      // If track is stitched then try all hits
-      if (!((crtTime >= t0MinMax.first - 10. && crtTime <= t0MinMax.second + 10.) 
-            || t0MinMax.first == t0MinMax.second)) continue;
-
-      // cut on CRT hit PE value
-      if (crtHit.peshit<fPEcut) continue;
-      if (crtHit.x_err>fMaxUncert) continue;
-      if (crtHit.y_err>fMaxUncert) continue;
-      if (crtHit.z_err>fMaxUncert) continue;
-      if (tpcTrack.Length() < fMinTrackLength) continue;
-
       geo::Point_t crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
 
       //Calculate Track direction
@@ -575,6 +587,7 @@ namespace icarus{
 						   recob::Track const& tpcTrack, std::vector<sbn::crt::CRTHit> const& crtHits, 
 						   const art::Event& event, uint64_t trigger_timestamp) const{
     std::vector<double> ftime;
+    CRTHitTimeIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
       if (!tpcTrackHandle.isValid()) continue;
@@ -582,7 +595,7 @@ namespace icarus{
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-	ftime.push_back(T0FromCRTHits(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	ftime.push_back(T0FromCRTHits(detProp, tpcTrack, hits, crtHitIndex));
 	// return T0FromCRTHits(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -600,9 +613,17 @@ namespace icarus{
 				      recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
 				      std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t& trigger_timestamp)  const{
 
+    return T0FromCRTHits(detProp, tpcTrack, hits, MakeCRTHitIndex(crtHits, trigger_timestamp, false));
+
+  }
+
+  double CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+				      recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+				      CRTHitTimeIndex const& crtHitIndex)  const{
+
     if (tpcTrack.Length() < fMinTrackLength) return -99999; 
 
-    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false);
+    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
     if(closestHit.dca <0) return -99999;
 
     double crtTime;
@@ -623,6 +644,7 @@ namespace icarus{
 									     const art::Event& event, uint64_t trigger_timestamp) const{ 
    
     std::vector<std::pair<double, double> > ft0anddca;
+    CRTHitTimeIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
       if (!tpcTrackHandle.isValid()) continue;
@@ -630,7 +652,7 @@ namespace icarus{
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-	ft0anddca.push_back(T0AndDCAFromCRTHits(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	ft0anddca.push_back(T0AndDCAFromCRTHits(detProp, tpcTrack, hits, crtHitIndex));
 	//        return T0AndDCAFromCRTHits(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -647,9 +669,17 @@ namespace icarus{
 							       recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
 							       std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t& trigger_timestamp) const{
 
+    return T0AndDCAFromCRTHits(detProp, tpcTrack, hits, MakeCRTHitIndex(crtHits, trigger_timestamp, false));
+
+  }
+
+  std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+							       recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+							       CRTHitTimeIndex const& crtHitIndex) const{
+
     if (tpcTrack.Length() < fMinTrackLength) return std::make_pair(-9999., -9999.);
 
-    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false);
+    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
 
     if(closestHit.dca < 0 ) return std::make_pair(-9999., -9999.);
     if (closestHit.dca < fDistanceLimit && (closestHit.dca/closestHit.extrapLen) < fDoverLLimit) return std::make_pair(closestHit.t0, closestHit.dca);
@@ -840,6 +870,14 @@ namespace icarus{
 					    recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
 					    std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t trigger_timestamp, bool IsData) const{
 
+    return GetClosestCRTHit_geo(detProp, tpcTrack, hits, MakeCRTHitIndex(crtHits, trigger_timestamp, IsData));
+
+  }
+
+  std::vector<icarus::match_geometry> CRTT0MatchAlg::GetClosestCRTHit_geo(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+					    CRTHitTimeIndex const& crtHitIndex) const{
+
     auto start = tpcTrack.Vertex();
     auto end   = tpcTrack.End();
 
@@ -853,7 +891,7 @@ namespace icarus{
     // Get the allowed t0 range
     std::pair<double, double> t0MinMax = TrackT0Range(detProp, start.X(), end.X(), driftDirection, xLimits);
 
-    return GetClosestCRTHit_geo(detProp, tpcTrack, t0MinMax, crtHits, driftDirection, trigger_timestamp, IsData);
+    return GetClosestCRTHit_geo(detProp, tpcTrack, t0MinMax, crtHitIndex, driftDirection);
 
   }
 /*
@@ -891,6 +929,14 @@ namespace icarus{
 					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
 					    std::vector<sbn::crt::CRTHit> const& crtHits, int driftDirection, uint64_t& trigger_timestamp, bool IsData) const{
 
+    return GetClosestCRTHit_geo(detProp, tpcTrack, t0MinMax, MakeCRTHitIndex(crtHits, trigger_timestamp, IsData), driftDirection);
+
+  }
+
+    std::vector<icarus::match_geometry> CRTT0MatchAlg::GetClosestCRTHit_geo(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+					    CRTHitTimeIndex const& crtHitIndex, int driftDirection) const{
+
     auto start = tpcTrack.Vertex();
     auto end   = tpcTrack.End();
 
@@ -901,11 +947,13 @@ namespace icarus{
     //  std::vector<std::pair<sbn::crt::CRTHit, double>> t0Candidates;
     std::vector<match_geometry> t0Candidates;
 
-    //    if (crtHits.size() == 0) continue;
-    // Loop over all the CRT hits
-    for(auto &crtHit : crtHits){
-      // Check if hit is within the allowed t0 range
-      double crtTime = GetCRTTime(crtHit,trigger_timestamp,IsData);  // units are us
+    if (tpcTrack.Length() < fMinTrackLength) return t0Candidates;
+
+    // Loop over the CRT hits within the allowed t0 range (all of them if the track is stitched)
+    // which pass the quality cuts
+    for(CRTHitTimeIndex::Entry const* entry : CandidateCRTHits(crtHitIndex, t0MinMax)){
+      sbn::crt::CRTHit const& crtHit = *(entry->hit);
+      double crtTime = entry->time;  // units are us
 
      icarus::match_geometry this_candidate;// = makeNULLmc_geo();
 /*     if(IsData){
@@ -921,17 +969,6 @@ namespace icarus{
      else if(!IsData){	
 	crtTime = crtHit.ts0_ns/1e3;
      }//end else if(!IsData)*/
-      // If track is stitched then try all hits
-      if (!((crtTime >= t0MinMax.first - 10. && crtTime <= t0MinMax.second + 10.) 
-            || t0MinMax.first == t0MinMax.second)) continue;
-
-      // cut on CRT hit PE value
-      if (crtHit.peshit<fPEcut) continue;
-      if (crtHit.x_err>fMaxUncert) continue;
-      if (crtHit.y_err>fMaxUncert) continue;
-      if (crtHit.z_err>fMaxUncert) continue;
-      if (tpcTrack.Length() < fMinTrackLength) continue;
-
       geo::Point_t crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
 
       //Calculate Track direction
@@ -1064,4 +1101,89 @@ namespace icarus{
     }//end definition of double CRTT0MatchAlg::GetCRTTime(sbn::crt:CRTHit const& crthit, uint64_t trigger_timestamp, bool isdata) const
 
 
+  CRTHitTimeIndex CRTT0MatchAlg::MakeCRTHitIndex(std::vector<sbn::crt::CRTHit> const& crtHits, 
+						 uint64_t trigger_timestamp, bool IsData) const {
+
+    std::vector<sbn::crt::CRTHit const*> hitPtrs;
+    hitPtrs.reserve(crtHits.size());
+    for(auto const& crtHit : crtHits) hitPtrs.push_back(&crtHit);
+    return MakeCRTHitIndex(hitPtrs, trigger_timestamp, IsData);
+
+  }
+
+  CRTHitTimeIndex CRTT0MatchAlg::MakeCRTHitIndex(std::vector<art::Ptr<sbn::crt::CRTHit>> const& crtHits, 
+						 uint64_t trigger_timestamp, bool IsData) const {
+
+    std::vector<sbn::crt::CRTHit const*> hitPtrs;
+    hitPtrs.reserve(crtHits.size());
+    for(auto const& crtHit : crtHits) hitPtrs.push_back(crtHit.get());
+    return MakeCRTHitIndex(hitPtrs, trigger_timestamp, IsData);
+
+  }
+
+  CRTHitTimeIndex CRTT0MatchAlg::MakeCRTHitIndex(std::vector<sbn::crt::CRTHit const*> const& crtHits, 
+						 uint64_t trigger_timestamp, bool IsData) const {
+
+    CRTHitTimeIndex index;
+    index.fByTime.reserve(crtHits.size());
+    for(std::size_t order = 0; order < crtHits.size(); ++order){
+      sbn::crt::CRTHit const& crtHit = *crtHits[order];
+
+      // cut on CRT hit PE value and position uncertainty
+      if (crtHit.peshit<fPEcut) continue;
+      if (crtHit.x_err>fMaxUncert) continue;
+      if (crtHit.y_err>fMaxUncert) continue;
+      if (crtHit.z_err>fMaxUncert) continue;
+
+      index.fByTime.push_back({ GetCRTTime(crtHit, trigger_timestamp, IsData), order, &crtHit });
+    }
+
+    std::sort(index.fByTime.begin(), index.fByTime.end(),
+	      [](CRTHitTimeIndex::Entry const& a, CRTHitTimeIndex::Entry const& b){ return a.time < b.time; });
+    return index;
+
+  }
+
+  std::vector<CRTHitTimeIndex::Entry const*> CRTT0MatchAlg::CandidateCRTHits(CRTHitTimeIndex const& crtHitIndex,
+									     std::pair<double, double> t0MinMax) const {
+
+    // If track is stitched then try all hits
+    if (t0MinMax.first == t0MinMax.second) return crtHitIndex.All();
+    return crtHitIndex.InWindow(t0MinMax.first - 10., t0MinMax.second + 10.);
+
+  }
+
+
+  std::vector<CRTHitTimeIndex::Entry const*> CRTHitTimeIndex::InWindow(double tmin, double tmax) const {
+
+    auto const begin = std::lower_bound(fByTime.begin(), fByTime.end(), tmin,
+					[](Entry const& entry, double time){ return entry.time < time; });
+    auto const end = std::upper_bound(begin, fByTime.end(), tmax,
+				      [](double time, Entry const& entry){ return time < entry.time; });
+    return InOriginalOrder(begin, end);
+
+  }
+
+  std::vector<CRTHitTimeIndex::Entry const*> CRTHitTimeIndex::All() const {
+
+    return InOriginalOrder(fByTime.begin(), fByTime.end());
+
+  }
+
+  std::vector<CRTHitTimeIndex::Entry const*> CRTHitTimeIndex::InOriginalOrder
+    (std::vector<Entry>::const_iterator begin, std::vector<Entry>::const_iterator end)
+  {
+
+    // the choice of the best match among equivalent candidates depends on the order
+    std::vector<Entry const*> entries;
+    if (begin >= end) return entries;
+    entries.reserve(end - begin);
+    for(auto it = begin; it != end; ++it) entries.push_back(&*it);
+    std::sort(entries.begin(), entries.end(),
+	      [](Entry const* a, Entry const* b){ return a->order < b->order; });
+    return entries;
+
+  }
+
+
 }
@@ -54,6 +54,7 @@
 #include <utility>
 #include <cmath> 
 #include <memory>
+#include <cstddef>
 
 // ROOT
 #include "TVector3.h"
@@ -111,6 +112,36 @@ namespace icarus{
 
 
 
+  // CRT hits of an event which pass the quality cuts, with their time,
+  // sorted by time; built once per event by CRTT0MatchAlg::MakeCRTHitIndex()
+  // so that each track only scans the hits in its allowed t0 range
+  class CRTHitTimeIndex {
+  public:
+
+    struct Entry {
+      double time;                  // CRT hit time [us], as from GetCRTTime()
+      std::size_t order;            // position of the hit in the original list
+      sbn::crt::CRTHit const* hit;
+    };
+
+    // Hits with time in [tmin, tmax], in their original order
+    std::vector<Entry const*> InWindow(double tmin, double tmax) const;
+
+    // All the hits, in their original order
+    std::vector<Entry const*> All() const;
+
+    std::size_t size() const { return fByTime.size(); }
+
+  private:
+    friend class CRTT0MatchAlg;
+
+    std::vector<Entry> fByTime; // sorted by time
+
+    static std::vector<Entry const*> InOriginalOrder
+      (std::vector<Entry>::const_iterator begin, std::vector<Entry>::const_iterator end);
+  };
+
+
   class CRTT0MatchAlg {
   public:
 
@@ -208,8 +239,48 @@ namespace icarus{
 
     double GetCRTTime(sbn::crt::CRTHit const& crthit, uint64_t trigger_timestamp, bool isdata) const;
 
+    // Index of the CRT hits of an event (which must outlive it), with the times
+    // from GetCRTTime() and only the hits passing the PE and uncertainty cuts
+    CRTHitTimeIndex MakeCRTHitIndex(std::vector<sbn::crt::CRTHit> const& crtHits, 
+				    uint64_t trigger_timestamp, bool IsData) const;
+
+    CRTHitTimeIndex MakeCRTHitIndex(std::vector<art::Ptr<sbn::crt::CRTHit>> const& crtHits, 
+				    uint64_t trigger_timestamp, bool IsData) const;
+
+    // Same as the functions above taking a list of CRT hits, using an index built once per event
+    matchCand GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+			       CRTHitTimeIndex const& crtHitIndex) const;
+
+    matchCand GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+			       CRTHitTimeIndex const& crtHitIndex, int driftDirection) const;
+
+    std::vector<icarus::match_geometry> GetClosestCRTHit_geo(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+			       CRTHitTimeIndex const& crtHitIndex) const;
+
+    std::vector<icarus::match_geometry> GetClosestCRTHit_geo(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+			       CRTHitTimeIndex const& crtHitIndex, int driftDirection) const;
+
+    double T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+			 recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+			 CRTHitTimeIndex const& crtHitIndex) const;
+
+    std::pair<double, double>  T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+						   recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+						   CRTHitTimeIndex const& crtHitIndex) const;
+
   private:
 
+    CRTHitTimeIndex MakeCRTHitIndex(std::vector<sbn::crt::CRTHit const*> const& crtHits, 
+				    uint64_t trigger_timestamp, bool IsData) const;
+
+    // CRT hits which may match a track with the specified t0 range
+    std::vector<CRTHitTimeIndex::Entry const*> CandidateCRTHits(CRTHitTimeIndex const& crtHitIndex,
+								 std::pair<double, double> t0MinMax) const;
+
     geo::GeometryCore const* fGeometryService;
     spacecharge::SpaceCharge  const* fSCE;
 
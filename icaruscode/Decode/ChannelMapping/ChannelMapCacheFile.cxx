@@ -0,0 +1,419 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.cxx
+ * @brief  On-disk binary cache of the channel mapping database content.
+ * @date   October 16, 2026
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h
+ */
+
+// library header
+#include "icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h"
+
+// POSIX
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h> // close(), getpid()
+
+// C/C++ standard libraries
+#include <fstream>
+#include <stdexcept> // std::runtime_error
+#include <cstring> // std::memcpy()
+#include <cstdio> // std::rename(), std::remove()
+#include <utility> // std::move(), std::swap()
+#include <type_traits>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /*
+   * File layout (all integers in native byte order):
+   *
+   * [ 8 bytes] magic string "ICMAPCF1"
+   * [ 4 bytes] byte order marker, 0x01020304
+   * [ 4 bytes] format version
+   * [ 8 bytes] payload size in bytes
+   * [ 8 bytes] payload hash (ChannelMapCacheFile::hash())
+   * [ 8 bytes] key size, followed by the key
+   * [ ...    ] payload: the six maps, each as element count and elements
+   */
+  constexpr char Magic[8] = { 'I', 'C', 'M', 'A', 'P', 'C', 'F', '1' };
+  constexpr std::uint32_t ByteOrderMarker = 0x01020304;
+  constexpr std::uint32_t FormatVersion = 1;
+
+
+  /// Appends binary data to a string buffer.
+  class BinaryWriter {
+    std::string& fBuffer;
+
+      public:
+    BinaryWriter(std::string& buffer): fBuffer{ buffer } {}
+
+    template <typename T>
+    void write(T value)
+      {
+        static_assert(std::is_arithmetic_v<T>);
+        fBuffer.append(reinterpret_cast<char const*>(&value), sizeof(value));
+      }
+
+    void write(std::string const& s)
+      { write<std::uint64_t>(s.size()); fBuffer.append(s); }
+
+  }; // BinaryWriter
+
+
+  /// Reads binary data from a memory region, checking its boundaries.
+  class BinaryReader {
+    char const* fCursor;
+    char const* const fEnd;
+    bool fOK = true;
+
+      public:
+    BinaryReader(char const* begin, char const* end)
+      : fCursor{ begin }, fEnd{ end } {}
+
+    /// Returns whether all reads so far were within boundaries.
+    bool ok() const { return fOK; }
+
+    template <typename T>
+    T read()
+      {
+        static_assert(std::is_arithmetic_v<T>);
+        T value{};
+        if (!require(sizeof(T))) return value;
+        std::memcpy(&value, fCursor, sizeof(T)); // may be unaligned
+        fCursor += sizeof(T);
+        return value;
+      }
+
+    std::string readString()
+      {
+        std::uint64_t const size = read<std::uint64_t>();
+        if (!require(size)) return {};
+        std::string s{ fCursor, static_cast<std::size_t>(size) };
+        fCursor += size;
+        return s;
+      }
+
+    /// Reads an element count; fails if the elements can't possibly fit.
+    std::size_t readCount()
+      {
+        std::uint64_t const n = read<std::uint64_t>();
+        // every element takes at least one byte
+        if (n > static_cast<std::uint64_t>(fEnd - fCursor)) fOK = false;
+        return fOK? static_cast<std::size_t>(n): 0;
+      }
+
+      private:
+    bool require(std::uint64_t size)
+      {
+        if (fOK && (size > static_cast<std::uint64_t>(fEnd - fCursor)))
+          fOK = false;
+        return fOK;
+      }
+
+  }; // BinaryReader
+
+
+  /// Read-only memory mapping of a whole file (RAII).
+  class MappedFile {
+    void* fData = MAP_FAILED;
+    std::size_t fSize = 0;
+
+      public:
+    explicit MappedFile(std::string const& path)
+      {
+        int const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if ((::fstat(fd, &info) == 0) && (info.st_size > 0)) {
+          fSize = static_cast<std::size_t>(info.st_size);
+          fData = ::mmap(nullptr, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd); // the mapping stays valid
+      }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator= (MappedFile const&) = delete;
+
+    ~MappedFile() { if (fData != MAP_FAILED) ::munmap(fData, fSize); }
+
+    bool valid() const { return fData != MAP_FAILED; }
+    char const* begin() const { return static_cast<char const*>(fData); }
+    char const* end() const { return begin() + fSize; }
+
+  }; // MappedFile
+
+
+  // --- BEGIN --- map serialization -------------------------------------------
+  void writeMap
+    (BinaryWriter& out, icarusDB::TPCFragmentIDToReadoutIDMap const& map)
+  {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ fragmentID, crateAndBoards ]: map) {
+      out.write<std::uint32_t>(fragmentID);
+      out.write(crateAndBoards.first);
+      out.write<std::uint64_t>(crateAndBoards.second.size());
+      for (unsigned int const boardID: crateAndBoards.second)
+        out.write<std::uint32_t>(boardID);
+    }
+  } // writeMap(TPCFragmentIDToReadoutIDMap)
+
+  void readMap(BinaryReader& in, icarusDB::TPCFragmentIDToReadoutIDMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      auto& [ crateName, boards ] = map[in.read<std::uint32_t>()];
+      crateName = in.readString();
+      for (std::size_t nB = in.readCount(); in.ok() && nB; --nB)
+        boards.push_back(in.read<std::uint32_t>());
+    }
+  } // readMap(TPCFragmentIDToReadoutIDMap)
+
+
+  void writeMap
+    (BinaryWriter& out, icarusDB::TPCReadoutBoardToChannelMap const& map)
+  {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ boardID, slotAndChannels ]: map) {
+      out.write<std::uint32_t>(boardID);
+      out.write<std::uint32_t>(slotAndChannels.first);
+      out.write<std::uint64_t>(slotAndChannels.second.size());
+      for (auto const& [ channel, plane ]: slotAndChannels.second) {
+        out.write<std::uint32_t>(channel);
+        out.write<std::uint32_t>(plane);
+      }
+    }
+  } // writeMap(TPCReadoutBoardToChannelMap)
+
+  void readMap(BinaryReader& in, icarusDB::TPCReadoutBoardToChannelMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      auto& [ slot, channels ] = map[in.read<std::uint32_t>()];
+      slot = in.read<std::uint32_t>();
+      for (std::size_t nC = in.readCount(); in.ok() && nC; --nC) {
+        unsigned int const channel = in.read<std::uint32_t>();
+        channels.emplace_back(channel, in.read<std::uint32_t>());
+      }
+    }
+  } // readMap(TPCReadoutBoardToChannelMap)
+
+
+  void writeMap
+    (BinaryWriter& out, icarusDB::PMTFragmentToDigitizerChannelMap const& map)
+  {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ key, channels ]: map) {
+      out.write<std::uint32_t>(key);
+      out.write<std::uint64_t>(channels.size());
+      for (icarusDB::PMTChannelInfo_t const& info: channels) {
+        out.write(info.digitizerLabel);
+        out.write<std::uint32_t>(info.digitizerChannelNo);
+        out.write<std::uint32_t>(info.channelID);
+        out.write<std::uint32_t>(info.laserChannelNo);
+        out.write<std::uint16_t>(info.LVDSconnector);
+        out.write<std::uint16_t>(info.LVDSbit);
+        out.write<std::uint16_t>(info.adderConnector);
+        out.write<std::uint16_t>(info.adderBit);
+      }
+    }
+  } // writeMap(PMTFragmentToDigitizerChannelMap)
+
+  void readMap
+    (BinaryReader& in, icarusDB::PMTFragmentToDigitizerChannelMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      auto& channels = map[in.read<std::uint32_t>()];
+      for (std::size_t nC = in.readCount(); in.ok() && nC; --nC) {
+        icarusDB::PMTChannelInfo_t info;
+        info.digitizerLabel = in.readString();
+        info.digitizerChannelNo = in.read<std::uint32_t>();
+        info.channelID = in.read<std::uint32_t>();
+        info.laserChannelNo = in.read<std::uint32_t>();
+        info.LVDSconnector = in.read<std::uint16_t>();
+        info.LVDSbit = in.read<std::uint16_t>();
+        info.adderConnector = in.read<std::uint16_t>();
+        info.adderBit = in.read<std::uint16_t>();
+        channels.push_back(std::move(info));
+      }
+    }
+  } // readMap(PMTFragmentToDigitizerChannelMap)
+
+
+  void writeMap(
+    BinaryWriter& out,
+    icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap const& map
+  ) {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ channel, addresses ]: map) {
+      out.write<std::uint32_t>(channel);
+      out.write<std::uint32_t>(addresses.first);
+      out.write<std::uint32_t>(addresses.second);
+    }
+  } // writeMap(CRTChannelIDToHWtoSimMacAddressPairMap)
+
+  void readMap
+    (BinaryReader& in, icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      auto& [ hwAddress, simAddress ] = map[in.read<std::uint32_t>()];
+      hwAddress = in.read<std::uint32_t>();
+      simAddress = in.read<std::uint32_t>();
+    }
+  } // readMap(CRTChannelIDToHWtoSimMacAddressPairMap)
+
+
+  void writeMap
+    (BinaryWriter& out, icarusDB::TopCRTHWtoSimMacAddressPairMap const& map)
+  {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ hwAddress, simAddress ]: map) {
+      out.write<std::uint32_t>(hwAddress);
+      out.write<std::uint32_t>(simAddress);
+    }
+  } // writeMap(TopCRTHWtoSimMacAddressPairMap)
+
+  void readMap(BinaryReader& in, icarusDB::TopCRTHWtoSimMacAddressPairMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      unsigned int const hwAddress = in.read<std::uint32_t>();
+      map[hwAddress] = in.read<std::uint32_t>();
+    }
+  } // readMap(TopCRTHWtoSimMacAddressPairMap)
+
+
+  void writeMap
+    (BinaryWriter& out, icarusDB::SideCRTChannelToCalibrationMap const& map)
+  {
+    out.write<std::uint64_t>(map.size());
+    for (auto const& [ key, calib ]: map) {
+      out.write<std::uint32_t>(key.first);
+      out.write<std::uint32_t>(key.second);
+      out.write<double>(calib.first);
+      out.write<double>(calib.second);
+    }
+  } // writeMap(SideCRTChannelToCalibrationMap)
+
+  void readMap(BinaryReader& in, icarusDB::SideCRTChannelToCalibrationMap& map)
+  {
+    for (std::size_t n = in.readCount(); in.ok() && n; --n) {
+      unsigned int const mac5 = in.read<std::uint32_t>();
+      unsigned int const channel = in.read<std::uint32_t>();
+      auto& [ gain, pedestal ] = map[{ mac5, channel }];
+      gain = in.read<double>();
+      pedestal = in.read<double>();
+    }
+  } // readMap(SideCRTChannelToCalibrationMap)
+
+  // --- END ----- map serialization -------------------------------------------
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+bool icarusDB::ChannelMapCacheFile::read
+  (std::string const& key, Content& content) const
+{
+  MappedFile const file{ fPath };
+  if (!file.valid()) return false;
+
+  BinaryReader header{ file.begin(), file.end() };
+  for (char const c: Magic) if (header.read<char>() != c) return false;
+  if (header.read<std::uint32_t>() != ByteOrderMarker) return false;
+  if (header.read<std::uint32_t>() != FormatVersion) return false;
+  std::uint64_t const payloadSize = header.read<std::uint64_t>();
+  std::uint64_t const payloadHash = header.read<std::uint64_t>();
+  if (!header.ok() || (header.readString() != key) || !header.ok())
+    return false;
+
+  // the payload is whatever follows the header
+  std::size_t const headerSize = sizeof(Magic) + 2 * sizeof(std::uint32_t)
+    + 3 * sizeof(std::uint64_t) + key.size();
+  std::size_t const fileSize = file.end() - file.begin();
+  if (fileSize != headerSize + payloadSize) return false;
+  std::string_view const payload
+    { file.begin() + headerSize, static_cast<std::size_t>(payloadSize) };
+  if (hash(payload) != payloadHash) return false;
+
+  // read into new maps, so that a failure leaves the content untouched
+  TPCFragmentIDToReadoutIDMap TPCfragments;
+  TPCReadoutBoardToChannelMap TPCboards;
+  PMTFragmentToDigitizerChannelMap PMTfragments;
+  CRTChannelIDToHWtoSimMacAddressPairMap CRTside;
+  TopCRTHWtoSimMacAddressPairMap CRTtop;
+  SideCRTChannelToCalibrationMap CRTcalibration;
+
+  BinaryReader in{ payload.data(), payload.data() + payload.size() };
+  readMap(in, TPCfragments);
+  readMap(in, TPCboards);
+  readMap(in, PMTfragments);
+  readMap(in, CRTside);
+  readMap(in, CRTtop);
+  readMap(in, CRTcalibration);
+  if (!in.ok()) return false;
+
+  std::swap(content.TPCfragments, TPCfragments);
+  std::swap(content.TPCboards, TPCboards);
+  std::swap(content.PMTfragments, PMTfragments);
+  std::swap(content.CRTside, CRTside);
+  std::swap(content.CRTtop, CRTtop);
+  std::swap(content.CRTcalibration, CRTcalibration);
+  return true;
+
+} // icarusDB::ChannelMapCacheFile::read()
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapCacheFile::write
+  (std::string const& key, Content const& content) const
+{
+  std::string payload;
+  BinaryWriter out{ payload };
+  writeMap(out, content.TPCfragments);
+  writeMap(out, content.TPCboards);
+  writeMap(out, content.PMTfragments);
+  writeMap(out, content.CRTside);
+  writeMap(out, content.CRTtop);
+  writeMap(out, content.CRTcalibration);
+
+  std::string header;
+  BinaryWriter headerOut{ header };
+  header.append(Magic, sizeof(Magic));
+  headerOut.write(ByteOrderMarker);
+  headerOut.write(FormatVersion);
+  headerOut.write<std::uint64_t>(payload.size());
+  headerOut.write<std::uint64_t>(hash(payload));
+  headerOut.write(key);
+
+  // write to a unique temporary file, then atomically replace the target
+  std::string const tempPath = fPath + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+    file.write(header.data(), header.size());
+    file.write(payload.data(), payload.size());
+    if (!file.flush()) {
+      std::remove(tempPath.c_str());
+      throw std::runtime_error
+        { "ChannelMapCacheFile: failed writing '" + tempPath + "'" };
+    }
+  }
+  if (std::rename(tempPath.c_str(), fPath.c_str()) != 0) {
+    std::remove(tempPath.c_str());
+    throw std::runtime_error
+      { "ChannelMapCacheFile: failed to create '" + fPath + "'" };
+  }
+
+} // icarusDB::ChannelMapCacheFile::write()
+
+
+// -----------------------------------------------------------------------------
+std::uint64_t icarusDB::ChannelMapCacheFile::hash
+  (std::string_view data, std::uint64_t seed /* = HashSeed */)
+{
+  constexpr std::uint64_t Prime = 0x100000001b3ULL;
+  std::uint64_t h = seed;
+  for (unsigned char const c: data) { h ^= c; h *= Prime; }
+  return h;
+} // icarusDB::ChannelMapCacheFile::hash()
+
+
+// -----------------------------------------------------------------------------
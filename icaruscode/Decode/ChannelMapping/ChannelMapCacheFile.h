@@ -0,0 +1,110 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h
+ * @brief  On-disk binary cache of the channel mapping database content.
+ * @date   October 16, 2026
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPCACHEFILE_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPCACHEFILE_H
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapDataTypes.h"
+
+// C/C++ standard libraries
+#include <string>
+#include <string_view>
+#include <cstdint> // std::uint64_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarusDB { class ChannelMapCacheFile; }
+/**
+ * @brief A binary file holding all the channel mapping maps of a run period.
+ *
+ * Reading the channel mapping from the database backends (SQLite files or the
+ * PostgreSQL conditions database) takes seconds, and it happens at the start
+ * of each job. This class stores the fully built maps in a compact binary
+ * file, which is read back with a single memory mapping.
+ *
+ * Each file is tagged with a _key_, which describes the content of the
+ * database it was built from (see `icarusDB::IChannelMapping::CacheKey()`).
+ * Reading a file with a different key, or one which is truncated, corrupted,
+ * from an older format or from a platform with different endianness, fails
+ * quietly: callers are expected to treat that as a cache miss and read from
+ * the database instead.
+ *
+ * Files are written to a temporary name and then renamed, so that concurrent
+ * jobs sharing the same cache directory never see a partially written file.
+ *
+ * Example:
+ * @code{.cpp}
+ * icarusDB::ChannelMapCacheFile cacheFile{ "/tmp/chmap_period2.bin" };
+ * icarusDB::ChannelMapCacheFile::Content content{
+ *   TPCfragments, TPCboards, PMTfragments, CRTside, CRTtop, CRTcalibration
+ *   };
+ * if (!cacheFile.read(key, content)) {
+ *   // ... fill the maps from the database, then:
+ *   cacheFile.write(key, content);
+ * }
+ * @endcode
+ */
+class icarusDB::ChannelMapCacheFile {
+
+    public:
+
+  /// All the maps stored in a cache file (the maps are owned by the caller).
+  struct Content {
+    TPCFragmentIDToReadoutIDMap& TPCfragments;
+    TPCReadoutBoardToChannelMap& TPCboards;
+    PMTFragmentToDigitizerChannelMap& PMTfragments;
+    CRTChannelIDToHWtoSimMacAddressPairMap& CRTside;
+    TopCRTHWtoSimMacAddressPairMap& CRTtop;
+    SideCRTChannelToCalibrationMap& CRTcalibration;
+  }; // Content
+
+
+  /// Constructor: the cache file will be at `path`.
+  explicit ChannelMapCacheFile(std::string path): fPath{ std::move(path) } {}
+
+  /// Returns the path of the cache file.
+  std::string const& path() const { return fPath; }
+
+  /**
+   * @brief Fills `content` from the cache file.
+   * @param key the key the cache file must have been written with
+   * @param[out] content the maps to be filled
+   * @return whether the cache file was valid and `content` was filled
+   *
+   * The maps in `content` are replaced only if the whole file is valid;
+   * otherwise they are left untouched.
+   */
+  bool read(std::string const& key, Content& content) const;
+
+  /**
+   * @brief Writes the cache file with `content`, tagged with `key`.
+   * @throw std::runtime_error if writing fails
+   *
+   * An existing file is replaced.
+   */
+  void write(std::string const& key, Content const& content) const;
+
+
+  /// Returns a 64-bit FNV-1a hash of `data` (chainable via `seed`).
+  static std::uint64_t hash
+    (std::string_view data, std::uint64_t seed = HashSeed);
+
+  /// Initial value for `hash()`.
+  static constexpr std::uint64_t HashSeed = 0xcbf29ce484222325ULL;
+
+
+    private:
+
+  std::string fPath; ///< Path of the cache file.
+
+}; // icarusDB::ChannelMapCacheFile
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPCACHEFILE_H
@@ -129,6 +129,16 @@ bool icarusDB::ChannelMapPostGres::SelectPeriod(RunPeriod period) {
 } // icarusDB::ChannelMapPostGres::SelectPeriod()
 
 
+// -----------------------------------------------------------------------------
+std::string icarusDB::ChannelMapPostGres::CacheKey() const {
+  
+  // the same URL and timestamp may serve different content over time, and the
+  // database does not tell which version it serves: never cache
+  return {};
+  
+} // icarusDB::ChannelMapPostGres::CacheKey()
+
+
 // -----------------------------------------------------------------------------
 icarusDB::details::WDADataset icarusDB::ChannelMapPostGres::GetDataset
   (std::string const& name, std::string url, std::string const& dataType) const
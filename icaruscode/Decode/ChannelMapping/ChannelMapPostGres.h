@@ -94,6 +94,16 @@ class icarusDB::ChannelMapPostGres
    * necessary, but it's not harmful either (at most, wasteful).
    */
   virtual bool SelectPeriod(RunPeriod period) override;
+  
+  /**
+   * @brief Returns an empty key: the content of this database is never cached.
+   * 
+   * The remote database may change the content served under the same URL for
+   * the same period, and it does not expose a version of that content that
+   * could be included in the key; a persistent cache could then silently
+   * serve a stale mapping.
+   */
+  virtual std::string CacheKey() const override;
 
   /**
    *  @brief Define the returned data structures for a mapping between TPC Fragment IDs
@@ -7,6 +7,7 @@
 // library header
 #include "icaruscode/Decode/ChannelMapping/ChannelMapSQLite.h"
 #include "icaruscode/Decode/ChannelMapping/PositionFinder.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h"
 
 // ICARUS libraries
 
@@ -26,6 +27,8 @@
 
 // C++ standard libraries
 #include <algorithm> // std::transform()
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <memory>
@@ -219,6 +222,55 @@ bool icarusDB::ChannelMapSQLite::SelectPeriod(RunPeriod period) {
 } // icarusDB::ChannelMapSQLite::SelectPeriod()
 
 
+// -----------------------------------------------------------------------------
+std::string icarusDB::ChannelMapSQLite::CacheKey() const {
+  
+  if (!fCurrentTable) return {}; // no period selected yet
+  
+  return "SQLite;" + fTag
+    + ";" + fCurrentTable->TPCfragmentMap
+    + ";" + fCurrentTable->TPCreadoutBoardMap
+    + ";" + fCurrentTable->PMTfragmentMap
+    + ";" + fCurrentTable->CRTsideMap
+    + ";" + fCurrentTable->CRTtopMap
+    + ";" + fDBFileName + ":" + FileChecksum(fDBFileName)
+    + ";" + fCalibDBFileName + ":" + FileChecksum(fCalibDBFileName + ".db")
+    ;
+  
+} // icarusDB::ChannelMapSQLite::CacheKey()
+
+
+// -----------------------------------------------------------------------------
+std::string const& icarusDB::ChannelMapSQLite::FileChecksum
+  (std::string const& fileName) const
+{
+  if (auto const it = fFileChecksums.find(fileName); it != fFileChecksums.end())
+    return it->second;
+  
+  std::string fullFileName;
+  cet::search_path searchPath("FW_SEARCH_PATH");
+  if (!searchPath.find_file(fileName, fullFileName)) {
+    throw cet::exception{ "ChannelMapSQLite" }
+      << "FileChecksum(): can't find input file: '" << fileName << "'\n";
+  }
+  
+  std::ifstream file{ fullFileName, std::ios::binary };
+  std::string buffer(1 << 20, '\0');
+  std::uint64_t checksum = ChannelMapCacheFile::HashSeed;
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    checksum = ChannelMapCacheFile::hash
+      ({ buffer.data(), static_cast<std::size_t>(file.gcount()) }, checksum);
+  }
+  
+  std::ostringstream sstr;
+  sstr << std::hex << checksum;
+  mfLogDebug() << "Checksum of '" << fullFileName << "': " << sstr.str();
+  return fFileChecksums[fileName] = sstr.str();
+  
+} // icarusDB::ChannelMapSQLite::FileChecksum()
+
+
 // -----------------------------------------------------------------------------
 int icarusDB::ChannelMapSQLite::GetDataset
   (std::string const& table, SQLiteCallbackFunc_t func, void* data) const
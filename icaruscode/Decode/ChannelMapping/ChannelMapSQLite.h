@@ -17,6 +17,7 @@
 #include "fhiclcpp/types/Atom.h"
 
 // C++ standard libraries
+#include <map>
 #include <set>
 #include <string>
 
@@ -87,6 +88,15 @@ class icarusDB::ChannelMapSQLite
    */
   virtual bool SelectPeriod(RunPeriod period) override;
   
+  /**
+   * @brief Returns a key describing the content served for the current period.
+   * 
+   * The key includes the database tag, the tables of the current period and
+   * a checksum of the content of both database files, so that the key
+   * changes whenever any of them is updated.
+   */
+  virtual std::string CacheKey() const override;
+  
   
   /// Fill mapping between TPC Fragment IDs and the related crate and readout
   /// information.
@@ -147,6 +157,13 @@ class icarusDB::ChannelMapSQLite
 
   /// The set of tables being served. Chosen by `SelectRun()`.
   TableNames_t const* fCurrentTable = nullptr;
+  
+  /// Checksums of the database files, by file name (filled on demand).
+  mutable std::map<std::string, std::string> fFileChecksums;
+  
+  /// Returns a checksum of the content of the file `fileName` (searched in
+  /// `FW_SEARCH_PATH`).
+  std::string const& FileChecksum(std::string const& fileName) const;
 
   /**
    * @brief Reads a full `table` from the database and process data with `func`.
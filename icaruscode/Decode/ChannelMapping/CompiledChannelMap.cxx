@@ -0,0 +1,128 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/CompiledChannelMap.cxx
+ * @brief  Flat, array-indexed snapshot of the TPC and PMT channel mapping.
+ * @date   October 16, 2026
+ * @see    icaruscode/Decode/ChannelMapping/CompiledChannelMap.h
+ */
+
+// library header
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::lower_bound(), std::max()
+#include <utility> // std::move()
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+// --- icarusDB::details::DenseIDIndex
+// -----------------------------------------------------------------------------
+icarusDB::details::DenseIDIndex::DenseIDIndex(std::vector<unsigned int> IDs)
+  : fSize{ IDs.size() }
+{
+  assert(std::is_sorted(IDs.begin(), IDs.end()));
+  if (IDs.empty()) return;
+
+  fMinID = IDs.front();
+  std::size_t const span = std::size_t{ IDs.back() } - fMinID + 1;
+  if (span > MaxDenseSpan) { // too sparse: keep the sorted list
+    fIDs = std::move(IDs);
+    return;
+  }
+
+  fTable.assign(span, NoIndex);
+  for (std::size_t i = 0; i < IDs.size(); ++i) fTable[IDs[i] - fMinID] = i;
+
+} // icarusDB::details::DenseIDIndex::DenseIDIndex()
+
+
+// -----------------------------------------------------------------------------
+std::size_t icarusDB::details::DenseIDIndex::findSorted(unsigned int ID) const
+{
+  auto const it = std::lower_bound(fIDs.begin(), fIDs.end(), ID);
+  return ((it == fIDs.end()) || (*it != ID))? NoIndex: (it - fIDs.begin());
+} // icarusDB::details::DenseIDIndex::findSorted()
+
+
+// -----------------------------------------------------------------------------
+// --- icarusDB::CompiledChannelMap
+// -----------------------------------------------------------------------------
+icarusDB::CompiledChannelMap::CompiledChannelMap(
+  TPCFragmentIDToReadoutIDMap const& TPCfragments,
+  TPCReadoutBoardToChannelMap const& TPCboards,
+  PMTFragmentToDigitizerChannelMap const& PMTfragments,
+  CacheID_t cacheID
+)
+  : fCacheID{ cacheID }
+{
+
+  // maps are sorted by key, which is what the indices need
+
+  //
+  // TPC readout boards
+  //
+  std::vector<unsigned int> boardIDs;
+  boardIDs.reserve(TPCboards.size());
+  fTPCboards.reserve(TPCboards.size());
+  for (auto const& [ boardID, slotAndChannels ]: TPCboards) {
+    boardIDs.push_back(boardID);
+    fTPCboards.push_back
+      ({ slotAndChannels.first, slotAndChannels.second });
+  }
+  fTPCboardIndex = details::DenseIDIndex{ std::move(boardIDs) };
+
+  //
+  // TPC fragments, with their boards in slot order
+  //
+  std::vector<unsigned int> fragmentIDs;
+  fragmentIDs.reserve(TPCfragments.size());
+  fTPCfragments.reserve(TPCfragments.size());
+  for (auto const& [ fragmentID, crateAndBoards ]: TPCfragments) {
+    fragmentIDs.push_back(fragmentID);
+
+    ReadoutIDVec const& readoutIDs = crateAndBoards.second;
+    ReadoutIDVec slotOrder(readoutIDs.size());
+    for (unsigned int const boardID: readoutIDs) {
+      TPCBoardInfo_t const* board = findTPCboard(boardID);
+      if (!board || (board->slot >= slotOrder.size())) {
+        slotOrder.clear(); // incomplete: users need to go the long way
+        break;
+      }
+      slotOrder[board->slot] = boardID;
+    } // for boards
+
+    fTPCfragments.push_back
+      ({ crateAndBoards.first, readoutIDs, std::move(slotOrder) });
+  } // for fragments
+  fTPCfragmentIndex = details::DenseIDIndex{ std::move(fragmentIDs) };
+
+  //
+  // PMT fragments, with an index of their digitizer channels
+  //
+  std::vector<unsigned int> PMTkeys;
+  PMTkeys.reserve(PMTfragments.size());
+  fPMTfragments.reserve(PMTfragments.size());
+  for (auto const& [ key, channels ]: PMTfragments) {
+    PMTkeys.push_back(key);
+
+    PMTFragmentInfo_t info{ channels, {} };
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+      unsigned int const channelNo = channels[i].digitizerChannelNo;
+      if (channelNo >= details::DenseIDIndex::MaxDenseSpan) continue;
+      if (channelNo >= info.byDigitizerChannel.size()) {
+        info.byDigitizerChannel.resize
+          (channelNo + 1, details::DenseIDIndex::NoIndex);
+      }
+      // the first record wins, like in a linear search
+      if (info.byDigitizerChannel[channelNo] == details::DenseIDIndex::NoIndex)
+        info.byDigitizerChannel[channelNo] = i;
+    } // for channels
+
+    fPMTfragments.push_back(std::move(info));
+  } // for PMT fragments
+  fPMTfragmentIndex = details::DenseIDIndex{ std::move(PMTkeys) };
+
+} // icarusDB::CompiledChannelMap::CompiledChannelMap()
+
+
+// -----------------------------------------------------------------------------
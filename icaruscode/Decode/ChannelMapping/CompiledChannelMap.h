@@ -0,0 +1,246 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/CompiledChannelMap.h
+ * @brief  Flat, array-indexed snapshot of the TPC and PMT channel mapping.
+ * @date   October 16, 2026
+ * @see    icaruscode/Decode/ChannelMapping/CompiledChannelMap.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_COMPILEDCHANNELMAP_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_COMPILEDCHANNELMAP_H
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapDataTypes.h"
+#include "icaruscode/Utilities/CacheCounter.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarusDB {
+  class CompiledChannelMap;
+  namespace details { class DenseIDIndex; }
+}
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Index from sparse integral IDs to positions in a dense array.
+ *
+ * When the IDs span a range smaller than `MaxDenseSpan`, the lookup is a
+ * single array access; otherwise it falls back to a binary search on the
+ * sorted IDs.
+ */
+class icarusDB::details::DenseIDIndex {
+
+    public:
+
+  /// Value returned by `find()` for IDs not in the index.
+  static constexpr std::size_t NoIndex = ~std::size_t{ 0 };
+
+  /// Largest ID range indexed with a direct lookup table.
+  static constexpr std::size_t MaxDenseSpan = 1U << 16;
+
+  /// Constructor: an empty index.
+  DenseIDIndex() = default;
+
+  /// Constructor: indexes the `IDs`, which must be sorted and unique.
+  explicit DenseIDIndex(std::vector<unsigned int> IDs);
+
+  /// Returns the position of `ID` in the indexed list, `NoIndex` if missing.
+  std::size_t find(unsigned int ID) const
+    {
+      if (!fIDs.empty()) return findSorted(ID);
+      if (ID < fMinID) return NoIndex;
+      std::size_t const offset = ID - fMinID;
+      return (offset < fTable.size())? fTable[offset]: NoIndex;
+    }
+
+  /// Returns the number of indexed IDs.
+  std::size_t size() const { return fSize; }
+
+    private:
+
+  unsigned int fMinID = 0; ///< Smallest indexed ID.
+
+  std::size_t fSize = 0; ///< Number of indexed IDs.
+
+  std::vector<std::size_t> fTable; ///< Positions, by `ID - fMinID`.
+
+  std::vector<unsigned int> fIDs; ///< Sorted IDs, only if too sparse.
+
+  /// Binary search fallback for sparse IDs.
+  std::size_t findSorted(unsigned int ID) const;
+
+}; // icarusDB::details::DenseIDIndex
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Immutable, array-indexed copy of the TPC and PMT channel mapping.
+ *
+ * The channel mapping providers cache the database content in associative
+ * containers (`std::map`), which are convenient to build but require a tree
+ * walk on each query. Decoders run those queries for every board and channel
+ * of every event, from many threads.
+ *
+ * This object is built once per run period from the provider caches (see
+ * `ICARUSChannelMapProviderBase::compiledMap()`) and stores the same
+ * information in contiguous arrays indexed by the (offset) IDs.
+ * It is never modified after construction, and the provider hands it over via
+ * `std::shared_ptr`, so users can keep it and query it without locking even
+ * while the provider moves to a new period.
+ *
+ * All queries return pointers, which are `nullptr` if the requested ID is not
+ * known; no exception is thrown.
+ *
+ * PMT fragments are looked up by their fragment ID, which is converted to the
+ * database key as `ICARUSChannelMapProviderBase::PMTfragmentIDtoDBkey()` does.
+ */
+class icarusDB::CompiledChannelMap {
+
+    public:
+
+  using CacheID_t = util::CacheCounter::CacheID_t; ///< Type of cache ID.
+
+  /// Information of a TPC fragment (that is, of a readout crate).
+  struct TPCFragmentInfo_t {
+    std::string crateName; ///< Name of the crate.
+    ReadoutIDVec readoutIDs; ///< IDs of the boards, in database order.
+    /// IDs of the boards in slot order; empty if any board is not in the map.
+    ReadoutIDVec boardsInSlotOrder;
+  }; // TPCFragmentInfo_t
+
+  /// Information of a TPC readout board.
+  struct TPCBoardInfo_t {
+    unsigned int slot; ///< Slot number in the crate.
+    ChannelPlanePairVec channelPlanePairs; ///< Channel and plane of each input.
+  }; // TPCBoardInfo_t
+
+
+  /// Constructor: compiles the specified maps, tagged with `cacheID`.
+  CompiledChannelMap(
+    TPCFragmentIDToReadoutIDMap const& TPCfragments,
+    TPCReadoutBoardToChannelMap const& TPCboards,
+    PMTFragmentToDigitizerChannelMap const& PMTfragments,
+    CacheID_t cacheID
+    );
+
+
+  /// Returns the cache ID of the provider caches this map was compiled from.
+  CacheID_t cacheID() const { return fCacheID; }
+
+
+  // --- BEGIN --- TPC information ---------------------------------------------
+
+  /// Returns the information of the TPC `fragmentID` (`nullptr` if unknown).
+  TPCFragmentInfo_t const* findTPCfragment(unsigned int fragmentID) const
+    { return findIn(fTPCfragments, fTPCfragmentIndex, fragmentID); }
+
+  /// Returns the IDs of the boards of `fragmentID` in slot order, `nullptr` if
+  /// the fragment is unknown or any of its boards is.
+  ReadoutIDVec const* boardsInSlotOrder(unsigned int fragmentID) const;
+
+  /// Returns the information of the TPC board `boardID` (`nullptr` if unknown).
+  TPCBoardInfo_t const* findTPCboard(unsigned int boardID) const
+    { return findIn(fTPCboards, fTPCboardIndex, boardID); }
+
+  /// Returns the channels of the TPC board `boardID` (`nullptr` if unknown).
+  ChannelPlanePairVec const* findChannelPlanePairs(unsigned int boardID) const
+    {
+      TPCBoardInfo_t const* info = findTPCboard(boardID);
+      return info? &(info->channelPlanePairs): nullptr;
+    }
+
+  // --- END ----- TPC information ---------------------------------------------
+
+
+  // --- BEGIN --- PMT information ---------------------------------------------
+
+  /// Returns all the channels of the PMT `fragmentID` (`nullptr` if unknown).
+  PMTdigitizerInfoVec const* findPMTfragment(unsigned int fragmentID) const
+    {
+      std::size_t const index = fPMTfragmentIndex.find(PMTkey(fragmentID));
+      return (index == details::DenseIDIndex::NoIndex)
+        ? nullptr: &(fPMTfragments[index].channels);
+    }
+
+  /// Returns the information of the channel `digitizerChannel` of the PMT
+  /// `fragmentID`, `nullptr` if not known.
+  PMTChannelInfo_t const* findPMTchannel
+    (unsigned int fragmentID, unsigned int digitizerChannel) const;
+
+  // --- END ----- PMT information ---------------------------------------------
+
+
+    private:
+
+  /// All the information of a PMT fragment.
+  struct PMTFragmentInfo_t {
+    PMTdigitizerInfoVec channels; ///< Channel records in database order.
+    /// Position in `channels` of each digitizer channel number.
+    std::vector<std::size_t> byDigitizerChannel;
+  }; // PMTFragmentInfo_t
+
+  CacheID_t fCacheID; ///< ID of the provider caches this map comes from.
+
+  std::vector<TPCFragmentInfo_t> fTPCfragments; ///< Per TPC fragment.
+  details::DenseIDIndex fTPCfragmentIndex; ///< TPC fragment ID index.
+
+  std::vector<TPCBoardInfo_t> fTPCboards; ///< Per TPC readout board.
+  details::DenseIDIndex fTPCboardIndex; ///< TPC board ID index.
+
+  std::vector<PMTFragmentInfo_t> fPMTfragments; ///< Per PMT fragment.
+  details::DenseIDIndex fPMTfragmentIndex; ///< PMT database key index.
+
+
+  /// Returns the PMT database key of the specified fragment.
+  static constexpr unsigned int PMTkey(unsigned int fragmentID)
+    { return fragmentID & 0xFF; }
+
+  /// Returns a pointer to the element of `data` with the specified `ID`.
+  template <typename T>
+  static T const* findIn(
+    std::vector<T> const& data, details::DenseIDIndex const& index,
+    unsigned int ID
+    )
+    {
+      std::size_t const i = index.find(ID);
+      return (i == details::DenseIDIndex::NoIndex)? nullptr: &(data[i]);
+    }
+
+}; // icarusDB::CompiledChannelMap
+
+
+// -----------------------------------------------------------------------------
+// ---  inline implementation
+// -----------------------------------------------------------------------------
+inline auto icarusDB::CompiledChannelMap::boardsInSlotOrder
+  (unsigned int fragmentID) const -> ReadoutIDVec const*
+{
+  TPCFragmentInfo_t const* info = findTPCfragment(fragmentID);
+  return (info && !info->boardsInSlotOrder.empty())
+    ? &(info->boardsInSlotOrder): nullptr;
+} // icarusDB::CompiledChannelMap::boardsInSlotOrder()
+
+
+// -----------------------------------------------------------------------------
+inline auto icarusDB::CompiledChannelMap::findPMTchannel
+  (unsigned int fragmentID, unsigned int digitizerChannel) const
+  -> PMTChannelInfo_t const*
+{
+  std::size_t const index = fPMTfragmentIndex.find(PMTkey(fragmentID));
+  if (index == details::DenseIDIndex::NoIndex) return nullptr;
+  PMTFragmentInfo_t const& info = fPMTfragments[index];
+  if (digitizerChannel >= info.byDigitizerChannel.size()) return nullptr;
+  std::size_t const iChannel = info.byDigitizerChannel[digitizerChannel];
+  return (iChannel == details::DenseIDIndex::NoIndex)
+    ? nullptr: &(info.channels[iChannel]);
+} // icarusDB::CompiledChannelMap::findPMTchannel()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_COMPILEDCHANNELMAP_H
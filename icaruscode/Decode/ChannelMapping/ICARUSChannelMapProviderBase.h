@@ -9,6 +9,8 @@
 
 // ICARUS libraries
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMapProvider.h"
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h"
 #include "icarusalg/Utilities/mfLoggingClass.h"
 
 // framework libraries
@@ -19,7 +21,7 @@
 
 // C/C++ standard libraries
 #include <string>
-#include <memory> // std::unique_ptr<>
+#include <memory> // std::unique_ptr<>, std::shared_ptr<>
 
 
 // -----------------------------------------------------------------------------
@@ -45,6 +47,16 @@ namespace icarusDB {
  * At the moment of writing, the three caches are actually updated all at the
  * same times.
  * 
+ * The content read from the database can also be saved into a binary file in
+ * the directory specified by the `CacheDirectory` configuration parameter
+ * (see `icarusDB::ChannelMapCacheFile`); jobs finding a file for the same
+ * period and database content (as told by the `CacheKey()` of the database
+ * backend) load it instead of querying the database.
+ * 
+ * Each time the caches are updated, a flat snapshot of the TPC and PMT mapping
+ * (`icarusDB::CompiledChannelMap`) is also compiled from them and made
+ * available via `compiledMap()`.
+ * 
  * 
  * Configuration parameters
  * =========================
@@ -56,6 +68,10 @@ namespace icarusDB {
  * * `LogCategory` (string, default: same as `ChannelMappingTool.LogCategory`):
  *     name of the messagefacility category used to send messages to console,
  *     useful for filtering messages.
+ * * `CacheDirectory` (string, default: empty): directory where to read and
+ *     write the binary cache of the database content; if empty, the database
+ *     is always queried. Backends which can't describe their content with a
+ *     key (`CacheKey()` empty, like PostgreSQL) are always queried too.
  * 
  * 
  * Implementation details
@@ -109,6 +125,12 @@ class icarusDB::ICARUSChannelMapProviderBase
       Comment{ "name of the console stream to send messages to" }
       };
     
+    fhicl::Atom<std::string> CacheDirectory{
+      Name{ "CacheDirectory" },
+      Comment{ "directory of the binary cache of the database (empty: none)" },
+      "" // default
+      };
+    
   }; // Config
   
   using Parameters = fhicl::Table<Config>;
@@ -235,7 +257,12 @@ class icarusDB::ICARUSChannelMapProviderBase
   
   /// @}
   /// --- END ----- CRT information --------------------------------------------
-
+  
+  /// Returns the flat snapshot of the TPC and PMT mapping of the current period.
+  virtual std::shared_ptr<CompiledChannelMap const> compiledMap() const
+    override
+    { return fCompiledMap; }
+  
   /// Returns the channel mapping database key for the specified PMT fragment ID.
   static constexpr unsigned int PMTfragmentIDtoDBkey(unsigned int fragmentID);
   
@@ -252,6 +279,8 @@ class icarusDB::ICARUSChannelMapProviderBase
   
   std::string const fLogCategory;
   
+  std::string const fCacheDirectory; ///< Where to keep the binary cache.
+  
   // --- END ----- Configuration parameters ------------------------------------
   
   
@@ -274,11 +303,24 @@ class icarusDB::ICARUSChannelMapProviderBase
 
   icarusDB::SideCRTChannelToCalibrationMap fSideCRTChannelToCalibrationMap;
   
+  /// Snapshot of the TPC and PMT caches above.
+  std::shared_ptr<CompiledChannelMap const> fCompiledMap;
+  
   // --- END ----- Cache -------------------------------------------------------
   
 
+  /// Fills the mapping caches for `period`, from the binary cache file if
+  /// available, from the database otherwise.
+  void readFromDatabase(RunPeriod period);
+  
   /// Has the channel mapping tool fill the mapping caches.
-  void readFromDatabase();
+  void readFromBackend();
+  
+  /// Returns the binary cache file for `period` with the specified `key`.
+  ChannelMapCacheFile cacheFile(RunPeriod period, std::string const& key) const;
+  
+  /// Returns the description of all the mapping caches, for the binary cache.
+  ChannelMapCacheFile::Content cacheContent();
   
   /// Returns the list of records of all channels in the PMT readout board with
   /// the specified fragment.
@@ -16,6 +16,8 @@
 #include "cetlib/cpu_timer.h"
 
 // C++ standard libraries
+#include <filesystem>
+#include <sstream>
 #include <string>
 #include <cassert>
 
@@ -27,6 +29,7 @@ icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::ICARUSChannelMapProviderBase
   : icarus::ns::util::mfLoggingClass
     { config.LogCategory().value_or(config.ChannelMappingTool().LogCategory()) }
   , fDiagnosticOutput  { config.DiagnosticOutput() }
+  , fCacheDirectory    { config.CacheDirectory() }
   , fChannelMappingAlg { config.ChannelMappingTool() }
 {
   addCacheTags({ "TPC", "PMT", "CRT" }); // all caches updated at the same time
@@ -65,7 +68,7 @@ bool icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::forPeriod
   // if cache is not invalidated, we don't refresh it
   if (!fChannelMappingAlg.SelectPeriod(period)) return false;
   
-  readFromDatabase();
+  readFromDatabase(period);
   return true;
 }
 
@@ -262,10 +265,54 @@ auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::findPMTfragmentEntry
 
 // -----------------------------------------------------------------------------
 template <typename ChMapAlg>
-void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
+void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase
+  (RunPeriod period)
+{
+  // the old snapshot must not survive a failure to read the new caches
+  fCompiledMap.reset();
+  
+  std::string const cacheKey
+    = fCacheDirectory.empty()? std::string{}: fChannelMappingAlg.CacheKey();
+  
+  if (cacheKey.empty()) readFromBackend();
+  else {
+    ChannelMapCacheFile const file = cacheFile(period, cacheKey);
+    ChannelMapCacheFile::Content content = cacheContent();
+    if (file.read(cacheKey, content)) {
+      mfLogInfo() << "Channel mapping loaded from '" << file.path() << "'";
+      updateCacheID(); // all caches
+    }
+    else {
+      readFromBackend();
+      try {
+        std::filesystem::create_directories(fCacheDirectory);
+        file.write(cacheKey, content);
+        mfLogInfo() << "Channel mapping saved into '" << file.path() << "'";
+      }
+      catch (std::exception const& e) {
+        // not being able to write the cache is not fatal
+        mfLogWarning() << "Failed to save the channel mapping into '"
+          << file.path() << "': " << e.what();
+      }
+    }
+  }
+  
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // flat snapshot for the decoders
+  fCompiledMap = std::make_shared<CompiledChannelMap const>(
+    fTPCFragmentToReadoutMap, fTPCReadoutBoardToChannelMap,
+    fPMTFragmentToDigitizerMap, cacheID("")
+    );
+  
+} // icarusDB::ICARUSChannelMapProviderBase<>::readFromDatabase()
 
-  mfLogInfo() << "Building the channel mapping";
 
+// -----------------------------------------------------------------------------
+template <typename ChMapAlg>
+void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromBackend() {
+
+  mfLogInfo() << "Building the channel mapping";
+  
   updateCacheID("TPC");
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -401,7 +448,38 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   
-} // icarusDB::ICARUSChannelMapProviderBase<>::readFromDatabase()
+} // icarusDB::ICARUSChannelMapProviderBase<>::readFromBackend()
+
+
+// -----------------------------------------------------------------------------
+template <typename ChMapAlg>
+auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::cacheFile
+  (RunPeriod period, std::string const& key) const -> ChannelMapCacheFile
+{
+  // the key is also stored in the file and checked on read, so that hash
+  // collisions are harmless
+  std::ostringstream fileName;
+  fileName << "ICARUSChannelMap_period" << static_cast<unsigned int>(period)
+    << "_" << std::hex << ChannelMapCacheFile::hash(key) << ".bin";
+  return ChannelMapCacheFile
+    { (std::filesystem::path{ fCacheDirectory } / fileName.str()).string() };
+} // icarusDB::ICARUSChannelMapProviderBase<>::cacheFile()
+
+
+// -----------------------------------------------------------------------------
+template <typename ChMapAlg>
+auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::cacheContent()
+  -> ChannelMapCacheFile::Content
+{
+  return {
+      fTPCFragmentToReadoutMap
+    , fTPCReadoutBoardToChannelMap
+    , fPMTFragmentToDigitizerMap
+    , fCRTChannelIDToHWtoSimMacAddressPairMap
+    , fTopCRTHWtoSimMacAddressPairMap
+    , fSideCRTChannelToCalibrationMap
+    };
+} // icarusDB::ICARUSChannelMapProviderBase<>::cacheContent()
 
 
 // -----------------------------------------------------------------------------
@@ -53,6 +53,18 @@ class icarusDB::IChannelMapping {
    */
   virtual bool SelectPeriod(icarusDB::RunPeriod period) = 0;
   
+  /**
+   * @brief Returns a key describing the content served for the current period.
+   * @return the key, or an empty string if the content should not be cached
+   * 
+   * Two calls returning the same key must guarantee that all the `Build...()`
+   * methods fill the same content. Service providers use this key to tag the
+   * persistent caches of the database content
+   * (`icarusDB::ChannelMapCacheFile`).
+   * By default, caching is not supported.
+   */
+  virtual std::string CacheKey() const { return {}; }
+  
   
   // --- BEGIN --- TPC mapping -------------------------------------------------
   /// @name TPC mapping.
@@ -13,6 +13,7 @@
 #include "icaruscode/Utilities/CacheCounter.h"
 
 // C/C++ standard libraries
+#include <memory> // std::shared_ptr
 #include <vector>
 #include <map>
 #include <string>
@@ -22,7 +23,10 @@
 
 // -----------------------------------------------------------------------------
 
-namespace icarusDB { class IICARUSChannelMapProvider; }
+namespace icarusDB {
+  class IICARUSChannelMapProvider;
+  class CompiledChannelMap;
+}
 /**
  * @brief Interface of ICARUS channel mapping service provider.
  * 
@@ -162,7 +166,22 @@ class icarusDB::IICARUSChannelMapProvider: public util::CacheCounter {
   
   /// @}
   /// --- END ----- CRT information --------------------------------------------
-
+  
+  
+  /**
+   * @brief Returns a flat snapshot of the TPC and PMT mapping of this period.
+   * @return the snapshot, or `nullptr` if not supported
+   * @see `icarusDB::CompiledChannelMap`
+   * 
+   * The snapshot is immutable and users may keep it for as long as they want,
+   * and query it without locking; its `cacheID()` tells which version of the
+   * provider caches it was built from.
+   * Implementations are not required to support it, and by default they do
+   * not: users should fall back to the other methods of this interface.
+   */
+  virtual std::shared_ptr<CompiledChannelMap const> compiledMap() const
+    { return nullptr; }
+  
 }; // icarusDB::IICARUSChannelMapProvider
 
 
@@ -13,6 +13,7 @@
 #include "icaruscode/Decode/DecoderTools/details/PMTDecoderUtils.h"
 #include "icaruscode/Decode/DecoderTools/Dumpers/FragmentDumper.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
 #include "icaruscode/IcarusObj/PMTWaveformTimeCorrection.h"
 #include "icaruscode/Timing/PMTWaveformTimeCorrectionExtractor.h"
 #include "icaruscode/Timing/IPMTTimingCorrectionService.h"
@@ -66,6 +67,9 @@
 #include "fhiclcpp/types/Atom.h"
 #include "cetlib_except/exception.h"
 
+// TBB
+#include "tbb/parallel_for.h"
+
 // ROOT libraries
 #include "TTree.h"
 
@@ -213,6 +217,10 @@ namespace icarus { class DaqDecoderICARUSPMT; }
  *     the framework will be asked to remove the PMT data fragment from memory.
  *     Set this to `false` in the unlikely case where raw PMT fragments are
  *     still needed after decoding.
+ * * `ParallelBoardDecoding` (flag, default: `true`): decodes the fragments of
+ *     different readout boards concurrently (with TBB). The results are merged
+ *     in the order of the input fragments, so the output does not depend on
+ *     this setting; only the order of the console messages does.
  * * `LogCategory` (string, default: `DaqDecoderICARUSPMT`): name of the message
  *     facility category where the output is sent.
  * 
@@ -739,6 +747,12 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
       true // default
       };
     
+    fhicl::Atom<bool> ParallelBoardDecoding {
+      Name("ParallelBoardDecoding"),
+      Comment("decode the fragments of different boards concurrently"),
+      true // default
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category for message stream"),
@@ -787,6 +801,56 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
     std::uint16_t const* data = nullptr;
   }; // FragmentInfo_t
   
+  /**
+   * @brief Non-owning view of a single V1730 fragment.
+   * 
+   * The view points into the memory of the input data product, which must
+   * stay available until the decoding of the event is complete. It describes
+   * either a whole `artdaq::Fragment` or one of the entries of a container
+   * fragment, without copying either.
+   * The only exception are container entries serialized with an older
+   * version of the fragment header: those are copied (and upgraded) into
+   * `copy`, which the view then points into.
+   */
+  struct FragmentView_t {
+    
+    /// Value of `containerIndex` for fragments not in a container.
+    static constexpr std::size_t NotInContainer
+      = std::numeric_limits<std::size_t>::max();
+    
+    artdaq::Fragment::fragment_id_t fragmentID;
+    artdaq::Fragment::timestamp_t timestamp;
+    artdaq::Fragment::type_t type;
+    
+    /// Start of the fragment metadata (`nullptr` if none).
+    artdaq::RawDataType const* metadata = nullptr;
+    
+    artdaq::Fragment::byte_t const* dataBegin = nullptr; ///< Payload start.
+    std::size_t dataSize = 0U; ///< Size of the payload [bytes].
+    
+    /// The input fragment this view points into (may be a container).
+    artdaq::Fragment const* source = nullptr;
+    
+    /// Index of this fragment in the `source` container.
+    std::size_t containerIndex = NotInContainer;
+    
+    /// Owned copy of the fragment, only for entries not viewable in place.
+    std::shared_ptr<artdaq::Fragment const> copy;
+    
+    /// Returns whether this fragment is an entry of a container fragment.
+    bool inContainer() const { return containerIndex != NotInContainer; }
+    
+    /// Returns the metadata interpreted as a `Meta` object.
+    template <typename Meta>
+    Meta const* metadataAs() const
+      { return reinterpret_cast<Meta const*>(metadata); }
+    
+  }; // FragmentView_t
+  
+  /// Views of all the fragments of a board.
+  using FragmentViews_t = std::vector<FragmentView_t>;
+  
+  
   /// Information used in decoding from a board.
   struct NeededBoardInfo_t {
     static AllChannelSetup_t const DefaultChannelSetup; // default-initialized
@@ -847,6 +911,19 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
       { return waveform < than.waveform; }
     
   }; // struct ProtoWaveform_t
+  
+  /// Information for the fragment tree: fragment and waveform timestamp.
+  using FragmentTreeEntry_t = std::pair<FragmentInfo_t, electronics_time>;
+  
+  /// Result of the decoding of all the fragments of a single board.
+  struct BoardDecodingResult_t {
+    
+    std::vector<ProtoWaveform_t> waveforms; ///< Decoded (merged) waveforms.
+    
+    /// Entries for the fragment tree, filled later in input order.
+    std::vector<FragmentTreeEntry_t> treeEntries;
+    
+  }; // struct BoardDecodingResult_t
 
   /// Type of map: category to collection of waveforms under that category.
   using WaveformsByCategory_t
@@ -896,6 +973,9 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   /// Clear fragment data product cache after use.
   bool const fDropRawDataAfterUse;
   
+  /// Decode fragments from different boards concurrently.
+  bool const fParallelBoardDecoding;
+  
   std::string const fLogCategory; ///< Message facility category.
   
   // --- END ---- Configuration parameters -------------------------------------
@@ -1153,27 +1233,48 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   /// Reads the fragments to be processed.
   artdaq::Fragments const& readInputFragments(art::Event const& event) const;
   
-  /// Throws an exception if `artdaqFragment` is not of type `CAEN1730`.
-  void checkFragmentType(artdaq::Fragment const& artdaqFragment) const;
+  /// Throws an exception if `fragment` is not of type `CAEN1730`.
+  void checkFragmentType(FragmentView_t const& fragment) const;
   
-  /// Converts a fragment into a fragment collection
+  /// Converts a fragment into a collection of fragment views
   /// (dispatcher based on fragment type).
-  artdaq::FragmentPtrs makeFragmentCollection
+  FragmentViews_t makeFragmentCollection
     (artdaq::Fragment const& sourceFragment) const;
 
-  /// Converts a plain fragment into a fragment collection.
-  artdaq::FragmentPtrs makeFragmentCollectionFromFragment
+  /// Converts a plain fragment into a collection of fragment views.
+  FragmentViews_t makeFragmentCollectionFromFragment
     (artdaq::Fragment const& sourceFragment) const;
 
-  /// Converts a container fragment into a fragment collection.
-  artdaq::FragmentPtrs makeFragmentCollectionFromContainerFragment
+  /// Converts a container fragment into a collection of fragment views.
+  FragmentViews_t makeFragmentCollectionFromContainerFragment
     (artdaq::Fragment const& sourceFragment) const;
+  
+  /// Returns a view of the whole `fragment`.
+  static FragmentView_t makeFragmentView(artdaq::Fragment const& fragment);
+  
+  /**
+   * @brief Returns a view of the serialized fragment at `fragmentBegin`.
+   * @param fragmentBegin start of the serialized fragment (header first)
+   * @param fragmentSize bytes available to the serialized fragment
+   * @return a view of the fragment, pointing into the serialized data
+   * @throw cet::exception if the header is not of the current version, or
+   *                       its sizes are not consistent with `fragmentSize`
+   */
+  static FragmentView_t makeFragmentView(
+    artdaq::Fragment::byte_t const* fragmentBegin, std::size_t fragmentSize
+    );
 
-  /// Extracts waveforms from the specified fragments from a board.
-  std::vector<ProtoWaveform_t> processBoardFragments(
-    artdaq::FragmentPtrs const& artdaqFragment,
+  /**
+   * @brief Extracts waveforms from the specified fragments from a board.
+   * 
+   * This method does not change the state of the module, and it can be called
+   * concurrently for different boards. The information for the data trees is
+   * returned rather than filled.
+   */
+  BoardDecodingResult_t processBoardFragments(
+    FragmentViews_t const& fragments,
     TriggerInfo_t const& triggerInfo
-    );
+    ) const;
   
   // --- END ---- Input data management ----------------------------------------
   
@@ -1287,20 +1388,21 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   
   /**
    * @brief Create waveforms and fills trees for the specified artDAQ fragment.
-   * @param artdaqFragment the fragment to process
+   * @param fragment the fragment to process
    * @param boardInfo board information needed, from configuration/setup
    * @param triggerTime absolute time of the trigger
-   * @return collection of PMT waveforms from the fragment
+   * @param[out] result where to add waveforms and fragment tree information
    * 
-   * This method fills the information for the PMT fragment tree
-   * (`fillPMTfragmentTree()`) and creates PMT waveforms from the fragment data
-   * (`createFragmentWaveforms()`).
+   * This method collects the information for the PMT fragment tree
+   * (to be filled with `fillPMTfragmentTree()`) and creates PMT waveforms
+   * from the fragment data (`createFragmentWaveforms()`).
    */
-  std::vector<ProtoWaveform_t> processFragment(
-    artdaq::Fragment const& artdaqFragment,
+  void processFragment(
+    FragmentView_t const& fragment,
     NeededBoardInfo_t const& boardInfo,
-    TriggerInfo_t const& triggerInfo
-    );
+    TriggerInfo_t const& triggerInfo,
+    BoardDecodingResult_t& result
+    ) const;
 
   
   /**
@@ -1321,12 +1423,14 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
     ) const;
   
   /// Extracts useful information from fragment data.
-  FragmentInfo_t extractFragmentInfo
-    (artdaq::Fragment const& artdaqFragment) const;
+  FragmentInfo_t extractFragmentInfo(FragmentView_t const& fragment) const;
   
   /// Extracts the fragment ID (i.e. board ID) from the specified `fragment`.
   static BoardID_t extractFragmentBoardID(artdaq::Fragment const& fragment);
   
+  /// Extracts the fragment ID (i.e. board ID) from the specified `fragment`.
+  static BoardID_t extractFragmentBoardID(FragmentView_t const& fragment);
+  
   /// Returns the board information for this fragment.
   NeededBoardInfo_t neededBoardInfo
     (artdaq::Fragment::fragment_id_t fragment_id) const;
@@ -1610,6 +1714,7 @@ icarus::DaqDecoderICARUSPMT::DaqDecoderICARUSPMT(Parameters const& params)
       )
     }
   , fDropRawDataAfterUse{ params().DropRawDataAfterUse() }
+  , fParallelBoardDecoding{ params().ParallelBoardDecoding() }
   , fLogCategory{ params().LogCategory() }
   , fDetTimings
     { art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob() }
@@ -1828,10 +1933,12 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
   try { // catch-all
     auto const& fragments = readInputFragments(event);
     
+    // collect the fragments of each board first (this is quick)...
+    std::vector<FragmentViews_t> boardFragments;
+    boardFragments.reserve(fragments.size());
     for (artdaq::Fragment const& fragment: fragments) {
       
-      artdaq::FragmentPtrs const& fragmentCollection
-        = makeFragmentCollection(fragment);
+      FragmentViews_t fragmentCollection = makeFragmentCollection(fragment);
       
       if (empty(fragmentCollection)) {
         mf::LogWarning("DaqDecoderICARUSPMT")
@@ -1841,16 +1948,34 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
       } // if no data
       
       BoardID_t const boardID
-        = extractFragmentBoardID(*(fragmentCollection.front()));
+        = extractFragmentBoardID(fragmentCollection.front());
       if (++boardCounts[boardID] > 1U) duplicateBoards = true;
       
-      appendTo(
-        protoWaveforms,
-        processBoardFragments(fragmentCollection, triggerInfo)
-        );
+      boardFragments.push_back(std::move(fragmentCollection));
       
     } // for all input fragments
     
+    // ... then decode the boards, possibly concurrently
+    // (an exception from any of the boards is rethrown here)
+    std::vector<BoardDecodingResult_t> boardResults(boardFragments.size());
+    auto const decodeBoard = [&](std::size_t iBoard)
+      {
+        boardResults[iBoard]
+          = processBoardFragments(boardFragments[iBoard], triggerInfo);
+      };
+    if (fParallelBoardDecoding)
+      tbb::parallel_for(std::size_t{ 0 }, boardFragments.size(), decodeBoard);
+    else
+      for (std::size_t const iBoard: util::counter(boardFragments.size()))
+        decodeBoard(iBoard);
+    
+    // merge the results in input order, independently of the scheduling
+    for (BoardDecodingResult_t& result: boardResults) {
+      for (auto const& [ fragInfo, timeStamp ]: result.treeEntries)
+        fillPMTfragmentTree(fragInfo, triggerInfo, timeStamp);
+      appendTo(protoWaveforms, std::move(result.waveforms));
+    } // for boards
+    
   }
   catch (cet::exception const& e) {
     if (!fSurviveExceptions) throw;
@@ -2346,8 +2471,8 @@ auto icarus::DaqDecoderICARUSPMT::fetchTriggerTimestamp
 
 
 //------------------------------------------------------------------------------
-artdaq::FragmentPtrs icarus::DaqDecoderICARUSPMT::makeFragmentCollection
-  (artdaq::Fragment const& sourceFragment) const
+auto icarus::DaqDecoderICARUSPMT::makeFragmentCollection
+  (artdaq::Fragment const& sourceFragment) const -> FragmentViews_t
 {
   switch (sourceFragment.type()) {
     case sbndaq::FragmentType::CAENV1730:
@@ -2366,45 +2491,143 @@ artdaq::FragmentPtrs icarus::DaqDecoderICARUSPMT::makeFragmentCollection
 
 
 //------------------------------------------------------------------------------
-artdaq::FragmentPtrs
-icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromFragment
-  (artdaq::Fragment const& sourceFragment) const
+auto icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromFragment
+  (artdaq::Fragment const& sourceFragment) const -> FragmentViews_t
 {
   assert(sourceFragment.type() == sbndaq::FragmentType::CAENV1730);
-  artdaq::FragmentPtrs fragColl;
-  fragColl.push_back(std::make_unique<artdaq::Fragment>(sourceFragment));
-  return fragColl;
+  return { makeFragmentView(sourceFragment) };
 } // icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromFragment()
 
 
 //------------------------------------------------------------------------------
-artdaq::FragmentPtrs
-icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromContainerFragment
-  (artdaq::Fragment const& sourceFragment) const
+auto icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromContainerFragment
+  (artdaq::Fragment const& sourceFragment) const -> FragmentViews_t
 {
   assert(sourceFragment.type() == artdaq::Fragment::ContainerFragmentType);
   artdaq::ContainerFragment const containerFragment{ sourceFragment };
   
   if (containerFragment.block_count() == 0) return {};
+  
+  // the contained fragments are stored whole (header, metadata and payload)
+  // one after the other in the container payload: we just point there,
+  // unless they were serialized with a header layout other than the current
+  // one, in which case they are copied and upgraded by `ContainerFragment`
+  using artdaq::detail::RawFragmentHeader;
+  auto const containerData = static_cast<artdaq::Fragment::byte_t const*>
+    (containerFragment.dataBegin());
+  
+  FragmentViews_t fragColl;
+  fragColl.reserve(containerFragment.block_count());
+  for (auto const iFrag: util::counter(containerFragment.block_count())) {
+    artdaq::Fragment::byte_t const* const fragmentBegin
+      = containerData + containerFragment.fragmentIndex(iFrag);
+    std::size_t const fragmentSize = containerFragment.fragSize(iFrag);
+    
+    bool const currentVersion
+      = (fragmentSize >= sizeof(RawFragmentHeader))
+      && (reinterpret_cast<RawFragmentHeader const*>(fragmentBegin)->version
+        == RawFragmentHeader::CurrentVersion)
+      ;
     
-  artdaq::FragmentPtrs fragColl;
-  for (auto const iFrag: util::counter(containerFragment.block_count()))
-    fragColl.push_back(containerFragment.at(iFrag));
+    FragmentView_t view;
+    if (currentVersion) view = makeFragmentView(fragmentBegin, fragmentSize);
+    else {
+      std::shared_ptr<artdaq::Fragment const> copy
+        = containerFragment.at(iFrag);
+      view = makeFragmentView(*copy);
+      view.copy = std::move(copy);
+    }
+    view.source = &sourceFragment;
+    view.containerIndex = iFrag;
+    fragColl.push_back(std::move(view));
+  } // for
   
   return fragColl;
 } // icarus::DaqDecoderICARUSPMT::makeFragmentCollectionFromContainerFragment()
 
 
+//------------------------------------------------------------------------------
+auto icarus::DaqDecoderICARUSPMT::makeFragmentView
+  (artdaq::Fragment const& fragment) -> FragmentView_t
+{
+  return {
+      fragment.fragmentID()                                       // fragmentID
+    , fragment.timestamp()                                        // timestamp
+    , fragment.type()                                             // type
+    , fragment.hasMetadata()                                      // metadata
+        ? fragment.metadata<artdaq::RawDataType>(): nullptr
+    , fragment.dataBeginBytes()                                   // dataBegin
+    , fragment.dataSizeBytes()                                    // dataSize
+    , &fragment                                                   // source
+    };
+} // icarus::DaqDecoderICARUSPMT::makeFragmentView(Fragment)
+
+
+//------------------------------------------------------------------------------
+auto icarus::DaqDecoderICARUSPMT::makeFragmentView(
+  artdaq::Fragment::byte_t const* fragmentBegin, std::size_t fragmentSize
+) -> FragmentView_t {
+  // this is the layout of a serialized `artdaq::Fragment`
+  using artdaq::detail::RawFragmentHeader;
+  
+  if (fragmentSize < sizeof(RawFragmentHeader)) {
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "Serialized fragment too short (" << fragmentSize
+      << " bytes) for its header (" << sizeof(RawFragmentHeader)
+      << " bytes).\n";
+  }
+  
+  auto const& header
+    = *reinterpret_cast<RawFragmentHeader const*>(fragmentBegin);
+  
+  if (header.version != RawFragmentHeader::CurrentVersion) {
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "Serialized fragment (ID=" << header.fragment_id
+      << ") has header version " << header.version << ", can't view version "
+      << RawFragmentHeader::CurrentVersion << " in place.\n";
+  }
+  
+  std::size_t const headerWords
+    = RawFragmentHeader::num_words() + header.metadata_word_count;
+  if ((header.word_count < headerWords)
+    || (header.word_count * sizeof(artdaq::RawDataType) > fragmentSize)
+  ) {
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "Serialized fragment (ID=" << header.fragment_id
+      << ") has inconsistent size: " << header.word_count
+      << " words, with " << headerWords
+      << " words of header and metadata, in " << fragmentSize
+      << " bytes.\n";
+  }
+  
+  artdaq::RawDataType const* const metadata
+    = reinterpret_cast<artdaq::RawDataType const*>(fragmentBegin)
+    + RawFragmentHeader::num_words();
+  artdaq::RawDataType const* const data
+    = metadata + header.metadata_word_count;
+  std::size_t const dataWords = header.word_count - headerWords;
+  
+  return {
+      header.fragment_id                                          // fragmentID
+    , header.timestamp                                            // timestamp
+    , static_cast<artdaq::Fragment::type_t>(header.type)          // type
+    , (header.metadata_word_count > 0)? metadata: nullptr         // metadata
+    , reinterpret_cast<artdaq::Fragment::byte_t const*>(data)     // dataBegin
+    , dataWords * sizeof(artdaq::RawDataType)                     // dataSize
+    };
+} // icarus::DaqDecoderICARUSPMT::makeFragmentView(byte_t const*)
+
+
 //------------------------------------------------------------------------------
 void icarus::DaqDecoderICARUSPMT::checkFragmentType
-  (artdaq::Fragment const& artdaqFragment) const
+  (FragmentView_t const& fragment) const
 {
-  if (artdaqFragment.type() == sbndaq::FragmentType::CAENV1730) return;
+  if (fragment.type == sbndaq::FragmentType::CAENV1730) return;
   
   throw cet::exception("DaqDecoderICARUSPMT")
     << "Unexpected PMT fragment data type: '"
     << sbndaq::fragmentTypeToString
-      (static_cast<sbndaq::FragmentType>(artdaqFragment.type()))
+      (static_cast<sbndaq::FragmentType>(fragment.type))
     << "'\n";
   
 } // icarus::DaqDecoderICARUSPMT::checkFragmentType
@@ -2412,63 +2635,73 @@ void icarus::DaqDecoderICARUSPMT::checkFragmentType
 
 //------------------------------------------------------------------------------
 auto icarus::DaqDecoderICARUSPMT::processBoardFragments(
-  artdaq::FragmentPtrs const& artdaqFragments,
+  FragmentViews_t const& fragments,
   TriggerInfo_t const& triggerInfo
-) -> std::vector<ProtoWaveform_t> {
+) const -> BoardDecodingResult_t {
   
-  if (artdaqFragments.empty()) return {};
+  if (fragments.empty()) return {};
   
-  artdaq::Fragment const& referenceFragment = *(artdaqFragments.front());
-  assert(&referenceFragment);
+  FragmentView_t const& referenceFragment = fragments.front();
   
   checkFragmentType(referenceFragment);
   
   NeededBoardInfo_t const boardInfo
-    = neededBoardInfo(artdaqFragments.front()->fragmentID());
+    = neededBoardInfo(referenceFragment.fragmentID);
   
   mf::LogTrace(fLogCategory)
-    << " - " << boardInfo.name << ": " << artdaqFragments.size()
+    << " - " << boardInfo.name << ": " << fragments.size()
     << " fragments";
   
-  std::vector<ProtoWaveform_t> waveforms;
-  for (artdaq::FragmentPtr const& fragment: artdaqFragments)
-    appendTo(waveforms, processFragment(*fragment, boardInfo, triggerInfo));
+  BoardDecodingResult_t result;
+  for (FragmentView_t const& fragment: fragments)
+    processFragment(fragment, boardInfo, triggerInfo, result);
   
-  mergeWaveforms(waveforms);
+  mergeWaveforms(result.waveforms);
   
-  return { waveforms };
+  return result;
   
 } // icarus::DaqDecoderICARUSPMT::processBoardFragments()
 
 
 //------------------------------------------------------------------------------
-auto icarus::DaqDecoderICARUSPMT::processFragment(
-  artdaq::Fragment const& artdaqFragment,
+void icarus::DaqDecoderICARUSPMT::processFragment(
+  FragmentView_t const& fragment,
   NeededBoardInfo_t const& boardInfo,
-  TriggerInfo_t const& triggerInfo
-) -> std::vector<ProtoWaveform_t> {
+  TriggerInfo_t const& triggerInfo,
+  BoardDecodingResult_t& result
+) const {
   
-  checkFragmentType(artdaqFragment);
+  checkFragmentType(fragment);
   
   if (fPacketDump) {
+    // the dump needs a whole fragment: entries of containers are copied
+    // (this is a diagnostic option) unless they already were
+    std::shared_ptr<artdaq::Fragment const> fragmentCopy = fragment.copy;
+    if (!fragmentCopy && fragment.inContainer()) {
+      fragmentCopy = artdaq::ContainerFragment{ *fragment.source }
+        .at(fragment.containerIndex);
+    }
     mf::LogVerbatim{ fLogCategory } << "PMT packet:"
       << "\n" << std::string(80, '-')
-      << "\n" << sbndaq::dumpFragment(artdaqFragment)
+      << "\n" << sbndaq::dumpFragment
+        (fragmentCopy? *fragmentCopy: *fragment.source)
       << "\n" << std::string(80, '-')
       ;
   } // if diagnostics
   
-  FragmentInfo_t const fragInfo = extractFragmentInfo(artdaqFragment);
+  FragmentInfo_t const fragInfo = extractFragmentInfo(fragment);
   
   auto const timeStamp
     = fragmentWaveformTimestamp(fragInfo, boardInfo, triggerInfo.time);
     
-  if (fTreeFragment) fillPMTfragmentTree(fragInfo, triggerInfo, timeStamp);
+  if (fTreeFragment) result.treeEntries.emplace_back(fragInfo, timeStamp);
   
-  return (timeStamp != NoTimestamp)
-    ? createFragmentWaveforms(fragInfo, boardInfo.channelSetup(), timeStamp)
-    : std::vector<ProtoWaveform_t>{}
-    ;
+  if (timeStamp == NoTimestamp) return;
+  
+  appendTo(
+    result.waveforms,
+    createFragmentWaveforms(fragInfo, boardInfo.channelSetup(), timeStamp)
+    );
   
 } // icarus::DaqDecoderICARUSPMT::processFragment()
 
@@ -2487,21 +2720,31 @@ auto icarus::DaqDecoderICARUSPMT::createFragmentWaveforms(
   std::optional<mf::LogVerbatim> diagOut;
   if (fDiagnosticOutput) diagOut.emplace(fLogCategory);
   
+  unsigned int const effectiveFragmentID
+    = effectivePMTboardFragmentID(fragInfo.fragmentID);
   icarusDB::PMTdigitizerInfoVec const& digitizerChannelVec
-    = fChannelMap.getPMTchannelInfo
-      (effectivePMTboardFragmentID(fragInfo.fragmentID))
-    ;
+    = fChannelMap.getPMTchannelInfo(effectiveFragmentID);
+  
+  // the compiled channel map, when available, indexes the digitizer channels
+  std::shared_ptr<icarusDB::CompiledChannelMap const> const compiledMap
+    = fChannelMap.compiledMap();
   
-  // allocate the vector outside the loop since we'll reuse it over and over
-  std::vector<std::uint16_t> wvfm(fragInfo.nSamplesPerChannel);
+  std::size_t const nSamples = fragInfo.nSamplesPerChannel;
   
   // all waveforms share the same timestamp,
   // so either all contain the global trigger, or they all do not
-  bool const onGlobal = containsGlobalTrigger(timeStamp, wvfm.size());
+  bool const onGlobal = containsGlobalTrigger(timeStamp, nSamples);
   
   auto channelNumberToChannel
-    = [&digitizerChannelVec](unsigned short int channelNumber) -> raw::Channel_t
+    = [&digitizerChannelVec, &compiledMap, effectiveFragmentID]
+      (unsigned short int channelNumber) -> raw::Channel_t
     {
+      if (compiledMap) {
+        icarusDB::PMTChannelInfo_t const* chInfo
+          = compiledMap->findPMTchannel(effectiveFragmentID, channelNumber);
+        return chInfo
+          ? chInfo->channelID: sbn::V1730channelConfiguration::NoChannelID;
+      }
       for (icarusDB::PMTChannelInfo_t const & chInfo: digitizerChannelVec)
         if (chInfo.digitizerChannelNo == channelNumber) return chInfo.channelID;
       return sbn::V1730channelConfiguration::NoChannelID;
@@ -2574,17 +2817,21 @@ auto icarus::DaqDecoderICARUSPMT::createFragmentWaveforms(
     
     
     //
-    // fill the waveform data
+    // fill the waveform data, copying straight from the fragment payload
     //
-    std::size_t const ch_offset = iChunk * fragInfo.nSamplesPerChannel;
-    std::copy_n(fragInfo.data + ch_offset, wvfm.size(), wvfm.begin());
+    std::uint16_t const* const samplesBegin
+      = fragInfo.data + iChunk * nSamples;
+    std::uint16_t const* const samplesEnd = samplesBegin + nSamples;
+    
+    raw::OpDetWaveform waveform{ timeStamp.value(), channel, nSamples };
+    waveform.assign(samplesBegin, samplesEnd);
     
     //
     // create the proto-waveform
     //
-    auto const [ itMin, itMax ] = std::minmax_element(wvfm.begin(), wvfm.end());
+    auto const [ itMin, itMax ] = std::minmax_element(samplesBegin, samplesEnd);
     protoWaveforms.push_back({ // create the waveform and its ancillary info
-        raw::OpDetWaveform{ timeStamp.value(), channel, wvfm }  // waveform
+        std::move(waveform)                                     // waveform
       , &thisChannelSetup                                       // channelSetup
       , onGlobal                                                // onGlobal
       , *itMin                                                  // minSample
@@ -2593,7 +2840,7 @@ auto icarus::DaqDecoderICARUSPMT::createFragmentWaveforms(
     
     mf::LogTrace log(fLogCategory);
     log << "PMT channel " << dumpChannel(protoWaveforms.back())
-      << " has " << wvfm.size() << " samples (read from entry #" << iChunk
+      << " has " << nSamples << " samples (read from entry #" << iChunk
       << " in fragment data) starting at electronics time " << timeStamp;
     if (protoWaveforms.back().onGlobal) log << ", on global trigger";
     if (!protoWaveforms.back().channelSetup->category.empty()) {
@@ -2934,26 +3181,41 @@ auto icarus::DaqDecoderICARUSPMT::extractFragmentBoardID
 } // icarus::DaqDecoderICARUSPMT::extractFragmentBoardID()
 
 
+//------------------------------------------------------------------------------
+auto icarus::DaqDecoderICARUSPMT::extractFragmentBoardID
+  (FragmentView_t const& fragment) -> BoardID_t
+{
+  return static_cast<BoardID_t>(fragment.fragmentID);
+} // icarus::DaqDecoderICARUSPMT::extractFragmentBoardID(FragmentView_t)
+
+
 //------------------------------------------------------------------------------
 auto icarus::DaqDecoderICARUSPMT::extractFragmentInfo
-  (artdaq::Fragment const& artdaqFragment) const -> FragmentInfo_t
+  (FragmentView_t const& fragment) const -> FragmentInfo_t
 {
   //
   // fragment ID, timestamp and data begin
   //
-  artdaq::Fragment::fragment_id_t const fragment_id
-    = artdaqFragment.fragmentID();
-  artdaq::Fragment::timestamp_t const fragmentTimestamp
-    = artdaqFragment.timestamp();
+  artdaq::Fragment::fragment_id_t const fragment_id = fragment.fragmentID;
+  artdaq::Fragment::timestamp_t const fragmentTimestamp = fragment.timestamp;
   std::uint16_t const* data_begin = reinterpret_cast<std::uint16_t const*>
-    (artdaqFragment.dataBeginBytes() + sizeof(sbndaq::CAENV1730EventHeader));
+    (fragment.dataBegin + sizeof(sbndaq::CAENV1730EventHeader));
 
   //
   // event counter, trigger time tag, enabled channels
+  // (read in place, as `sbndaq::CAENV1730Fragment` would)
   //
-  sbndaq::CAENV1730Fragment const fragment { artdaqFragment };
-  sbndaq::CAENV1730FragmentMetadata const& metafrag = *(fragment.Metadata());
-  sbndaq::CAENV1730EventHeader const& header = fragment.Event()->Header;
+  auto const* metadata
+    = fragment.metadataAs<sbndaq::CAENV1730FragmentMetadata>();
+  if (!metadata) {
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "PMT fragment 0x" << std::hex << fragment_id << std::dec
+      << " has no metadata.\n";
+  }
+  sbndaq::CAENV1730FragmentMetadata const& metafrag = *metadata;
+  sbndaq::CAENV1730EventHeader const& header
+    = reinterpret_cast<sbndaq::CAENV1730Event const*>(fragment.dataBegin)
+      ->Header;
   
   unsigned int const eventCounter = header.eventCounter;
   
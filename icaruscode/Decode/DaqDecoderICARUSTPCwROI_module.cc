@@ -38,7 +38,6 @@
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
 #include "tbb/spin_mutex.h"
-#include "tbb/concurrent_vector.h"
 
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -50,7 +49,11 @@
 
 #include "icaruscode/Utilities/ArtHandleTrackerManager.h"
 #include "icaruscode/Decode/DecoderTools/INoiseFilter.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCFragmentUnpacking.h"
+#include "icaruscode/Decode/DecoderTools/details/ChannelOrderedOutput.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
+#include "icaruscode/Utilities/CacheCounter.h" // util::CacheGuard
 
 #include "icarus_signal_processing/ICARUSSigProcDefs.h"
 #include "icarus_signal_processing/WaveformTools.h"
@@ -83,8 +86,9 @@ public:
     using RawDigitCollectionPtr   = std::unique_ptr<RawDigitCollection>;
     using ChannelROICollection    = std::vector<recob::ChannelROI>;
     using ChannelROICollectionPtr = std::unique_ptr<ChannelROICollection>;
-    using ConcurrentRawDigitCol   = tbb::concurrent_vector<raw::RawDigit>;
-    using ConcurrentChannelROICol = tbb::concurrent_vector<recob::ChannelROI>;
+    using ConcurrentRawDigitCol   = daq::details::ChannelOrderedCollection<raw::RawDigit>;
+    using ConcurrentChannelROICol = daq::details::ChannelOrderedCollection<recob::ChannelROI>;
+    using TicketVec               = std::vector<size_t>;
 
     // Define data structures for organizing the decoded fragments
     // The idea is to form complete "images" organized by "logical" TPC. Here we are including
@@ -101,9 +105,22 @@ public:
     using ChannelArrayPair      = std::pair<daq::INoiseFilter::ChannelPlaneVec,icarus_signal_processing::ArrayFloat>;
     using ChannelArrayPairVec   = std::vector<ChannelArrayPair>;
 
+    // Per thread work buffers, reused across fragments and events so the decoding
+    // does not need to allocate them again once they have reached their steady state size
+    struct DecoderWorkspace
+    {
+        ChannelArrayPair                      channelArrayPair;   ///< A board worth of channels and waveforms
+        raw::RawDigit::ADCvector_t            wvfm;               ///< Float to short int conversion buffer
+        icarus_signal_processing::VectorFloat pedCorWaveforms;    ///< Pedestal corrected waveform
+
+        /// Makes sure the buffers can hold nChannels waveforms of nSamples each
+        void resize(size_t nChannels, size_t nSamples);
+    };
+
 
     // Function to do the work
     void processSingleFragment(size_t,
+                               size_t,
                                detinfo::DetectorClocksData const& clockData,
                                art::Handle<artdaq::Fragments>, 
                                ConcurrentRawDigitCol&,
@@ -119,6 +136,7 @@ private:
         multiThreadFragmentProcessing(DaqDecoderICARUSTPCwROI const&        parent,
                                       detinfo::DetectorClocksData const&    clockData,
                                       art::Handle<artdaq::Fragments> const& fragmentsHandle,
+                                      TicketVec const&                      firstTicketVec,
                                       ConcurrentRawDigitCol&                concurrentRawRawDigits,
                                       ConcurrentRawDigitCol&                concurrentRawDigits,
                                       ConcurrentRawDigitCol&                coherentRawDigits,
@@ -127,6 +145,7 @@ private:
             : fDaqDecoderICARUSTPCwROI(parent),
               fClockData{clockData},
               fFragmentsHandle(fragmentsHandle),
+              fFirstTicketVec(firstTicketVec),
               fConcurrentRawRawDigits(concurrentRawRawDigits),
               fConcurrentRawDigits(concurrentRawDigits),
               fCoherentRawDigits(coherentRawDigits),
@@ -137,12 +156,13 @@ private:
         void operator()(const tbb::blocked_range<size_t>& range) const
         {
             for (size_t idx = range.begin(); idx < range.end(); idx++)
-              fDaqDecoderICARUSTPCwROI.processSingleFragment(idx, fClockData, fFragmentsHandle, fConcurrentRawRawDigits, fConcurrentRawDigits, fCoherentRawDigits, fMorphedRawDigits, fConcurrentROIs);
+              fDaqDecoderICARUSTPCwROI.processSingleFragment(idx, fFirstTicketVec[idx], fClockData, fFragmentsHandle, fConcurrentRawRawDigits, fConcurrentRawDigits, fCoherentRawDigits, fMorphedRawDigits, fConcurrentROIs);
         }
     private:
         const DaqDecoderICARUSTPCwROI&        fDaqDecoderICARUSTPCwROI;
         detinfo::DetectorClocksData const&    fClockData;
         art::Handle<artdaq::Fragments> const& fFragmentsHandle;
+        TicketVec const&                      fFirstTicketVec;
         ConcurrentRawDigitCol&                fConcurrentRawRawDigits;
         ConcurrentRawDigitCol&                fConcurrentRawDigits;
         ConcurrentRawDigitCol&                fCoherentRawDigits;
@@ -150,6 +170,18 @@ private:
         ConcurrentChannelROICol&              fConcurrentROIs;
     };
 
+    // Pick up a new snapshot of the channel map if the provider moved to a new period
+    void updateChannelMapSnapshot();
+
+    // Recover the board IDs of a fragment in slot order, empty if the fragment can't be decoded
+    icarusDB::ReadoutIDVec getBoardIDVec(artdaq::detail::RawFragmentHeader::fragment_id_t, size_t) const;
+
+    // Recover the channels of a board, from the compiled channel map when available
+    const icarusDB::ChannelPlanePairVec& getChannelPlanePair(unsigned int) const;
+
+    // Book the outputs of all fragments in channel order, returns the first ticket of each fragment
+    TicketVec bookFragmentOutputs(artdaq::Fragments const&, daq::details::ChannelOrderedLayout&) const;
+
     // Function to save our RawDigits
     void saveRawDigits(const icarus_signal_processing::ArrayFloat&, 
                        const icarus_signal_processing::VectorFloat&, 
@@ -168,6 +200,7 @@ private:
     bool                                                        fDiagnosticOutput;           ///< Set this to get lots of messages
     float                                                       fSigmaForTruncation;         ///< Cut for truncated rms calc
     size_t                                                      fCoherentNoiseGrouping;      ///< Grouping for removing coherent noise
+    bool                                                        fFusedDecoding;              ///< Unpack whole board tiles and convert outputs in one pass
 
     bool fDropRawDataAfterUse;   ///< Clear fragment data product cache after use.
   
@@ -191,10 +224,13 @@ private:
 
     // Tools for decoding fragments depending on type
     std::vector<std::unique_ptr<INoiseFilter>>                  fDecoderToolVec;       ///< Decoder tools
+    std::vector<std::unique_ptr<DecoderWorkspace>>              fWorkspaceVec;         ///< Work buffers, one per thread
 
     // Useful services, keep copies for now (we can update during begin run periods)
     geo::GeometryCore const*                                    fGeometry;             ///< pointer to Geometry service
     const icarusDB::IICARUSChannelMap*                          fChannelMap;
+    util::CacheGuard                                            fChannelMapCacheGuard; ///< Tracks the TPC channel map version
+    std::shared_ptr<icarusDB::CompiledChannelMap const>         fCompiledMap;          ///< Snapshot of the channel map (may be null)
 };
 
 DEFINE_ART_MODULE(DaqDecoderICARUSTPCwROI)
@@ -207,11 +243,14 @@ DEFINE_ART_MODULE(DaqDecoderICARUSTPCwROI)
 /// pset - Fcl parameters.
 ///
 DaqDecoderICARUSTPCwROI::DaqDecoderICARUSTPCwROI(fhicl::ParameterSet const & pset, art::ProcessingFrame const& frame) :
-                            art::ReplicatedProducer(pset, frame),fLogCategory("DaqDecoderICARUSTPCwROI"),fNumEvent(0), fNumROPs(0)
+                            art::ReplicatedProducer(pset, frame),fLogCategory("DaqDecoderICARUSTPCwROI"),fNumEvent(0), fNumROPs(0),
+                            fChannelMapCacheGuard("TPC")
 {
     fGeometry   = art::ServiceHandle<geo::Geometry const>{}.get();
     fChannelMap = art::ServiceHandle<icarusDB::IICARUSChannelMap const>{}.get();
 
+    fChannelMapCacheGuard.setCache(*fChannelMap);
+
     configure(pset);
 
     // Check the concurrency 
@@ -219,6 +258,9 @@ DaqDecoderICARUSTPCwROI::DaqDecoderICARUSTPCwROI(fhicl::ParameterSet const & pse
 
     mf::LogDebug("DaqDecoderICARUSTPCwROI") << "     ==> concurrency: " << max_concurrency << std::endl;
 
+    // Pick up the flat snapshot of the channel map of the current period
+    updateChannelMapSnapshot();
+
     // Recover the vector of fhicl parameters for the ROI tools
     const fhicl::ParameterSet& decoderToolParams = pset.get<fhicl::ParameterSet>("DecoderTool");
     
@@ -230,6 +272,11 @@ DaqDecoderICARUSTPCwROI::DaqDecoderICARUSTPCwROI(fhicl::ParameterSet const & pse
         decoderTool = art::make_tool<INoiseFilter>(decoderToolParams);
     }
 
+    // The work buffers follow the same one-per-thread scheme as the tools
+    fWorkspaceVec.resize(max_concurrency);
+
+    for(auto& workspace : fWorkspaceVec) workspace = std::make_unique<DecoderWorkspace>();
+
     // Set up our "producers" 
     // Note that we can have multiple instances input to the module
     // Our convention will be to create a similar number of outputs with the same instance names
@@ -317,6 +364,7 @@ void DaqDecoderICARUSTPCwROI::configure(fhicl::ParameterSet const & pset)
     fSigmaForTruncation    = pset.get<float                     >("NSigmaForTrucation",                                                3.5);
     fCoherentNoiseGrouping = pset.get<size_t                    >("CoherentGrouping",                                                   64);
     fDropRawDataAfterUse   = pset.get<bool                      >("DropRawDataAfterUse",                                              true);
+    fFusedDecoding         = pset.get<bool                      >("FusedDecoding",                                                   false);
 }
 
 //----------------------------------------------------------------------------
@@ -344,6 +392,9 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
     util::LocalArtHandleTrackerManager dataCacheRemover
         (event, fDropRawDataAfterUse);
 
+    // The channel map service may have moved to a new period at the start of this run
+    updateChannelMapSnapshot();
+
     // Check the concurrency 
     int max_concurrency = tbb::this_task_arena::max_concurrency();
 
@@ -361,106 +412,42 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
         art::Handle<artdaq::Fragments> const& daq_handle
           = dataCacheRemover.getHandle<artdaq::Fragments>(fragmentLabel);
 
-        ConcurrentRawDigitCol   concurrentRawDigits;
+        // The channels each fragment will produce are known from the channel map, so we can
+        // assign each output its place in the final channel ordered collections up front
+        daq::details::ChannelOrderedLayout outputLayout;
+
+        TicketVec firstTicketVec = bookFragmentOutputs(*daq_handle, outputLayout);
+
+        ConcurrentRawDigitCol   concurrentRawDigits(outputLayout);
         ConcurrentRawDigitCol   concurrentRawRawDigits;
         ConcurrentRawDigitCol   coherentRawDigits;
         ConcurrentRawDigitCol   morphedRawDigits;
-        ConcurrentChannelROICol concurrentROIs;
-
-        PlaneIdxToImageMap   planeIdxToImageMap;
-        PlaneIdxToChannelMap planeIdxToChannelMap;
-
-        ChannelArrayPairVec  channelArrayPairVec(fNumROPs);
-
-        // Because the arrays can be variable size we need to loop to initialize
-        for(size_t ropIdx = 0; ropIdx < fNumROPs; ropIdx++)
-        {
-            ChannelArrayPair& channelArrayPair = channelArrayPairVec[ropIdx];
+        ConcurrentChannelROICol concurrentROIs(outputLayout);
 
-            channelArrayPair.first.resize(fROPToNumWiresMap[ropIdx]);
-            channelArrayPair.second.resize(fROPToNumWiresMap[ropIdx],icarus_signal_processing::VectorFloat(4096));
-
-            mf::LogDebug("DaqDecoderICARUSTPCwROI") << "**> Initializing ropIdx: " << ropIdx << " channelPairVec to " << channelArrayPair.first.size() << " channels with " << channelArrayPair.second[0].size() << " ticks" << std::endl;
-        }
+        if (fOutputRawWaveform) concurrentRawRawDigits = ConcurrentRawDigitCol(outputLayout);
+        if (fOutputCorrection)  coherentRawDigits      = ConcurrentRawDigitCol(outputLayout);
+        if (fOutputMorphed)     morphedRawDigits       = ConcurrentRawDigitCol(outputLayout);
 
         mf::LogDebug("DaqDecoderICARUSTPCwROI") << "****> Let's get ready to rumble!" << std::endl;
     
         // ... Launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
         auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService>()->DataFor(event);
 
-        multiThreadFragmentProcessing fragmentProcessing(*this, clockData, daq_handle, concurrentRawRawDigits, concurrentRawDigits, coherentRawDigits, morphedRawDigits, concurrentROIs);
+        multiThreadFragmentProcessing fragmentProcessing(*this, clockData, daq_handle, firstTicketVec, concurrentRawRawDigits, concurrentRawDigits, coherentRawDigits, morphedRawDigits, concurrentROIs);
 
         tbb::parallel_for(tbb::blocked_range<size_t>(0, daq_handle->size()), fragmentProcessing);
 
-        // Now let's process the resulting images
-    //    multiThreadImageProcessing imageProcessing(*this, clockData, channelArrayPairVec, concurrentRawDigits, coherentRawDigits, concurrentROIs);
-
-    //    tbb::parallel_for(tbb::blocked_range<size_t>(0, fNumROPs), imageProcessing);
-    
-        // Copy the raw digits from the concurrent vector to our output vector
-        RawDigitCollectionPtr rawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawDigits.begin()), 
-                                                                                                std::move_iterator(concurrentRawDigits.end()));
-    
-        // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-        std::sort(rawDigitCollection->begin(),rawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-
-        // What did we get back?
-        mf::LogDebug("DaqDecoderICARUSTPCwROI") << "****> Total size of map: " << planeIdxToImageMap.size() << std::endl;
-        for(const auto& planeImagePair : planeIdxToImageMap)
-        {
-            mf::LogDebug("DaqDecoderICARUSTPCwROI") << "      - plane: " << planeImagePair.first << " has " << planeImagePair.second.size() << " wires" << std::endl;
-        }
-    
-        // Now transfer ownership to the event store
-        event.put(std::move(rawDigitCollection), fragmentLabel.instance());
+        // The outputs were written in place already in channel order, transfer ownership to the event store
+        event.put(concurrentRawDigits.release(), fragmentLabel.instance());
 
         // Do the same to output the candidate ROIs
-        ChannelROICollectionPtr channelROICollection = std::make_unique<std::vector<recob::ChannelROI>>(std::move_iterator(concurrentROIs.begin()),
-                                                                                                        std::move_iterator(concurrentROIs.end()));
-
-        std::sort(channelROICollection->begin(),channelROICollection->end(),[](const auto& left, const auto& right){return left.Channel() < right.Channel();});
-
-        event.put(std::move(channelROICollection), fragmentLabel.instance());
+        event.put(concurrentROIs.release(), fragmentLabel.instance());
     
+        if (fOutputRawWaveform) event.put(concurrentRawRawDigits.release(),fragmentLabel.instance() + fOutputRawWavePath);
     
-        if (fOutputRawWaveform)
-        {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr rawRawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawRawDigits.begin()), 
-                                                                                                       std::move_iterator(concurrentRawRawDigits.end()));
-    
-            // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(rawRawDigitCollection->begin(),rawRawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-    
-            // Now transfer ownership to the event store
-            event.put(std::move(rawRawDigitCollection),fragmentLabel.instance() + fOutputRawWavePath);
-        }
-    
-        if (fOutputCorrection)
-        {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr coherentCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(coherentRawDigits.begin()), 
-                                                                                                    std::move_iterator(coherentRawDigits.end()));
+        if (fOutputCorrection) event.put(coherentRawDigits.release(),fragmentLabel.instance() + fOutputCoherentPath);
     
-            // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(coherentCollection->begin(),coherentCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-    
-            // Now transfer ownership to the event store
-            event.put(std::move(coherentCollection),fragmentLabel.instance() + fOutputCoherentPath);
-        }
-    
-        if (fOutputMorphed)
-        {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr morphedCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(morphedRawDigits.begin()), 
-                                                                                                   std::move_iterator(morphedRawDigits.end()));
-    
-            // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(morphedCollection->begin(),morphedCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-    
-            // Now transfer ownership to the event store
-            event.put(std::move(morphedCollection),fragmentLabel.instance() + fOutputMorphedPath);
-        }
+        if (fOutputMorphed) event.put(morphedRawDigits.release(),fragmentLabel.instance() + fOutputMorphedPath);
     }
 
     theClockTotal.stop();
@@ -472,7 +459,116 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
     return;
 }
 
+//----------------------------------------------------------------------------
+/// Refresh the flat snapshot of the channel map if the provider moved to a new period.
+///
+/// Each replica of this module keeps its own copy of the (immutable) snapshot, and
+/// checks it at every event; the check is a comparison of cache IDs.
+///
+void DaqDecoderICARUSTPCwROI::updateChannelMapSnapshot()
+{
+    if (!fChannelMapCacheGuard.update()) return;
+
+    fCompiledMap = fChannelMap->compiledMap();
+
+    mf::LogDebug(fLogCategory) << "Channel map snapshot updated (cache ID " << fChannelMapCacheGuard.lastUpdateID() << ")";
+}
+
+//----------------------------------------------------------------------------
+/// Recover the board IDs of a fragment, in slot order.
+///
+/// Returns an empty vector if the fragment or any of its boards is not in the channel map.
+///
+icarusDB::ReadoutIDVec DaqDecoderICARUSTPCwROI::getBoardIDVec(artdaq::detail::RawFragmentHeader::fragment_id_t fragmentID, size_t nBoardsPerFragment) const
+{
+    // The compiled channel map has the slot order ready
+    if (fCompiledMap)
+    {
+        if (const icarusDB::ReadoutIDVec* boardIDVec = fCompiledMap->boardsInSlotOrder(fragmentID)) return *boardIDVec;
+
+        if (!fCompiledMap->findTPCfragment(fragmentID)) return {};
+    }
+
+    // Look for special case of diagnostic running
+    if (!fChannelMap->hasFragmentID(fragmentID)) return {};
+
+    // Get the board ids for this fragment
+    const icarusDB::ReadoutIDVec& readoutIDVec = fChannelMap->getReadoutBoardVec(fragmentID);
+
+    icarusDB::ReadoutIDVec boardIDVec(readoutIDVec.size());
+
+    // Note we want these to be in "slot" order...
+    for(const auto& boardID : readoutIDVec)
+    {
+        // Look up the channels associated to this board
+        if (!fChannelMap->hasBoardID(boardID))
+        {
+            mf::LogDebug(fLogCategory) << "*** COULD NOT FIND BOARD ***\n" <<
+                                          "    - boardID: " << std::hex << boardID << ", board map size: " << readoutIDVec.size() << ", nBoardsPerFragment: " << nBoardsPerFragment;
+
+            return {};
+        }
+
+        unsigned int boardSlot = fChannelMap->getBoardSlot(boardID);
+
+        boardIDVec[boardSlot] = boardID;
+    }
+
+    return boardIDVec;
+}
+
+//----------------------------------------------------------------------------
+/// Recover the channels (and their planes) served by a board.
+const icarusDB::ChannelPlanePairVec& DaqDecoderICARUSTPCwROI::getChannelPlanePair(unsigned int boardID) const
+{
+    if (fCompiledMap)
+    {
+        if (const icarusDB::ChannelPlanePairVec* channelPlanePairVec = fCompiledMap->findChannelPlanePairs(boardID)) return *channelPlanePairVec;
+    }
+
+    return fChannelMap->getChannelPlanePair(boardID);
+}
+
+//----------------------------------------------------------------------------
+/// Book the outputs of all the fragments.
+///
+/// Each fragment books one output per channel of each of its boards, in board and channel
+/// order, which is how processSingleFragment() recovers its tickets from the first one.
+///
+DaqDecoderICARUSTPCwROI::TicketVec DaqDecoderICARUSTPCwROI::bookFragmentOutputs(artdaq::Fragments const&            fragments,
+                                                                                daq::details::ChannelOrderedLayout& outputLayout) const
+{
+    TicketVec firstTicketVec(fragments.size());
+
+    for(size_t idx = 0; idx < fragments.size(); idx++)
+    {
+        firstTicketVec[idx] = outputLayout.size();
+
+        // Only the fragment header and the channel map are needed here
+        icarus::PhysCrateFragment physCrateFragment(fragments[idx]);
+
+        size_t nBoardsPerFragment = physCrateFragment.nBoards();
+        size_t nChannelsPerBoard  = physCrateFragment.nChannelsPerBoard();
+
+        icarusDB::ReadoutIDVec boardIDVec = getBoardIDVec(fragments[idx].fragmentID(), nBoardsPerFragment);
+
+        for(size_t board = 0; board < std::min(boardIDVec.size(), nBoardsPerFragment); board++)
+        {
+            const icarusDB::ChannelPlanePairVec& channelPlanePairVec = getChannelPlanePair(boardIDVec[board]);
+
+            for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++) outputLayout.book(channelPlanePairVec[chanIdx].first);
+        }
+    }
+
+    outputLayout.prepare();
+
+    return firstTicketVec;
+}
+
+//----------------------------------------------------------------------------
+/// Decode and noise filter a single fragment, writing its outputs in their booked slots.
 void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t                             idx,
+                                                    size_t                             firstTicket,
                                                     detinfo::DetectorClocksData const& clockData,
                                                     art::Handle<artdaq::Fragments>     fragmentHandle,
                                                     ConcurrentRawDigitCol&             concurrentRawRawDigitCol,
@@ -507,37 +603,14 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
 
     mf::LogDebug(fLogCategory) << "==> Recovered fragmentID: " << std::hex << fragmentID << std::dec << std::endl;
 
-    // Look for special case of diagnostic running
-    if (!fChannelMap->hasFragmentID(fragmentID))
-    {
-        return;
-    }
+    // Get the board ids for this fragment, nothing to do for diagnostic running or missing boards
+    icarusDB::ReadoutIDVec boardIDVec = getBoardIDVec(fragmentID, nBoardsPerFragment);
+
+    if (boardIDVec.empty()) return;
 
     // Recover the crate name for this fragment
     const std::string& crateName = fChannelMap->getCrateName(fragmentID);
 
-    // Get the board ids for this fragment
-    const icarusDB::ReadoutIDVec& readoutIDVec = fChannelMap->getReadoutBoardVec(fragmentID);
-
-    icarusDB::ReadoutIDVec boardIDVec(readoutIDVec.size());
-
-    // Note we want these to be in "slot" order...
-    for(const auto& boardID : readoutIDVec)
-    {
-        // Look up the channels associated to this board
-        if (!fChannelMap->hasBoardID(boardID))
-        {
-            mf::LogDebug(fLogCategory) << "*** COULD NOT FIND BOARD ***\n" <<
-                                          "    - boardID: " << std::hex << boardID << ", board map size: " << readoutIDVec.size() << ", nBoardsPerFragment: " << nBoardsPerFragment;
-
-            return;
-        }
-
-        unsigned int boardSlot = fChannelMap->getBoardSlot(boardID);
-
-        boardIDVec[boardSlot] = boardID;
-    }
-
     std::string boardIDs = "";
 
     for(const auto& id : boardIDVec) boardIDs += std::to_string(id) + " ";
@@ -551,14 +624,15 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
     // Recover pointer to the decoder needed here
     INoiseFilter* decoderTool = fDecoderToolVec[tbb::this_task_arena::current_thread_index()].get();
 
-    // Create a local channel pair  to hold at most a boards worth of info (64 channels x 4096 ticks)
-    ChannelArrayPair channelArrayPair;
+    // Recover this thread's work buffers, holding at most a boards worth of info (64 channels x 4096 ticks)
+    DecoderWorkspace& workspace = *fWorkspaceVec[tbb::this_task_arena::current_thread_index()];
+
+    workspace.resize(nChannelsPerBoard, nSamplesPerChannel);
 
-    channelArrayPair.first.resize(nChannelsPerBoard);
-    channelArrayPair.second.resize(nChannelsPerBoard,icarus_signal_processing::VectorFloat(nSamplesPerChannel));
+    ChannelArrayPair& channelArrayPair = workspace.channelArrayPair;
 
     // Now set up for output, we need to convert back from float to short int so use this
-    raw::RawDigit::ADCvector_t wvfm(nSamplesPerChannel);
+    raw::RawDigit::ADCvector_t& wvfm = workspace.wvfm;
 
     // The first task is to recover the data from the board data block, determine and subtract the pedestals
     // and store into vectors useful for the next steps
@@ -571,7 +645,7 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
             continue;
         }
 
-        const icarusDB::ChannelPlanePairVec& channelPlanePairVec = fChannelMap->getChannelPlanePair(boardIDVec[board]);
+        const icarusDB::ChannelPlanePairVec& channelPlanePairVec = getChannelPlanePair(boardIDVec[board]);
 
         uint32_t boardSlot = physCrateFragment.DataTileHeader(board)->StatusReg_SlotID();
 
@@ -583,19 +657,29 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
 
         if (board != boardSlot)
         {
-            mf::LogInfo(fLogCategory) << "==> Found board/boardSlot mismatch, crate: " << crateName << ", board: " << board << ", boardSlot: " << boardSlot << " channelPlanePair: " << fChannelMap->getChannelPlanePair(boardIDVec[board]).front().first << "/"  << fChannelMap->getChannelPlanePair(boardIDVec[board]).front().second << ", slot: " << channelPlanePairVec[0].first << "/" << channelPlanePairVec[0].second;
+            mf::LogInfo(fLogCategory) << "==> Found board/boardSlot mismatch, crate: " << crateName << ", board: " << board << ", boardSlot: " << boardSlot << " channelPlanePair: " << getChannelPlanePair(boardIDVec[board]).front().first << "/"  << getChannelPlanePair(boardIDVec[board]).front().second << ", slot: " << channelPlanePairVec[0].first << "/" << channelPlanePairVec[0].second;
         }
         // Copy to input data array
-        for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
+        if (fFusedDecoding)
         {
-           icarus_signal_processing::VectorFloat& rawDataVec = channelArrayPair.second[chanIdx];
-           for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
-             rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
+            // Unpack the whole board tile in one pass, with the same masking as adc_val()
+            const icarus::A2795DataBlock::data_t adcMask = static_cast<icarus::A2795DataBlock::data_t>(~(1U << (physCrateFragment.metadata()->num_adc_bits() + 1)));
 
-          // Keep track of the channel
-          channelArrayPair.first[chanIdx] = channelPlanePairVec[chanIdx];
+            daq::details::unpackBoardTile(physCrateFragment.BoardData(board), nChannelsPerBoard, nSamplesPerChannel, adcMask, channelArrayPair.second);
+        }
+        else
+        {
+            for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
+            {
+               icarus_signal_processing::VectorFloat& rawDataVec = channelArrayPair.second[chanIdx];
+               for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
+                 rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
+            }
         }
 
+        // Keep track of the channels
+        for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++) channelArrayPair.first[chanIdx] = channelPlanePairVec[chanIdx];
+
         //process_fragment(event, rawfrag, product_collection, header_collection);
         decoderTool->process_fragment(clockData, channelArrayPair.first, channelArrayPair.second, fCoherentNoiseGrouping);
 
@@ -614,69 +698,149 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
         // Recover the denoised waveform
         const icarus_signal_processing::ArrayFloat& denoised = decoderTool->getWaveLessCoherent();
 
-        icarus_signal_processing::VectorFloat       pedCorWaveforms(denoised[0].size());
+        icarus_signal_processing::VectorFloat&      pedCorWaveforms = workspace.pedCorWaveforms;
+
+        pedCorWaveforms.resize(denoised[0].size());
 
         for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
         {
             // Get the channel number on the Fragment
             raw::ChannelID_t channel = channelPlanePairVec[chanIdx].first;
 
-            // Are we storing the raw waveforms?
-            if (fOutputRawWaveform)
+            // This is where the outputs of this channel were booked
+            size_t ticket = firstTicket + board * nChannelsPerBoard + chanIdx;
+
+            // The pedestal corrected waveform is the source for the ROIs
+            const raw::RawDigit::ADCvector_t* roiSourceADCs = nullptr;
+
+            if (fFusedDecoding)
             {
-                //const icarus_signal_processing::VectorFloat& waveform = decoderTool->getPedCorWaveforms()[chanIdx];
-                const icarus_signal_processing::VectorFloat& waveform = decoderTool->getRawWaveforms()[chanIdx];
+                // Determine the pedestal first so all the outputs can be converted together
+                waveformTools.getPedestalCorrectedWaveform(denoised[chanIdx],
+                                                           pedCorWaveforms,
+                                                           sigmaCut,
+                                                           localPedestal,
+                                                           localFullRMS,
+                                                           localTruncRMS,
+                                                           localNumTruncBins,
+                                                           localRangeBins);
+
+                // Convert from float to short int in a single pass, directly into the output vectors
+                daq::details::RoundingStreams<4> roundingStreams;
+
+                raw::RawDigit::ADCvector_t pedCorADCs(pedCorWaveforms.size());
+                raw::RawDigit::ADCvector_t rawADCs;
+                raw::RawDigit::ADCvector_t coherentADCs;
+                raw::RawDigit::ADCvector_t morphedADCs;
+
+                roundingStreams.add(pedCorWaveforms.data(), pedCorADCs.data());
+
+                if (fOutputRawWaveform)
+                {
+                    rawADCs.resize(pedCorWaveforms.size());
+                    roundingStreams.add(decoderTool->getRawWaveforms()[chanIdx].data(), rawADCs.data());
+                }
 
-                // Need to convert from float to short int
-                std::transform(waveform.begin(),waveform.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
-    
-                ConcurrentRawDigitCol::iterator newRawObjItr = concurrentRawRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+                if (fOutputCorrection)
+                {
+                    coherentADCs.resize(pedCorWaveforms.size());
+                    roundingStreams.add(decoderTool->getCorrectedMedians()[chanIdx].data(), coherentADCs.data());
+                }
 
-                newRawObjItr->SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
-            }
+                if (fOutputMorphed)
+                {
+                    morphedADCs.resize(pedCorWaveforms.size());
+                    roundingStreams.add(decoderTool->getMorphedWaveforms()[chanIdx].data(), morphedADCs.data());
+                }
 
-            if (fOutputCorrection)
-            {
-                const icarus_signal_processing::VectorFloat& corrections = decoderTool->getCorrectedMedians()[chanIdx];
+                roundingStreams.round(pedCorWaveforms.size());
 
-                // Need to convert from float to short int
-                std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+                if (fOutputRawWaveform)
+                {
+                    raw::RawDigit& newRawObj = concurrentRawRawDigitCol.emplace(ticket, channel,rawADCs.size(),std::move(rawADCs));
 
-                //ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
-                ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.push_back(raw::RawDigit(channel,wvfm.size(),wvfm)); 
+                    newRawObj.SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
+                }
 
-                newRawObjItr->SetPedestal(0.,0.);
-            }
+                if (fOutputCorrection)
+                {
+                    raw::RawDigit& newRawObj = coherentRawDigitCol.emplace(ticket, channel,coherentADCs.size(),std::move(coherentADCs));
 
-            if (fOutputMorphed)
-            {
-                const icarus_signal_processing::VectorFloat& corrections = decoderTool->getMorphedWaveforms()[chanIdx];
+                    newRawObj.SetPedestal(0.,0.);
+                }
 
-                // Need to convert from float to short int
-                std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+                if (fOutputMorphed)
+                {
+                    raw::RawDigit& newRawObj = morphedRawDigitCol.emplace(ticket, channel,morphedADCs.size(),std::move(morphedADCs));
 
-                //ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
-                ConcurrentRawDigitCol::iterator newRawObjItr = morphedRawDigitCol.push_back(raw::RawDigit(channel,wvfm.size(),wvfm)); 
+                    newRawObj.SetPedestal(0.,0.);
+                }
+
+                raw::RawDigit& newObj = concurrentRawDigitCol.emplace(ticket, channel,pedCorADCs.size(),std::move(pedCorADCs));
+
+                newObj.SetPedestal(localPedestal,localFullRMS);
 
-                newRawObjItr->SetPedestal(0.,0.);
+                roiSourceADCs = &newObj.ADCs();
             }
+            else
+            {
+                // Are we storing the raw waveforms?
+                if (fOutputRawWaveform)
+                {
+                    //const icarus_signal_processing::VectorFloat& waveform = decoderTool->getPedCorWaveforms()[chanIdx];
+                    const icarus_signal_processing::VectorFloat& waveform = decoderTool->getRawWaveforms()[chanIdx];
 
-            // Now determine the pedestal and correct for it
-            waveformTools.getPedestalCorrectedWaveform(denoised[chanIdx],
-                                                       pedCorWaveforms,
-                                                       sigmaCut,
-                                                       localPedestal,
-                                                       localFullRMS,
-                                                       localTruncRMS,
-                                                       localNumTruncBins,
-                                                       localRangeBins);
+                    // Need to convert from float to short int
+                    std::transform(waveform.begin(),waveform.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+    
+                    raw::RawDigit& newRawObj = concurrentRawRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm); 
 
-            // Need to convert from float to short int
-            std::transform(pedCorWaveforms.begin(),pedCorWaveforms.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+                    newRawObj.SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
+                }
+
+                if (fOutputCorrection)
+                {
+                    const icarus_signal_processing::VectorFloat& corrections = decoderTool->getCorrectedMedians()[chanIdx];
+
+                    // Need to convert from float to short int
+                    std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+
+                    raw::RawDigit& newRawObj = coherentRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm);
+
+                    newRawObj.SetPedestal(0.,0.);
+                }
+
+                if (fOutputMorphed)
+                {
+                    const icarus_signal_processing::VectorFloat& corrections = decoderTool->getMorphedWaveforms()[chanIdx];
+
+                    // Need to convert from float to short int
+                    std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+
+                    raw::RawDigit& newRawObj = morphedRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm);
+
+                    newRawObj.SetPedestal(0.,0.);
+                }
+
+                // Now determine the pedestal and correct for it
+                waveformTools.getPedestalCorrectedWaveform(denoised[chanIdx],
+                                                           pedCorWaveforms,
+                                                           sigmaCut,
+                                                           localPedestal,
+                                                           localFullRMS,
+                                                           localTruncRMS,
+                                                           localNumTruncBins,
+                                                           localRangeBins);
+
+                // Need to convert from float to short int
+                std::transform(pedCorWaveforms.begin(),pedCorWaveforms.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
+
+                raw::RawDigit& newObj = concurrentRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm); 
 
-            ConcurrentRawDigitCol::iterator newObjItr = concurrentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+                newObj.SetPedestal(localPedestal,localFullRMS);
 
-            newObjItr->SetPedestal(localPedestal,localFullRMS);
+                roiSourceADCs = &wvfm;
+            }
 
             // And, finally, the ROIs 
             const icarus_signal_processing::VectorBool& chanROIs = decoderTool->getROIVals()[chanIdx];
@@ -695,7 +859,7 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 {
                     std::vector<short> holder(roiIdx - roiStartIdx);
 
-                    for(size_t idx = 0; idx < holder.size(); idx++) holder[idx] = wvfm[roiStartIdx+idx];
+                    for(size_t idx = 0; idx < holder.size(); idx++) holder[idx] = (*roiSourceADCs)[roiStartIdx+idx];
 
                     ROIVec.add_range(roiStartIdx, std::move(holder));
                 }
@@ -703,7 +867,7 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 roiIdx++;
             }
         
-            concurrentROIs.push_back(recob::ChannelROICreator(std::move(ROIVec),channel).move());
+            concurrentROIs.emplace(ticket, recob::ChannelROICreator(std::move(ROIVec),channel).move());
         }
     }
 
@@ -722,6 +886,18 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
     return;
 }
 
+//----------------------------------------------------------------------------
+/// Resize the work buffers; once they have reached the size of a board this does not allocate
+void DaqDecoderICARUSTPCwROI::DecoderWorkspace::resize(size_t nChannels, size_t nSamples)
+{
+    channelArrayPair.first.resize(nChannels);
+    channelArrayPair.second.resize(nChannels);
+
+    for(auto& waveform : channelArrayPair.second) waveform.resize(nSamples);
+
+    wvfm.resize(nSamples);
+}
+
 //----------------------------------------------------------------------------
 /// End job method.
 void DaqDecoderICARUSTPCwROI::endJob(art::ProcessingFrame const&)
@@ -0,0 +1,148 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/ChannelOrderedOutput.h
+ * @brief  Output collections filled in place, in channel order, by many threads.
+ * @date   October 16, 2026
+ *
+ * This is a header-only library.
+ */
+
+#ifndef ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_CHANNELORDEREDOUTPUT_H
+#define ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_CHANNELORDEREDOUTPUT_H
+
+
+// C/C++ standard libraries
+#include <algorithm> // std::sort(), std::count()
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <memory> // std::unique_ptr
+#include <utility> // std::pair, std::move(), std::forward()
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace daq::details {
+
+  /**
+   * @brief Assigns to each booked output its position in channel order.
+   *
+   * Before the parallel processing starts, each output element which is
+   * expected to be produced is booked with `book()`, which returns a "ticket".
+   * Outputs which will be produced by the same task (e.g. all the channels of
+   * a fragment) should be booked consecutively, so that the task can recover
+   * each ticket from the first one and an index.
+   * After `prepare()`, `slot()` returns the position of each ticket in the
+   * channel-ordered output.
+   *
+   * The same layout can be shared by many `ChannelOrderedCollection` objects.
+   */
+  class ChannelOrderedLayout {
+
+      public:
+
+    using Channel_t = unsigned int; ///< Type of channel number.
+
+    /// Books an output for `channel`; returns its ticket.
+    std::size_t book(Channel_t channel)
+      {
+        fBooked.emplace_back(channel, fBooked.size());
+        return fBooked.size() - 1;
+      }
+
+    /// Returns the number of booked outputs.
+    std::size_t size() const { return fBooked.size(); }
+
+    /// Assigns the output slots; no booking is allowed after this call.
+    void prepare()
+      {
+        // sorting the booking (channel number, ticket) pairs is way cheaper
+        // than sorting the outputs afterwards
+        std::sort(fBooked.begin(), fBooked.end());
+        fTicketToSlot.resize(fBooked.size());
+        for (std::size_t slot = 0; slot < fBooked.size(); ++slot)
+          fTicketToSlot[fBooked[slot].second] = slot;
+      }
+
+    /// Returns the position of the output with the specified `ticket`.
+    std::size_t slot(std::size_t ticket) const
+      { assert(ticket < fTicketToSlot.size()); return fTicketToSlot[ticket]; }
+
+      private:
+
+    /// Booked outputs as (channel, ticket) pairs.
+    std::vector<std::pair<Channel_t, std::size_t>> fBooked;
+
+    std::vector<std::size_t> fTicketToSlot; ///< Output position of each ticket.
+
+  }; // class ChannelOrderedLayout
+
+
+  /**
+   * @brief Collection of outputs written in place from many threads.
+   * @tparam T type of the output element (must be default-constructible)
+   *
+   * All the storage is allocated at construction from the booked `layout`.
+   * Each element is then written with `emplace()` at the slot assigned to its
+   * ticket, so that no synchronization is needed as long as each ticket is
+   * written by only one task, and the collection is already sorted by channel
+   * when `release()` hands it over.
+   * Slots which were booked but never written are dropped on release.
+   */
+  template <typename T>
+  class ChannelOrderedCollection {
+
+      public:
+
+    /// Constructor: an unused collection, which does not allocate anything.
+    ChannelOrderedCollection() = default;
+
+    /// Constructor: allocates a slot for each output booked in `layout`.
+    explicit ChannelOrderedCollection(ChannelOrderedLayout const& layout)
+      : fLayout{ &layout }
+      , fData(layout.size())
+      , fFilled(layout.size(), 0)
+      {}
+
+    /// Creates the output element of `ticket` from the arguments.
+    template <typename... Args>
+    T& emplace(std::size_t ticket, Args&&... args)
+      {
+        assert(fLayout);
+        std::size_t const slot = fLayout->slot(ticket);
+        fData[slot] = T(std::forward<Args>(args)...);
+        fFilled[slot] = 1; // `char`, not `bool`: each slot has its own byte
+        return fData[slot];
+      }
+
+    /// Moves the filled elements, in channel order, into a new collection.
+    std::unique_ptr<std::vector<T>> release()
+      {
+        if (std::count(fFilled.begin(), fFilled.end(), 0) > 0) {
+          std::size_t iDest = 0;
+          for (std::size_t slot = 0; slot < fData.size(); ++slot) {
+            if (!fFilled[slot]) continue;
+            if (iDest != slot) fData[iDest] = std::move(fData[slot]);
+            ++iDest;
+          } // for
+          fData.resize(iDest);
+        } // if missing slots
+        fFilled.clear();
+        return std::make_unique<std::vector<T>>(std::move(fData));
+      } // release()
+
+      private:
+
+    ChannelOrderedLayout const* fLayout = nullptr; ///< Slot assignments.
+
+    std::vector<T> fData; ///< The output elements, in channel order.
+
+    std::vector<unsigned char> fFilled; ///< Whether each slot was written.
+
+  }; // class ChannelOrderedCollection
+
+
+} // namespace daq::details
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_CHANNELORDEREDOUTPUT_H
@@ -0,0 +1,142 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/TPCFragmentUnpacking.h
+ * @brief  Bulk unpacking of A2795 board data tiles and waveform conversions.
+ * @date   October 16, 2026
+ *
+ * This is a header-only library.
+ */
+
+#ifndef ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCFRAGMENTUNPACKING_H
+#define ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCFRAGMENTUNPACKING_H
+
+
+// C/C++ standard libraries
+#include <algorithm> // std::min()
+#include <array>
+#include <cassert>
+#include <cmath> // std::round()
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace daq::details {
+
+  /// Number of ticks transposed in one go by `unpackBoardTile()`.
+  constexpr std::size_t BoardTileTickBlock = 32U;
+
+  /// Number of ticks converted in one go by `RoundingStreams::round()`.
+  constexpr std::size_t RoundingTickBlock = 512U;
+
+
+  /**
+   * @brief Unpacks a whole A2795 board tile into channel-major waveforms.
+   * @tparam Word type of the ADC words in the board data block
+   * @tparam Waveforms a vector of vectors of `float`
+   * @param boardData pointer to the first ADC word of the board data block
+   * @param nChannels number of channels in the board
+   * @param nSamples number of samples per channel
+   * @param adcMask mask to be applied to each ADC word
+   * @param[out] waveforms destination, at least `nChannels` of `nSamples` each
+   *
+   * The A2795 board stores the data tick by tick (all the channels for the
+   * first tick, then all the channels for the next one, etc.).
+   * The tile is transposed in blocks of `BoardTileTickBlock` ticks, so that the
+   * source block stays in cache while each channel waveform is written
+   * contiguously, with inner loops the compiler can vectorize.
+   *
+   * The values are stored with inverted sign, as `adc_val()` based decoding
+   * in the decoders does.
+   */
+  template <typename Word, typename Waveforms>
+  void unpackBoardTile(
+    Word const* boardData, std::size_t nChannels, std::size_t nSamples,
+    Word adcMask, Waveforms& waveforms
+    )
+  {
+    assert(waveforms.size() >= nChannels);
+
+    for (std::size_t tickStart = 0; tickStart < nSamples;
+      tickStart += BoardTileTickBlock
+    ) {
+      std::size_t const tickEnd
+        = std::min(tickStart + BoardTileTickBlock, nSamples);
+
+      for (std::size_t channel = 0; channel < nChannels; ++channel) {
+        float* const dest = waveforms[channel].data();
+        Word const* const src = boardData + channel;
+        // negate as integer, like `-adc_val()` does (no negative zeroes)
+        for (std::size_t tick = tickStart; tick < tickEnd; ++tick) {
+          dest[tick] = static_cast<float>
+            (-static_cast<int>(src[tick * nChannels] & adcMask));
+        }
+      } // for channels
+    } // for tick blocks
+
+  } // unpackBoardTile()
+
+
+  /**
+   * @brief Rounds up to `MaxStreams` float waveforms into `short` ones at once.
+   * @tparam MaxStreams maximum number of waveforms converted together
+   *
+   * The waveforms of a channel (raw, coherent noise correction, morphed,
+   * pedestal-corrected...) are registered with `add()` and then converted
+   * all together with a single `round()` call, which walks them in blocks of
+   * `RoundingTickBlock` ticks so that all of them are produced in one pass.
+   * Rounding is the same as `short(std::round(value))`.
+   *
+   * Example:
+   * @code{.cpp}
+   * daq::details::RoundingStreams<4U> streams;
+   * streams.add(pedCorWaveform.data(), pedCorADCs.data());
+   * if (saveRaw) streams.add(rawWaveform.data(), rawADCs.data());
+   * streams.round(nTicks);
+   * @endcode
+   */
+  template <std::size_t MaxStreams>
+  class RoundingStreams {
+
+    std::array<float const*, MaxStreams> fSources {}; ///< Input waveforms.
+    std::array<short*, MaxStreams> fDests {}; ///< Output waveforms.
+    std::size_t fNStreams = 0U; ///< Number of registered streams.
+
+      public:
+
+    /// Registers the conversion of `source` into `dest`.
+    void add(float const* source, short* dest)
+      {
+        assert(fNStreams < MaxStreams);
+        fSources[fNStreams] = source;
+        fDests[fNStreams] = dest;
+        ++fNStreams;
+      }
+
+    /// Returns the number of registered streams.
+    std::size_t size() const { return fNStreams; }
+
+    /// Converts the first `nSamples` of all the registered streams.
+    void round(std::size_t nSamples) const
+      {
+        for (std::size_t tickStart = 0; tickStart < nSamples;
+          tickStart += RoundingTickBlock
+        ) {
+          std::size_t const tickEnd
+            = std::min(tickStart + RoundingTickBlock, nSamples);
+          for (std::size_t iStream = 0; iStream < fNStreams; ++iStream) {
+            float const* const src = fSources[iStream];
+            short* const dest = fDests[iStream];
+            for (std::size_t tick = tickStart; tick < tickEnd; ++tick)
+              dest[tick] = static_cast<short>(std::round(src[tick]));
+          } // for streams
+        } // for tick blocks
+      } // round()
+
+  }; // class RoundingStreams
+
+
+} // namespace daq::details
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCFRAGMENTUNPACKING_H
@@ -38,7 +38,6 @@
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
 #include "tbb/spin_mutex.h"
-#include "tbb/concurrent_vector.h"
 
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -49,6 +48,7 @@
 
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
 #include "icaruscode/Decode/DecoderTools/INoiseFilter.h"
+#include "icaruscode/Decode/DecoderTools/details/ChannelOrderedOutput.h"
 
 #include "icarus_signal_processing/WaveformTools.h"
 
@@ -74,8 +74,8 @@ public:
     using RawDigitCollectionPtr = std::unique_ptr<RawDigitCollection>;
     using WireCollection        = std::vector<recob::Wire>;
     using WireCollectionPtr     = std::unique_ptr<WireCollection>;
-    using ConcurrentRawDigitCol = tbb::concurrent_vector<raw::RawDigit>;
-    using ConcurrentWireCol     = tbb::concurrent_vector<recob::Wire>;
+    using ConcurrentRawDigitCol = daq::details::ChannelOrderedCollection<raw::RawDigit>;
+    using ConcurrentWireCol     = daq::details::ChannelOrderedCollection<recob::Wire>;
 
     // Define data structures for organizing the decoded fragments
     // The idea is to form complete "images" organized by "logical" TPC. Here we are including
@@ -96,6 +96,7 @@ public:
     void processSingleImage(const detinfo::DetectorClocksData&,
                             const ChannelArrayPair&,
                             size_t,
+                            size_t,
                             ConcurrentRawDigitCol&,
                             ConcurrentRawDigitCol&,
                             ConcurrentRawDigitCol&,
@@ -107,6 +108,7 @@ private:
     void processSingleLabel(art::Event&,
                             const art::InputTag&, 
                             detinfo::DetectorClocksData const&,
+                            daq::details::ChannelOrderedLayout&,
                             ChannelArrayPairVec const&,
                             size_t const&,
                             ConcurrentRawDigitCol&,
@@ -114,53 +116,6 @@ private:
                             ConcurrentRawDigitCol&,
                             ConcurrentWireCol&) const;
 
-    class multiThreadImageProcessing
-    {
-    public:
-        multiThreadImageProcessing(MCDecoderICARUSTPCwROI      const& parent,
-                                   detinfo::DetectorClocksData const& clockData,
-                                   ChannelArrayPairVec         const& channelArrayPairVec,
-                                   size_t                      const& coherentNoiseGrouping,
-                                   ConcurrentRawDigitCol&             concurrentRawDigits,
-                                   ConcurrentRawDigitCol&             concurrentRawRawDigits,
-                                   ConcurrentRawDigitCol&             coherentRawDigits,
-                                   ConcurrentWireCol&                 concurrentROIs)
-            : fMCDecoderICARUSTPCwROI(parent),
-              fClockData{clockData},
-              fChannelArrayPairVec(channelArrayPairVec),
-              fCoherentNoiseGrouping(coherentNoiseGrouping),
-              fConcurrentRawDigits(concurrentRawDigits),
-              fConcurrentRawRawDigits(concurrentRawRawDigits),
-              fCoherentRawDigits(coherentRawDigits),
-              fConcurrentROIs(concurrentROIs)
-        {}
-
-        void operator()(const tbb::blocked_range<size_t>& range) const
-        {
-            for (size_t idx = range.begin(); idx < range.end(); idx++)
-            {
-                const ChannelArrayPair& channelArrayPair = fChannelArrayPairVec[idx];
-
-                fMCDecoderICARUSTPCwROI.processSingleImage(fClockData, channelArrayPair, fCoherentNoiseGrouping, fConcurrentRawDigits, fConcurrentRawRawDigits, fCoherentRawDigits, fConcurrentROIs);
-            }
-        }
-    private:
-        const MCDecoderICARUSTPCwROI&      fMCDecoderICARUSTPCwROI;
-        const detinfo::DetectorClocksData& fClockData;
-        const ChannelArrayPairVec&         fChannelArrayPairVec;
-        size_t                             fCoherentNoiseGrouping;
-        ConcurrentRawDigitCol&             fConcurrentRawDigits;
-        ConcurrentRawDigitCol&             fConcurrentRawRawDigits;
-        ConcurrentRawDigitCol&             fCoherentRawDigits;
-        ConcurrentWireCol&                 fConcurrentROIs;
-    };
-
-    // Function to save our RawDigits
-    void saveRawDigits(const icarus_signal_processing::ArrayFloat&, 
-                       const icarus_signal_processing::VectorFloat&, 
-                       const icarus_signal_processing::VectorFloat&,
-                       const icarus_signal_processing::VectorInt&,
-                       ConcurrentRawDigitCol&) const;
 
     // Fcl parameters.
     std::vector<art::InputTag>                                  fRawDigitLabelVec;           ///< The input artdaq fragment label vector (for more than one)
@@ -386,6 +341,9 @@ void MCDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame co
         event.getByLabel(rawDigitLabel, daq_handle);
 	//std::cout << "\nLabel=" << rawDigitLabel << std::endl;
 
+        // Outputs are written in place in channel order, once the input channels are booked
+        daq::details::ChannelOrderedLayout outputLayout;
+
         ConcurrentRawDigitCol concurrentRawDigits;
         ConcurrentRawDigitCol concurrentRawRawDigits;
         ConcurrentRawDigitCol coherentRawDigits;
@@ -413,62 +371,17 @@ void MCDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame co
         auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService>()->DataFor(event);
     
         // ... repackage the input MC data to format suitable for noise processing
-        processSingleLabel(event, rawDigitLabel, clockData, channelArrayPairVec, fCoherentNoiseGrouping, concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
+        processSingleLabel(event, rawDigitLabel, clockData, outputLayout, channelArrayPairVec, fCoherentNoiseGrouping, concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
 
-//        multiThreadImageProcessing imageProcessing(*this, clockData, channelArrayPairVec, fCoherentNoiseGrouping, concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
-//
-//        tbb::parallel_for(tbb::blocked_range<size_t>(0, fNumROPs), imageProcessing);
-    
-        // Copy the raw digits from the concurrent vector to our output vector
-        RawDigitCollectionPtr rawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawDigits.begin()), 
-                                                                                                std::move_iterator(concurrentRawDigits.end()));
-    
-        // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-        std::sort(rawDigitCollection->begin(),rawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-
-        // What did we get back?
-        mf::LogDebug("MCDecoderICARUSTPCwROI") << "****> Total size of map: " << planeIdxToImageMap.size() << std::endl;
-        for(const auto& planeImagePair : planeIdxToImageMap)
-        {
-            mf::LogDebug("MCDecoderICARUSTPCwROI") << "      - plane: " << planeImagePair.first << " has " << planeImagePair.second.size() << " wires" << std::endl;
-        }
-    
-        // Now transfer ownership to the event store
-        event.put(std::move(rawDigitCollection), fOutInstanceLabelVec[instanceIdx]);
+        // Now transfer ownership to the event store, the collections are already in channel order
+        event.put(concurrentRawDigits.release(), fOutInstanceLabelVec[instanceIdx]);
 
         // Do the same to output the candidate ROIs
-        WireCollectionPtr wireCollection = std::make_unique<std::vector<recob::Wire>>(std::move_iterator(concurrentROIs.begin()),
-                                                                                      std::move_iterator(concurrentROIs.end()));
-
-        std::sort(wireCollection->begin(),wireCollection->end(),[](const auto& left, const auto& right){return left.Channel() < right.Channel();});
-
-        event.put(std::move(wireCollection), fOutInstanceLabelVec[instanceIdx]);
-    
-        if (fOutputRawWaveform)
-        {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr rawRawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawRawDigits.begin()), 
-                                                                                                       std::move_iterator(concurrentRawRawDigits.end()));
-    
-            // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(rawRawDigitCollection->begin(),rawRawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
-    
-            // Now transfer ownership to the event store
-            event.put(std::move(rawRawDigitCollection),fOutInstanceLabelVec[instanceIdx] + fOutputRawWavePath);
-        }
-    
-        if (fOutputCorrection)
-        {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr coherentCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(coherentRawDigits.begin()), 
-                                                                                                    std::move_iterator(coherentRawDigits.end()));
+        event.put(concurrentROIs.release(), fOutInstanceLabelVec[instanceIdx]);
     
-            // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(coherentCollection->begin(),coherentCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
+        if (fOutputRawWaveform) event.put(concurrentRawRawDigits.release(),fOutInstanceLabelVec[instanceIdx] + fOutputRawWavePath);
     
-            // Now transfer ownership to the event store
-            event.put(std::move(coherentCollection),fOutInstanceLabelVec[instanceIdx] + fOutputCoherentPath);
-        }
+        if (fOutputCorrection) event.put(coherentRawDigits.release(),fOutInstanceLabelVec[instanceIdx] + fOutputCoherentPath);
 
         instanceIdx++;
     }
@@ -485,6 +398,7 @@ void MCDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame co
 void MCDecoderICARUSTPCwROI::processSingleLabel(art::Event&                        event,
                                                 const art::InputTag&               inputLabel,
                                                 detinfo::DetectorClocksData const& clockData,
+                                                daq::details::ChannelOrderedLayout& outputLayout,
                                                 ChannelArrayPairVec         const& channelArrayPairVec,
                                                 size_t                      const& coherentNoiseGrouping,
                                                 ConcurrentRawDigitCol&             concurrentRawDigits,
@@ -534,17 +448,39 @@ void MCDecoderICARUSTPCwROI::processSingleLabel(art::Event&
 	        mapIter->second[wireIdx] = &rawDigit;
 	    }
 
-	    //std::cout << "boardToRawDigitMap.size()=" << boardToRawDigitMap.size() << std::endl;
-	    //for (auto elem : boardToRawDigitMap) {
-	    tbb::parallel_for (static_cast<std::size_t>(0),boardToRawDigitMap.size(),[&](size_t& r) 
+        // Collect the valid digits of each board and book their outputs, board by board
+        std::vector<std::vector<const raw::RawDigit*>> boardRawDigitVecs;
+        std::vector<size_t>                            firstTicketVec;
+
+        boardRawDigitVecs.reserve(boardToRawDigitMap.size());
+        firstTicketVec.reserve(boardToRawDigitMap.size());
+
+        for(const auto& boardPair : boardToRawDigitMap)
         {
-	        auto elem = std::next(boardToRawDigitMap.begin(),r);
+            firstTicketVec.push_back(outputLayout.size());
 
-	        //std::cout << "board=" << elem->first << " nch=" << elem->second.size() << " first=" << elem->second[0]->Channel() << " last=" << elem->second[elem->second.size()-1]->Channel() << std::endl;
+            std::vector<const raw::RawDigit*>& rawDigitVec = boardRawDigitVecs.emplace_back();
 
-	        std::vector<const raw::RawDigit*> rawDigitVec;
+            for (auto e : boardPair.second)
+            {
+                if (!raw::isValidChannelID(e->Channel())) continue;
+
+                rawDigitVec.push_back(e);
+                outputLayout.book(e->Channel());
+            }
+        }
+
+        outputLayout.prepare();
+
+        concurrentRawDigits = ConcurrentRawDigitCol(outputLayout);
+        concurrentROIs      = ConcurrentWireCol(outputLayout);
+
+        if (fOutputRawWaveform) concurrentRawRawDigits = ConcurrentRawDigitCol(outputLayout);
+        if (fOutputCorrection)  coherentRawDigits      = ConcurrentRawDigitCol(outputLayout);
 
-	        for (auto e : elem->second) if (raw::isValidChannelID(e->Channel())) rawDigitVec.push_back(e);
+	    tbb::parallel_for (static_cast<std::size_t>(0),boardRawDigitVecs.size(),[&](size_t& r) 
+        {
+	        const std::vector<const raw::RawDigit*>& rawDigitVec = boardRawDigitVecs[r];
 
             ChannelArrayPair chanArr;
             for (const auto rawDigit : rawDigitVec) 
@@ -564,8 +500,8 @@ void MCDecoderICARUSTPCwROI::processSingleLabel(art::Event&
 	            chanArr.second.push_back(boardDataVec);
 	        }
 
-	        if (chanArr.second.size() < 64) processSingleImage(clockData, chanArr, chanArr.second.size(), concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
-	        else                            processSingleImage(clockData, chanArr, coherentNoiseGrouping, concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
+	        if (chanArr.second.size() < 64) processSingleImage(clockData, chanArr, chanArr.second.size(), firstTicketVec[r], concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
+	        else                            processSingleImage(clockData, chanArr, coherentNoiseGrouping, firstTicketVec[r], concurrentRawDigits, concurrentRawRawDigits, coherentRawDigits, concurrentROIs);
 	    });
     }
 
@@ -581,6 +517,7 @@ void MCDecoderICARUSTPCwROI::processSingleLabel(art::Event&
 void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksData& clockData,
                                                 const ChannelArrayPair&            channelArrayPair,
                                                 size_t                             coherentNoiseGrouping,
+                                                size_t                             firstTicket,
                                                 ConcurrentRawDigitCol&             concurrentRawDigitCol,
                                                 ConcurrentRawDigitCol&             concurrentRawRawDigitCol,
                                                 ConcurrentRawDigitCol&             coherentRawDigitCol,
@@ -622,6 +559,9 @@ void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksDat
         
         raw::ChannelID_t channel = channelVec[chanIdx].first;
 
+        // This is where the outputs of this channel were booked
+        size_t ticket = firstTicket + chanIdx;
+
         if (fOutputRawWaveform)
         {
             //const icarus_signal_processing::VectorFloat& waveform = decoderTool->getPedCorWaveforms()[chanIdx];
@@ -630,9 +570,9 @@ void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksDat
             // Need to convert from float to short int
             std::transform(waveform.begin(),waveform.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
  
-            ConcurrentRawDigitCol::iterator newRawObjItr = concurrentRawRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+            raw::RawDigit& newRawObj = concurrentRawRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm); 
 
-            newRawObjItr->SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
+            newRawObj.SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
         }
 
         if (fOutputCorrection)
@@ -642,10 +582,9 @@ void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksDat
             // Need to convert from float to short int
             std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
 
-            //ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
-            ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.push_back(raw::RawDigit(channel,wvfm.size(),wvfm)); 
+            raw::RawDigit& newRawObj = coherentRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm);
 
-            newRawObjItr->SetPedestal(0.,0.);
+            newRawObj.SetPedestal(0.,0.);
         }
 
         // Recover the denoised waveform
@@ -665,9 +604,9 @@ void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksDat
         // Need to convert from float to short int
         std::transform(denoised.begin(),denoised.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
 
-        ConcurrentRawDigitCol::iterator newObjItr = concurrentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+        raw::RawDigit& newObj = concurrentRawDigitCol.emplace(ticket, channel,wvfm.size(),wvfm); 
 
-        newObjItr->SetPedestal(localPedestal,localTruncRMS);
+        newObj.SetPedestal(localPedestal,localTruncRMS);
 
         // And, finally, the ROIs 
         const icarus_signal_processing::VectorBool& chanROIs = decoderTool->getROIVals()[chanIdx];
@@ -692,53 +631,12 @@ void MCDecoderICARUSTPCwROI::processSingleImage(const detinfo::DetectorClocksDat
             roiIdx++;
         }
 
-        concurrentROIs.push_back(recob::WireCreator(std::move(ROIVec),channel,fGeometry->View(channel)).move());
+        concurrentROIs.emplace(ticket, recob::WireCreator(std::move(ROIVec),channel,fGeometry->View(channel)).move());
     }//loop over channel indices
 
     return;
 }
 
-void MCDecoderICARUSTPCwROI::saveRawDigits(const icarus_signal_processing::ArrayFloat&  dataArray, 
-                                           const icarus_signal_processing::VectorFloat& pedestalVec,
-                                           const icarus_signal_processing::VectorFloat& rmsVec,
-                                           const icarus_signal_processing::VectorInt&   channelVec,
-                                           ConcurrentRawDigitCol&                       rawDigitCol) const
-{
-    if (!dataArray.empty())
-    {
-        cet::cpu_timer theClockSave;
-
-        theClockSave.start();
-
-        raw::RawDigit::ADCvector_t wvfm(dataArray[0].size());
-
-        mf::LogDebug(fLogCategory) << "    --> saving rawdigits for " << dataArray.size() << " channels" << std::endl;
-
-        // Loop over the channels to recover the RawDigits after filtering
-        for(size_t chanIdx = 0; chanIdx != dataArray.size(); chanIdx++)
-        {
-            // Protect against case where there was no readout 
-            if (channelVec[chanIdx] < 0) continue;
-
-            const icarus_signal_processing::VectorFloat& dataVec = dataArray[chanIdx];
-
-            // Need to convert from float to short int
-            std::transform(dataVec.begin(),dataVec.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
-
-            ConcurrentRawDigitCol::iterator newObjItr = rawDigitCol.emplace_back(channelVec[chanIdx],wvfm.size(),wvfm); 
-            newObjItr->SetPedestal(pedestalVec[chanIdx],rmsVec[chanIdx]);
-        }//loop over channel indices
-
-        theClockSave.stop();
-
-        double totalTime = theClockSave.accumulated_real_time();
-
-        mf::LogDebug(fLogCategory) << "    --> done with save, time: " << totalTime << std::endl;
-    }
-
-    return;
-}
-
 //----------------------------------------------------------------------------
 /// End job method.
 void MCDecoderICARUSTPCwROI::endJob(art::ProcessingFrame const&)
@@ -20,6 +20,7 @@
 
 // C/C++ standard libraries
 #include <algorithm> // std::fill_n()
+#include <cmath> // std::round()
 #include <memory> // std::unique_ptr<>
 #include <utility> // std::move()
 
@@ -47,6 +48,7 @@ class icarus::opdet::ConstantPedestalGeneratorAlg
   
   using ADCcount_t = typename Base_t::ADCcount_t;
   using Timestamp_t = typename Base_t::Timestamp_t;
+  using RoundedADC_t = typename Base_t::RoundedADC_t;
   
   /// Underlying fundamental type of `ADCcount_t`, e.g. `float`.
   using ADCvalue_t = util::value_t<typename Base_t::ADCcount_t>;
@@ -166,6 +168,23 @@ class icarus::opdet::ConstantPedestalGeneratorAlg
     ADCcount_t* begin, std::size_t n
     ) override;
   
+  /**
+   * @brief Overwrites `n` rounded samples starting at `begin` with pedestal.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param begin pointer to the first sample to be overwritten with pedestal
+   * @param n number of samples to fill with pedestal
+   * @return the number of samples actually overwritten with pedestal
+   * 
+   * The pedestal level is handed to the noise generator, which adds the noise
+   * to it and writes the rounded samples directly into the destination
+   * (`NoiseGeneratorAlg::fillRounded()`).
+   */
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time,
+    RoundedADC_t* begin, std::size_t n
+    ) override;
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -240,6 +259,21 @@ std::size_t icarus::opdet::ConstantPedestalGeneratorAlg<ADCT>::doFill(
 } // icarus::opdet::ConstantPedestalGeneratorAlg<>::doFill()
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::ConstantPedestalGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t channel, Timestamp_t time,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  if (fNoiseGen)
+    return fNoiseGen->fillRounded(channel, time, fParams.level, begin, n);
+  std::fill_n
+    (begin, n, static_cast<RoundedADC_t>(std::round(value(fParams.level))));
+  return n;
+} // icarus::opdet::ConstantPedestalGeneratorAlg<>::doFillRounded()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::ConstantPedestalGeneratorAlg<ADCT>::doDump(
@@ -18,7 +18,10 @@
 #include "CLHEP/Random/RandEngine.h" // CLHEP::HepRandomEngine
 
 // C/C++ standard libraries
+#include <array>
 #include <vector>
+#include <algorithm> // std::min()
+#include <cmath> // std::round()
 #include <utility> // std::move()
 
 
@@ -52,10 +55,11 @@ namespace icarus::opdet {
  * Note that unless the random engine is multi-thread safe, this function
  * won't gain anything from multi-threading.
  * 
- * @note Despite the name, the generator limits to generate one sample per call.
- *       It may be possible, if this proved to be a limitation, to extend
- *       `util::FastAndPoorGauss` to generate an array of numbers, in the hope
- *       that the compiler lets vectorization kick in.
+ * Samples are generated in blocks of `BlockSize`: the uniform numbers for a
+ * whole block are requested to the engine at once (`flatArray()`), and the
+ * Gaussian conversion then runs on the block in a tight loop with no calls
+ * into CLHEP. The sequence of random numbers drawn from the engine is the
+ * same as if they were extracted one at a time.
  */
 template <typename ADCT /* = double */>
 class icarus::opdet::FastGaussianNoiseGeneratorAlg
@@ -67,6 +71,7 @@ class icarus::opdet::FastGaussianNoiseGeneratorAlg
   
   using ADCcount_t = typename Base_t::ADCcount_t;
   using Timestamp_t = typename Base_t::Timestamp_t;
+  using RoundedADC_t = typename Base_t::RoundedADC_t;
   
   /// Underlying fundamental type of `ADCcount_t`, e.g. `float`.
   using ADCvalue_t = util::value_t<typename Base_t::ADCcount_t>;
@@ -119,6 +124,9 @@ class icarus::opdet::FastGaussianNoiseGeneratorAlg
   
   using GaussAdapter_t = util::FastAndPoorGauss<32768U, ADCvalue_t>;
   
+  /// Number of samples generated in a single request to the random engine.
+  static constexpr std::size_t BlockSize = 256U;
+  
   // --- BEGIN -- Configuration parameters -------------------------------------
   
   Params_t const fParams; ///< All configuration parameters.
@@ -177,6 +185,23 @@ class icarus::opdet::FastGaussianNoiseGeneratorAlg
     ADCcount_t* begin, std::size_t n
     ) override;
   
+  /**
+   * @brief Overwrites `n` rounded samples with `baseline` plus noise.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param baseline the value the noise is added to
+   * @param begin pointer to the first sample to be overwritten
+   * @param n number of samples to fill
+   * @return the number of samples actually overwritten (always `n`)
+   * 
+   * The noise is generated in blocks and each sample is rounded straight into
+   * the destination, with no intermediate buffer.
+   */
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+    RoundedADC_t* begin, std::size_t n
+    ) override;
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -191,6 +216,20 @@ class icarus::opdet::FastGaussianNoiseGeneratorAlg
   // --- END ---- Virtual interface --------------------------------------------
   
   
+  /**
+   * @brief Generates `n` noise samples and hands them to `op`, in blocks.
+   * @tparam Dest type of the destination samples
+   * @tparam Op type of operation to apply to each sample
+   * @param begin pointer to the first sample to be processed
+   * @param n number of samples to process
+   * 
+   * For each destination sample `dest`, `op(dest, noise)` is called with a new
+   * `noise` sample.
+   */
+  template <typename Dest, typename Op>
+  void generateInBlocks(Dest* begin, std::size_t n, Op op);
+  
+  
   /// Extracts the configuration parameters from a FHiCL configuration.
   static Params_t convert(Config const& config);
   
@@ -230,11 +269,8 @@ std::size_t icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::doAdd(
   raw::Channel_t channel, Timestamp_t time,
   ADCcount_t* begin, std::size_t n
 ) {
-  ADCcount_t* const end = begin + n;
-  while (begin != end) {
-    *(begin++)
-      += static_cast<ADCcount_t>(fParams.RMS*FastGauss(fRandomEngine.flat()));
-  }
+  generateInBlocks
+    (begin, n, [](ADCcount_t& dest, ADCcount_t noise){ dest += noise; });
   return n;
 } // icarus::opdet::FastGaussianNoiseGeneratorAlg<>::doAdd()
 
@@ -245,15 +281,28 @@ std::size_t icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::doFill(
   raw::Channel_t channel, Timestamp_t time,
   ADCcount_t* begin, std::size_t n
 ) {
-  ADCcount_t* const end = begin + n;
-  while (begin != end) {
-    *(begin++)
-      = static_cast<ADCcount_t>(fParams.RMS*FastGauss(fRandomEngine.flat()));
-  }
+  generateInBlocks
+    (begin, n, [](ADCcount_t& dest, ADCcount_t noise){ dest = noise; });
   return n;
 } // icarus::opdet::FastGaussianNoiseGeneratorAlg<>::doFill()
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  generateInBlocks(begin, n, [baseline](RoundedADC_t& dest, ADCcount_t noise)
+    {
+      ADCcount_t const sample = baseline + noise;
+      dest = static_cast<RoundedADC_t>(std::round(value(sample)));
+    });
+  return n;
+} // icarus::opdet::FastGaussianNoiseGeneratorAlg<>::doFillRounded()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::doDump(
@@ -267,6 +316,26 @@ void icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::doDump(
 } // icarus::opdet::FastGaussianNoiseGeneratorAlg<>::doDump()
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+template <typename Dest, typename Op>
+void icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::generateInBlocks
+  (Dest* begin, std::size_t n, Op op)
+{
+  std::array<double, BlockSize> uniform;
+  Dest* const end = begin + n;
+  while (begin != end) {
+    std::size_t const nBlock
+      = std::min(static_cast<std::size_t>(end - begin), BlockSize);
+    fRandomEngine.flatArray(static_cast<int>(nBlock), uniform.data());
+    for (std::size_t i = 0; i < nBlock; ++i) {
+      op(*(begin++),
+        static_cast<ADCcount_t>(fParams.RMS*FastGauss(uniform[i])));
+    }
+  } // while
+} // icarus::opdet::FastGaussianNoiseGeneratorAlg<>::generateInBlocks()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 auto icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCT>::convert
@@ -22,7 +22,10 @@
 #include "CLHEP/Random/RandGaussQ.h"
 
 // C/C++ standard libraries
+#include <array>
 #include <vector>
+#include <algorithm> // std::min()
+#include <cmath> // std::round()
 #include <utility> // std::move()
 
 
@@ -41,7 +44,9 @@ namespace icarus::opdet {
  * `CLHEP::RandGaussQ` adaptor on it.
  * 
  * Generating for any type `ADCT` other that the CLHEP-native `double` requires
- * a conversion and slows down the generation.
+ * a conversion and slows down the generation. In that case, the noise is
+ * extracted in blocks of `BlockSize` samples into a local buffer and then
+ * converted, so that no memory is allocated on each call.
  * 
  */
 template <typename ADCT /* = double */>
@@ -54,6 +59,7 @@ class icarus::opdet::GaussianNoiseGeneratorAlg
   
   using ADCcount_t = typename Base_t::ADCcount_t;
   using Timestamp_t = typename Base_t::Timestamp_t;
+  using RoundedADC_t = typename Base_t::RoundedADC_t;
   
   /// Underlying fundamental type of `ADCcount_t`, e.g. `float`.
   using ADCvalue_t = util::value_t<typename Base_t::ADCcount_t>;
@@ -117,6 +123,9 @@ class icarus::opdet::GaussianNoiseGeneratorAlg
   
   CLHEP::RandGaussQ fGausRandom; ///< Gaussian random extractor adapter.
   
+  /// Number of samples generated in a single request to the random adapter.
+  static constexpr std::size_t BlockSize = 256U;
+  
   
   
   // --- BEGIN -- Virtual interface --------------------------------------------
@@ -162,6 +171,23 @@ class icarus::opdet::GaussianNoiseGeneratorAlg
     ADCcount_t* begin, std::size_t n
     ) override;
   
+  /**
+   * @brief Overwrites `n` rounded samples with `baseline` plus noise.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param baseline the value the noise is added to
+   * @param begin pointer to the first sample to be overwritten
+   * @param n number of samples to fill
+   * @return the number of samples actually overwritten (always `n`)
+   * 
+   * The noise is generated in blocks and each sample is rounded straight into
+   * the destination, with no intermediate buffer.
+   */
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+    RoundedADC_t* begin, std::size_t n
+    ) override;
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -176,6 +202,20 @@ class icarus::opdet::GaussianNoiseGeneratorAlg
   // --- END ---- Virtual interface --------------------------------------------
   
   
+  /**
+   * @brief Generates `n` noise samples and hands them to `op`, in blocks.
+   * @tparam Dest type of the destination samples
+   * @tparam Op type of operation to apply to each sample
+   * @param begin pointer to the first sample to be processed
+   * @param n number of samples to process
+   * 
+   * For each destination sample `dest`, `op(dest, noise)` is called with a new
+   * `noise` sample (in the native `double` type).
+   */
+  template <typename Dest, typename Op>
+  void generateInBlocks(Dest* begin, std::size_t n, Op op);
+  
+  
   /// Extracts the configuration parameters from a FHiCL configuration.
   static Params_t convert(Config const& config);
   
@@ -210,10 +250,9 @@ std::size_t icarus::opdet::GaussianNoiseGeneratorAlg<ADCT>::doAdd(
   raw::Channel_t channel, Timestamp_t time,
   ADCcount_t* begin, std::size_t n
 ) {
-  std::vector<double> noise(n);
-  fGausRandom.fireArray(static_cast<int>(n), noise.data());
-  for (double const sample: noise)
-    *(begin++) += static_cast<ADCcount_t>(sample);
+  generateInBlocks
+    (begin, n, [](ADCcount_t& dest, double noise)
+      { dest += static_cast<ADCcount_t>(noise); });
   return n;
 } // icarus::opdet::GaussianNoiseGeneratorAlg<>::doAdd()
 
@@ -231,15 +270,47 @@ std::size_t icarus::opdet::GaussianNoiseGeneratorAlg<ADCT>::doFill(
     return n;
   }
   else {
-    std::vector<double> noise(n);
-    fGausRandom.fireArray(static_cast<int>(n), noise.data());
-    for (double const sample: noise)
-      *(begin++) = static_cast<ADCcount_t>(sample);
+    generateInBlocks
+      (begin, n, [](ADCcount_t& dest, double noise)
+        { dest = static_cast<ADCcount_t>(noise); });
     return n;
   }
 } // icarus::opdet::GaussianNoiseGeneratorAlg<>::doFill()
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::GaussianNoiseGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  generateInBlocks(begin, n, [baseline](RoundedADC_t& dest, double noise)
+    {
+      ADCcount_t const sample = baseline + static_cast<ADCcount_t>(noise);
+      dest = static_cast<RoundedADC_t>(std::round(value(sample)));
+    });
+  return n;
+} // icarus::opdet::GaussianNoiseGeneratorAlg<>::doFillRounded()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+template <typename Dest, typename Op>
+void icarus::opdet::GaussianNoiseGeneratorAlg<ADCT>::generateInBlocks
+  (Dest* begin, std::size_t n, Op op)
+{
+  std::array<double, BlockSize> noise;
+  Dest* const end = begin + n;
+  while (begin != end) {
+    std::size_t const nBlock
+      = std::min(static_cast<std::size_t>(end - begin), BlockSize);
+    fGausRandom.fireArray(static_cast<int>(nBlock), noise.data());
+    for (std::size_t i = 0; i < nBlock; ++i) op(*(begin++), noise[i]);
+  } // while
+} // icarus::opdet::GaussianNoiseGeneratorAlg<>::generateInBlocks()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::GaussianNoiseGeneratorAlg<ADCT>::doDump(
@@ -15,6 +15,7 @@
 
 // C/C++ standard libraries
 #include <algorithm>
+#include <cmath> // std::round()
 #include <vector>
 #include <utility> // std::move()
 
@@ -41,6 +42,7 @@ class icarus::opdet::NoNoiseGeneratorAlg
   
   using ADCcount_t = typename Base_t::ADCcount_t;
   using Timestamp_t = typename Base_t::Timestamp_t;
+  using RoundedADC_t = typename Base_t::RoundedADC_t;
   
   /// Underlying fundamental type of `ADCcount_t`, e.g. `float`.
   using ADCvalue_t = util::value_t<typename Base_t::ADCcount_t>;
@@ -135,6 +137,12 @@ class icarus::opdet::NoNoiseGeneratorAlg
     ADCcount_t* begin, std::size_t n
     ) override;
   
+  /// Overwrites `n` rounded samples starting at `begin` with `baseline`.
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+    RoundedADC_t* begin, std::size_t n
+    ) override;
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -194,6 +202,18 @@ std::size_t icarus::opdet::NoNoiseGeneratorAlg<ADCT>::doFill
 } // icarus::opdet::NoNoiseGeneratorAlg<ADCT>::doFill()
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::NoNoiseGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t, Timestamp_t, ADCcount_t baseline,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  std::fill_n(begin, n, static_cast<RoundedADC_t>(std::round(value(baseline))));
+  return n;
+} // icarus::opdet::NoNoiseGeneratorAlg<ADCT>::doFillRounded()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::NoNoiseGeneratorAlg<ADCT>::doDump(
@@ -8,15 +8,19 @@
 #ifndef ICARUSCODE_PMT_ALGORITHMS_NOISEGENERATORALG_H
 #define ICARUSCODE_PMT_ALGORITHMS_NOISEGENERATORALG_H
 
+// ICARUS libraries
+#include "icaruscode/Utilities/quantities_utils.h" // util::value()
+
 // LArSoft libraries
 #include <cstdint>  // uint16_t in OpDetWaveform.h
-#include "lardataobj/RawData/OpDetWaveform.h" // raw::Channel_t
+#include "lardataobj/RawData/OpDetWaveform.h" // raw::Channel_t, raw::ADC_Count_t
 
 // C/C++ standard libraries
 #include <ostream>
 #include <sstream>
 #include <algorithm>
 #include <vector>
+#include <cmath> // std::round()
 #include <cstdint> // std::uint64_t
 #include <cstddef> // std::size_t
 #include <cassert>
@@ -86,6 +90,8 @@ class icarus::opdet::NoiseGeneratorAlg {
   
   using Timestamp_t = std::uint64_t; ///< Type of timestamp.
   
+  using RoundedADC_t = raw::ADC_Count_t; ///< Type of the rounded sample value.
+  
   
   virtual ~NoiseGeneratorAlg() = default;
   
@@ -251,6 +257,26 @@ class icarus::opdet::NoiseGeneratorAlg {
     std::vector<ADCcount_t>& samples, std::size_t n
     );
   
+  /**
+   * @brief Overwrites `n` rounded samples starting at `begin` with `baseline`
+   *        plus noise.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param baseline the value the noise is added to
+   * @param begin pointer to the first sample to be overwritten
+   * @param n number of samples to fill
+   * @return the number of samples actually overwritten
+   * 
+   * Each sample is assigned the value `baseline` plus the noise, computed in
+   * `ADCcount_t` as `add()` would, and rounded to the nearest integer.
+   * The same considerations apply as expressed in
+   * `fill(raw::Channel_t, Timestamp_t, ADCcount_t*, std::size_t)`.
+   */
+  std::size_t fillRounded(
+    raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+    RoundedADC_t* begin, std::size_t n
+    );
+  
   /// @}
   // --- END ---- Noise overwrite ----------------------------------------------
   
@@ -335,6 +361,25 @@ class icarus::opdet::NoiseGeneratorAlg {
     ADCcount_t* begin, std::size_t n
     ) = 0;
   
+  /**
+   * @brief Overwrites `n` rounded samples with `baseline` plus noise.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param baseline the value the noise is added to
+   * @param begin pointer to the first sample to be overwritten
+   * @param n number of samples to fill
+   * @return the number of samples actually overwritten
+   * 
+   * The default implementation generates the noise into a temporary buffer
+   * with `doFill()` and then rounds it into the destination.
+   * Implementations generating noise in blocks are encouraged to write the
+   * rounded samples directly instead.
+   */
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+    RoundedADC_t* begin, std::size_t n
+    );
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -484,6 +529,16 @@ std::size_t icarus::opdet::NoiseGeneratorAlg<ADCT>::append(
 }
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::NoiseGeneratorAlg<ADCT>::fillRounded(
+  raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+  RoundedADC_t* begin, std::size_t n
+) {
+  return doFillRounded(channel, time, baseline, begin, n);
+}
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::NoiseGeneratorAlg<ADCT>::dump(
@@ -518,6 +573,27 @@ std::string icarus::opdet::NoiseGeneratorAlg<ADCT>::toString
   { return toString(indent, indent); }
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::NoiseGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t channel, Timestamp_t time, ADCcount_t baseline,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  
+  std::vector<ADCcount_t> noise(n);
+  std::size_t const nSamples = fill(channel, time, noise);
+  assert(nSamples <= n);
+  
+  for (std::size_t i = 0; i < nSamples; ++i) {
+    ADCcount_t const sample = baseline + noise[i];
+    begin[i] = static_cast<RoundedADC_t>(std::round(value(sample)));
+  }
+  
+  return nSamples;
+} // icarus::opdet::NoiseGeneratorAlg<>::doFillRounded()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 std::size_t icarus::opdet::NoiseGeneratorAlg<ADCT>::_fillByAdding(
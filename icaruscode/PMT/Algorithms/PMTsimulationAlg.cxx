@@ -24,13 +24,14 @@
 
 // CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/RandBinomial.h"
 #include "CLHEP/Random/RandPoisson.h"
 #include "CLHEP/Random/RandExponential.h"
 
 // C++ standard libaries
 #include <chrono> // std::chrono::high_resolution_clock
-#include <unordered_map>
 #include <algorithm>
+#include <iterator> // std::next()
 #include <utility> // std::move(), std::cref(), ...
 #include <limits> // std::numeric_limits
 #include <cmath> // std::signbit(), std::pow()
@@ -156,6 +157,17 @@ std::tuple<std::vector<raw::OpDetWaveform>, std::optional<sim::SimPhotons>>
 {
   std::optional<sim::SimPhotons> photons_used;
 
+  if (fParams.windowedSimulation) {
+    PEdeposits_t deposits
+      = CollectPhotoelectrons(photons, lite_photons, photons_used);
+    CollectDarkNoise(deposits);
+    SortAndMergeDeposits(deposits);
+    return {
+      CreateWindowedOpDetWaveforms(photons.OpChannel(), deposits),
+      std::move(photons_used)
+      };
+  }
+
   Waveform_t const waveform = CreateFullWaveform(photons, lite_photons, photons_used);
 
   return {
@@ -189,159 +201,216 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
   const -> Waveform_t
 {
 
-    using namespace util::quantities::time_literals;
     using namespace util::quantities::frequency_literals;
     using namespace util::quantities::electronics_literals;
-    using namespace detinfo::timescales;
-    detinfo::DetectorTimings const& timings = *(fParams.detTimings);
 
     std::uint64_t const waveformStartTS = waveformStartTimestamp();
     
-    tick const endSample = tick::castFrom(fNsamples);
-    
     raw::Channel_t const channel = photons.OpChannel();
 
+    PEdeposits_t const peDeposits
+      = CollectPhotoelectrons(photons, lite_photons, photons_used);
+
     //
-    // collect the amount of photoelectrons arriving at each subtick;
-    // the waveform is split in groups of photons at the same relative subtick
-    // (i.e. first all the photons on the first subtick of a tick, then
-    // all the photons on the second subtick of a tick, and so on);
-    // storage is by subtick group (vector index is the subtick), then by
-    // tick (unordered map index is the tick number).
+    // add the collected photoelectrons to the waveform
+    // (in time order, so that close pulses share the same memory)
     //
-    std::vector<std::unordered_map<tick, unsigned int>> peMaps
-      (wsp.nSubsamples());
+    Waveform_t waveform(fNsamples, 0_ADCf);
+    
+    unsigned int const nTotalPE [[maybe_unused]] // unused if not in `debug` mode
+      = AddPhotoelectronDeposits(waveform, peDeposits.begin(), peDeposits.end());
+    MF_LOG_TRACE("PMTsimulationAlg")
+      << nTotalPE << " photoelectrons at " << peDeposits.size()
+      << " times in channel " << channel
+      ;
 
-    // returns tick and relative subtick number
-    TimeToTickAndSubtickConverter const toTickAndSubtick(peMaps.size());
+      AddPedestal(channel, waveformStartTS, waveform);
+      if(fParams.darkNoiseRate > 0.0_Hz) AddDarkNoise(waveform);
 
-//     auto start = std::chrono::high_resolution_clock::now();
+    // saturation in terms of photoelectrons (sharp);
+    ADCcount const baseline
+      = fPedestalGen->pedestalLevel(channel, waveformStartTS);
+    auto const ADCrange = fParams.ADCrange();
+    ApplySaturation(waveform, baseline, ADCrange);
     
-    if (photons_used) {
-      photons_used->clear();
-      photons_used->SetChannel(channel);
-    }
-    for(auto const& ph : photons) {
-      if (!KicksPhotoelectron()) continue;
+    // clip to the ADC range, 0 -- 2
+    ClipWaveform(waveform, ADCrange.first, ADCrange.second);
+    
+    return waveform;
+  } // CreateFullWaveform()
 
-      if (photons_used) photons_used->push_back(ph); // copy
 
-      simulation_time const photonTime { ph.Time };
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::CollectPhotoelectrons
+  (sim::SimPhotons const& photons,
+   sim::SimPhotonsLite const& lite_photons,
+   std::optional<sim::SimPhotons>& photons_used)
+  const -> PEdeposits_t
+{
+  using namespace util::quantities::time_literals;
+  using namespace detinfo::timescales;
+  detinfo::DetectorTimings const& timings = *(fParams.detTimings);
 
-      trigger_time const mytime
-        = timings.toTriggerTime(photonTime)
-        - fParams.triggerOffsetPMT
-        ;
-      if ((mytime < 0.0_us) || (mytime >= fParams.readoutEnablePeriod)) continue;
-
-      auto const [ tick, subtick ]
-        = toTickAndSubtick(mytime.quantity() * fSampling);
-      /*
-      mf::LogTrace("PMTsimulationAlg")
-        << "Photon at " << photonTime << ", optical time " << mytime
-        << " => tick " << tick_d
-        << " => sample " << tick << " subsample " << subtick
-        ;
-      */
-      if (tick >= endSample) continue;
-      ++peMaps[subtick][tick];
-    } // for photons
+  tick const endSample = tick::castFrom(fNsamples);
 
-//     auto end = std::chrono::high_resolution_clock::now();
-//     std::chrono::duration<double> diff = end-start;
-//     std::cout << "\tcollected pes... " << channel << " " << diff.count() << std::endl;
-//     start=std::chrono::high_resolution_clock::now();
+  //
+  // collect the amount of photoelectrons arriving at each subtick;
+  // the photoelectrons are stored in a flat list of deposits, each with
+  // its tick and relative subtick number; the list is later sorted by time
+  // and the deposits at the same tick and subtick are merged.
+  //
+  PEdeposits_t peDeposits;
+  peDeposits.reserve(photons.size() + lite_photons.DetectedPhotons.size());
 
-    // Add SimPhotonsLite.  Loop over geant ticks (=ns).
+  // returns tick and relative subtick number
+  TimeToTickAndSubtickConverter const toTickAndSubtick(wsp.nSubsamples());
 
-    for(auto const& [ time_ns, nphotons ]: lite_photons.DetectedPhotons) {
+  if (photons_used) {
+    photons_used->clear();
+    photons_used->SetChannel(photons.OpChannel());
+  }
+  for(auto const& ph : photons) {
+    if (!KicksPhotoelectron()) continue;
 
-      // Count photoelectrons.
+    if (photons_used) photons_used->push_back(ph); // copy
 
-      unsigned int nPE = 0;
-      for(int i=0; i<nphotons; ++i) {
-        if(KicksPhotoelectron())
-          ++nPE;
-      }
+    simulation_time const photonTime { ph.Time };
 
-      // Convert photon time bin to ticks.
+    trigger_time const mytime
+      = timings.toTriggerTime(photonTime)
+      - fParams.triggerOffsetPMT
+      ;
+    if ((mytime < 0.0_us) || (mytime >= fParams.readoutEnablePeriod)) continue;
+
+    auto const [ tick, subtick ]
+      = toTickAndSubtick(mytime.quantity() * fSampling);
+    /*
+    mf::LogTrace("PMTsimulationAlg")
+      << "Photon at " << photonTime << ", optical time " << mytime
+      << " => tick " << tick_d
+      << " => sample " << tick << " subsample " << subtick
+      ;
+    */
+    if (tick >= endSample) continue;
+    peDeposits.push_back({ tick, subtick, 1U });
+  } // for photons
 
-      simulation_time const photonTime { time_ns + 0.5 };
-      trigger_time const mytime
-        = timings.toTriggerTime(photonTime)
-        - fParams.triggerOffsetPMT;
-      if ((mytime < 0.0_us) || (mytime >= fParams.readoutEnablePeriod)) continue;
+  // Add SimPhotonsLite.  Loop over geant ticks (=ns).
 
-      auto const [ tick, subtick ]
-        = toTickAndSubtick(mytime.quantity() * fSampling);
-      if (tick < endSample)
-        peMaps[subtick][tick] += nPE;
-    }
+  for(auto const& [ time_ns, nphotons ]: lite_photons.DetectedPhotons) {
 
-    //
-    // add the collected photoelectrons to the waveform
-    //
-    Waveform_t waveform(fNsamples, 0_ADCf);
-    
-    unsigned int nTotalPE [[maybe_unused]] = 0U; // unused if not in `debug` mode
-    double nTotalEffectivePE [[maybe_unused]] = 0U; // unused if not in `debug` mode
+    // Convert photon time bin to ticks.
 
-    auto gainFluctuation = makeGainFluctuator();
+    simulation_time const photonTime { time_ns + 0.5 };
+    trigger_time const mytime
+      = timings.toTriggerTime(photonTime)
+      - fParams.triggerOffsetPMT;
+    if ((mytime < 0.0_us) || (mytime >= fParams.readoutEnablePeriod)) continue;
 
-    // go though all subsamples (starting each at a fraction of a tick)
-    for (auto const& [ iSubsample, peMap ]: util::enumerate(peMaps)) {
+    auto const [ tick, subtick ]
+      = toTickAndSubtick(mytime.quantity() * fSampling);
+    if (tick >= endSample) continue;
 
-      // this is the waveform sampling for the selected subsample:
-      auto const& subsample = wsp.subsample(iSubsample);
+    // Count photoelectrons (only for photons in the readout window).
 
-      for (auto const& [ startTick, nPE ]: peMap) {
-        nTotalPE += nPE;
+    unsigned int const nPE = CountPhotoelectrons(nphotons);
+    if (nPE > 0) peDeposits.push_back({ tick, subtick, nPE });
+  }
 
-        double const nEffectivePE = gainFluctuation(nPE);
-        nTotalEffectivePE += nEffectivePE;
+  SortAndMergeDeposits(peDeposits);
 
-        AddPhotoelectrons(
-          subsample, waveform, startTick,
-          static_cast<WaveformValue_t>(nEffectivePE)
-          );
-        //        std::cout << "Channel=" << channel << ", subsample=" << iSubsample << ", tick=" << startTick << ", nPE=" << nPE << ", ePE=" << nEffectivePE << std::endl;
+  return peDeposits;
+} // icarus::opdet::PMTsimulationAlg::CollectPhotoelectrons()
 
-      } // for sample
-    } // for subsamples
-    MF_LOG_TRACE("PMTsimulationAlg")
-      << nTotalPE << " photoelectrons at "
-      << std::accumulate(
-           peMaps.begin(), peMaps.end(), 0U,
-           [](unsigned int n, auto const& map){ return n + map.size(); }
-         )
-      << " times in channel " << channel
-      ;
 
-//       end=std::chrono::high_resolution_clock::now(); diff = end-start;
-//       std::cout << "\tadded pes... " << channel << " " << diff.count() << std::endl;
-//       start=std::chrono::high_resolution_clock::now();
+//------------------------------------------------------------------------------
+void icarus::opdet::PMTsimulationAlg::CollectDarkNoise
+  (PEdeposits_t& deposits) const
+{
+  /*
+   * Same extraction as in `AddDarkNoise()`, but the photoelectrons are
+   * collected instead of being added to a waveform; the gain fluctuation is
+   * applied when the deposits are added to the waveform.
+   */
+  using namespace util::quantities::frequency_literals;
 
-      AddPedestal(channel, waveformStartTS, waveform);
-      if(fParams.darkNoiseRate > 0.0_Hz) AddDarkNoise(waveform);
+  if (fParams.darkNoiseRate <= 0.0_Hz) return; // no dark noise
 
-//       end=std::chrono::high_resolution_clock::now(); diff = end-start;
-//       std::cout << "\tadded noise... " << channel << " " << diff.count() << std::endl;
-//       start=std::chrono::high_resolution_clock::now();
-      
-    // saturation in terms of photoelectrons (sharp);
-    ADCcount const baseline
-      = fPedestalGen->pedestalLevel(channel, waveformStartTS);
-    auto const ADCrange = fParams.ADCrange();
-    ApplySaturation(waveform, baseline, ADCrange);
+  CLHEP::RandExponential random(*(fParams.darkNoiseRandomEngine),
+    (1.0 / fParams.darkNoiseRate).convertInto<nanosecond>().value());
+
+  nanosecond const maxTime = static_cast<double>(fNsamples) / fSampling;
+
+  TimeToTickAndSubtickConverter const toTickAndSubtick(wsp.nSubsamples());
+
+  for (nanosecond darkNoiseTime { random.fire() }; darkNoiseTime < maxTime;
+    darkNoiseTime += nanosecond{ random.fire() }
+  ) {
+    auto const [ tick, subtick ] = toTickAndSubtick(darkNoiseTime * fSampling);
+    deposits.push_back({ tick, subtick, 1U }); // leakage is one photoelectron
+  } // for
+
+} // icarus::opdet::PMTsimulationAlg::CollectDarkNoise()
+
+
+//------------------------------------------------------------------------------
+void icarus::opdet::PMTsimulationAlg::SortAndMergeDeposits
+  (PEdeposits_t& deposits)
+{
+  auto const byTime = [](PEdeposit_t const& a, PEdeposit_t const& b)
+    {
+      return (a.startTick != b.startTick)
+        ? (a.startTick < b.startTick): (a.subsample < b.subsample);
+    };
+  
+  std::sort(deposits.begin(), deposits.end(), byTime);
+  if (deposits.empty()) return;
+  
+  auto iLast = deposits.begin();
+  for (auto it = std::next(iLast); it != deposits.end(); ++it) {
+    if ((it->startTick == iLast->startTick)
+      && (it->subsample == iLast->subsample)
+    ) {
+      iLast->nPE += it->nPE;
+    }
+    else *(++iLast) = *it;
+  } // for
+  deposits.erase(std::next(iLast), deposits.end());
+  
+} // icarus::opdet::PMTsimulationAlg::SortAndMergeDeposits()
+
+
+//------------------------------------------------------------------------------
+unsigned int icarus::opdet::PMTsimulationAlg::AddPhotoelectronDeposits(
+  Waveform_t& wave,
+  PEdeposits_t::const_iterator begin, PEdeposits_t::const_iterator end,
+  std::size_t firstTick /* = 0U */
+) const {
+  
+  tick const offset = tick::castFrom(firstTick);
+  
+  unsigned int nTotalPE = 0U;
+  
+  auto gainFluctuation = makeGainFluctuator();
+  
+  for (auto it = begin; it != end; ++it) {
+    auto const& [ startTick, iSubsample, nPE ] = *it;
+    assert(startTick >= offset);
+    nTotalPE += nPE;
     
-    // clip to the ADC range, 0 -- 2
-    ClipWaveform(waveform, ADCrange.first, ADCrange.second);
+    double const nEffectivePE = gainFluctuation(nPE);
     
-//       end=std::chrono::high_resolution_clock::now(); diff = end-start;
-//       std::cout << "\tadded saturation... " << channel << " " << diff.count() << std::endl;
+    // the waveform sampling for the subsample is starting at a fraction
+    // of a tick
+    AddPhotoelectrons(
+      wsp.subsample(iSubsample), wave, startTick - offset,
+      static_cast<WaveformValue_t>(nEffectivePE)
+      );
     
-    return waveform;
-  } // CreateFullWaveform()
+  } // for deposits
+  
+  return nTotalPE;
+} // icarus::opdet::PMTsimulationAlg::AddPhotoelectronDeposits()
 
   auto icarus::opdet::PMTsimulationAlg::CreateBeamGateTriggers() const
     -> std::vector<optical_tick>
@@ -505,24 +574,11 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
    */
   
   //
-  // parameters check and setup
+  // setup
   //
   
-  // not a big deal if this assertion fails, but a bit more care needs to be
-  // taken in comparisons and subtractions
-  static_assert(
-    std::is_signed_v<optical_tick::value_t>,
-    "This algorithm requires tick type to be signed."
-    );
-  
   using namespace detinfo::timescales; // electronics_time, time_interval, ...
 
-  auto const pretrigSize = optical_time_ticks::castFrom(fParams.pretrigSize());
-  auto const posttrigSize = optical_time_ticks::castFrom(fParams.posttrigSize());
-  
-  // first viable tick number: since this is the item index in `wvfm`, it's 0
-  optical_tick const firstTick { 0 };
-
   // use hardware trigger time plus the configured offset as waveform start time
   OpDetWaveformMaker_t createOpDetWaveform {
     waveform,
@@ -540,18 +596,58 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
     = fPedestalGen->pedestalLevel(opChannel, waveformStartTimestamp());
   std::vector<optical_tick> const trigger_locations
     = FindTriggers(waveform, baseline);
-  auto const tend = trigger_locations.end();
+  
+  //
+  // collect all buffer ranges and merge them
+  //
+  std::vector<BufferRange_t> const buffers
+    = MakeReadoutBuffers(trigger_locations);
+  
+  //
+  // turn each buffer into a waveform
+  //
+  MF_LOG_TRACE("PMTsimulationAlg")
+    << "Channel #" << opChannel << ": " << buffers.size() << " waveforms for "
+    << trigger_locations.size() << " triggers"
+    ;
+  std::vector<raw::OpDetWaveform> output_opdets;
+  for (BufferRange_t const& buffer: buffers) {
+    
+    output_opdets.push_back(createOpDetWaveform(opChannel, buffer));
+    
+  } // for buffers
+  
+  return output_opdets;
+} // icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::MakeReadoutBuffers
+  (std::vector<optical_tick> const& triggers) const
+  -> std::vector<BufferRange_t>
+{
+  // not a big deal if this assertion fails, but a bit more care needs to be
+  // taken in comparisons and subtractions
+  static_assert(
+    std::is_signed_v<optical_tick::value_t>,
+    "This algorithm requires tick type to be signed."
+    );
+  
+  using detinfo::timescales::optical_time_ticks;
+  
+  auto const pretrigSize = optical_time_ticks::castFrom(fParams.pretrigSize());
+  auto const posttrigSize = optical_time_ticks::castFrom(fParams.posttrigSize());
+  
+  // first viable tick number: since this is the item index in `wvfm`, it's 0
+  optical_tick const firstTick { 0 };
+  
+  auto const tend = triggers.end();
   
   // find the first viable trigger
   auto tooEarlyTrigger = [earliest = firstTick + pretrigSize](optical_tick t)
     { return t < earliest; };
-  auto iNextTrigger
-    = std::find_if_not(trigger_locations.begin(), tend, tooEarlyTrigger);
+  auto iNextTrigger = std::find_if_not(triggers.begin(), tend, tooEarlyTrigger);
   
-  //
-  // collect all buffer ranges and merge them
-  //
-  using BufferRange_t = OpDetWaveformMaker_t::BufferRange_t;
   auto makeBuffer
     = [pretrigSize, posttrigSize](optical_tick triggerTime) -> BufferRange_t
     { return { triggerTime - pretrigSize, triggerTime + posttrigSize }; }
@@ -560,7 +656,7 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
   std::vector<BufferRange_t> buffers;
   buffers.reserve(std::distance(iNextTrigger, tend)); // worst case
   
-  auto lastBufferEnd{ firstTick - detinfo::timescales::optical_time_ticks{ 1 }};
+  auto lastBufferEnd{ firstTick - optical_time_ticks{ 1 }};
   while (iNextTrigger != tend) {
     
     BufferRange_t const buffer = makeBuffer(*iNextTrigger);
@@ -576,22 +672,200 @@ icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms
     ++iNextTrigger;
   } // while
   
+  return buffers;
+} // icarus::opdet::PMTsimulationAlg::MakeReadoutBuffers()
+
+
+//------------------------------------------------------------------------------
+auto icarus::opdet::PMTsimulationAlg::FindSimulationWindows(
+  PEdeposits_t const& deposits,
+  std::vector<optical_tick> const& beamGateTriggers
+) const -> std::vector<SimulationWindow_t> {
+  
+  /*
+   * Each photoelectron deposit has activity for the duration of the single
+   * photoelectron response, and each beam gate trigger for a single tick.
+   * Each activity region is padded with enough samples to fill readout
+   * buffers from triggers anywhere within it; padded regions which overlap or
+   * touch are merged.
+   * Both inputs are sorted, so the activity regions are sorted by start.
+   */
+  std::size_t const pretrigSize = fParams.pretrigSize();
+  std::size_t const posttrigSize = fParams.posttrigSize();
+  std::size_t const pulseLength = wsp.pulseLength();
+  
+  std::vector<SimulationWindow_t> windows;
+  
+  auto addActivity = [&windows,pretrigSize,posttrigSize,this]
+    (std::size_t start, std::size_t end)
+    {
+      SimulationWindow_t const window{
+        (start > pretrigSize)? start - pretrigSize: 0U, // start
+        std::min(end + posttrigSize, fNsamples),        // end
+        start,                                          // signalStart
+        end                                             // signalEnd
+        };
+      if (windows.empty() || (window.start > windows.back().end)) {
+        windows.push_back(window);
+        return;
+      }
+      SimulationWindow_t& last = windows.back();
+      last.end = std::max(last.end, window.end);
+      last.signalStart = std::min(last.signalStart, window.signalStart);
+      last.signalEnd = std::max(last.signalEnd, window.signalEnd);
+    };
+  
+  auto iDeposit = deposits.begin();
+  auto const dend = deposits.end();
+  auto iTrigger = beamGateTriggers.begin();
+  auto const tend = beamGateTriggers.end();
+  while ((iDeposit != dend) || (iTrigger != tend)) {
+    
+    if ((iTrigger == tend)
+      || ((iDeposit != dend) && (iDeposit->startTick.value() < iTrigger->value()))
+    ) {
+      auto const start = static_cast<std::size_t>(iDeposit->startTick.value());
+      addActivity(start, start + pulseLength);
+      ++iDeposit;
+    }
+    else {
+      if (iTrigger->value() >= 0) {
+        auto const start = static_cast<std::size_t>(iTrigger->value());
+        addActivity(start, start + 1U);
+      }
+      ++iTrigger;
+    }
+    
+  } // while
+  
+  return windows;
+} // icarus::opdet::PMTsimulationAlg::FindSimulationWindows()
+
+
+//------------------------------------------------------------------------------
+std::vector<raw::OpDetWaveform>
+icarus::opdet::PMTsimulationAlg::CreateWindowedOpDetWaveforms
+  (raw::Channel_t channel, PEdeposits_t const& deposits) const
+{
+  /*
+   * Plan:
+   * 
+   * 1. determine the regions to simulate from the photoelectron times
+   * 2. simulate each region separately, and discriminate it
+   *    (with the triggers in each region which can have a full readout buffer
+   *    within that region)
+   * 3. merge the triggers into buffers like in the full simulation
+   * 4. create the actual `raw::OpDetWaveform` objects from the region
+   *    containing each buffer
+   */
+  using namespace util::quantities::electronics_literals;
+  using namespace detinfo::timescales; // electronics_time, time_interval, ...
+  
+  std::vector<optical_tick> const beamGateTriggers
+    = fParams.createBeamGateTriggers
+    ? CreateBeamGateTriggers(): std::vector<optical_tick>{};
+  
+  std::vector<SimulationWindow_t> const windows
+    = FindSimulationWindows(deposits, beamGateTriggers);
+  
+  std::uint64_t const waveformStartTS = waveformStartTimestamp();
+  ADCcount const baseline
+    = fPedestalGen->pedestalLevel(channel, waveformStartTS);
+  auto const ADCrange = fParams.ADCrange();
+  
   //
-  // turn each buffer into a waveform
+  // simulate each window, and collect its triggers
   //
+  std::vector<Waveform_t> windowWaveforms;
+  windowWaveforms.reserve(windows.size());
+  std::vector<optical_tick> trigger_locations;
+  
+  auto iDeposit = deposits.begin();
+  for (SimulationWindow_t const& window: windows) {
+    
+    auto const iFirstDeposit = iDeposit;
+    while ((iDeposit != deposits.end())
+      && (std::size_t(iDeposit->startTick.value()) < window.end)
+    ) {
+      ++iDeposit;
+    }
+    
+    Waveform_t& waveform
+      = windowWaveforms.emplace_back(window.end - window.start, 0_ADCf);
+    
+    AddPhotoelectronDeposits(waveform, iFirstDeposit, iDeposit, window.start);
+    
+    nanosecond const windowOffset
+      = static_cast<double>(window.start) / fSampling;
+    AddPedestal(channel,
+      waveformStartTS
+        + static_cast<std::uint64_t>(std::round(windowOffset.value())),
+      waveform
+      );
+    
+    ApplySaturation(waveform, baseline, ADCrange);
+    ClipWaveform(waveform, ADCrange.first, ADCrange.second);
+    
+    for (optical_tick const trigger: (this->*fDiscrAlgo)(waveform, baseline)) {
+      std::size_t const t = window.start + trigger.value();
+      if ((t < window.signalStart) || (t >= window.signalEnd)) continue;
+      trigger_locations.push_back(optical_tick::castFrom(t));
+    } // for triggers
+    
+  } // for windows
+  assert(iDeposit == deposits.end());
+  
+  trigger_locations.insert(trigger_locations.end(),
+    beamGateTriggers.begin(), beamGateTriggers.end());
+  std::inplace_merge(
+    trigger_locations.begin(),
+    trigger_locations.end() - beamGateTriggers.size(),
+    trigger_locations.end()
+    );
+  
+  //
+  // turn each buffer into a waveform, from the window it lies in
+  //
+  std::vector<BufferRange_t> const buffers
+    = MakeReadoutBuffers(trigger_locations);
+  
   MF_LOG_TRACE("PMTsimulationAlg")
-    << "Channel #" << opChannel << ": " << buffers.size() << " waveforms for "
-    << trigger_locations.size() << " triggers"
+    << "Channel #" << channel << ": " << buffers.size() << " waveforms for "
+    << trigger_locations.size() << " triggers from " << windows.size()
+    << " simulated regions"
     ;
+  
+  electronics_time const PMTstartTime = fParams.detTimings->TriggerTime()
+    + time_interval{ fParams.triggerOffsetPMT };
+  nanosecond const samplingPeriod = 1.0 / fSampling;
+  
   std::vector<raw::OpDetWaveform> output_opdets;
+  output_opdets.reserve(buffers.size());
+  std::size_t iWindow = 0;
   for (BufferRange_t const& buffer: buffers) {
     
-    output_opdets.push_back(createOpDetWaveform(opChannel, buffer));
+    // buffers never span more than one window
+    while ((iWindow + 1 < windows.size())
+      && (windows[iWindow].end <= std::size_t(buffer.first.value()))
+    ) {
+      ++iWindow;
+    }
+    SimulationWindow_t const& window = windows[iWindow];
+    
+    OpDetWaveformMaker_t const createOpDetWaveform {
+      windowWaveforms[iWindow],
+      PMTstartTime + window.start * samplingPeriod,
+      samplingPeriod
+      };
+    optical_time_ticks const shift
+      = optical_time_ticks::castFrom(window.start);
+    output_opdets.push_back(createOpDetWaveform
+      (channel, { buffer.first - shift, buffer.second - shift }));
     
   } // for buffers
   
   return output_opdets;
-} // icarus::opdet::PMTsimulationAlg::CreateFixedSizeOpDetWaveforms()
+} // icarus::opdet::PMTsimulationAlg::CreateWindowedOpDetWaveforms()
 
 
 // -----------------------------------------------------------------------------
@@ -599,6 +873,17 @@ bool icarus::opdet::PMTsimulationAlg::KicksPhotoelectron() const
   { return CLHEP::RandFlat::shoot(fParams.randomEngine) < fQE; }
 
 
+// -----------------------------------------------------------------------------
+unsigned int icarus::opdet::PMTsimulationAlg::CountPhotoelectrons
+  (int nPhotons) const
+{
+  if (nPhotons <= 0) return 0U;
+  if (fQE >= 1.0) return nPhotons; // as `KicksPhotoelectron()` would do
+  return static_cast<unsigned int>
+    (CLHEP::RandBinomial::shoot(fParams.randomEngine, nPhotons, fQE));
+} // icarus::opdet::PMTsimulationAlg::CountPhotoelectrons()
+
+
 // -----------------------------------------------------------------------------
 void icarus::opdet::PMTsimulationAlg::AddPhotoelectrons(
   PulseSampling_t const& pulse, Waveform_t& wave, tick const time_bin,
@@ -627,7 +912,7 @@ void icarus::opdet::PMTsimulationAlg::AddPulseShape(
   ) const
 {
   std::size_t const min = time_bin.value();
-  std::size_t const max = std::min(min + pulse.size(), fNsamples);
+  std::size_t const max = std::min(min + pulse.size(), wave.size());
   if (min >= max) return;
 
   std::transform(
@@ -905,6 +1190,7 @@ icarus::opdet::PMTsimulationAlgMaker::PMTsimulationAlgMaker
   fBaseConfig.beamGateTriggerRepPeriod = microsecond(config.BeamGateTriggerRepPeriod());
   fBaseConfig.beamGateTriggerNReps     = config.BeamGateTriggerNReps();
   fBaseConfig.discrimAlgo              = config.getDiscriminationAlgo();
+  fBaseConfig.windowedSimulation       = config.WindowedSimulation();
 
   //
   // parameter checks
@@ -309,6 +309,36 @@ class icarus::opdet::OpDetWaveformMakerClass {
  *       suppressed, and if the readout buffer is longer than the single
  *       photoelectron response (as it should) the tail of the buffer will
  *       always contain just noise.
+ * * `WindowedSimulation` (default: `false`): simulates only the time regions
+ *     around photoelectrons (including dark noise ones) and beam gate
+ *     triggers, instead of the whole readout enable period; see
+ *     @ref ICARUS_PMTSimulationAlg_Windowed "below".
+ *
+ *
+ * Windowed simulation
+ * --------------------
+ *
+ * @anchor ICARUS_PMTSimulationAlg_Windowed
+ *
+ * By default, the full waveform of each channel is simulated over the whole
+ * readout enable period (for example, one million samples for 2 ms at
+ * 500 MHz), and zero suppression then keeps only the readout buffers around
+ * the interest points.
+ *
+ * When `WindowedSimulation` is enabled, the times of all the photoelectrons
+ * (from scintillation and from dark noise) are extracted first. Each of them
+ * defines a signal region as long as the single photoelectron response,
+ * extended on each side by the pre-trigger and post-trigger buffer sizes;
+ * overlapping regions are merged. Beam gate interest points define regions
+ * as well. Pedestal, electronics noise, saturation and discrimination are
+ * then simulated only within these regions, each one with its own short
+ * waveform, and readout buffers are built out of them in the same way as in
+ * the full simulation.
+ *
+ * The result is statistically equivalent to the full simulation, except that
+ * interest points caused by electronics noise alone, far from any
+ * photoelectron, are not simulated. With the standard thresholds these are
+ * expected at a rate well below one per event.
  *
  *
  * Random number generators
@@ -465,6 +495,9 @@ class icarus::opdet::PMTsimulationAlg {
     /// Which waveform discrimination algorithm to use for zero suppression.
     DiscriminationAlgo discrimAlgo = DiscriminationAlgo::CrossingThreshold;
 
+    /// Simulate only the regions around photoelectrons and beam gate triggers.
+    bool windowedSimulation = false;
+
     bool createBeamGateTriggers; ///< Option to create unbiased readout around beam spill
     microsecond beamGateTriggerRepPeriod; ///< Repetition Period (us) for BeamGateTriggers TODO make this a time_interval
     size_t beamGateTriggerNReps; ///< Number of beamgate trigger reps to produce
@@ -570,6 +603,8 @@ class icarus::opdet::PMTsimulationAlg {
   
   /// Type internally used for storing waveforms.
   using Waveform_t = OpDetWaveformMaker_t::WaveformData_t;
+  /// Range of ticks of a readout buffer.
+  using BufferRange_t = OpDetWaveformMaker_t::BufferRange_t;
   /// Numeric type in waveforms.
   using WaveformValue_t = util::value_t<ADCcount>;
 
@@ -626,6 +661,25 @@ class icarus::opdet::PMTsimulationAlg {
 
   // --- END -- Helper functors ------------------------------------------------
 
+  using SubsampleIndex_t = TimeToTickAndSubtickConverter::SubsampleIndex_t;
+
+  /// Photoelectrons arriving on the same tick and subtick.
+  struct PEdeposit_t {
+    tick startTick;             ///< Tick the deposit is on.
+    SubsampleIndex_t subsample; ///< Subtick the deposit is on.
+    unsigned int nPE;           ///< Number of photoelectrons.
+  }; // PEdeposit_t
+
+  using PEdeposits_t = std::vector<PEdeposit_t>;
+
+  /// A region of the readout enable period simulated in windowed mode.
+  struct SimulationWindow_t {
+    std::size_t start;       ///< First tick of the region.
+    std::size_t end;         ///< Tick after the last one of the region.
+    std::size_t signalStart; ///< First tick with photoelectron activity.
+    std::size_t signalEnd;   ///< Tick after the last one with activity.
+  }; // SimulationWindow_t
+
 
   ConfigurationParameters_t fParams; ///< Complete algorithm configuration.
 
@@ -666,6 +720,77 @@ class icarus::opdet::PMTsimulationAlg {
     std::optional<sim::SimPhotons>& photons_used
     ) const;
   
+  /**
+   * @brief Returns the photoelectrons from `photons` within the readout period.
+   * @param photons the simulated list of photons
+   * @param lite_photons the simulated photons, in "lite" format
+   * @param photons_used (_output_) list of used photoelectrons
+   * @return the photoelectron deposits, sorted by time
+   *
+   * Quantum efficiency is applied here. Deposits on the same tick and subtick
+   * are merged.
+   */
+  PEdeposits_t CollectPhotoelectrons(
+    sim::SimPhotons const& photons,
+    sim::SimPhotonsLite const& lite_photons,
+    std::optional<sim::SimPhotons>& photons_used
+    ) const;
+  
+  /// Appends to `deposits` the dark noise photoelectrons of the whole readout
+  /// enable period (not sorted).
+  void CollectDarkNoise(PEdeposits_t& deposits) const;
+  
+  /// Sorts `deposits` by time and merges the ones on the same subtick.
+  static void SortAndMergeDeposits(PEdeposits_t& deposits);
+  
+  /**
+   * @brief Adds photoelectron deposits to a waveform.
+   * @param wave the waveform to add the photoelectrons to
+   * @param begin iterator to the first deposit to be added
+   * @param end iterator past the last deposit to be added
+   * @param firstTick the tick of the first sample of `wave`
+   * @return the number of photoelectrons added
+   *
+   * Gain fluctuations are applied to each deposit.
+   */
+  unsigned int AddPhotoelectronDeposits(
+    Waveform_t& wave,
+    PEdeposits_t::const_iterator begin, PEdeposits_t::const_iterator end,
+    std::size_t firstTick = 0U
+    ) const;
+  
+  /**
+   * @brief Returns the regions to be simulated in windowed mode.
+   * @param deposits all the photoelectron deposits, sorted by time
+   * @param beamGateTriggers the beam gate interest points, sorted
+   * @return the simulation regions, sorted and non-contiguous
+   * 
+   * See the @ref ICARUS_PMTSimulationAlg_Windowed "class documentation".
+   */
+  std::vector<SimulationWindow_t> FindSimulationWindows(
+    PEdeposits_t const& deposits,
+    std::vector<optical_tick> const& beamGateTriggers
+    ) const;
+  
+  /**
+   * @brief Simulates the waveforms of a channel only around its activity.
+   * @param channel number of optical detector channel to simulate
+   * @param deposits all the photoelectron deposits, sorted by time
+   * @return a collection of `raw::OpDetWaveform`
+   * 
+   * This is the windowed alternative to `CreateFullWaveform()` followed by
+   * `CreateFixedSizeOpDetWaveforms()`; see the
+   * @ref ICARUS_PMTSimulationAlg_Windowed "class documentation".
+   */
+  std::vector<raw::OpDetWaveform> CreateWindowedOpDetWaveforms
+    (raw::Channel_t channel, PEdeposits_t const& deposits) const;
+  
+  /// Returns the readout buffers around the sorted `triggers`, merging the
+  /// overlapping and contiguous ones, and skipping the triggers too early to
+  /// have a full pre-trigger buffer.
+  std::vector<BufferRange_t> MakeReadoutBuffers
+    (std::vector<optical_tick> const& triggers) const;
+  
   /**
    * @brief Creates `raw::OpDetWaveform` objects from a waveform data.
    * @param opChannel number of optical detector channel the data belongs to
@@ -879,6 +1004,11 @@ class icarus::opdet::PMTsimulationAlg {
   /// Returns a random response whether a photon generates a photoelectron.
   bool KicksPhotoelectron() const;
   
+  /// Returns a random number of photoelectrons out of `nPhotons` photons
+  /// (a single binomial extraction, equivalent to `KicksPhotoelectron()` on
+  /// each of them).
+  unsigned int CountPhotoelectrons(int nPhotons) const;
+  
   /// Returns the ADC range allowed for photoelectron saturation.
   std::pair<ADCcount, ADCcount> saturationRange(ADCcount baseline) const;
   
@@ -1053,6 +1183,12 @@ class icarus::opdet::PMTsimulationAlgMaker {
       PMTsimulationAlg::DiscrimAlgoSelector.get
         (DiscriminationAlgo::CrossingThreshold).name()
       };
+    fhicl::Atom<bool> WindowedSimulation {
+      Name("WindowedSimulation"),
+      Comment
+        ("simulate only the regions around photoelectrons and beam gate triggers"),
+      false
+      };
 
     /// Returns the discrimination algorithm as a `DiscriminationAlgo` value.
     DiscriminationAlgo getDiscriminationAlgo() const;
@@ -1213,6 +1349,9 @@ void icarus::opdet::PMTsimulationAlg::printConfiguration
   }
   else out << '\n' << indent << "Do not create beam gate triggers.";
 
+  if (fParams.windowedSimulation)
+    out << '\n' << indent << "Simulate only around photoelectrons.";
+
   out << '\n' << indent << "... and more.";
 
   out << '\n' << indent << "Template photoelectron waveform settings:"
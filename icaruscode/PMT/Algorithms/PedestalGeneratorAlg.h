@@ -8,9 +8,12 @@
 #ifndef ICARUSCODE_PMT_ALGORITHMS_PEDESTALGENERATORALG_H
 #define ICARUSCODE_PMT_ALGORITHMS_PEDESTALGENERATORALG_H
 
+// ICARUS libraries
+#include "icaruscode/Utilities/quantities_utils.h" // util::value()
+
 // LArSoft libraries
 #include <cstdint>  // uint16_t in OpDetWaveform.h
-#include "lardataobj/RawData/OpDetWaveform.h" // raw::Channel_t
+#include "lardataobj/RawData/OpDetWaveform.h" // raw::Channel_t, raw::ADC_Count_t
 
 // C/C++ standard libraries
 #include <ostream>
@@ -18,6 +21,7 @@
 #include <algorithm>
 #include <vector>
 #include <limits> // std::numeric_limits
+#include <cmath> // std::round()
 #include <cstdint> // std::uint64_t
 #include <cstddef> // std::size_t
 #include <cassert>
@@ -92,6 +96,8 @@ class icarus::opdet::PedestalGeneratorAlg {
   
   using Timestamp_t = std::uint64_t; ///< Type of timestamp.
   
+  using RoundedADC_t = raw::ADC_Count_t; ///< Type of the rounded sample value.
+  
   
   /// Special pedestal value to express no knowledge of the pedestal.
   static constexpr ADCcount_t NoPedestalLevel
@@ -274,6 +280,25 @@ class icarus::opdet::PedestalGeneratorAlg {
     std::vector<ADCcount_t>& samples, std::size_t n
     );
   
+  /**
+   * @brief Overwrites `n` rounded samples starting at `begin` with pedestal.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param begin pointer to the first sample to be overwritten with pedestal
+   * @param n number of samples to fill with pedestal
+   * @return number of samples actually overwritten with pedestal
+   * @see `fill(raw::Channel_t, Timestamp_t, ADCcount_t*, std::size_t)`
+   * 
+   * Each sample has the value `fill()` would assign it, rounded to the nearest
+   * integer.
+   * Whether an intermediate buffer in `ADCcount_t` is used depends on the
+   * implementation (see `doFillRounded()`).
+   */
+  std::size_t fillRounded(
+    raw::Channel_t channel, Timestamp_t time,
+    RoundedADC_t* begin, std::size_t n
+    );
+  
   /// @}
   // --- END ---- Pedestal overwrite -------------------------------------------
   
@@ -371,6 +396,23 @@ class icarus::opdet::PedestalGeneratorAlg {
     ADCcount_t* begin, std::size_t n
     ) = 0;
   
+  /**
+   * @brief Overwrites `n` rounded samples starting at `begin` with pedestal.
+   * @param channel ID of the readout channel the samples are from
+   * @param time the absolute time of the first sample being filled [UTC, ns]
+   * @param begin pointer to the first sample to be overwritten with pedestal
+   * @param n number of samples to fill with pedestal
+   * @return the number of samples actually overwritten with pedestal
+   * 
+   * The default implementation generates the pedestal with `doFill()` into a
+   * buffer owned by this object (reused across calls), and then rounds it into
+   * the destination.
+   */
+  virtual std::size_t doFillRounded(
+    raw::Channel_t channel, Timestamp_t time,
+    RoundedADC_t* begin, std::size_t n
+    );
+  
   /**
    * @brief Prints into the stream the parameters of this algorithm.
    * @param out the C++ output stream to write into
@@ -439,6 +481,12 @@ class icarus::opdet::PedestalGeneratorAlg {
   
   // --- END ---- Convenience implementation functions -------------------------
   
+  
+    private:
+  
+  /// Buffer for the default `doFillRounded()`.
+  std::vector<ADCcount_t> fRoundingBuffer;
+  
 }; // icarus::opdet::PedestalGeneratorAlg
 
 
@@ -529,6 +577,37 @@ std::size_t icarus::opdet::PedestalGeneratorAlg<ADCT>::append(
 }
 
 
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::PedestalGeneratorAlg<ADCT>::fillRounded(
+  raw::Channel_t channel, Timestamp_t time,
+  RoundedADC_t* begin, std::size_t n
+) {
+  return doFillRounded(channel, time, begin, n);
+}
+
+
+// -----------------------------------------------------------------------------
+template <typename ADCT>
+std::size_t icarus::opdet::PedestalGeneratorAlg<ADCT>::doFillRounded(
+  raw::Channel_t channel, Timestamp_t time,
+  RoundedADC_t* begin, std::size_t n
+) {
+  using util::value;
+  
+  fRoundingBuffer.resize(n);
+  std::size_t const nSamples
+    = fill(channel, time, fRoundingBuffer.data(), n);
+  assert(nSamples <= n);
+  
+  ADCcount_t const* const src = fRoundingBuffer.data();
+  for (std::size_t i = 0; i < nSamples; ++i)
+    begin[i] = static_cast<RoundedADC_t>(std::round(value(src[i])));
+  
+  return nSamples;
+} // icarus::opdet::PedestalGeneratorAlg<>::doFillRounded()
+
+
 // -----------------------------------------------------------------------------
 template <typename ADCT>
 void icarus::opdet::PedestalGeneratorAlg<ADCT>::dump(
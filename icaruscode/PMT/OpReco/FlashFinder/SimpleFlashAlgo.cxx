@@ -2,7 +2,10 @@
 #define SIMPLEFLASHALGO_CXX
 
 #include "SimpleFlashAlgo.h"
+#include <algorithm>
+#include <limits>
 #include <set>
+#include <utility>
 namespace pmtana{
     
     static SimpleFlashAlgoFactory __SimpleFlashAlgoFactoryStaticObject__;
@@ -109,13 +112,20 @@ namespace pmtana{
     LiteOpFlashArray_t SimpleFlashAlgo::RecoFlash(const LiteOpHitArray_t ophits) {
         
         Reset();
+        return FindFlashes(ophits);
+    }
+    
+    LiteOpFlashArray_t SimpleFlashAlgo::FindFlashes(const LiteOpHitArray_t& ophits) const {
+        
+        // All the work buffers are local and only the time bins with hits are
+        // stored, together with the PE of the PMTs actually hit in each of them.
+        // Sums are accumulated in the same order as the dense (bin x PMT)
+        // algorithm did, so the results are identical to it.
+        
+        LiteOpFlashArray_t res;
+        
         size_t max_ch = _opch_to_index_v.size() - 1;
-        size_t NOpDet = _index_to_opch_v.size();
         
-        //static std::vector<double> pesum_v;
-        static std::vector<double> mult_v;  //< this is not strictly a multiplicity of PMTs, but multiplicity of hits
-        static std::vector<std::vector<double> > pespec_v;
-        static std::vector<std::vector<unsigned int> > hitidx_v;
         double min_time=1.1e20;
         double max_time=1.1e20;
         for(auto const& oph : ophits) {
@@ -128,18 +138,10 @@ namespace pmtana{
             std::cout << "T span: " << min_time << " => " << max_time << " ... " << (size_t)((max_time - min_time) / _time_res) << std::endl;
         
         size_t nbins_pesum_v = (size_t)((max_time - min_time) / _time_res) + 1;
-        if(_pesum_v.size() < nbins_pesum_v) _pesum_v.resize(nbins_pesum_v,0);
-        if(mult_v.size()   < nbins_pesum_v) mult_v.resize(nbins_pesum_v,0);
-        if(pespec_v.size() < nbins_pesum_v) pespec_v.resize(nbins_pesum_v,std::vector<double>(NOpDet));
-        if(hitidx_v.size() < nbins_pesum_v) hitidx_v.resize(nbins_pesum_v,std::vector<unsigned int>());
-        for(size_t i=0; i<_pesum_v.size(); ++i) {
-            _pesum_v[i] = 0;
-            mult_v[i]  = 0;
-            hitidx_v[i].clear();
-            for(auto& v : pespec_v[i]) v=0;
-        }
         
-        // Fill _pesum_v
+        // Assign the usable hits to time bins: (bin index, hit index)
+        std::vector<std::pair<size_t,unsigned int> > binned_v;
+        binned_v.reserve(ophits.size());
         for(size_t hitidx = 0; hitidx < ophits.size(); ++hitidx) {
             auto const& oph = ophits[hitidx];
             if(oph.channel > max_ch || _opch_to_index_v[oph.channel] < 0) {
@@ -150,95 +152,132 @@ namespace pmtana{
                 if(_debug) std::cout << "Ignoring hit @ time " << oph.peak_time << std::endl;
                 continue;
             }
-	    if(oph.pe <= 0.) continue;
-	    if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
+            if(oph.pe <= 0.) continue;
+            if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
             size_t index = (size_t)((oph.peak_time - min_time) / _time_res);
-            _pesum_v[index] += oph.pe;
-            mult_v[index] += 1;
-            pespec_v[index][_opch_to_index_v[oph.channel]] += oph.pe;
-            hitidx_v[index].push_back(hitidx);
+            binned_v.emplace_back(index, hitidx);
+        }
+        // hits stay in their original order within each bin
+        std::sort(binned_v.begin(), binned_v.end());
+        
+        // Fill the non-empty bins, sorted by index
+        std::vector<PEBin_t> bin_v;
+        std::vector<unsigned int> hitidx_v; // hit indices, by bin
+        std::vector<std::pair<size_t,double> > pespec_v; // (PMT index, PE), by bin
+        hitidx_v.reserve(binned_v.size());
+        pespec_v.reserve(binned_v.size());
+        for(auto const& index_hit : binned_v) {
+            auto const& oph = ophits[index_hit.second];
+            if(bin_v.empty() || bin_v.back().index != index_hit.first) {
+                bin_v.push_back(PEBin_t{ index_hit.first, 0., 0.,
+                                         hitidx_v.size(), hitidx_v.size(),
+                                         pespec_v.size(), pespec_v.size() });
+            }
+            auto& bin = bin_v.back();
+            bin.pesum += oph.pe;
+            bin.mult += 1;
+            hitidx_v.push_back(index_hit.second);
+            bin.hit_end = hitidx_v.size();
+            
+            size_t pmt_index = _opch_to_index_v[oph.channel];
+            auto pmt_iter = pespec_v.begin() + bin.pmt_begin;
+            while(pmt_iter != pespec_v.end() && pmt_iter->first != pmt_index) ++pmt_iter;
+            if(pmt_iter == pespec_v.end()) {
+                pespec_v.emplace_back(pmt_index, 0.);
+                pmt_iter = pespec_v.end() - 1;
+                bin.pmt_end = pespec_v.size();
+            }
+            pmt_iter->second += oph.pe;
         }
         
-        // Order by pe (above threshold)
-        std::map<double,size_t> pesum_idx_map;
-        for(size_t idx=0; idx<nbins_pesum_v; ++idx) {
-            if(_pesum_v[idx] < _min_pe_coinc   ) continue;
-            if(mult_v[idx]  < _min_mult_coinc ) continue;
-            pesum_idx_map[1./(_pesum_v[idx])] = idx;
+        // Order the candidates by PE (above threshold); on equal PE, only the
+        // latest bin is considered (as the former std::map keyed on 1/PE did)
+        typedef std::pair<double,size_t> Candidate_t; // (1/PE, bin index)
+        auto const lower_priority = [](Candidate_t const& a, Candidate_t const& b)
+        { return (a.first > b.first) || (a.first == b.first && a.second < b.second); };
+        std::vector<Candidate_t> candidate_v;
+        candidate_v.reserve(bin_v.size() + 1);
+        for(auto const& bin : bin_v) {
+            if(bin.pesum < _min_pe_coinc   ) continue;
+            if(bin.mult  < _min_mult_coinc ) continue;
+            candidate_v.emplace_back(1./(bin.pesum), bin.index);
         }
+        if(_min_pe_coinc <= 0 && _min_mult_coinc <= 0) {
+            // with no thresholds also empty bins are candidates (1/PE = inf),
+            // but only the latest of them survives the tie
+            size_t last_empty = nbins_pesum_v;
+            for(auto bin_iter = bin_v.rbegin(); bin_iter != bin_v.rend(); ++bin_iter) {
+                if(bin_iter->index + 1 < last_empty) break;
+                last_empty = bin_iter->index;
+            }
+            if(last_empty > 0)
+                candidate_v.emplace_back(std::numeric_limits<double>::infinity(), last_empty - 1);
+        }
+        std::make_heap(candidate_v.begin(), candidate_v.end(), lower_priority);
         
         // Get candidate flash times
         std::vector<std::pair<size_t,size_t> > flash_period_v;
         std::vector<size_t> flash_time_v;
+        std::set<size_t> flash_start_s;
         size_t veto_ctr = (size_t)(_veto_time / _time_res);
-        size_t default_integral_ctr = (size_t)(_integral_time / _time_res);
+        size_t integral_ctr = (size_t)(_integral_time / _time_res);
         size_t precount = (size_t)(_pre_sample / _time_res);
-        flash_period_v.reserve(pesum_idx_map.size());
-        flash_time_v.reserve(pesum_idx_map.size());
         
-        double sum_baseline = 0;
-        //for(auto const& v : _pe_baseline_v) sum_baseline += v;
+        auto const bin_lower_bound = [&bin_v](size_t index)
+        {
+            return std::lower_bound(bin_v.begin(), bin_v.end(), index,
+                                    [](PEBin_t const& bin, size_t index){ return bin.index < index; });
+        };
         
-        for(auto const& pe_idx : pesum_idx_map) {
+        double last_key = 0;
+        bool first_candidate = true;
+        while(!candidate_v.empty()) {
+            
+            std::pop_heap(candidate_v.begin(), candidate_v.end(), lower_priority);
+            Candidate_t const pe_idx = candidate_v.back();
+            candidate_v.pop_back();
+            
+            if(!first_candidate && pe_idx.first == last_key) continue;
+            first_candidate = false;
+            last_key = pe_idx.first;
             
-            //auto const& pe  = 1./(pe_idx.first);
             auto const& idx = pe_idx.second;
             
             size_t start_time = idx;
             if(start_time < precount) start_time = 0;
             else start_time = idx - precount;
             
-            // see if this idx can be used
-            bool skip=false;
-            size_t integral_ctr = default_integral_ctr;
-            for(auto const& used_period : flash_period_v) {
-                if( start_time <= used_period.first && (start_time + veto_ctr) > used_period.first ) {
-                    skip=true;
-                    break;
-                }
-                if( used_period.first <= start_time && start_time < (used_period.first + veto_ctr) ) {
-                    skip=true;
-                    break;
-                }
-                if( used_period.first >= start_time && used_period.first < (start_time + integral_ctr) ) {
-                    if(_debug) std::cout << "Truncating flash @ " << start_time
-                        << " (previous flash @ " << used_period.first
-                        << ") ... integral ctr change: " << integral_ctr
-                        << " => " << used_period.first - start_time << std::endl;
-                    
-                    integral_ctr = used_period.first - start_time;
-                }
-                if(_debug) {
-                    std::cout << "Flash @ " << min_time + used_period.first * _time_res
-                    << " => " << min_time + (used_period.first + used_period.second) * _time_res
-                    << " does not interfare with THIS flash @ " << min_time + start_time * _time_res
-                    << " => " << min_time + (start_time + integral_ctr) * _time_res << std::endl;
-                }
-            }
-            if(skip) {
+            // see if this idx can be used: no flash may start within the veto
+            // time before or after this one; since the integral time does not
+            // exceed the veto time, the integral is never truncated
+            auto used_iter = flash_start_s.lower_bound
+                (start_time < veto_ctr? 0: start_time - veto_ctr + 1);
+            if(used_iter != flash_start_s.end() && *used_iter < start_time + veto_ctr) {
                 if(_debug) std::cout << "Skipping a candidate @ " << min_time + start_time * _time_res << " as it is in a veto window!" <<std::endl;
                 continue;
             }
             
             // See if this flash is declarable
             double pesum = 0;
-            for(size_t i=start_time; i<std::min(nbins_pesum_v,(start_time+integral_ctr)); ++i)
+            for(auto bin_iter = bin_lower_bound(start_time);
+                bin_iter != bin_v.end() && bin_iter->index < start_time + integral_ctr; ++bin_iter)
                 
-                pesum += _pesum_v[i];
+                pesum += bin_iter->pesum;
             
-            if(pesum < (_min_pe_flash + sum_baseline)) {
+            if(pesum < _min_pe_flash) {
                 if(_debug) std::cout << "Skipping a candidate @ " << start_time  << " => " << start_time + integral_ctr
                     << " as it got " << pesum
-                    << " PE which is lower than threshold " << (_min_pe_flash + sum_baseline) << std::endl;
+                    << " PE which is lower than threshold " << _min_pe_flash << std::endl;
                 continue;
             }
             
             flash_period_v.push_back(std::pair<size_t,size_t>(start_time,integral_ctr));
             flash_time_v.push_back(idx);
+            flash_start_s.insert(start_time);
         }
         
         // Construct flash
-        LiteOpFlashArray_t res;
+        res.reserve(flash_period_v.size());
         for(size_t flash_idx=0; flash_idx<flash_period_v.size(); ++flash_idx) {
             
             auto const& start  = flash_period_v[flash_idx].first;
@@ -246,28 +285,16 @@ namespace pmtana{
             auto const& time   = flash_time_v[flash_idx];
             
             std::vector<double> pe_v(max_ch+1,0);
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
-                
-                for(size_t pmt_index=0; pmt_index<NOpDet; ++pmt_index)
-                    
-                    pe_v[_index_to_opch_v[pmt_index]] += pespec_v[index][pmt_index];
-                
-            }
-            
-            for(size_t opch=0; opch<max_ch; ++opch) {
-                
-                if(_opch_to_index_v[opch]<0) continue;
-                
-                //pe_v[opch] -= _pe_baseline_v[_opch_to_index_v[opch]];
+            std::vector<unsigned int> asshit_v;
+            for(auto bin_iter = bin_lower_bound(start);
+                bin_iter != bin_v.end() && bin_iter->index < start + period; ++bin_iter) {
                 
-                if(pe_v[opch]<0) pe_v[opch]=0;
+                for(size_t i=bin_iter->pmt_begin; i<bin_iter->pmt_end; ++i)
+                    pe_v[_index_to_opch_v[pespec_v[i].first]] += pespec_v[i].second;
                 
-            }
-            
-            std::vector<unsigned int> asshit_v;
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
-                for(auto const& idx : hitidx_v[index])
-                    asshit_v.push_back(idx);
+                asshit_v.insert(asshit_v.end(),
+                                hitidx_v.begin() + bin_iter->hit_begin,
+                                hitidx_v.begin() + bin_iter->hit_end);
             }
             
             if(_debug) {
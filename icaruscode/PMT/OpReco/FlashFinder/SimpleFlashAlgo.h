@@ -19,14 +19,26 @@ namespace pmtana
 
     LiteOpFlashArray_t RecoFlash(const LiteOpHitArray_t ophits);
 
-    bool Veto(double t) const;
+    /// Flash finding proper; it keeps no state, and it can run concurrently.
+    LiteOpFlashArray_t FindFlashes(const LiteOpHitArray_t& ophits) const;
 
-    const std::vector<double>& PESumArray() const { return _pesum_v; }
+    bool Veto(double t) const;
 
     const double TimeRes() const { return _time_res; }
 
   private:
 
+    /// Hits, PE and PE per PMT in a single (non-empty) time bin.
+    struct PEBin_t {
+      size_t index;       ///< time bin index
+      double pesum;       ///< total PE in the bin
+      double mult;        ///< number of hits in the bin
+      size_t hit_begin;   ///< first hit in the list of binned hits
+      size_t hit_end;     ///< past the last hit in the list of binned hits
+      size_t pmt_begin;   ///< first entry in the list of PE per PMT
+      size_t pmt_end;     ///< past the last entry in the list of PE per PMT
+    };
+
     double TotalCharge(const std::vector<double>& PEs);
 
     // minimum PE to account for a hit
@@ -53,9 +65,6 @@ namespace pmtana
     // time pre-sample
     double _pre_sample;
 
-    // pw aum array
-    std::vector<double> _pesum_v;
-
     // calibration: PEs to be subtracted from each opdet
     std::vector<double> _pe_baseline_v;
 
@@ -49,13 +49,16 @@
 #include "fhiclcpp/types/DelegatedParameter.h"
 #include "fhiclcpp/ParameterSet.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+
 // C++ standard libraries
-#include <algorithm> // std::copy_if(), std::binary_search()
+#include <algorithm> // std::binary_search()
 #include <vector>
-#include <variant>
 #include <memory> // std::unique_ptr
 #include <string>
 #include <functional> // std::mem_fn()
+#include <iterator> // std::make_move_iterator()
 #include <utility> // std::move()
 #include <cassert>
 
@@ -159,6 +162,9 @@ namespace opdet { class ICARUSOpHitFinder; }
  *   instead of the peak time.
  * * `ChannelMasks` (list of channel numbers, default: empty): skip waveforms
  *   on the channels specified in this list.
+ * * `HitFinderWorkers` (integer, default: `1`): number of independent sets of
+ *   hit finding algorithms, each processing a share of the waveforms in
+ *   parallel (see @ref ICARUSOpHitFinder_Multithreading "Multithreading").
  * * `HitAlgoPset` (table, mandatory): configuration of the hit finding
  *   algorithm; its content depends on the algorithm itself, but the following
  *   elements are nonetheless mandatory:
@@ -188,6 +194,7 @@ namespace opdet { class ICARUSOpHitFinder; }
  * 
  * Multithreading
  * ---------------
+ * @anchor ICARUSOpHitFinder_Multithreading
  * 
  * In order to support the algorithms that require an event-specific
  * configuration, the module is not shared. While the algorithms could be
@@ -198,6 +205,19 @@ namespace opdet { class ICARUSOpHitFinder; }
  * (and multiple managers) but each of them sees an event at a time, in a way
  * that the module (replica) can predict.
  * 
+ * Within an event, the waveforms can also be processed in parallel.
+ * The pulse reconstruction algorithms keep state while processing a waveform,
+ * so each replica owns `HitFinderWorkers` complete and independent sets of
+ * them (manager, hit finding and pedestal algorithms). The waveforms are split
+ * in as many contiguous shares, each processed by one set in its own TBB task.
+ * The hits from each share are then merged in share order, so the output is
+ * the same, in content and order, as with a single set of algorithms.
+ * 
+ * Masked channels are skipped via a list of pointers to the selected
+ * waveforms, which are never copied. This is also what allows the `Fixed`
+ * pedestal algorithm to be used together with `ChannelMasks`: that algorithm
+ * recognises a waveform by its address in the data product.
+ * 
  */
 class opdet::ICARUSOpHitFinder: public art::ReplicatedProducer {
     public:
@@ -222,6 +242,15 @@ class opdet::ICARUSOpHitFinder: public art::ReplicatedProducer {
       std::vector<raw::Channel_t>{}
       };
     
+    fhicl::Atom<unsigned int> HitFinderWorkers {
+      Name{ "HitFinderWorkers" },
+      Comment{
+        "number of independent hit finding algorithm sets"
+        " processing the waveforms in parallel"
+        },
+      1U
+      };
+    
     fhicl::Atom<float> HitThreshold {
       Name{ "HitThreshold" },
       Comment{ "Hit reconstruction threshold [ADC#]" }
@@ -311,19 +340,38 @@ class opdet::ICARUSOpHitFinder: public art::ReplicatedProducer {
   using FWInterfacedPedAlgo
     = opdet::factory::FWInterfacedIF<pmtana::PMTPedestalBase, ArtTraits>;
   
-  pmtana::PulseRecoManager fPulseRecoMgr;
-  std::unique_ptr<pmtana::PMTPulseRecoBase> const fThreshAlg;
-  std::unique_ptr<FWInterfacedPedAlgo> const fPedAlg;
+  /// A complete set of hit finding algorithms, used by one task at a time.
+  struct HitFinderWorker_t {
+    pmtana::PulseRecoManager pulseRecoMgr;
+    std::unique_ptr<pmtana::PMTPulseRecoBase> threshAlg;
+    std::unique_ptr<FWInterfacedPedAlgo> pedAlg;
+  }; // HitFinderWorker_t
+  
+  /// Algorithm sets, one per parallel share of waveforms.
+  std::vector<std::unique_ptr<HitFinderWorker_t>> fWorkers;
   
   // --- END ---- Algorithms ---------------------------------------------------
   
+  using WaveformPtrs_t = std::vector<raw::OpDetWaveform const*>;
+  
+  /// Creates and registers a new set of algorithms from the configuration.
+  std::unique_ptr<HitFinderWorker_t> makeWorker(Config const& config);
+  
   /// Optionally reads the beam gates from `fBeamGateTag`, empty if none.
   std::vector<sim::BeamGateInfo const*> fetchBeamGates
     (art::Event const& event) const;
 
-  /// Returns a vector with copies of only the waveforms not in masked channels.
-  std::vector<raw::OpDetWaveform> selectWaveforms
+  /// Returns pointers to only the waveforms not in masked channels.
+  WaveformPtrs_t selectWaveforms
     (std::vector<raw::OpDetWaveform> const& waveforms) const;
+  
+  /// Appends to `hits` the hits found in the waveforms in `[ begin, end [`.
+  void findHits(
+    HitFinderWorker_t& worker,
+    WaveformPtrs_t::const_iterator begin, WaveformPtrs_t::const_iterator end,
+    geo::GeometryCore const& geom, detinfo::DetectorClocksData const& clockData,
+    std::vector<recob::OpHit>& hits
+    ) const;
 
 
 }; // opdet::ICARUSOpHitFinder
@@ -432,50 +480,6 @@ namespace {
   std::vector<T> sortedVector(std::vector<T> v)
     { sortVector(v); return v; }
   
-  
-  /**
-   * @brief A "smart" pointer that may or may not own its data.
-   * @tparam T type of the data to point to
-   * 
-   * This pointer can be used when depending on a run-time condition a data set
-   * may come from an immutable, owning source (like `art::Event`) or from a
-   * local processing (e.g. a selection of the above).
-   * 
-   * If initialized with a pointer to the data, this pointer will refer to it
-   * without owning; if initialized with a r-value (reference) to data, the data
-   * is stolen and owned from now on.
-   */
-  template <typename T>
-  class MaybeOwnerPtr {
-      public:
-    using element_type = T;
-    using pointer = T*;
-    
-    /// Points to the given pointer without owning it.
-    MaybeOwnerPtr(pointer ptr) noexcept: fStorage{ ptr } {}
-    
-    /// Steals the data and owns it.
-    MaybeOwnerPtr(element_type&& data): fStorage{ std::move(data) } {}
-    
-    pointer get() const { return std::visit(PointerGetter{}, fStorage); }
-    
-    pointer operator->() const { return get(); }
-    auto& operator*() const { return *(get()); }
-    
-      private:
-    
-    struct PointerGetter {
-      pointer operator() (pointer ptr) const noexcept { return ptr; }
-      pointer operator() (element_type& item) const noexcept { return &item; }
-    }; // PointerGetter
-    
-    using store_t = std::variant<element_type, pointer>;
-    
-    store_t fStorage; ///< Contains the data or pointer to it.
-    
-  }; // MaybeOwnerPtr
-  
-  
 } // local namespace
 
 
@@ -491,12 +495,6 @@ opdet::ICARUSOpHitFinder::ICARUSOpHitFinder
   , fUseStartTime{ params().UseStartTime() }
   // caches
   , fMaxOpChannel{ frame.serviceHandle<geo::Geometry>()->MaxOpChannel() }
-  // algorithms
-  , fPulseRecoMgr{}
-  , fThreshAlg
-    { HitAlgoFactory.create(params().HitAlgoPset.get<fhicl::ParameterSet>()) }
-  , fPedAlg
-    { PedAlgoFactory.create(params().PedAlgoPset.get<fhicl::ParameterSet>()) }
 {
   
   //
@@ -522,37 +520,15 @@ opdet::ICARUSOpHitFinder::ICARUSOpHitFinder
   } // if ... else
   
   //
-  // register the algorithms in the manager
+  // algorithms, each set with its own manager
   //
-  fPulseRecoMgr.AddRecoAlgo(fThreshAlg.get());
-  fPulseRecoMgr.SetDefaultPedAlgo(&(fPedAlg->algo()));
-  
-  // framework hooks to the algorithms
-  if (!fChannelMasks.empty() && (fPedAlg->algo().Name() == "Fixed")) {
-    /* TODO
-     * The reason why this is not working is complicate.
-     * The interface of ophit mini-framework is quite minimal and tight,
-     * it accepts only `std::vector<short>` input and nothing more.
-     * The whole reason of this module is to overcome that limitation;
-     * since there is no channel information, we have to guess which channel
-     * this is the data of, and the way we do it is by address of the data;
-     * `raw::OpDetWaveform` derives from `std::vector<short>`, so when we use
-     * the original data product, the waveform data `std::vector<short>` is
-     * actually the same object and we can compare with the address of the data
-     * product, which we have because of the framework hooks here introduced;
-     * but if the `ChannelMasks` is not empty, we are forced to copy the
-     * original data in a new location (excluding the masked channels) and the
-     * new data has a different address. In principle we could still try to
-     * look for which `raw::OpDetWaveform` data product has the same content as
-     * the `std::vector<short>` we were given, which may be a bit tedious
-     * (thousand of vector comparisons to do, although all except the target one
-     * will be short because the noise pattern are different).
-     */
+  if (params().HitFinderWorkers() == 0) {
     throw art::Exception{ art::errors::Configuration }
-      << "Pedestal algorithm \"Fixed\" will not work"
-      " since a channel mask list is specified.\n";
+      << "At least one hit finder worker is needed ('HitFinderWorkers').\n";
   }
-  fPedAlg->initialize(consumesCollector());
+  fWorkers.reserve(params().HitFinderWorkers());
+  for (unsigned int i = 0; i < params().HitFinderWorkers(); ++i)
+    fWorkers.push_back(makeWorker(params()));
   
   //
   // declare output products
@@ -573,28 +549,14 @@ void opdet::ICARUSOpHitFinder::produce
   auto const& allWaveforms
     = event.getProduct<std::vector<raw::OpDetWaveform>>(fWaveformTags);
   
-  // this pointer owns the waveforms only if they come from `selectWaveforms()`
-//   MaybeOwnerPtr<std::vector<raw::OpDetWaveform> const> waveforms
-//     = fChannelMasks.empty()? &allWaveforms: selectWaveforms(allWaveforms);
-  using WaveformsPtr_t = MaybeOwnerPtr<std::vector<raw::OpDetWaveform> const>;
-  WaveformsPtr_t waveforms = fChannelMasks.empty()
-    ? WaveformsPtr_t{ &allWaveforms }
-    : WaveformsPtr_t{ selectWaveforms(allWaveforms) }
-    ;
-  
-  if (fChannelMasks.empty() && (&allWaveforms != &*waveforms)) {
-    // if this happens, contact the author
-    throw art::Exception{ art::errors::LogicError }
-      << "Bug in MaybeOwnerPtr!\n";
-  }
-  assert(fChannelMasks.empty() || (&allWaveforms == &*waveforms));
+  WaveformPtrs_t const waveforms = selectWaveforms(allWaveforms);
   
   //
   // run the algorithm
   //
   
   // framework hooks to the algorithms
-  fPedAlg->beginEvent(event);
+  for (auto const& worker: fWorkers) worker->pedAlg->beginEvent(event);
   
   std::vector<sim::BeamGateInfo const*> const beamGateArray
     = fetchBeamGates(event);
@@ -605,24 +567,37 @@ void opdet::ICARUSOpHitFinder::produce
       ->DataFor(event)
     ;
   
-  std::vector<recob::OpHit> opHits;
-
-  RunHitFinder(
-    *waveforms, opHits,
-    fPulseRecoMgr, *fThreshAlg,
-    geom,
-    fHitThreshold,
-    clockData,
-    *fCalib,
-    fUseStartTime
-    );
+  // each worker gets a contiguous share of the waveforms and its own output
+  std::size_t const nWorkers = fWorkers.size();
+  std::vector<std::vector<recob::OpHit>> workerHits(nWorkers);
+  auto const processShare = [&](std::size_t iWorker)
+    {
+      auto const share = [&waveforms,nWorkers](std::size_t i)
+        { return waveforms.begin() + (waveforms.size() * i / nWorkers); };
+      findHits(
+        *fWorkers[iWorker], share(iWorker), share(iWorker + 1),
+        geom, clockData, workerHits[iWorker]
+        );
+    };
+  
+  if (nWorkers == 1) processShare(0);
+  else tbb::parallel_for(std::size_t{ 0 }, nWorkers, processShare);
+  
+  // merge in share order, which is the order of the input waveforms
+  std::vector<recob::OpHit> opHits = std::move(workerHits.front());
+  for (std::size_t iWorker = 1; iWorker < nWorkers; ++iWorker) {
+    opHits.insert(opHits.end(),
+      std::make_move_iterator(workerHits[iWorker].begin()),
+      std::make_move_iterator(workerHits[iWorker].end())
+      );
+  } // for
   
   mf::LogInfo{ "ICARUSOpHitFinder" }
-    << "Found " << opHits.size() << " hits from " << waveforms->size()
+    << "Found " << opHits.size() << " hits from " << waveforms.size()
     << " waveforms.";
   
   // framework hooks to the algorithms
-  fPedAlg->endEvent(event);
+  for (auto const& worker: fWorkers) worker->pedAlg->endEvent(event);
   
   //
   // store results into the event
@@ -632,6 +607,27 @@ void opdet::ICARUSOpHitFinder::produce
 } // opdet::ICARUSOpHitFinder::produce()
 
 
+//------------------------------------------------------------------------------
+auto opdet::ICARUSOpHitFinder::makeWorker(Config const& config)
+  -> std::unique_ptr<HitFinderWorker_t>
+{
+  auto worker = std::make_unique<HitFinderWorker_t>();
+  worker->threshAlg
+    = HitAlgoFactory.create(config.HitAlgoPset.get<fhicl::ParameterSet>());
+  worker->pedAlg
+    = PedAlgoFactory.create(config.PedAlgoPset.get<fhicl::ParameterSet>());
+  
+  // register the algorithms in the manager
+  worker->pulseRecoMgr.AddRecoAlgo(worker->threshAlg.get());
+  worker->pulseRecoMgr.SetDefaultPedAlgo(&(worker->pedAlg->algo()));
+  
+  // framework hooks to the algorithms
+  worker->pedAlg->initialize(consumesCollector());
+  
+  return worker;
+} // opdet::ICARUSOpHitFinder::makeWorker()
+
+
 //------------------------------------------------------------------------------
 std::vector<sim::BeamGateInfo const*> opdet::ICARUSOpHitFinder::fetchBeamGates
   (art::Event const& event) const
@@ -649,24 +645,60 @@ std::vector<sim::BeamGateInfo const*> opdet::ICARUSOpHitFinder::fetchBeamGates
 
 
 //----------------------------------------------------------------------------
-std::vector<raw::OpDetWaveform> opdet::ICARUSOpHitFinder::selectWaveforms
-  (std::vector<raw::OpDetWaveform> const& waveforms) const
+auto opdet::ICARUSOpHitFinder::selectWaveforms
+  (std::vector<raw::OpDetWaveform> const& waveforms) const -> WaveformPtrs_t
 {
-  std::vector<raw::OpDetWaveform> selected;
-  
-  auto const isNotMasked = [this](raw::OpDetWaveform const& waveform)
-    {
-      return !std::binary_search
-        (fChannelMasks.begin(), fChannelMasks.end(), waveform.ChannelNumber());
-    };
-  
-  std::copy_if
-    (waveforms.begin(), waveforms.end(), back_inserter(selected), isNotMasked);
+  WaveformPtrs_t selected;
+  selected.reserve(waveforms.size());
+  
+  for (raw::OpDetWaveform const& waveform: waveforms) {
+    if (std::binary_search
+      (fChannelMasks.begin(), fChannelMasks.end(), waveform.ChannelNumber())
+    ) {
+      continue;
+    }
+    selected.push_back(&waveform);
+  } // for
   
   return selected;
 } // selectWaveforms()
 
 
+//----------------------------------------------------------------------------
+void opdet::ICARUSOpHitFinder::findHits(
+  HitFinderWorker_t& worker,
+  WaveformPtrs_t::const_iterator begin, WaveformPtrs_t::const_iterator end,
+  geo::GeometryCore const& geom, detinfo::DetectorClocksData const& clockData,
+  std::vector<recob::OpHit>& hits
+) const {
+  
+  // same as `RunHitFinder()`, but on a selection of waveforms
+  for (auto it = begin; it != end; ++it) {
+    raw::OpDetWaveform const& waveform = **it;
+    
+    int const channel = static_cast<int>(waveform.ChannelNumber());
+    if (!geom.IsValidOpChannel(channel)) {
+      mf::LogError("ICARUSOpHitFinder")
+        << "Error! unrecognized channel number " << channel
+        << ". Ignoring pulse";
+      continue;
+    }
+    
+    // the waveform is passed as is: the `Fixed` pedestal algorithm needs that
+    worker.pulseRecoMgr.Reconstruct(waveform);
+    
+    double const timeStamp = waveform.TimeStamp();
+    for (pmtana::pulse_param const& pulse: worker.threshAlg->GetPulses()) {
+      ConstructHit(
+        fHitThreshold, channel, timeStamp, pulse, hits,
+        clockData, *fCalib, fUseStartTime
+        );
+    }
+  } // for waveforms
+  
+} // opdet::ICARUSOpHitFinder::findHits()
+
+
 // -----------------------------------------------------------------------------
 DEFINE_ART_MODULE(opdet::ICARUSOpHitFinder)
 
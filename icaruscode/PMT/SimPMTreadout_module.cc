@@ -53,10 +53,16 @@
 
 // CLHEP libraries
 #include "CLHEP/Random/RandEngine.h" // CLHEP::HepRandomEngine
+#include "CLHEP/Random/JamesRandom.h" // CLHEP::HepJamesRandom
+#include "CLHEP/Random/RandFlat.h"
+
+// TBB libraries
+#include "tbb/parallel_for.h"
 
 // C/C++ standard library
 #include <vector>
 #include <algorithm> // std::min()
+#include <iterator> // std::distance()
 #include <atomic> // std::atomic_flag
 #include <mutex> // std::mutex, std::lock_guard
 #include <memory> // std::make_unique()
@@ -188,6 +194,21 @@ namespace icarus::opdet { class SimPMTreadout; }
  * `TriggerTags` tags).
  * 
  * 
+ * ### Multithreading
+ * 
+ * @anchor SimPMTreadout_Multithreading
+ * 
+ * Channels are independent, with the exception of the random stream used for
+ * noise generation. When `ParallelChannels` is enabled, each channel is given
+ * its own random engine and its own noise generator, and on each event the
+ * engine of each channel is reseeded with a seed drawn, in channel order, from
+ * the random engine managed by `NuRandomService`. Channels are then processed
+ * concurrently, and their waveforms merged in channel order, so that the result
+ * does not depend on the number of threads (it does differ from the one with
+ * `ParallelChannels` disabled, where a single random stream is used for all
+ * channels in sequence).
+ * 
+ * 
  * Configuration
  * ==============
  * 
@@ -222,6 +243,9 @@ namespace icarus::opdet { class SimPMTreadout; }
  * * `NoiseGeneratorSeed` (integer, optional): if specified, the value is used
  *   to seed the noise generation algorithm random engine; otherwise, the seed
  *   is assigned by `NuRandomService`.
+ * * `ParallelChannels` (flag, default: `false`): if set, the channels are
+ *   processed concurrently (see
+ *   @ref SimPMTreadout_Multithreading "Multithreading" below).
  * * `CryostatFirstBit` (positive integer, mandatory): the trigger bit which is
  *   set on input triggers from cryostat 0; as many bits are expected as
  *   there are cryostats in the detector (thus, 2 for ICARUS). The value `0`
@@ -353,6 +377,12 @@ class icarus::opdet::SimPMTreadout: public art::EDProducer {
       Comment("fix the seed for stochastic electronics noise generation")
       };
     
+    fhicl::Atom<bool> ParallelChannels{
+      Name{ "ParallelChannels" },
+      Comment{ "simulate the channels concurrently, each with its own noise stream" },
+      false
+      };
+    
     fhicl::Atom<std::string> LogCategory{
       Name{ "LogCategory" },
       Comment{ "category name for the message facility stream to be used" },
@@ -502,6 +532,16 @@ class icarus::opdet::SimPMTreadout: public art::EDProducer {
   /// Pedestal and electronics noise generation algorithm.
   std::unique_ptr<PedestalGenerator_t> const fPedestalGenerator;
   
+  /// Noise random engine of each channel (only with `ParallelChannels`).
+  std::vector<std::unique_ptr<CLHEP::HepRandomEngine>> fChannelEngines;
+  
+  /// Pedestal generator of each channel (only with `ParallelChannels`).
+  std::vector<std::unique_ptr<PedestalGenerator_t>> fChannelPedestalGenerators;
+  
+  
+  /// Reseeds the engines of all channels from `fNoiseGeneratorEngine`.
+  void reseedChannelEngines();
+  
   
   /// Registers local primitives (affecting only part of the detector).
   void addLocalPrimitives(
@@ -516,11 +556,13 @@ class icarus::opdet::SimPMTreadout: public art::EDProducer {
     ) const;
   
   /// Creates waveforms on a single channel, filling the specified readout
-  /// windows, from the samples in `source` waveforms.
+  /// windows, from the samples in `source` waveforms, and the rest with
+  /// `pedestalGenerator`.
   std::vector<raw::OpDetWaveform> makeWaveforms(
     raw::Channel_t channel, std::uint64_t beamGateTimestamp,
     std::vector<raw::OpDetWaveform const*> const& source,
-    std::vector<Window_t> const& readoutWindows
+    std::vector<Window_t> const& readoutWindows,
+    PedestalGenerator_t& pedestalGenerator
     ) const;
   
   /// Creates waveform metadata and associations for all `waveforms`.
@@ -745,6 +787,24 @@ icarus::opdet::SimPMTreadout::SimPMTreadout(Parameters const& config)
     }
 {
   
+  //
+  // per-channel noise generators
+  //
+  if (config().ParallelChannels()) {
+    fhicl::ParameterSet const pedestalConfig
+      = config().Pedestal.get<fhicl::ParameterSet>();
+    fChannelEngines.reserve(fNOpChannels);
+    fChannelPedestalGenerators.reserve(fNOpChannels);
+    while (fChannelEngines.size() < fNOpChannels) {
+      CLHEP::HepRandomEngine& engine = *(fChannelEngines.emplace_back
+        (std::make_unique<CLHEP::HepJamesRandom>()));
+      fChannelPedestalGenerators.push_back(
+        art::make_tool<icarus::opdet::PMTpedestalGeneratorTool>(pedestalConfig)
+          ->makeGenerator(engine)
+        );
+    } // for channels
+  } // if parallel
+  
   //
   // configuration checks
   //
@@ -823,6 +883,9 @@ icarus::opdet::SimPMTreadout::SimPMTreadout(Parameters const& config)
     
     log << "\n - pedestal generation: " << *fPedestalGenerator;
     
+    if (!fChannelEngines.empty())
+      log << "\n - channels simulated concurrently";
+    
   } // --- END ---- configuration dump -----------------------------------------
   
 } // icarus::opdet::SimPMTreadout::SimPMTreadout()
@@ -880,17 +943,31 @@ void icarus::opdet::SimPMTreadout::produce(art::Event& event) {
   
   std::uint64_t const beamGateTimestamp = event.time().value();
   std::vector<std::vector<raw::OpDetWaveform>> readoutWaveforms{ fNOpChannels };
-  for (auto const channel: util::counter<raw::Channel_t>(fNOpChannels)) {
-    
-    std::vector<Window_t> const readoutWindows
-      = makeReadoutWindows(primitives.forChannel(channel));
-    std::vector<raw::OpDetWaveform const*> const waveforms
-      = simWaveforms[channel];
-    
-    readoutWaveforms[channel]
-      = makeWaveforms(channel, beamGateTimestamp, waveforms, readoutWindows);
-    
-  } // for channels
+  auto const processChannel
+    = [&](raw::Channel_t channel, PedestalGenerator_t& pedestalGenerator)
+    {
+      std::vector<Window_t> const readoutWindows
+        = makeReadoutWindows(primitives.forChannel(channel));
+      std::vector<raw::OpDetWaveform const*> const& waveforms
+        = simWaveforms[channel];
+      
+      readoutWaveforms[channel] = makeWaveforms
+        (channel, beamGateTimestamp, waveforms, readoutWindows, pedestalGenerator);
+    };
+  
+  if (fChannelEngines.empty()) {
+    for (auto const channel: util::counter<raw::Channel_t>(fNOpChannels))
+      processChannel(channel, *fPedestalGenerator);
+  }
+  else {
+    // after this, the primitive manager is only read, which is thread-safe
+    primitives.prepare();
+    reseedChannelEngines();
+    tbb::parallel_for(raw::Channel_t{ 0 }, raw::Channel_t{ fNOpChannels },
+      [&](raw::Channel_t channel)
+        { processChannel(channel, *(fChannelPedestalGenerators[channel])); }
+      );
+  }
   
   
   //
@@ -909,6 +986,18 @@ void icarus::opdet::SimPMTreadout::produce(art::Event& event) {
 } // icarus::opdet::SimPMTreadout::produce()
 
 
+// ---------------------------------------------------------------------------
+void icarus::opdet::SimPMTreadout::reseedChannelEngines() {
+  
+  // seeds are drawn in channel order from the engine managed by NuRandomService
+  // so that they do not depend on the order the channels are processed in
+  constexpr long MaxSeed = 900'000'000L; // limit from `CLHEP::HepJamesRandom`
+  for (std::unique_ptr<CLHEP::HepRandomEngine> const& engine: fChannelEngines)
+    engine->setSeed(CLHEP::RandFlat::shootInt(&fNoiseGeneratorEngine, MaxSeed), 0);
+  
+} // icarus::opdet::SimPMTreadout::reseedChannelEngines()
+
+
 // ---------------------------------------------------------------------------
 std::vector<geo::CryostatID> icarus::opdet::SimPMTreadout::cryostatsOf
   (raw::Trigger const& trigger) const
@@ -979,7 +1068,8 @@ void icarus::opdet::SimPMTreadout::addGlobalPrimitives
 std::vector<raw::OpDetWaveform> icarus::opdet::SimPMTreadout::makeWaveforms(
   raw::Channel_t channel, std::uint64_t beamGateTimestamp,
   std::vector<raw::OpDetWaveform const*> const& source,
-  std::vector<Window_t> const& readoutWindows
+  std::vector<Window_t> const& readoutWindows,
+  PedestalGenerator_t& pedestalGenerator
 ) const {
   
   // assumption: source waveforms are sorted by timestamp
@@ -1036,7 +1126,7 @@ std::vector<raw::OpDetWaveform> icarus::opdet::SimPMTreadout::makeWaveforms(
     electronics_time neededTime = window.start();
     
     // --- BEGIN DEBUG ---------------------------------------------------------
-    auto sampleIndex [[maybe_unused]]
+    auto sampleIndex
       = [&itSample,b=samples.begin()](){ return itSample - b; };
     MF_LOG_TRACE("SimPMTreadout")
       << "Expected waveform with " << samples.size() << " samples;"
@@ -1094,14 +1184,12 @@ std::vector<raw::OpDetWaveform> icarus::opdet::SimPMTreadout::makeWaveforms(
         // our source and destination is in rounded ADC counts;
         // we need to convert (emitting directly in ADC counts is only good if
         // the pedestal is already integer, otherwise we stack yet another
-        // rounding)
-        std::vector<util::quantities::counts_f> extendedNoise(nNoiseSamples);
-        fPedestalGenerator->fill
-          (channel, toTimestamp(neededTime), extendedNoise);
-        for (util::quantities::counts_f const noise: extendedNoise) {
-          *(itSample++)
-            = static_cast<raw::ADC_Count_t>(std::round(noise.value()));
-        }
+        // rounding); the generator does that in bulk for us
+        itSample += pedestalGenerator.fillRounded(
+          channel, toTimestamp(neededTime),
+          samples.data() + std::distance(samples.begin(), itSample),
+          nNoiseSamples
+          );
         assert(itSample <= send);
         
         neededTime = noiseEnd;
@@ -0,0 +1,161 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.cxx
+ * @brief  Algorithm to produce trigger gates out of optical readout waveforms.
+ * @date   October 16, 2026
+ * @see    `icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.h`
+ *
+ */
+
+
+// class header
+#include "icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.h"
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // ADCCounts_t
+#include "icarusalg/Utilities/WaveformOperations.h"
+
+// LArSoft libraries
+#include "lardataobj/RawData/OpDetWaveform.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::min(), std::max()
+#include <limits>
+#include <cmath> // std::round(), std::ceil(), std::floor()
+#include <cstddef> // std::ptrdiff_t
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Type of a single sample of the raw waveform.
+  using Sample_t = raw::OpDetWaveform::value_type;
+
+  /**
+   * @brief Returns the first sample from `first` out of the current level.
+   * @param data the samples
+   * @param first index of the first sample to check
+   * @param last index after the last sample to check
+   * @param openBound samples not larger than this reach a higher level
+   * @param closeBound samples larger than this fall to a lower level
+   * @return the index of the first sample out of level, `last` if none
+   *
+   * Most of the samples do not change level: they are checked in blocks with
+   * no early exit, which the compiler can vectorize.
+   */
+  std::ptrdiff_t findLevelChange(
+    Sample_t const* data, std::ptrdiff_t first, std::ptrdiff_t last,
+    int openBound, int closeBound
+  ) {
+    constexpr std::ptrdiff_t BlockSize = 32;
+
+    auto const outOfLevel = [openBound,closeBound](int sample)
+      { return (sample <= openBound) | (sample > closeBound); };
+
+    while (first + BlockSize <= last) {
+      bool any = false;
+      for (std::ptrdiff_t i = first; i < first + BlockSize; ++i)
+        any |= outOfLevel(data[i]);
+      if (any) break;
+      first += BlockSize;
+    } // while
+
+    while ((first < last) && !outOfLevel(data[first])) ++first;
+    return first;
+  } // findLevelChange()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+//--- icarus::trigger::ManagedTriggerGateBuilder
+//------------------------------------------------------------------------------
+auto icarus::trigger::ManagedTriggerGateBuilder::findThresholdCrossings
+  (WaveformWithBaseline const& waveformData) const
+  -> std::vector<ThresholdCrossing_t>
+{
+  using ops = icarus::waveform_operations::NegativePolarityOperations<float>;
+
+  raw::OpDetWaveform const& waveform = waveformData.waveform();
+  ops const waveOps { waveformData.baseline().baseline() };
+
+  // baseline subtraction is performed in floating point,
+  // but then rounding is applied again
+  auto const subtractBaseline = [waveOps](Sample_t sample) -> ADCCounts_t
+    {
+      return
+        ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)));
+    };
+
+  //
+  // convert each threshold into the largest raw sample value which is at or
+  // above it (negative polarity: the lower the sample, the higher the signal);
+  // the search uses the same subtraction as the signal, so it's exact;
+  // it is restricted to the samples whose subtracted value is representable
+  // as ADC counts, since out of that range the conversion is not monotonic
+  //
+  using Count_t = ADCCounts_t::value_t;
+  float const baseline = waveformData.baseline().baseline();
+  int const MinSample = std::max<int>(
+    std::numeric_limits<Sample_t>::min(),
+    std::ceil(baseline - std::numeric_limits<Count_t>::max())
+    );
+  int const MaxSample = std::min<int>(
+    std::numeric_limits<Sample_t>::max(),
+    std::floor(baseline - std::numeric_limits<Count_t>::min())
+    );
+
+  std::vector<int> sampleBounds;
+  sampleBounds.reserve(nChannelThresholds());
+  for (ADCCounts_t const threshold: channelThresholds()) {
+    auto const passes = [&subtractBaseline,threshold](int sample)
+      { return subtractBaseline(static_cast<Sample_t>(sample)) >= threshold; };
+    int low = MinSample, high = MaxSample;
+    if (!passes(low)) { // no sample can pass
+      sampleBounds.push_back(low - 1);
+      continue;
+    }
+    while (low < high) {
+      int const middle = low + (high - low + 1) / 2;
+      if (passes(middle)) low = middle;
+      else high = middle - 1;
+    } // while
+    sampleBounds.push_back(low);
+  } // for thresholds
+
+  //
+  // single pass through the waveform
+  //
+  std::size_t const nThresholds = sampleBounds.size();
+  auto const openBoundAt = [&sampleBounds,nThresholds](std::size_t level)
+    {
+      return (level < nThresholds)
+        ? sampleBounds[level]: std::numeric_limits<int>::min();
+    };
+  auto const closeBoundAt = [&sampleBounds](std::size_t level)
+    {
+      return (level > 0U)
+        ? sampleBounds[level - 1]: std::numeric_limits<int>::max();
+    };
+
+  std::vector<ThresholdCrossing_t> crossings;
+  std::size_t level = 0U;
+  Sample_t const* const data = waveform.data();
+  std::ptrdiff_t const nSamples = waveform.size();
+  std::ptrdiff_t iSample = 0;
+  while (true) {
+    iSample = findLevelChange
+      (data, iSample, nSamples, openBoundAt(level), closeBoundAt(level));
+    if (iSample >= nSamples) break;
+
+    int const sample = data[iSample];
+    while ((level < nThresholds) && (sample <= sampleBounds[level])) ++level;
+    while ((level > 0U) && (sample > sampleBounds[level - 1])) --level;
+    crossings.push_back({ iSample, level });
+    ++iSample;
+  } // while
+
+  return crossings;
+} // icarus::trigger::ManagedTriggerGateBuilder::findThresholdCrossings()
+
+
+//------------------------------------------------------------------------------
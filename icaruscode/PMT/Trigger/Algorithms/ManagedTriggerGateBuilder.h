@@ -3,7 +3,8 @@
  * @brief  Algorithm to produce trigger gates out of optical readout waveforms.
  * @author Gianluca Petrillo (petrillo@slac.stanford.edu)
  * @date   April 1, 2019
- * @see    `icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.tcc`
+ * @see    `icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.tcc`,
+ *         `icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.cxx`
  * 
  */
 
@@ -19,6 +20,7 @@
 
 // C/C++ standard libraries
 #include <vector>
+#include <cstddef> // std::ptrdiff_t, std::size_t
 
 
 namespace icarus::trigger {
@@ -50,6 +52,15 @@ namespace icarus::trigger {
  * The algorithm keeps track at each time of which are the thresholds enclosing
  * the signal level, and if the level crosses one of them, the gates associated
  * to those thresholds, and only them, are offered a chance to react.
+ * 
+ * Each waveform is scanned only once for all the thresholds
+ * (`findThresholdCrossings()`): the thresholds are first converted into ADC
+ * counts of the raw waveform (i.e. with the baseline not subtracted), and the
+ * samples are then compared to the two thresholds enclosing the current signal
+ * level, in blocks that the compiler can vectorize. The gates are then updated
+ * from the list of crossings.
+ * Channels are processed in parallel; the gate managers must allow that their
+ * gate information objects on different channels are used concurrently.
  */
 class icarus::trigger::ManagedTriggerGateBuilder
   : public icarus::trigger::TriggerGateBuilder
@@ -93,6 +104,13 @@ class icarus::trigger::ManagedTriggerGateBuilder
   }; // struct GateManager
   
   
+  /// A change in the number of thresholds a waveform is at or above of.
+  struct ThresholdCrossing_t {
+    std::ptrdiff_t sample; ///< Index of the first sample at the new level.
+    std::size_t level; ///< Number of thresholds the samples are at or above of.
+  }; // ThresholdCrossing_t
+  
+  
   /// Returns a collection of `TriggerGates` objects sorted by threshold.
   template <typename GateMgr>
   std::vector<TriggerGates> unifiedBuild
@@ -105,6 +123,18 @@ class icarus::trigger::ManagedTriggerGateBuilder
     (std::vector<GateInfo>& channelGates, Waveforms const& channelWaveforms)
     const;
   
+  /**
+   * @brief Returns all the changes of threshold level along a waveform.
+   * @param waveformData the waveform and its baseline
+   * @return the list of level changes, sorted by sample
+   * 
+   * The level of a sample is the number of configured thresholds that its
+   * baseline-subtracted value is at or above of. The waveform starts at level
+   * `0`, and an entry is added for each sample where the level changes.
+   */
+  std::vector<ThresholdCrossing_t> findThresholdCrossings
+    (WaveformWithBaseline const& waveformData) const;
+  
 }; // class icarus::trigger::ManagedTriggerGateBuilder
 
 
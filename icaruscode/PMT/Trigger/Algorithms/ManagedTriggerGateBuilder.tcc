@@ -19,12 +19,9 @@
 
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // icarus::trigger::ADCCounts_t
-#include "icarusalg/Utilities/WaveformOperations.h"
 
 // LArSoft libraries
 #include "lardataobj/RawData/OpDetWaveform.h"
-#include "larcorealg/CoreUtils/counter.h"
-// #include "larcorealg/CoreUtils/StdUtils.h" // util::to_string()
 
 // framework libraries
 #include "messagefacility/MessageLogger/MessageLogger.h" // MF_LOG_TRACE()
@@ -32,11 +29,14 @@
 // range library
 #include "range/v3/view/chunk_by.hpp"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+
 // C/C++ standard libraries
-#include <optional>
-#include <iterator> // std::next(), std::prev()
-#include <cmath> // std::round()
-#include <cstddef> // std::ptrdiff_t
+#include <type_traits> // std::decay_t
+#include <utility> // std::move()
+#include <cassert>
+#include <cstddef> // std::size_t
 
 
 //------------------------------------------------------------------------------
@@ -47,7 +47,7 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
   (GateMgr&& gateManager, std::vector<WaveformWithBaseline> const& waveforms)
   const -> std::vector<TriggerGates>
 {
-  using GateManager_t = GateMgr;
+  using GateManager_t = std::decay_t<GateMgr>;
   using GateInfo_t = typename GateManager_t::GateInfo_t;
   
   /*
@@ -62,13 +62,18 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
   raw::Channel_t channel = InvalidChannel;
   
   // now group the waveforms by channel (must be already sorted!)
-  // and process waveforms channel by channel
   auto sameChannel
     = [] (WaveformWithBaseline const& a, WaveformWithBaseline const& b)
       { return a.waveform().ChannelNumber() == b.waveform().ChannelNumber(); }
     ;
   
   auto byChannel = waveforms | ranges::views::chunk_by(sameChannel);
+  using ChannelWaveforms_t = ranges::range_value_t<decltype(byChannel)>;
+  
+  //
+  // create all the gates first, since that changes the gate collections
+  //
+  std::vector<ChannelWaveforms_t> allChannelWaveforms;
   for (auto const& channelWaveforms: byChannel) {
     
     auto const& firstWaveform = channelWaveforms.front().waveform();
@@ -82,23 +87,46 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
     if (firstWaveform.ChannelNumber() != channel)
       channel = firstWaveform.ChannelNumber();
     
-    // we don't know how many... (maybe C++20 ranges will tell us)
-    MF_LOG_TRACE(details::TriggerGateDebugLog)
-      << "Building trigger gates from waveforms on channel " << channel;
+    for (TriggerGates& thrGates: allGates) thrGates.gateFor(firstWaveform);
+    
+    allChannelWaveforms.push_back(channelWaveforms);
+    
+  } // for channels
+  
+  std::vector<std::vector<GateInfo_t>> allChannelGates;
+  allChannelGates.reserve(allChannelWaveforms.size());
+  for (ChannelWaveforms_t const& channelWaveforms: allChannelWaveforms) {
+    
+    raw::Channel_t const waveformChannel
+      = channelWaveforms.front().waveform().ChannelNumber();
     
     std::vector<GateInfo_t> channelGates;
     channelGates.reserve(nChannelThresholds());
     for (TriggerGates& thrGates: allGates) {
-      channelGates.push_back 
-        (gateManager.create(thrGates.gateFor(firstWaveform)));
+      auto* const gate = thrGates.getGateFor(waveformChannel);
+      assert(gate);
+      channelGates.push_back(gateManager.create(*gate));
     }
-    
-    // this method will update the channel gates referenced in `channelGates`,
-    // which are owned by `allGates`
-    buildChannelGates(channelGates, channelWaveforms);
-    
+    allChannelGates.push_back(std::move(channelGates));
   } // for channels
   
+  //
+  // process the waveforms channel by channel, in parallel;
+  // each call updates only the gates of its channel referenced in its
+  // `channelGates`, which are owned by `allGates`
+  //
+  tbb::parallel_for(std::size_t{ 0 }, allChannelWaveforms.size(),
+    [this,&allChannelGates,&allChannelWaveforms](std::size_t iChannel)
+      {
+        MF_LOG_TRACE(details::TriggerGateDebugLog)
+          << "Building trigger gates from waveforms on channel "
+          << allChannelWaveforms[iChannel].front().waveform().ChannelNumber();
+        
+        buildChannelGates
+          (allChannelGates[iChannel], allChannelWaveforms[iChannel]);
+      }
+    );
+  
   return allGates;
 } // icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild()
 
@@ -110,14 +138,8 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
   Waveforms const& channelWaveforms
 ) const
 {
-  using ops = icarus::waveform_operations::NegativePolarityOperations<float>;
-  
   if (channelWaveforms.empty()) return;
   
-  //
-  // extract all thresholds from each waveform in one pass
-  //
-  
   raw::OpDetWaveform const& firstWaveform
     = channelWaveforms.front().waveform();
   raw::Channel_t const channel = firstWaveform.ChannelNumber();
@@ -138,17 +160,6 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
 
     raw::OpDetWaveform const& waveform = waveformData.waveform();
     
-    ops const waveOps { waveformData.baseline().baseline() };
-    
-    // baseline subtraction is performed in floating point,
-    // but then rounding is applied again
-    auto subtractBaseline = [waveOps](float sample) -> ADCCounts_t
-      {
-        return
-          ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)));
-      };
-    
-    
     ++nWaveforms;
     assert(waveform.ChannelNumber() == channel);
     
@@ -168,145 +179,37 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
     assert(lastWaveformTick <= waveformTickStart);
     lastWaveformTick = waveformTickEnd;
     
-    auto const tbegin = channelThresholds().begin();
-    auto const tend = channelThresholds().end();
-    
     // register this waveform with the gates (this feature is unused here)
     for (auto& gateInfo: channelGates) gateInfo.addTrackingInfo(waveform);
     
     // all gates start closed; this gate is not necessarily closed, but the
     // waveform is not above the gate threshold any more.
-    auto nextGateToOpen = channelGates.begin();
-    
-    // we keep track of whether we have no lower or higher thresholds available
-    // to simplify the checks;
-    // we name them "pp" because they behave (almost) like pointers to pointers
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic push
-    # if (__GNUC__ <= 9) // last tested with: GCC 9.3.0
-    #  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-    # else
-    //#  error "Maintenance required here. See comments in the code"
-    /* [20210715 petrillo@slac.stanford.edu] The comments in the code:
-     * GCC 9.3.0 erroneously thinks that `ppXxxerThreshold` value _might_ be
-     * used before initialization. Due to the logic of the program, that is
-     * not the case (unless I am wrong!), and the only "solution" I have found
-     * is to disable the warning; Clang 7 on the other end does not complain.
-     * When GCC is updated and support for GCC 9 is dropped, this situation
-     * should be revisited by attempting the compilation with the warning
-     * still enabled (by just commenting out the #error directive).
-     * If compilation succeeds, this whole block and the `pop` directive below
-     * have become unnecessary and should be removed. Otherwise, the GCC version
-     * in the check above should be bumped up to cover the last tested GCC
-     * (here I went lazy and stuck to just the major version).
-     * I do not know which newer GCC version, if any, solves this issue so far.
-     */
-    # endif // GCC version
-    #endif // GCC
-    using ThresholdIterPtr_t
-      = std::optional<std::vector<ADCCounts_t>::const_iterator>;
-    // start at bottom with no lower threshold:
-    ThresholdIterPtr_t ppLowerThreshold = std::nullopt;
-    ThresholdIterPtr_t ppUpperThreshold = std::nullopt;
-    if (!channelThresholds().empty())
-      ppUpperThreshold = channelThresholds().begin(); // std::optional behavior
-    
-    for (auto iSample: util::counter<std::ptrdiff_t>(waveform.size())) {
+    // The level is the number of thresholds the waveform is at or above of,
+    // and also the index of the next gate to be opened.
+    std::size_t level = 0U;
+    std::vector<ThresholdCrossing_t> const crossings
+      = findThresholdCrossings(waveformData);
+    for (ThresholdCrossing_t const& crossing: crossings) {
+      optical_tick const tick
+        = waveformTickStart + optical_time_ticks{ crossing.sample };
       
-      // baseline subtraction is always a subtraction (as in "A minus B"),
-      // regardless the polarity of the waveform
-      auto const sample = waveform[iSample];
-      ADCCounts_t const relSample = subtractBaseline(sample);
-      
-      /* // this is too much also for regular debugging...
       MF_LOG_TRACE(details::TriggerGateDebugLog)
-        << "Sample #" << iSample << ": " << sample << " [=> " << relSample
-        << "]; thresholds lower: "
-          << (ppLowerThreshold? util::to_string(**ppLowerThreshold): "none")
-        << ", upper: "
-          << (ppUpperThreshold? util::to_string(**ppUpperThreshold): "none")
-        ;
-      */
+        << "Sample #" << crossing.sample << " (" << waveform[crossing.sample]
+        << " on " << waveformData.baseline().baseline()
+        << ") moves from " << level << " to " << crossing.level
+        << " thresholds at " << tick;
       
-      //
-      // if this sample is lower than the current lower threshold,
-      // we are just tracking the thresholds: gate closing has already happened
-      //
-      if (ppLowerThreshold && (relSample < **ppLowerThreshold)) {
-        
-        MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") leaving thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // if there is an lower threshold, there must also be a open gate!
-          assert(nextGateToOpen != channelGates.begin());
-          
-          
-          (--nextGateToOpen)->belowThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "  => decreasing threshold " << **ppLowerThreshold;
-          
-          if (*ppLowerThreshold == tbegin) { // was this the bottom threshold?
-            ppLowerThreshold = std::nullopt;
-            break;
-          }
-          --*ppLowerThreshold; // point to previous threshold
-          
-        } while (relSample < **ppLowerThreshold);
-        
-        // we can't be at the top since we just closed a gate
-        ppUpperThreshold
-          = ppLowerThreshold? std::next(*ppLowerThreshold): tbegin;
-        
-      } // if closing gate
+      // we keep opening gates at increasing thresholds;
+      // note that it is not guaranteed that gates at lower thresholds are
+      // still open (that depends on the builder implementation)
+      while (level < crossing.level)
+        channelGates[level++].aboveThresholdAt(tick);
       
-      //
-      // if this sample is greater or matching the next threshold,
-      // we *are* opening gate(s)
-      //
-      else if (ppUpperThreshold && (relSample >= **ppUpperThreshold)) {
-        
-        MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") passing thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // note that it is not guaranteed that gates at lower thresholds are
-          // still open (that depends on the builder implementation)
-          
-          // if there is an upper threshold, there must also be a closed gate!
-          assert(nextGateToOpen != channelGates.end());
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "Opening thr=" << (**ppUpperThreshold);
-          
-          (nextGateToOpen++)->aboveThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          if (++*ppUpperThreshold == tend) { // was this the top threshold?
-            ppUpperThreshold = std::nullopt;
-            break;
-          }
-          
-        } while (relSample >= **ppUpperThreshold);
-        
-        // we can't be at the bottom since we just opened a gate
-        ppLowerThreshold = std::prev(ppUpperThreshold? *ppUpperThreshold: tend);
-        
-      } // if opening gate
+      // ... or closing them at decreasing thresholds
+      while (level > crossing.level)
+        channelGates[--level].belowThresholdAt(tick);
       
-    } // for threshold
-
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic pop
-    #endif // __clang__
+    } // for crossings
     
   } // for waveforms
   
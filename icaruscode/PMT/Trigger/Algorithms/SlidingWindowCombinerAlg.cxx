@@ -199,7 +199,10 @@ auto icarus::trigger::SlidingWindowCombinerAlg::firstChannelPresent
 {
   auto iChannel = channels.begin();
   auto const cend = channels.end();
-  while (iChannel != cend) if (!isMissingChannel(*iChannel)) return iChannel;
+  while (iChannel != cend) {
+    if (!isMissingChannel(*iChannel)) return iChannel;
+    ++iChannel;
+  }
   return cend;
 } // icarus::trigger::SlidingWindowCombinerAlg::firstChannelPresent()
 
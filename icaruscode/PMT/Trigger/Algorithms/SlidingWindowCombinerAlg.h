@@ -124,8 +124,9 @@ class icarus::trigger::SlidingWindowCombinerAlg {
 inline bool icarus::trigger::SlidingWindowCombinerAlg::isMissingChannel
   (raw::Channel_t channel) const
 {
-  return std::find(fMissingChannels.begin(), fMissingChannels.end(), channel)
-    != fMissingChannels.end();
+  // fMissingChannels is sorted
+  return std::binary_search
+    (fMissingChannels.begin(), fMissingChannels.end(), channel);
 } // icarus::trigger::SlidingWindowCombinerAlg::isMissingChannel()
 
 
@@ -24,9 +24,10 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 // C/C++ standard libraries
-#include <algorithm> // std::binary_search()
+#include <algorithm> // std::binary_search(), std::max()
 #include <utility> // std::pair<>, std::move()
 #include <optional>
+#include <string>
 #include <cassert>
 
 
@@ -67,18 +68,51 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   auto const& inBeamGates = fBeamGate? fBeamGate->applyToAll(gates): gates;
   
   //
-  // 2.   apply pattern:
+  // 2.   apply pattern
   //
+  auto const gateResponse = [this,&inBeamGates](std::size_t iWindow)
+    { return applyWindowPattern(fWindowPattern, iWindow, inBeamGates); };
+  
+  if (fEvaluationMode == EvaluationMode_t::Gates)
+    return collectResponses(gateResponse);
+  
+  // all gates are discriminated at once
+  std::vector<TriggerGateData_t const*> gateData;
+  gateData.reserve(inBeamGates.size());
+  for (InputTriggerGate_t const& gate: inBeamGates)
+    gateData.push_back(&gateIn(gate));
+  icarus::trigger::WindowGateBitsets const bits
+    { gateData, maxPatternLevel(fWindowPattern) };
+  
+  AllTriggerInfo_t bitsetResponse = collectResponses(
+    [this,&inBeamGates,&bits](std::size_t iWindow)
+      {
+        return applyWindowPattern
+          (fWindowTopology.info(iWindow), fWindowPattern, inBeamGates, bits);
+      }
+    );
+  
+  if (fEvaluationMode == EvaluationMode_t::Validate)
+    compareResponses(collectResponses(gateResponse), bitsetResponse);
+  
+  return bitsetResponse;
+} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+
+
+//------------------------------------------------------------------------------
+template <typename WindowResponse>
+auto icarus::trigger::SlidingWindowPatternAlg::collectResponses
+  (WindowResponse windowResponse) const -> AllTriggerInfo_t
+{
   std::size_t const nWindows = fWindowTopology.nWindows();
     
   //
-  // 2.1.   for each main window, apply the pattern
+  // for each main window, apply the pattern
   //
   WindowTriggerInfo_t triggerInfo; // start empty
   for (std::size_t const iWindow: util::counter(nWindows)) {
     
-    TriggerInfo_t const windowResponse
-      = applyWindowPattern(fWindowPattern, iWindow, inBeamGates);
+    TriggerInfo_t const windowResponse = windowResponse(iWindow);
     
     if (!windowResponse) continue;
     
@@ -104,8 +138,8 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
     }
     
     //
-    // 2.2. pick the main window with the earliest successful response, if any;
-    //      that defines location and time of the trigger
+    // pick the main window with the earliest successful response, if any;
+    // that defines location and time of the trigger
     //
     if (!triggerInfo || triggerInfo.info.atTick() > windowResponse.atTick()) {
       if (!triggerInfo) mfLogTrace() << "  (new global trigger)";
@@ -115,7 +149,20 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   } // main window choice
   
   return { std::move(triggerInfo.info), MoreInfo_t{ triggerInfo.windowIndex } };
-} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+} // icarus::trigger::SlidingWindowPatternAlg::collectResponses()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::parseEvaluationMode
+  (std::string const& name) -> EvaluationMode_t
+{
+  if (name == "Gates") return EvaluationMode_t::Gates;
+  if (name == "Bitsets") return EvaluationMode_t::Bitsets;
+  if (name == "Validate") return EvaluationMode_t::Validate;
+  throw cet::exception("SlidingWindowPatternAlg")
+    << "Unknown pattern evaluation mode: '" << name
+    << "' (supported: 'Gates', 'Bitsets', 'Validate').\n";
+} // icarus::trigger::SlidingWindowPatternAlg::parseEvaluationMode()
 
 
 //------------------------------------------------------------------------------
@@ -353,4 +400,196 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
 } // icarus::trigger::SlidingWindowTriggerEfficiencyPlots::applyWindowPattern()
 
 
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
+  WindowTopology_t::WindowInfo_t const& windowInfo,
+  WindowPattern_t const& pattern,
+  TriggerGates_t const& gates,
+  icarus::trigger::WindowGateBitsets const& bits
+  ) const -> TriggerInfo_t
+{
+  
+  /*
+   * This follows the same steps as the gate version of `applyWindowPattern()`,
+   * with the discriminated gates replaced by bitsets:
+   * 1. check that the pattern can be applied; if not, return no trigger
+   * 2. combine in AND the bitsets of all the relevant requirements
+   * 3. each sequence of set buckets is a trigger opening; its level is the
+   *    maximum of the base gate (main, or main plus opposite window) in it
+   */
+  using WindowGateBitsets = icarus::trigger::WindowGateBitsets;
+  
+  TriggerInfo_t res; // no trigger by default
+  assert(!res);
+  
+  WindowTopology_t::WindowTopology_t const& winTopology
+    = windowInfo.topology;
+  
+  //
+  // 1. check that the pattern can be applied; if not, return no trigger
+  //
+  if (pattern.requireUpstreamWindow && !winTopology.hasUpstreamWindow())
+    return res;
+  if (pattern.requireDownstreamWindow && !winTopology.hasDownstreamWindow())
+    return res;
+  
+  //
+  // 2. combine in AND the bitsets of all the relevant requirements
+  //
+  std::size_t const iMain = winTopology.index;
+  bool const sumMode = (pattern.minSumInOppositeWindows > 0U);
+  bool const sumOpposite = sumMode && winTopology.hasOppositeWindow();
+  
+  // the base trigger primitive must be open
+  WindowGateBitsets::Bits_t trigBits = sumOpposite
+    ? bits.sumAtLeast(iMain, winTopology.opposite, 1U)
+    : bits.atLeast(iMain, 1U)
+    ;
+  
+  if (pattern.minInMainWindow > 0U) {
+    WindowGateBitsets::intersect
+      (trigBits, bits.atLeast(iMain, pattern.minInMainWindow));
+  }
+  
+  if ((pattern.minInOppositeWindow > 0U) && winTopology.hasOppositeWindow()) {
+    WindowGateBitsets::intersect(trigBits,
+      bits.atLeast(winTopology.opposite, pattern.minInOppositeWindow));
+  }
+  
+  if (sumMode) {
+    WindowGateBitsets::intersect(trigBits, sumOpposite
+      ? bits.sumAtLeast
+        (iMain, winTopology.opposite, pattern.minSumInOppositeWindows)
+      : bits.atLeast(iMain, pattern.minSumInOppositeWindows)
+      );
+  }
+  
+  if ((pattern.minInUpstreamWindow > 0U) && winTopology.hasUpstreamWindow()) {
+    WindowGateBitsets::intersect(trigBits,
+      bits.atLeast(winTopology.upstream, pattern.minInUpstreamWindow));
+  }
+  
+  if ((pattern.minInDownstreamWindow > 0U)
+    && winTopology.hasDownstreamWindow()
+  ) {
+    WindowGateBitsets::intersect(trigBits,
+      bits.atLeast(winTopology.downstream, pattern.minInDownstreamWindow));
+  }
+  
+  std::size_t iBucket = bits.findSet(trigBits);
+  if (iBucket == WindowGateBitsets::NoBucket) return res; // most common case
+  
+  //
+  // 3. each sequence of set buckets is a trigger opening
+  //
+  std::optional<TriggerGateData_t> mainPlusOpposite;
+  if (sumOpposite) {
+    mainPlusOpposite.emplace(sumGates
+      (gateIn(gates[iMain]), gateIn(gates[winTopology.opposite]))
+      );
+  }
+  TriggerGateData_t const& baseGate
+    = mainPlusOpposite? *mainPlusOpposite: gateIn(gates[iMain]);
+  
+  do {
+    std::size_t const iEnd = bits.findUnset(trigBits, iBucket);
+    TriggerGateData_t::ClockTick_t const start = bits.bucketStart(iBucket);
+    TriggerGateData_t::ClockTick_t const closing = bits.bucketEnd(iEnd - 1);
+    res.add({
+      TriggerInfo_t::optical_tick{ start },
+      baseGate.openingCount(baseGate.findMaxOpen(start, closing)),
+      TriggerInfo_t::LocationID_t{ iMain }
+      });
+    iBucket = bits.findSet(trigBits, iEnd);
+  } while (iBucket != WindowGateBitsets::NoBucket);
+  
+  mfLogTrace() << "Window #" << iMain << " pattern " << pattern.tag()
+    << ": " << res.nTriggers() << " openings from bitsets";
+  
+  return res;
+  
+} // icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::maxPatternLevel
+  (WindowPattern_t const& pattern) -> TriggerGateData_t::OpeningCount_t
+{
+  return static_cast<TriggerGateData_t::OpeningCount_t>(std::max({
+    1U, // the base gate is always required to be open
+    pattern.minInMainWindow,
+    pattern.minInUpstreamWindow,
+    pattern.minInDownstreamWindow,
+    pattern.minInOppositeWindow,
+    pattern.minSumInOppositeWindows
+    }));
+} // icarus::trigger::SlidingWindowPatternAlg::maxPatternLevel()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::SlidingWindowPatternAlg::compareResponses(
+  AllTriggerInfo_t const& gateResponse,
+  AllTriggerInfo_t const& bitsetResponse
+  ) const
+{
+  std::string errorMsg; // if this stays `empty()` there is no error
+  
+  using OpeningInfo_t = TriggerInfo_t::OpeningInfo_t;
+  
+  auto const sameOpening = [](OpeningInfo_t const& a, OpeningInfo_t const& b)
+    {
+      return (a.tick == b.tick) && (a.level == b.level)
+        && (a.locationID == b.locationID);
+    };
+  auto const openingStr = [](OpeningInfo_t const& info)
+    {
+      return "{ tick " + std::to_string(info.tick.value())
+        + ", level " + std::to_string(info.level)
+        + ", location " + std::to_string(info.locationID) + " }";
+    };
+  
+  TriggerInfo_t const& gateInfo = gateResponse.info;
+  TriggerInfo_t const& bitsetInfo = bitsetResponse.info;
+  if (gateInfo.fired() != bitsetInfo.fired()) {
+    errorMsg += std::string{ "gates " }
+      + (gateInfo.fired()? "fired": "did not fire") + ", bitsets "
+      + (bitsetInfo.fired()? "fired": "did not fire") + "\n";
+  }
+  else if (gateInfo.fired()) {
+    if (gateResponse.extra.windowIndex != bitsetResponse.extra.windowIndex) {
+      errorMsg += "trigger window: "
+        + std::to_string(gateResponse.extra.windowIndex) + " from gates, "
+        + std::to_string(bitsetResponse.extra.windowIndex) + " from bitsets\n";
+    }
+    if (!sameOpening(gateInfo.main(), bitsetInfo.main())) {
+      errorMsg += "main trigger: " + openingStr(gateInfo.main())
+        + " from gates, " + openingStr(bitsetInfo.main()) + " from bitsets\n";
+    }
+    if (gateInfo.nTriggers() != bitsetInfo.nTriggers()) {
+      errorMsg += "number of openings: " + std::to_string(gateInfo.nTriggers())
+        + " from gates, " + std::to_string(bitsetInfo.nTriggers())
+        + " from bitsets\n";
+    }
+    else {
+      for (std::size_t i = 0; i < gateInfo.nTriggers(); ++i) {
+        OpeningInfo_t const& gateOpening = gateInfo.all()[i];
+        OpeningInfo_t const& bitsetOpening = bitsetInfo.all()[i];
+        if (sameOpening(gateOpening, bitsetOpening)) continue;
+        errorMsg += "opening #" + std::to_string(i) + ": "
+          + openingStr(gateOpening) + " from gates, "
+          + openingStr(bitsetOpening) + " from bitsets\n";
+      } // for
+    }
+  } // if fired
+  
+  if (errorMsg.empty()) return;
+  
+  throw cet::exception("SlidingWindowPatternAlg")
+    << "Pattern " << fWindowPattern.tag()
+    << ": bitset evaluation does not match the gate evaluation:\n"
+    << errorMsg;
+  
+} // icarus::trigger::SlidingWindowPatternAlg::compareResponses()
+
+
 //------------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h"
 #include "icaruscode/PMT/Trigger/Algorithms/ApplyBeamGate.h"
 #include "icaruscode/PMT/Trigger/Algorithms/details/TriggerInfo_t.h"
 #include "icaruscode/PMT/Trigger/Utilities/TrackedOpticalTriggerGate.h"
@@ -47,6 +48,23 @@ namespace icarus::trigger { class SlidingWindowPatternAlg; }
  * 
  * For the definition of the windows, see `icarus::trigger::WindowChannelMap`.
  * 
+ * 
+ * Evaluation modes
+ * -----------------
+ * 
+ * The pattern can be evaluated in different ways (`setEvaluationMode()`):
+ * * `EvaluationMode_t::Gates` (default): for each window, the relevant gates
+ *   are discriminated and multiplied, gate by gate;
+ * * `EvaluationMode_t::Bitsets`: all the gates are discriminated once per
+ *   event into `icarus::trigger::WindowGateBitsets`, and the requirements of
+ *   each window are combined with bitwise operations; the gate levels are
+ *   still used to assign the level of each trigger opening;
+ * * `EvaluationMode_t::Validate`: both the above are run, and an exception is
+ *   thrown if their responses differ in any detail.
+ * 
+ * The two evaluations are expected to give identical responses; the bitset one
+ * avoids the creation of new gates for most windows, which do not fire.
+ * 
  */
 class icarus::trigger::SlidingWindowPatternAlg
   : public icarus::ns::util::mfLoggingClass
@@ -81,6 +99,13 @@ class icarus::trigger::SlidingWindowPatternAlg
     
   }; // struct MoreInfo_t
   
+  /// How the pattern is evaluated.
+  enum class EvaluationMode_t {
+    Gates,    ///< Combination of discriminated gates.
+    Bitsets,  ///< Bitwise combination of discriminated gates.
+    Validate  ///< Both the above, with a check that the results match.
+  }; // EvaluationMode_t
+  
   /// Complete information from this algorithm, standard + non-standard (extra).
   struct AllTriggerInfo_t {
     TriggerInfo_t info; ///< Standard trigger information.
@@ -165,6 +190,22 @@ class icarus::trigger::SlidingWindowPatternAlg
   void clearBeamGate();
   
   
+  /// Returns the current evaluation mode.
+  EvaluationMode_t evaluationMode() const { return fEvaluationMode; }
+  
+  /// Sets how the pattern is evaluated.
+  void setEvaluationMode(EvaluationMode_t mode) { fEvaluationMode = mode; }
+  
+  /**
+   * @brief Returns the evaluation mode with the specified name.
+   * @param name name of the mode (`"Gates"`, `"Bitsets"` or `"Validate"`)
+   * @return the evaluation mode
+   * @throw cet::exception (category: `SlidingWindowPatternAlg`) if the name
+   *        is not known
+   */
+  static EvaluationMode_t parseEvaluationMode(std::string const& name);
+  
+  
   /**
    * @brief Returns the trigger response for the specified window pattern.
    * @param windowInfo the topology of the windows
@@ -223,6 +264,48 @@ class icarus::trigger::SlidingWindowPatternAlg
   /// Time interval when to evaluate the trigger.
   std::optional<icarus::trigger::ApplyBeamGateClass const> fBeamGate;
   
+  /// How the pattern is evaluated.
+  EvaluationMode_t fEvaluationMode = EvaluationMode_t::Gates;
+  
+  
+  /// Returns the response of the windows, each from `windowResponse(iWindow)`.
+  template <typename WindowResponse>
+  AllTriggerInfo_t collectResponses(WindowResponse windowResponse) const;
+  
+  /**
+   * @brief Returns the trigger response for the specified window pattern.
+   * @param windowInfo the topology of the windows
+   * @param pattern the trigger requirement pattern
+   * @param gates trigger gates, one per window
+   * @param bits the discriminated `gates`
+   * @return a `TriggerInfo_t` record with the response of the pattern
+   * 
+   * This is the bitset evaluation of `applyWindowPattern()`; `bits` must have
+   * been built from `gates` with a level at least as large as all the ones
+   * required by `pattern` (see `maxPatternLevel()`).
+   */
+  TriggerInfo_t applyWindowPattern(
+    WindowTopology_t::WindowInfo_t const& windowInfo,
+    WindowPattern_t const& pattern,
+    TriggerGates_t const& gates,
+    icarus::trigger::WindowGateBitsets const& bits
+    ) const;
+  
+  /// Returns the highest gate level `pattern` needs to be discriminated at.
+  static TriggerGateData_t::OpeningCount_t maxPatternLevel
+    (WindowPattern_t const& pattern);
+  
+  /**
+   * @brief Checks that two responses are identical.
+   * @param gateResponse the response from `EvaluationMode_t::Gates`
+   * @param bitsetResponse the response from `EvaluationMode_t::Bitsets`
+   * @throw cet::exception (category: `SlidingWindowPatternAlg`) on mismatch
+   */
+  void compareResponses(
+    AllTriggerInfo_t const& gateResponse,
+    AllTriggerInfo_t const& bitsetResponse
+    ) const;
+  
   
   /**
    * @brief Returns the trigger response for the specified window pattern.
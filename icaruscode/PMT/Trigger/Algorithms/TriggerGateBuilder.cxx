@@ -129,6 +129,15 @@ auto icarus::trigger::TriggerGateBuilder::TriggerGates::getGateFor
   return (it == fGates.end())? nullptr: &*it;
 }
 
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::TriggerGateBuilder::TriggerGates::getGateFor
+  (raw::Channel_t const channel) -> triggergate_t*
+{
+  auto const it = findGateFor(channel);
+  return (it == fGates.end())? nullptr: &*it;
+}
+
 //------------------------------------------------------------------------------
 auto icarus::trigger::TriggerGateBuilder::TriggerGates::gateFor
   (raw::OpDetWaveform const& waveform) -> triggergate_t&
@@ -151,6 +151,9 @@ class icarus::trigger::TriggerGateBuilder {
     /// Returns the gate for the specified waveform `channel`, `nullptr` if n/a.
     triggergate_t const* getGateFor(raw::Channel_t const channel) const;
     
+    /// Returns the gate for the specified waveform `channel`, `nullptr` if n/a.
+    triggergate_t* getGateFor(raw::Channel_t const channel);
+    
     /// Returns (and creates, if necessary) the gate for the specified waveform.
     triggergate_t& gateFor(raw::OpDetWaveform const& waveform);
     
@@ -0,0 +1,188 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.cxx
+ * @brief  Compact bitset representation of sliding window trigger gates.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h
+ */
+
+
+// library header
+#include "icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::sort(), std::unique(), std::upper_bound()
+#include <iterator> // std::distance()
+#include <utility> // std::pair<>
+#include <cassert>
+
+
+//------------------------------------------------------------------------------
+icarus::trigger::WindowGateBitsets::WindowGateBitsets(
+  std::vector<TriggerGateData_t const*> const& gates,
+  OpeningCount_t maxLevel
+  )
+  : fNWindows{ gates.size() }
+  , fMaxLevel{ maxLevel }
+{
+  using Interval_t = std::pair<ClockTick_t, ClockTick_t>;
+  constexpr ClockTick_t MinTick = TriggerGateData_t::MinTick;
+  constexpr ClockTick_t MaxTick = TriggerGateData_t::MaxTick;
+
+  //
+  // 1. discriminate each gate at each level, collecting the opening intervals
+  //    with the same rules as `icarus::trigger::discriminate()`
+  //
+  std::vector<std::vector<Interval_t>> intervals(fNWindows * fMaxLevel);
+  fBucketStarts.push_back(MinTick);
+  for (std::size_t iWindow = 0; iWindow < fNWindows; ++iWindow) {
+    TriggerGateData_t const& gate = *(gates[iWindow]);
+    for (OpeningCount_t level = 1; level <= fMaxLevel; ++level) {
+      std::vector<Interval_t>& levelIntervals
+        = intervals[(iWindow * fMaxLevel) + (level - 1)];
+
+      ClockTick_t tick = MinTick;
+      if (gate.openingCount(tick) >= level) {
+        tick = gate.findClose(level, tick + 1);
+        levelIntervals.emplace_back(MinTick, tick);
+      }
+      while (tick < MaxTick) {
+        ClockTick_t const open = gate.findOpen(level, tick + 1);
+        if (open == MaxTick) break;
+        tick = gate.findClose(level, open + 1);
+        levelIntervals.emplace_back(open, tick);
+      } // while
+
+      for (auto const& [ open, close ]: levelIntervals) {
+        fBucketStarts.push_back(open);
+        if (close != MaxTick) fBucketStarts.push_back(close);
+      }
+    } // for levels
+  } // for windows
+
+  //
+  // 2. the bucket edges are all the ticks where any gate changes state
+  //
+  std::sort(fBucketStarts.begin(), fBucketStarts.end());
+  fBucketStarts.erase(
+    std::unique(fBucketStarts.begin(), fBucketStarts.end()),
+    fBucketStarts.end()
+    );
+
+  //
+  // 3. fill the bits
+  //
+  fBits.assign(intervals.size(), Bits_t(nWords(), Word_t{ 0 }));
+  for (std::size_t i = 0; i < intervals.size(); ++i) {
+    for (auto const& [ open, close ]: intervals[i]) {
+      setRange(fBits[i], bucketOf(open),
+        (close == MaxTick)? nBuckets(): bucketOf(close));
+    }
+  } // for
+
+} // icarus::trigger::WindowGateBitsets::WindowGateBitsets()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::WindowGateBitsets::sumAtLeast
+  (std::size_t window1, std::size_t window2, OpeningCount_t level) const
+  -> Bits_t
+{
+  assert(level <= fMaxLevel);
+
+  // sum >= level if, for some k, window1 >= k and window2 >= (level - k);
+  // k = 0 and k = level are the cases with a single window
+  Bits_t sum = (level == 0)
+    ? Bits_t(nWords(), ~Word_t{ 0 }): atLeast(window2, level);
+  if (level == 0) return sum;
+
+  Bits_t const& all1 = atLeast(window1, level);
+  for (std::size_t i = 0; i < sum.size(); ++i) sum[i] |= all1[i];
+
+  for (OpeningCount_t k = 1; k < level; ++k) {
+    Bits_t const& bits1 = atLeast(window1, k);
+    Bits_t const& bits2 = atLeast(window2, level - k);
+    for (std::size_t i = 0; i < sum.size(); ++i) sum[i] |= bits1[i] & bits2[i];
+  } // for
+  return sum;
+} // icarus::trigger::WindowGateBitsets::sumAtLeast()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::trigger::WindowGateBitsets::findSet
+  (Bits_t const& bits, std::size_t from /* = 0 */) const
+{
+  std::size_t const n = nBuckets();
+  if (from >= n) return NoBucket;
+
+  std::size_t iWord = from / WordBits;
+  Word_t word = bits[iWord] & (~Word_t{ 0 } << (from % WordBits));
+  while (word == 0) {
+    if (++iWord >= bits.size()) return NoBucket;
+    word = bits[iWord];
+  }
+
+  // count the trailing zeroes
+  std::size_t iBit = 0;
+  while ((word & Word_t{ 1 }) == 0) { word >>= 1; ++iBit; }
+  std::size_t const iBucket = iWord * WordBits + iBit;
+  return (iBucket < n)? iBucket: NoBucket;
+} // icarus::trigger::WindowGateBitsets::findSet()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::trigger::WindowGateBitsets::findUnset
+  (Bits_t const& bits, std::size_t from) const
+{
+  std::size_t const n = nBuckets();
+  if (from >= n) return n;
+
+  std::size_t iWord = from / WordBits;
+  Word_t word = ~bits[iWord] & (~Word_t{ 0 } << (from % WordBits));
+  while (word == 0) {
+    if (++iWord >= bits.size()) return n;
+    word = ~bits[iWord];
+  }
+
+  std::size_t iBit = 0;
+  while ((word & Word_t{ 1 }) == 0) { word >>= 1; ++iBit; }
+  return std::min(iWord * WordBits + iBit, n);
+} // icarus::trigger::WindowGateBitsets::findUnset()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::WindowGateBitsets::intersect
+  (Bits_t& bits, Bits_t const& other)
+{
+  assert(bits.size() == other.size());
+  for (std::size_t i = 0; i < bits.size(); ++i) bits[i] &= other[i];
+} // icarus::trigger::WindowGateBitsets::intersect()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::trigger::WindowGateBitsets::bucketOf
+  (ClockTick_t tick) const
+{
+  auto const itNext
+    = std::upper_bound(fBucketStarts.begin(), fBucketStarts.end(), tick);
+  assert(itNext != fBucketStarts.begin());
+  return std::distance(fBucketStarts.begin(), itNext) - 1;
+} // icarus::trigger::WindowGateBitsets::bucketOf()
+
+
+//------------------------------------------------------------------------------
+void icarus::trigger::WindowGateBitsets::setRange
+  (Bits_t& bits, std::size_t first, std::size_t last)
+{
+  while (first < last) {
+    std::size_t const iWord = first / WordBits;
+    std::size_t const iBit = first % WordBits;
+    std::size_t const nBits = std::min(WordBits - iBit, last - first);
+    Word_t const mask = (nBits == WordBits)
+      ? ~Word_t{ 0 }: (((Word_t{ 1 } << nBits) - 1) << iBit);
+    bits[iWord] |= mask;
+    first += nBits;
+  } // while
+} // icarus::trigger::WindowGateBitsets::setRange()
+
+
+//------------------------------------------------------------------------------
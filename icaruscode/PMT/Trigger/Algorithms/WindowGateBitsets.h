@@ -0,0 +1,147 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h
+ * @brief  Compact bitset representation of sliding window trigger gates.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.cxx
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_ALGORITHMS_WINDOWGATEBITSETS_H
+#define ICARUSCODE_PMT_TRIGGER_ALGORITHMS_WINDOWGATEBITSETS_H
+
+
+// ICARUS libraries
+#include "sbnobj/ICARUS/PMT/Trigger/Data/OpticalTriggerGate.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <limits> // std::numeric_limits<>
+#include <cstdint> // std::uint64_t
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::trigger { class WindowGateBitsets; }
+/**
+ * @brief Window trigger gates as bitsets of "at least N open" on time buckets.
+ *
+ * The gates of all the windows are discriminated at all the levels from `1`
+ * to `maxLevel()`, and all the ticks where any of the discriminated gates
+ * changes state are collected. The time between two consecutive such ticks is
+ * a _bucket_: within a bucket, each window gate is steadily either above or
+ * below each of the levels. So for each window and level, a bitset with one
+ * bit per bucket fully describes when that window gate was at or above that
+ * level.
+ *
+ * The first bucket always starts at `MinTick`, and the last one extends to
+ * `MaxTick`.
+ *
+ * Requirements on windows are then combined with bitwise operations on a few
+ * 64-bit words: for example, the requirement on the sum of two windows
+ * (`sumAtLeast()`) is the bitwise "or", across all the ways to split the
+ * required level between the two windows, of the "and" of the two bitsets.
+ * The discrimination follows the same rules as
+ * `icarus::trigger::discriminate()`.
+ *
+ * This object does not keep any reference to the original gates.
+ */
+class icarus::trigger::WindowGateBitsets {
+
+    public:
+
+  /// Type of gate data (gate levels only).
+  using TriggerGateData_t = icarus::trigger::OpticalTriggerGateData_t;
+
+  /// Type of gate time.
+  using ClockTick_t = TriggerGateData_t::ClockTick_t;
+
+  /// Type of gate opening level.
+  using OpeningCount_t = TriggerGateData_t::OpeningCount_t;
+
+  using Word_t = std::uint64_t; ///< Type of storage for the bits.
+
+  using Bits_t = std::vector<Word_t>; ///< A bitset with one bit per bucket.
+
+  /// Value returned by searches when no bucket satisfies them.
+  static constexpr std::size_t NoBucket
+    = std::numeric_limits<std::size_t>::max();
+
+
+  /**
+   * @brief Constructor: discriminates all the `gates` up to `maxLevel`.
+   * @param gates the gate of each window, by window index
+   * @param maxLevel the highest level that can be queried
+   */
+  WindowGateBitsets(
+    std::vector<TriggerGateData_t const*> const& gates,
+    OpeningCount_t maxLevel
+    );
+
+
+  /// Returns the number of windows.
+  std::size_t nWindows() const { return fNWindows; }
+
+  /// Returns the highest level that can be queried.
+  OpeningCount_t maxLevel() const { return fMaxLevel; }
+
+  /// Returns the number of time buckets.
+  std::size_t nBuckets() const { return fBucketStarts.size(); }
+
+  /// Returns the first tick of the bucket `iBucket`.
+  ClockTick_t bucketStart(std::size_t iBucket) const
+    { return fBucketStarts[iBucket]; }
+
+  /// Returns the tick after the end of the bucket `iBucket` (may be `MaxTick`).
+  ClockTick_t bucketEnd(std::size_t iBucket) const
+    {
+      return (iBucket + 1 < nBuckets())
+        ? fBucketStarts[iBucket + 1]: TriggerGateData_t::MaxTick;
+    }
+
+  /// Returns the buckets where `window` has at least `level` (`>= 1`) open.
+  Bits_t const& atLeast(std::size_t window, OpeningCount_t level) const
+    { return fBits[(window * fMaxLevel) + (level - 1)]; }
+
+  /// Returns the buckets where `window1` plus `window2` have at least `level`.
+  Bits_t sumAtLeast
+    (std::size_t window1, std::size_t window2, OpeningCount_t level) const;
+
+  /// Returns the index of the first bucket set in `bits`, from `from` on.
+  std::size_t findSet(Bits_t const& bits, std::size_t from = 0) const;
+
+  /// Returns the index of the first bucket unset in `bits`, from `from` on.
+  /// If all buckets are set, `nBuckets()` is returned.
+  std::size_t findUnset(Bits_t const& bits, std::size_t from) const;
+
+
+  /// Sets `bits` to the buckets set both in `bits` and `other`.
+  static void intersect(Bits_t& bits, Bits_t const& other);
+
+
+    private:
+
+  static constexpr std::size_t WordBits = std::numeric_limits<Word_t>::digits;
+
+  std::size_t fNWindows = 0; ///< Number of windows.
+
+  OpeningCount_t fMaxLevel = 0; ///< Highest level available.
+
+  std::vector<ClockTick_t> fBucketStarts; ///< Start tick of each bucket.
+
+  /// Bitsets by window and level (`1` to `fMaxLevel`).
+  std::vector<Bits_t> fBits;
+
+  /// Returns the number of words needed to store all buckets.
+  std::size_t nWords() const { return (nBuckets() + WordBits - 1) / WordBits; }
+
+  /// Returns the bucket including `tick`.
+  std::size_t bucketOf(ClockTick_t tick) const;
+
+  /// Sets the bits of the buckets `[ first, last [` in `bits`.
+  static void setRange(Bits_t& bits, std::size_t first, std::size_t last);
+
+}; // icarus::trigger::WindowGateBitsets
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_TRIGGER_ALGORITHMS_WINDOWGATEBITSETS_H
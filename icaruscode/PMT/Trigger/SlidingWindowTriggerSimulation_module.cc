@@ -158,6 +158,12 @@ namespace icarus::trigger { class SlidingWindowTriggerSimulation; }
  *     the actual beam gate opens at;
  * * `BeamBits` (bitmask as 32-bit integral number): bits to be set in the
  *     produced `raw::Trigger` objects (see also `daq::TriggerDecoder` tool).
+ * * `PatternEvaluation` (string, default: `Gates`): how the pattern is
+ *     evaluated: `Gates` combines discriminated trigger gates window by window,
+ *     `Bitsets` discriminates all the gates once per event and combines the
+ *     requirements with bitwise operations, and `Validate` runs both and
+ *     throws an exception if their results differ (see
+ *     `icarus::trigger::SlidingWindowPatternAlg` for details).
  * * `LogCategory` (string, default `SlidingWindowTriggerSimulation`): name of
  *     category used to stream messages from this module into message facility.
  * 
@@ -333,6 +339,12 @@ class icarus::trigger::SlidingWindowTriggerSimulation
       300 // 5 minutes
       };
     
+    fhicl::Atom<std::string> PatternEvaluation {
+      Name("PatternEvaluation"),
+      Comment("pattern evaluation: \"Gates\", \"Bitsets\" or \"Validate\""),
+      "Gates" // default
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category used for the output"),
@@ -415,6 +427,10 @@ class icarus::trigger::SlidingWindowTriggerSimulation
   
   double fEventTimeBinning; ///< Trigger time plot binning [s]
   
+  /// How the trigger pattern is evaluated.
+  icarus::trigger::SlidingWindowPatternAlg::EvaluationMode_t const
+    fPatternEvaluation;
+  
   /// Message facility stream category for output.
   std::string const fLogCategory;
   
@@ -590,6 +606,10 @@ icarus::trigger::SlidingWindowTriggerSimulation::SlidingWindowTriggerSimulation
   , fBeamBits             (config().BeamBits())
   , fTriggerTimeResolution(config().TriggerTimeResolution())
   , fEventTimeBinning     (config().EventTimeBinning())
+  , fPatternEvaluation
+      (icarus::trigger::SlidingWindowPatternAlg::parseEvaluationMode
+        (config().PatternEvaluation())
+      )
   , fLogCategory          (config().LogCategory())
   // services
   , fOutputDir (*art::ServiceHandle<art::TFileService>())
@@ -986,8 +1006,10 @@ auto icarus::trigger::SlidingWindowTriggerSimulation::produceForThreshold(
   
   
   // extract or verify the topology of the trigger windows
-  if (fWindowMapMan(gates))
+  if (fWindowMapMan(gates)) {
     fPatternAlg.emplace(*fWindowMapMan, fPattern, fLogCategory);
+    fPatternAlg->setEvaluationMode(fPatternEvaluation);
+  }
   assert(fPatternAlg);
   
   //
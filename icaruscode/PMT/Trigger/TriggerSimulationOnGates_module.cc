@@ -196,6 +196,12 @@ namespace icarus::trigger { class TriggerSimulationOnGates; }
  *     there are cryostats in the detector (thus, 2 for ICARUS). The value `0`
  *     represents the least significant bit. Using a value larger than the size
  *     of the trigger bit field (which is the default) will disable this mark.
+ * * `PatternEvaluation` (string, default: `Gates`): how the pattern is
+ *     evaluated: `Gates` combines discriminated trigger gates window by window,
+ *     `Bitsets` discriminates all the gates once per event and combines the
+ *     requirements with bitwise operations, and `Validate` runs both and
+ *     throws an exception if their results differ (see
+ *     `icarus::trigger::SlidingWindowPatternAlg` for details).
  * * `LogCategory` (string, default `TriggerSimulationOnGates`): name of
  *     category used to stream messages from this module into message facility.
  * 
@@ -488,6 +494,12 @@ class icarus::trigger::TriggerSimulationOnGates
       300 // 5 minutes
       };
     
+    fhicl::Atom<std::string> PatternEvaluation {
+      Name("PatternEvaluation"),
+      Comment("pattern evaluation: \"Gates\", \"Bitsets\" or \"Validate\""),
+      "Gates" // default
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category used for the output"),
@@ -589,6 +601,10 @@ class icarus::trigger::TriggerSimulationOnGates
   
   double const fEventTimeBinning; ///< Trigger time plot binning [s]
   
+  /// How the trigger pattern is evaluated.
+  icarus::trigger::SlidingWindowPatternAlg::EvaluationMode_t const
+    fPatternEvaluation;
+  
   /// Message facility stream category for output.
   std::string const fLogCategory;
   
@@ -846,6 +862,10 @@ icarus::trigger::TriggerSimulationOnGates::TriggerSimulationOnGates
   , fCryostatZeroMask     (bitMask<TriggerBits_t>(config().CryostatFirstBit()))
   , fTriggerTimeResolution(config().TriggerTimeResolution())
   , fEventTimeBinning     (config().EventTimeBinning())
+  , fPatternEvaluation
+      (icarus::trigger::SlidingWindowPatternAlg::parseEvaluationMode
+        (config().PatternEvaluation())
+      )
   , fLogCategory          (config().LogCategory())
   // services
   , fOutputDir (*art::ServiceHandle<art::TFileService>())
@@ -1333,8 +1353,10 @@ auto icarus::trigger::TriggerSimulationOnGates::produceForThreshold(
   
   
   // extract or verify the topology of the trigger windows
-  if (fWindowMapMan(gates))
+  if (fWindowMapMan(gates)) {
     fPatternAlg.emplace(*fWindowMapMan, fPattern, fLogCategory);
+    fPatternAlg->setEvaluationMode(fPatternEvaluation);
+  }
   assert(fPatternAlg);
   
   //
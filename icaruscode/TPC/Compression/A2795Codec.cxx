@@ -0,0 +1,188 @@
+/**
+ * @file   icaruscode/TPC/Compression/A2795Codec.cxx
+ * @brief  Encoder and decoder of the A2795 TPC board delta compression.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/Compression/A2795Codec.h
+ */
+
+// library header
+#include "icaruscode/TPC/Compression/A2795Codec.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::copy_n()
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Marker of the words storing a full (12-bit) value.
+  constexpr std::uint16_t FullWordMarker = 0x8000;
+
+  /// Number of channels sharing a compression block.
+  constexpr std::size_t BlockSize = 4;
+
+
+  /**
+   * @brief Decodes the differences of one sample of all channels.
+   * @param data the compressed words of the sample
+   * @param nChannels number of channels in the board
+   * @param firstSample whether this is the first sample (stored as is)
+   * @param[out] diffs difference from the previous sample, per channel
+   * @return the number of compressed words of the sample
+   */
+  std::size_t decodeSampleDiffs(
+    std::uint16_t const* data, std::size_t nChannels, bool firstSample,
+    std::uint16_t* diffs
+  ) {
+    std::uint16_t const* word = data;
+    std::size_t nCompressed = 0;
+    for (std::size_t first = 0; first + BlockSize <= nChannels;
+      first += BlockSize
+    ) {
+      if ((*word & 0xF000) != FullWordMarker) {
+        // four 4-bit differences, sign-extended
+        std::uint16_t const packed = *(word++);
+        for (std::size_t i = 0; i < BlockSize; ++i) {
+          std::uint16_t const nibble = (packed >> (4 * i)) & 0x000F;
+          diffs[first + i] = (nibble & 0x0008)? (nibble | 0xFFF0): nibble;
+        }
+        ++nCompressed;
+      }
+      else {
+        // four 12-bit differences, sign-extended except for the first sample
+        for (std::size_t i = 0; i < BlockSize; ++i) {
+          std::uint16_t const value = *(word++) & 0x0FFF;
+          diffs[first + i] = (!firstSample && (value & 0x0800))
+            ? (value | 0xF000): value;
+        }
+      }
+    } // for blocks
+
+    // a spacer follows an odd number of compressed blocks
+    if (nCompressed % 2) ++word;
+    return word - data;
+  } // decodeSampleDiffs()
+
+
+  /**
+   * @brief Decodes a board, passing each sample to `store`.
+   * @param data the compressed words of the board
+   * @param nChannels number of channels in the board
+   * @param nSamples number of samples per channel
+   * @param store called as `store(sample, adcs)` with the ADC of all channels
+   * @return the number of compressed words of the board
+   *
+   * The differences of each sample are decoded first, and then summed to the
+   * previous sample all at once, in a loop the compiler can vectorize.
+   */
+  template <typename Store>
+  std::size_t decodeBoardImpl(
+    std::uint16_t const* data, std::size_t nChannels, std::size_t nSamples,
+    Store store
+  ) {
+    std::vector<std::uint16_t> row(nChannels, 0), diffs(nChannels);
+    std::uint16_t* const rowData = row.data();
+    std::uint16_t const* const diffData = diffs.data();
+
+    std::uint16_t const* word = data;
+    for (std::size_t sample = 0; sample < nSamples; ++sample) {
+      word += decodeSampleDiffs(word, nChannels, sample == 0, diffs.data());
+      for (std::size_t channel = 0; channel < nChannels; ++channel)
+        rowData[channel] += diffData[channel];
+      store(sample, rowData);
+    } // for samples
+    return word - data;
+  } // decodeBoardImpl()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::compression::encodeBoard(
+  std::uint16_t const* adcs, std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t* out
+) {
+  if (nSamples == 0) return 0;
+
+  std::uint16_t* word = out;
+
+  // the first sample is stored as is
+  for (std::size_t channel = 0; channel < nChannels; ++channel)
+    *(word++) = (adcs[channel] & 0x0FFF) + FullWordMarker;
+
+  // differences (modulo 2^16) and whether they fit in 4 bits, for all the
+  // channels of a sample at once, in loops the compiler can vectorize
+  std::vector<std::uint16_t> diffs(nChannels);
+  std::vector<std::uint8_t> small(nChannels);
+  std::uint16_t* const diffData = diffs.data();
+  std::uint8_t* const smallData = small.data();
+
+  for (std::size_t sample = 1; sample < nSamples; ++sample) {
+    std::uint16_t const* const row = adcs + sample * nChannels;
+    std::uint16_t const* const prev = row - nChannels;
+
+    for (std::size_t channel = 0; channel < nChannels; ++channel) {
+      std::uint16_t const diff = row[channel] - prev[channel];
+      diffData[channel] = diff;
+      // -7 <= diff <= +7
+      smallData[channel] = static_cast<std::uint16_t>(diff + 7) < 15;
+    }
+
+    bool oddCompressions = false;
+    for (std::size_t first = 0; first + BlockSize <= nChannels;
+      first += BlockSize
+    ) {
+      std::uint16_t const* const d = diffData + first;
+      std::uint8_t const* const s = smallData + first;
+      if (s[0] & s[1] & s[2] & s[3]) {
+        *(word++) = ((d[3] & 0x000F) << 12) | ((d[2] & 0x000F) << 8)
+          | ((d[1] & 0x000F) << 4) | (d[0] & 0x000F);
+        oddCompressions = !oddCompressions;
+      }
+      else {
+        for (std::size_t i = 0; i < BlockSize; ++i)
+          *(word++) = (d[i] & 0x0FFF) + FullWordMarker;
+      }
+    } // for blocks
+
+    // if there are an odd number of words in the difference, add a spacer
+    if (oddCompressions) *(word++) = 0;
+
+  } // for samples
+
+  return word - out;
+} // icarus::compression::encodeBoard()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::compression::decodeBoard(
+  std::uint16_t const* data, std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t* adcs
+) {
+  return decodeBoardImpl(data, nChannels, nSamples,
+    [adcs,nChannels](std::size_t sample, std::uint16_t const* row)
+      { std::copy_n(row, nChannels, adcs + sample * nChannels); }
+    );
+} // icarus::compression::decodeBoard(std::uint16_t*)
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::compression::decodeBoard(
+  std::uint16_t const* data, std::size_t nChannels, std::size_t nSamples,
+  float* plane
+) {
+  return decodeBoardImpl(data, nChannels, nSamples,
+    [plane,nChannels,nSamples](std::size_t sample, std::uint16_t const* row)
+      {
+        float* waveform = plane + sample;
+        for (std::size_t channel = 0; channel < nChannels; ++channel) {
+          *waveform = row[channel];
+          waveform += nSamples;
+        }
+      }
+    );
+} // icarus::compression::decodeBoard(float*)
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+/**
+ * @file   icaruscode/TPC/Compression/A2795Codec.h
+ * @brief  Encoder and decoder of the A2795 TPC board delta compression.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/Compression/A2795Codec.cxx
+ *
+ * The compression scheme is the one of the A2795 readout boards, as emulated
+ * by `ICARUSProduceCompressed` module.
+ */
+
+#ifndef ICARUSCODE_TPC_COMPRESSION_A2795CODEC_H
+#define ICARUSCODE_TPC_COMPRESSION_A2795CODEC_H
+
+
+// C/C++ standard libraries
+#include <cstdint> // std::uint16_t
+#include <cstddef> // std::size_t
+
+
+namespace icarus::compression {
+
+  /**
+   * @brief Encodes the ADC samples of a board with the A2795 delta compression.
+   * @param adcs ADC counts of the board, `adcs[sample * nChannels + channel]`
+   * @param nChannels number of channels in the board (a multiple of 4)
+   * @param nSamples number of samples per channel
+   * @param[out] out where to write the compressed 16-bit words
+   * @return the number of 16-bit words written into `out`
+   *
+   * The first sample of each channel is stored as is, as `0x8000` plus its
+   * 12-bit value. Each following sample is stored as the difference from the
+   * previous one, in blocks of 4 channels: if the differences of all the
+   * channels in the block are within `[ -7, +7 ]`, the block is stored in a
+   * single word of four 4-bit differences (the first channel in the lowest
+   * bits), otherwise it takes four words, each with `0x8000` plus a 12-bit
+   * difference. If the number of single-word blocks of a sample is odd, a
+   * `0x0000` spacer word follows the sample.
+   *
+   * The output buffer must have room for `nChannels * nSamples` words plus
+   * one spacer per sample. The headers and trailers of the board data tile
+   * are not part of the encoded data.
+   */
+  std::size_t encodeBoard(
+    std::uint16_t const* adcs, std::size_t nChannels, std::size_t nSamples,
+    std::uint16_t* out
+    );
+
+  /**
+   * @brief Decodes the compressed data of a board written by `encodeBoard()`.
+   * @param data the compressed 16-bit words
+   * @param nChannels number of channels in the board (a multiple of 4)
+   * @param nSamples number of samples per channel
+   * @param[out] adcs ADC counts of the board,
+   *                  `adcs[sample * nChannels + channel]`
+   * @return the number of compressed words read from `data`
+   *
+   * Differences stored in 12 bits are interpreted as signed; the ADC counts
+   * are the running sum of the differences modulo 2^16.
+   */
+  std::size_t decodeBoard(
+    std::uint16_t const* data, std::size_t nChannels, std::size_t nSamples,
+    std::uint16_t* adcs
+    );
+
+  /**
+   * @brief Decodes the compressed data of a board into channel waveforms.
+   * @param data the compressed 16-bit words
+   * @param nChannels number of channels in the board (a multiple of 4)
+   * @param nSamples number of samples per channel
+   * @param[out] plane ADC counts, `plane[channel * nSamples + sample]`
+   * @return the number of compressed words read from `data`
+   *
+   * This is the same as `decodeBoard()`, but the output is channel by channel
+   * and converted to floating point, as the TPC decoders use it.
+   */
+  std::size_t decodeBoard(
+    std::uint16_t const* data, std::size_t nChannels, std::size_t nSamples,
+    float* plane
+    );
+
+} // namespace icarus::compression
+
+
+#endif // ICARUSCODE_TPC_COMPRESSION_A2795CODEC_H
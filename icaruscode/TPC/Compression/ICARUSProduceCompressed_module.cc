@@ -1,6 +1,6 @@
 // std inlcudes
 #include <arpa/inet.h>
-#include <array>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -12,6 +12,9 @@
 #include "artdaq-core/Data/Fragment.hh"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+// icaruscode includes
+#include "icaruscode/TPC/Compression/A2795Codec.h"
+
 //namespace
 namespace reprocessRaw
 {
@@ -113,14 +116,6 @@ namespace reprocessRaw
         uint64_t newWord = (oldWord & filter) + ((value64 << shift) & ~filter);
         setFragmentWord(f, nWord / 4, newWord);
       }
-      size_t SampleBytesFromKey(std::array<bool, 16> const& key)
-      {
-        size_t nCompressed = 0;
-        for (auto const& bit : key)
-          nCompressed += bit;
-
-        return 128 - 6*nCompressed + 2*(nCompressed % 2);
-      }
       uint16_t adc_val(artdaq::Fragment const& f, size_t b, size_t c, size_t s)
       {
         size_t nChannels = f.metadata<MetaData>()->channels_per_board();
@@ -174,98 +169,40 @@ namespace reprocessRaw
     // go through board/channel/sample and load up the data
     // data is stored in channel->sample->board
     // keep track of where we are reading from/writing to
+    // (the fragment is a sequence of 16-bit A2795 words)
+    uint16_t const* uncompressedData = reinterpret_cast<uint16_t const*>(f.dataBeginBytes());
+    uint16_t*         compressedData = reinterpret_cast<uint16_t*>(compressed_fragment.dataBeginBytes());
     size_t   compressedDataOffset = 0;
     size_t uncompressedDataOffset = 0;
-    std::vector<std::array<bool, 16>> compressionKeys;
-    compressionKeys.resize(nBoards * nSamples);
     size_t totalDataTileSize = 0;
+
+    // the ADC values of a board, with the same mask as adc_val()
+    uint16_t const adcMask = ~(1<<(f.metadata<MetaData>()->num_adc_bits()+1));
+    std::vector<uint16_t> boardADCs(nChannels*nSamples);
+
     for (size_t board = 0; board < nBoards; ++board)
     {
       // each board has a header...
-      uint32_t boardDataTileSize = 36;
-      for (size_t boardHeaderWord = 0; boardHeaderWord < 18; ++boardHeaderWord)
-      {
-        setA2795Word(compressed_fragment, compressedDataOffset, getA2795Word(f, uncompressedDataOffset));
-        ++compressedDataOffset;
-        ++uncompressedDataOffset;
-      } // done with board header
-
-      // since the 0th sample is used as a reference, store it as is
-      compressionKeys[board*nSamples] = {};
-      for (size_t channel = 0; channel < nChannels; ++channel)
-      {
-        uint16_t sampleADC  = (adc_val(f, board, channel, 0) & 0x0FFF);
-        sampleADC += 0x8000;
-        setA2795Word(compressed_fragment, compressedDataOffset, sampleADC);
-        ++compressedDataOffset;
-        ++uncompressedDataOffset;
-      } // done with channel in sample 0
-      boardDataTileSize += SampleBytesFromKey({});
-
-      // from here on we store the difference between samples for each channel
-      for (size_t sample = 1; sample < nSamples; ++sample)
-      {
-        bool oddCompressions = false;
-        // work in blocks of 4 channels
-        for (size_t channelBlock = 0; channelBlock < nChannels / 4; ++channelBlock)
-        {
-          int16_t adcDiff_0 = adc_val(f, board, 4*channelBlock + 0, sample) - adc_val(f, board, 4*channelBlock + 0, sample - 1);
-          int16_t adcDiff_1 = adc_val(f, board, 4*channelBlock + 1, sample) - adc_val(f, board, 4*channelBlock + 1, sample - 1);
-          int16_t adcDiff_2 = adc_val(f, board, 4*channelBlock + 2, sample) - adc_val(f, board, 4*channelBlock + 2, sample - 1);
-          int16_t adcDiff_3 = adc_val(f, board, 4*channelBlock + 3, sample) - adc_val(f, board, 4*channelBlock + 3, sample - 1);
-
-          bool isComp = (std::abs(adcDiff_0) < 8) &&
-                        (std::abs(adcDiff_1) < 8) &&
-                        (std::abs(adcDiff_2) < 8) &&
-                        (std::abs(adcDiff_3) < 8);
-
-          uncompressedDataOffset += 4;
-
-          if (isComp)
-          {
-            compressionKeys[board*nSamples + sample][channelBlock] = true;
-            oddCompressions = (not oddCompressions);
-            uint16_t new_word  = (adcDiff_3 & 0x000F);
-            new_word <<= 4;
-                     new_word += (adcDiff_2 & 0x000F);
-            new_word <<= 4;
-                     new_word += (adcDiff_1 & 0x000F);
-            new_word <<= 4;
-                     new_word += (adcDiff_0 & 0x000F);
-            setA2795Word(compressed_fragment, compressedDataOffset, new_word);
-            ++compressedDataOffset;
-          } else {
-            compressionKeys[board*nSamples + sample][channelBlock] = false;
-            setA2795Word(compressed_fragment, compressedDataOffset + 0, (adcDiff_0 & 0x0FFF) + 0x8000);
-            setA2795Word(compressed_fragment, compressedDataOffset + 1, (adcDiff_1 & 0x0FFF) + 0x8000);
-            setA2795Word(compressed_fragment, compressedDataOffset + 2, (adcDiff_2 & 0x0FFF) + 0x8000);
-            setA2795Word(compressed_fragment, compressedDataOffset + 3, (adcDiff_3 & 0x0FFF) + 0x8000);
-            compressedDataOffset += 4;
-          }
-        } // done with channels
-
-        // if there are an odd number of words in the difference then there needs to be a spacer added
-        if (oddCompressions)
-        {
-          setA2795Word(compressed_fragment, compressedDataOffset, 0);
-          ++compressedDataOffset;
-        }
+      std::copy_n(uncompressedData + uncompressedDataOffset, 18, compressedData + compressedDataOffset);
+      compressedDataOffset += 18;
+      uncompressedDataOffset += 18;
+
+      // the samples are compressed all at once
+      std::transform(uncompressedData + uncompressedDataOffset, uncompressedData + uncompressedDataOffset + boardADCs.size(),
+                     boardADCs.begin(), [adcMask](uint16_t adc) -> uint16_t { return adc & adcMask; });
+      uncompressedDataOffset += boardADCs.size();
 
-        // add up the size of the differences
-        boardDataTileSize += SampleBytesFromKey(compressionKeys[board*nSamples + sample]);
-      } // done with samples
+      size_t nCompressedWords = icarus::compression::encodeBoard(boardADCs.data(), nChannels, nSamples, compressedData + compressedDataOffset);
+      compressedDataOffset += nCompressedWords;
 
       // ...and each board has a trailer
-      boardDataTileSize += 4*sizeof(uint16_t);
-      for (size_t boardTrailerWord = 0; boardTrailerWord < 4; ++boardTrailerWord)
-      {
-        setA2795Word(compressed_fragment, compressedDataOffset, getA2795Word(f, uncompressedDataOffset));
-        ++compressedDataOffset;
-        ++uncompressedDataOffset;
-      }
+      std::copy_n(uncompressedData + uncompressedDataOffset, 4, compressedData + compressedDataOffset);
+      compressedDataOffset += 4;
+      uncompressedDataOffset += 4;
 
       // now that we know the size for the data tile, store that in the tile header
       // endianness is weird for this, hence the htonl...
+      uint32_t boardDataTileSize = (18 + nCompressedWords + 4)*sizeof(uint16_t);
       TileHeader* boardHeader = reinterpret_cast<TileHeader*>(compressed_fragment.dataBeginBytes() + totalDataTileSize);
       boardHeader->packSize = htonl(boardDataTileSize);
       totalDataTileSize += boardDataTileSize;
@@ -306,43 +243,13 @@ namespace reprocessRaw
         std::vector<uint16_t> adcValues(nBoards*nChannels*nSamples, std::numeric_limits<uint16_t>::min());
 
         // loop to fill
-        uint64_t fragWord = 0;
+        uint16_t const* compressedData = reinterpret_cast<uint16_t const*>(new_fragment.dataBeginBytes());
+        size_t fragWord = 0;
         for (size_t b = 0; b < nBoards; b++)
         {
           // skip board headers...
           fragWord += ((28 + 8) / sizeof(uint16_t));
-          for (size_t s = 0; s < nSamples; s++)
-          {
-            size_t keyCount = 0;
-            for (size_t bit = 0; bit < nChannels/4; bit++)
-            {
-              uint16_t word = getA2795Word(new_fragment, fragWord);
-              bool isCompressed = (((word & 0xF000) != 0x8000));
-              for (size_t cInSet = 0; cInSet < 4; ++ cInSet)
-              {
-                size_t c = 4*bit + cInSet;
-                if (not isCompressed)
-                {
-                  uint16_t tempWord = getA2795Word(new_fragment, fragWord + cInSet);
-                  int16_t twelveBitDiff = (tempWord & 0x0FFF);
-                  bool isNeg = (twelveBitDiff >> 11) && (s != 0);
-                  uint16_t prevSample = (s != 0) ? adcValues[b*nSamples*nChannels + c*nSamples + s - 1] : 0;
-                  uint16_t currSample = (isNeg*0xF000 + twelveBitDiff + prevSample);
-                  adcValues.at(b*nSamples*nChannels + c*nSamples + s) = currSample;
-                } else {
-                  int16_t fourBitDiff = (word >> (4*cInSet)) & 0x000F;
-                  bool isNeg = (fourBitDiff >> 3);
-                  uint16_t prevSample = (s != 0) ? adcValues[b*nSamples*nChannels + c*nSamples + s - 1] : 0;
-                  uint16_t currSample = (isNeg*0xFFF0 + fourBitDiff + prevSample);
-                  adcValues.at(b*nSamples*nChannels + c*nSamples + s) = currSample;
-                }
-              }
-              fragWord += (isCompressed) ? 1 : 4;
-              keyCount += isCompressed;
-            }
-            if ((keyCount % 2) == 1)
-              fragWord += 1;
-          }
+          fragWord += icarus::compression::decodeBoard(compressedData + fragWord, nChannels, nSamples, adcValues.data() + b*nSamples*nChannels);
           // ...and skip board trailers
           fragWord += 4;
         }
@@ -351,7 +258,7 @@ namespace reprocessRaw
             for (size_t channel = 0; channel < nChannels; ++channel)
             {
               uint16_t oldADC = adc_val(old_fragment, board, channel, sample);
-              uint16_t newADC = adcValues.at(board*nSamples*nChannels + channel*nSamples + sample);
+              uint16_t newADC = adcValues.at(board*nSamples*nChannels + sample*nChannels + channel);
               if (oldADC != newADC)
                 MF_LOG_VERBATIM("ICARUSProduceCompressed")
                   << "ERROR - ADC Mismatch in board " << board << ", sample " << sample << ", channel " << channel << '\n'
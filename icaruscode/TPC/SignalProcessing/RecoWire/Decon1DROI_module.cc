@@ -13,6 +13,8 @@
 #include <vector>
 #include <utility> // std::pair<>
 #include <memory> // std::unique_ptr<>
+#include <optional>
+#include <algorithm> // std::stable_sort()
 #include <iomanip>
 #include <fstream>
 #include <random>
@@ -56,13 +58,10 @@
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
-#include "tbb/spin_mutex.h"
 
 ///creation of calibrated signals on wires
 namespace caldata {
     
-tbb::spin_mutex deconvolutionSpinMutex;
-
 class Decon1DROI : public art::ReplicatedProducer
 {
   public:
@@ -77,36 +76,58 @@ class Decon1DROI : public art::ReplicatedProducer
     
   private:
 
+    // Output of the processing of each raw digit (empty if no wire was made)
+    using WireSlotVec = std::vector<std::optional<recob::Wire>>;
+
+    // A raw digit ready for the deconvolution, and then its deconvolved waveform
+    struct ChannelData
+    {
+        size_t                                   idx;                ///< Index of the raw digit
+        raw::ChannelID_t                         channel;
+        size_t                                   plane;
+        float                                    rawNoise;
+        std::vector<float>                       rawAdcLessPedVec;   ///< Pedestal subtracted waveform
+        icarus_tool::IROIFinder::CandidateROIVec deconROIVec;        ///< Range to deconvolve
+        recob::Wire::RegionsOfInterest_t         deconVec;           ///< Deconvolved waveform
+    };
+
     // Define a class to handle processing for individual threads
+    // Each thread writes only into the slots of its own raw digits, so no locking is needed.
+    // The raw digits of a range are deconvolved together, so that the deconvolution tool can batch them
     class multiThreadDeconvolutionProcessing 
     {
     public:
         multiThreadDeconvolutionProcessing(Decon1DROI const&                        parent,
                                            art::Event&                              event,
                                            art::Handle<std::vector<raw::RawDigit>>& rawDigitHandle, 
-                                           std::vector<recob::Wire>&                wireColVec,
-                                           art::Assns<raw::RawDigit,recob::Wire>&   wireAssns,
-                                           std::string const&                       instance)
+                                           WireSlotVec&                             wireSlotVec)
             : fDecon1DROI(parent),
               fEvent(event),
               fRawDigitHandle(rawDigitHandle),
-              fWireColVec(wireColVec),
-              fWireAssns(wireAssns),
-              fInstance(instance)
+              fWireSlotVec(wireSlotVec)
         {}
 
         void operator()(const tbb::blocked_range<size_t>& range) const
         {
+            std::vector<ChannelData> channelDataVec;
+            
+            channelDataVec.reserve(range.size());
+            
             for (size_t idx = range.begin(); idx < range.end(); idx++)
-                fDecon1DROI.processChannel(idx, fEvent, fRawDigitHandle, fWireColVec, fWireAssns, fInstance);
+            {
+                if (auto channelData = fDecon1DROI.prepareChannel(idx, fRawDigitHandle)) channelDataVec.push_back(std::move(*channelData));
+            }
+            
+            fDecon1DROI.deconvolveChannels(channelDataVec, fEvent);
+            
+            for (auto& channelData : channelDataVec)
+                fWireSlotVec[channelData.idx] = fDecon1DROI.finishChannel(channelData, fRawDigitHandle);
         }
     private:
         const Decon1DROI&                        fDecon1DROI;
         art::Event&                              fEvent;
         art::Handle<std::vector<raw::RawDigit>>& fRawDigitHandle;
-        std::vector<recob::Wire>&                fWireColVec;
-        art::Assns<raw::RawDigit,recob::Wire>&   fWireAssns;
-        std::string                              fInstance;
+        WireSlotVec&                             fWireSlotVec;
     };
 
     // It seems there are pedestal shifts that need correcting
@@ -114,13 +135,16 @@ class Decon1DROI : public art::ReplicatedProducer
     
     float getTruncatedRMS(const std::vector<float>&) const;
 
-    // Function to do the work
-    void  processChannel(size_t,
-                         art::Event&,
-                         art::Handle<std::vector<raw::RawDigit>>, 
-                         std::vector<recob::Wire>&, 
-                         art::Assns<raw::RawDigit,recob::Wire>&,
-                         const std::string&) const;
+    // Functions to do the work: pedestal subtraction (nothing is returned for channels to skip)...
+    std::optional<ChannelData> prepareChannel(size_t,
+                                              art::Handle<std::vector<raw::RawDigit>>) const;
+    
+    // ... deconvolution of many channels at once...
+    void deconvolveChannels(std::vector<ChannelData>&, art::Event&) const;
+    
+    // ... and ROI finding, returning the wire (if any) made from the raw digit
+    std::optional<recob::Wire> finishChannel(ChannelData&,
+                                             art::Handle<std::vector<raw::RawDigit>>) const;
     
     std::vector<art::InputTag>                                 fRawDigitLabelVec;           ///< Contains the input tags for finding RawDigits
                                                                                             ///< it is set by the DigitModuleLabel
@@ -286,13 +310,42 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
             return;
         }
     
-        // Reserve the room for the output
-        wireCol->reserve(digitVecHandle->size());
+        // One output slot per raw digit
+        WireSlotVec wireSlotVec(digitVecHandle->size());
     
         // ... Launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
-        multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, evt, digitVecHandle, *wireCol, *wireDigitAssn, rawDigitLabel.instance());
+        multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, evt, digitVecHandle, wireSlotVec);
     
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, digitVecHandle->size()), deconvolutionProcessing);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, digitVecHandle->size(), fDeconvolution->preferredBatchSize()), deconvolutionProcessing);
+        
+        // Now collect the wires sorted by channel (ties in raw digit order), which makes the
+        // output independent of the thread scheduling, and associate them to their raw digits
+        std::vector<size_t> wireIdxVec;
+        
+        wireIdxVec.reserve(wireSlotVec.size());
+        
+        for(size_t idx = 0; idx < wireSlotVec.size(); idx++)
+            if (wireSlotVec[idx]) wireIdxVec.push_back(idx);
+        
+        std::stable_sort(wireIdxVec.begin(), wireIdxVec.end(), [&wireSlotVec](size_t left, size_t right){return wireSlotVec[left]->Channel() < wireSlotVec[right]->Channel();});
+        
+        wireCol->reserve(wireIdxVec.size());
+        
+        for(size_t idx : wireIdxVec)
+        {
+            wireCol->push_back(std::move(*wireSlotVec[idx]));
+            
+            art::Ptr<raw::RawDigit> digitVec(digitVecHandle, idx);
+            
+            // add an association between the last object in wirecol
+            // (that we just inserted) and digitVec
+            if (!util::CreateAssn(evt, *wireCol, digitVec, *wireDigitAssn, rawDigitLabel.instance()))
+            {
+                throw art::Exception(art::errors::ProductRegistrationFailure)
+                    << "Can't associate wire #" << (wireCol->size() - 1)
+                    << " with raw digit #" << digitVec.key();
+            } // if failed to add association
+        }
         
         // Time to stroe everything
         if(wireCol->size() == 0)
@@ -312,9 +365,6 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
             }
         }
     
-        // Make sure the collection is sorted
-        std::sort(wireCol->begin(), wireCol->end(), [](const auto& left, const auto& right){return left.Channel() < right.Channel();});
-       
         evt.put(std::move(wireCol), rawDigitLabel.instance());
         evt.put(std::move(wireDigitAssn), rawDigitLabel.instance());
     }
@@ -420,24 +470,16 @@ float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw
     return localRMS;
 }
 
-void  Decon1DROI::processChannel(size_t                                  idx,
-                                 art::Event&                             event,
-                                 art::Handle<std::vector<raw::RawDigit>> digitVecHandle, 
-                                 std::vector<recob::Wire>&               wireColVec, 
-                                 art::Assns<raw::RawDigit,recob::Wire>&  wireAssns,
-                                 const std::string&                      instance) const
+std::optional<Decon1DROI::ChannelData> Decon1DROI::prepareChannel(size_t                                  idx,
+                                                                   art::Handle<std::vector<raw::RawDigit>> digitVecHandle) const
 {
-    // vector that will be moved into the Wire object
-    recob::Wire::RegionsOfInterest_t deconVec;
-    recob::Wire::RegionsOfInterest_t ROIVec;
-
     // get the reference to the current raw::RawDigit
     art::Ptr<raw::RawDigit> digitVec(digitVecHandle, idx);
 
     raw::ChannelID_t channel = digitVec->Channel();
     
     // The following test is meant to be temporary until the "correct" solution is implemented
-    if (!fChannelFilter->IsPresent(channel)) return;
+    if (!fChannelFilter->IsPresent(channel)) return std::nullopt;
 
     // The waveforms should have been set to a 0. pedestal...
     float pedestal = 0.;
@@ -446,7 +488,7 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     std::vector<geo::WireID> wids = fGeometry->ChannelToWire(channel);
     
     // skip bad channels
-    if( fChannelFilter->Status(channel) < fMinAllowedChanStatus) return;
+    if( fChannelFilter->Status(channel) < fMinAllowedChanStatus) return std::nullopt;
 
     size_t dataSize = digitVec->Samples();
     
@@ -467,18 +509,19 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     catch(...)
     {
         mf::LogDebug("Decon1DROI_module") << "Pedestal lookup fails with channel: " << channel << std::endl;
-        return;
+        return std::nullopt;
     }
     
+    ChannelData channelData{idx, channel, planeID.Plane, 0., std::vector<float>(dataSize), {}, {}};
     
     // Get the pedestal subtracted data, centered in the deconvolution vector
-    std::vector<float> rawAdcLessPedVec(dataSize);
+    std::vector<float>& rawAdcLessPedVec = channelData.rawAdcLessPedVec;
     
     std::transform(rawadc.begin(),rawadc.end(),rawAdcLessPedVec.begin(),std::bind(std::minus<short>(),std::placeholders::_1,pedestal));
     
     // It seems there are deviations from the pedestal when using wirecell for noise filtering
     //float raw_noise = fixTheFreakingWaveform(rawAdcLessPedVec, channel, rawAdcLessPedVec);
-    float raw_noise = digitVec->GetSigma();
+    channelData.rawNoise = digitVec->GetSigma();
     
     // Recover a measure of the noise on the channel for use in the ROI finder
     //float raw_noise = getTruncatedRMS(rawAdcLessPedVec);
@@ -488,22 +531,44 @@ void  Decon1DROI::processChannel(size_t                                  idx,
 //        fWaveformTool->medianSmooth(rawAdcLessPedVec,rawAdcSmoothVec);
         
     // Make a dummy candidate roi vec
-    icarus_tool::IROIFinder::CandidateROIVec deconROIVec;
+    channelData.deconROIVec.push_back(icarus_tool::IROIFinder::CandidateROI(0,rawAdcLessPedVec.size() - 1));
     
-    deconROIVec.push_back(icarus_tool::IROIFinder::CandidateROI(0,rawAdcLessPedVec.size() - 1));
+    return channelData;
+}
+
+void Decon1DROI::deconvolveChannels(std::vector<ChannelData>& channelDataVec, art::Event& event) const
+{
+    icarus_tool::IDeconvolution::ChannelToDeconvolveVec channelVec;
     
-    // Do the deconvolution on the full waveform
+    channelVec.reserve(channelDataVec.size());
+    
+    for(auto& channelData : channelDataVec)
+        channelVec.push_back({&channelData.rawAdcLessPedVec, channelData.channel, &channelData.deconROIVec, &channelData.deconVec});
+    
+    // Do the deconvolution on the full waveforms
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
-    fDeconvolution->Deconvolve(rawAdcLessPedVec, sampling_rate(clockData), channel, deconROIVec, deconVec);
+    fDeconvolution->DeconvolveBatch(channelVec, sampling_rate(clockData));
+    
+    return;
+}
+
+std::optional<recob::Wire> Decon1DROI::finishChannel(ChannelData&                            channelData,
+                                                     art::Handle<std::vector<raw::RawDigit>> digitVecHandle) const
+{
+    // vector that will be moved into the Wire object
+    recob::Wire::RegionsOfInterest_t ROIVec;
+
+    raw::ChannelID_t channel = channelData.channel;
+    size_t           plane   = channelData.plane;
     
     // Recover the deconvolved waveform
-    const std::vector<float>& deconvolvedWaveform = deconVec.get_ranges().front().data();
+    const std::vector<float>& deconvolvedWaveform = channelData.deconVec.get_ranges().front().data();
 
     // vector of candidate ROI begin and end bins
     icarus_tool::IROIFinder::CandidateROIVec candRoiVec;
     
     // Now find the candidate ROI's
-    fROIFinderVec.at(planeID.Plane)->FindROIs(deconvolvedWaveform, channel, fEventCount, raw_noise, candRoiVec);
+    fROIFinderVec.at(plane)->FindROIs(deconvolvedWaveform, channel, fEventCount, channelData.rawNoise, candRoiVec);
     
     std::vector<float> holder;
     
@@ -530,37 +595,25 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     // Make some histograms?
     if (fOutputHistograms)
     {
-        fNumROIsHistVec.at(planeID.Plane)->Fill(candRoiVec.size(), 1.);
+        fNumROIsHistVec.at(plane)->Fill(candRoiVec.size(), 1.);
         
         for(const auto& pair : candRoiVec)
-            fROILenHistVec.at(planeID.Plane)->Fill(pair.second-pair.first, 1.);
+            fROILenHistVec.at(plane)->Fill(pair.second-pair.first, 1.);
     
         float fullRMS = std::inner_product(deconvolvedWaveform.begin(), deconvolvedWaveform.end(), deconvolvedWaveform.begin(), 0.);
     
         fullRMS = std::sqrt(std::max(float(0.),fullRMS / float(deconvolvedWaveform.size())));
 
-        fFullRMSVec[planeID.Plane]->Fill(fullRMS, 1.);
+        fFullRMSVec[plane]->Fill(fullRMS, 1.);
     }
 
     // Don't save empty wires
-    if (ROIVec.empty()) return;
-
-    // First get a lock to make sure we are clear to run
-    tbb::spin_mutex::scoped_lock lock(deconvolutionSpinMutex);
+    if (ROIVec.empty()) return std::nullopt;
 
-    // create the new wire directly in wirecol
-    wireColVec.push_back(recob::WireCreator(std::move(ROIVec),*digitVec).move());
-
-    // add an association between the last object in wirecol
-    // (that we just inserted) and digitVec
-    if (!util::CreateAssn(event, wireColVec, digitVec, wireAssns, instance))
-    {
-        throw art::Exception(art::errors::ProductRegistrationFailure)
-            << "Can't associate wire #" << (wireColVec.size() - 1)
-            << " with raw digit #" << digitVec.key();
-    } // if failed to add association
-
-    return;
+    // create the new wire, which will be moved into the output collection
+    art::Ptr<raw::RawDigit> digitVec(digitVecHandle, channelData.idx);
+    
+    return recob::WireCreator(std::move(ROIVec),*digitVec).move();
 }
 
 } // end namespace caldata
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////
+/// \file   BatchedDeconvolutionFFT.cxx
+////////////////////////////////////////////////////////////////////////
+
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h"
+
+#include "cetlib_except/exception.h"
+
+namespace icarus_tool
+{
+
+//----------------------------------------------------------------------
+BatchedDeconvolutionFFT::Workspace::Workspace(size_t fftSize, size_t batchSize)
+    : fFFTSize(fftSize),
+      fTime(fftwf_alloc_real(fftSize * batchSize)),
+      fFrequency(fftwf_alloc_complex((fftSize / 2 + 1) * batchSize)),
+      fStartVec(batchSize, 0)
+{
+    if (!fTime || !fFrequency)
+        throw cet::exception("BatchedDeconvolutionFFT") << "Failed to allocate the buffers for " << batchSize << " windows of " << fftSize << " ticks\n";
+
+    // The windows of a batch which are not used are transformed anyway, so they had better be harmless
+    std::fill(fTime.get(), fTime.get() + fftSize * batchSize, 0.f);
+}
+
+void BatchedDeconvolutionFFT::Workspace::extract(size_t slot, size_t first, size_t last, float* dest) const
+{
+    // The time offset is a rotation of the window: tick i comes from (start + i) modulo the size
+    const float* buffer = window(slot);
+    size_t       start  = (fStartVec[slot] + first) % fFFTSize;
+    size_t       nTicks = last - first;
+    size_t       nFirst = std::min(nTicks, fFFTSize - start);
+
+    std::copy(buffer + start, buffer + start + nFirst, dest);
+    std::copy(buffer, buffer + (nTicks - nFirst), dest + nFirst);
+
+    return;
+}
+
+//----------------------------------------------------------------------
+BatchedDeconvolutionFFT::BatchedDeconvolutionFFT(size_t fftSize, size_t batchSize)
+    : fFFTSize(fftSize),
+      fBatchSize(batchSize)
+{
+    if (fFFTSize == 0 || fBatchSize == 0)
+        throw cet::exception("BatchedDeconvolutionFFT") << "Invalid FFT size (" << fFFTSize << ") or batch size (" << fBatchSize << ")\n";
+
+    // The plans are made on buffers with the layout of a workspace; FFTW_ESTIMATE leaves them untouched
+    // and does not depend on timing, so the same algorithm (and the same output) is obtained every job
+    Workspace workspace = makeWorkspace();
+
+    int nTicks = static_cast<int>(fFFTSize);
+    int nBins  = static_cast<int>(nFrequencyBins());
+    int nBatch = static_cast<int>(fBatchSize);
+
+    fForwardPlan = fftwf_plan_many_dft_r2c(1, &nTicks, nBatch,
+                                           workspace.fTime.get(),      nullptr, 1, nTicks,
+                                           workspace.fFrequency.get(), nullptr, 1, nBins,
+                                           FFTW_ESTIMATE);
+    fInversePlan = fftwf_plan_many_dft_c2r(1, &nTicks, nBatch,
+                                           workspace.fFrequency.get(), nullptr, 1, nBins,
+                                           workspace.fTime.get(),      nullptr, 1, nTicks,
+                                           FFTW_ESTIMATE);
+
+    if (!fForwardPlan || !fInversePlan)
+        throw cet::exception("BatchedDeconvolutionFFT") << "Failed to make the FFTW plans for " << fBatchSize << " windows of " << fFFTSize << " ticks\n";
+}
+
+BatchedDeconvolutionFFT::~BatchedDeconvolutionFFT()
+{
+    fftwf_destroy_plan(fForwardPlan);
+    fftwf_destroy_plan(fInversePlan);
+}
+
+//----------------------------------------------------------------------
+void BatchedDeconvolutionFFT::deconvolute(Workspace& workspace, std::vector<Kernel> const& kernelVec, float scale) const
+{
+    if (kernelVec.size() > fBatchSize)
+        throw cet::exception("BatchedDeconvolutionFFT") << "Asked to deconvolve " << kernelVec.size() << " windows in batches of " << fBatchSize << "\n";
+
+    size_t nBins = nFrequencyBins();
+
+    // FFTW does not normalize the inverse transform
+    float norm = scale / static_cast<float>(fFFTSize);
+
+    fftwf_execute_dft_r2c(fForwardPlan, workspace.fTime.get(), workspace.fFrequency.get());
+
+    for(size_t slot = 0; slot < kernelVec.size(); slot++)
+    {
+        const Kernel&              kernel    = kernelVec[slot];
+        std::complex<float>*       frequency = reinterpret_cast<std::complex<float>*>(workspace.fFrequency.get() + slot * nBins);
+
+        if (!accepts(*kernel.kernel))
+            throw cet::exception("BatchedDeconvolutionFFT") << "Kernel with " << kernel.kernel->size() << " bins for transforms with " << nBins << "\n";
+
+        for(size_t bin = 0; bin < nBins; bin++)
+            frequency[bin] *= norm * std::complex<float>((*kernel.kernel)[bin]);
+
+        long offset = kernel.tOffset % static_cast<long>(fFFTSize);
+
+        workspace.fStartVec[slot] = offset < 0 ? offset + fFFTSize : offset;
+    }
+
+    fftwf_execute_dft_c2r(fInversePlan, workspace.fFrequency.get(), workspace.fTime.get());
+
+    return;
+}
+
+}
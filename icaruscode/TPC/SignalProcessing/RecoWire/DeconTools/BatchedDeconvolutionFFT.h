@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   BatchedDeconvolutionFFT.h
+///
+/// \brief  Deconvolution of many same-size waveform windows with a single
+///         batched single precision FFTW plan.
+///
+///         The windows of a batch are packed in one contiguous buffer.
+///         Each batch is transformed forward, multiplied by the kernel of
+///         each window and transformed back, with one plan execution per
+///         direction. The result of each window is the same as the one of
+///         `icarus_signal_processing::ICARUSFFT::deconvolute()`, in float
+///         precision, except that the time offset is applied when reading
+///         the result out rather than by rotating the buffer.
+///
+///         The plans are made at construction and only executed afterwards,
+///         so a single object can be shared by many threads as long as each
+///         of them uses its own `Workspace`.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef BatchedDeconvolutionFFT_H
+#define BatchedDeconvolutionFFT_H
+
+#include "icaruscode/TPC/Utilities/tools/SignalProcessingDefs.h"
+
+#include <fftw3.h>
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace icarus_tool
+{
+    class BatchedDeconvolutionFFT
+    {
+    public:
+        /// Kernel of one window (as passed to `ICARUSFFT::deconvolute()`)
+        struct Kernel
+        {
+            icarusutil::FrequencyVec const* kernel;  ///< Frequency domain kernel
+            int                             tOffset; ///< Time offset of the response
+        };
+
+        /// Buffers for one batch of windows; each concurrent user needs its own
+        class Workspace
+        {
+        public:
+            /// Returns the time domain buffer of the window in `slot`
+            float*       window(size_t slot)       {return fTime.get() + slot * fFFTSize;}
+            float const* window(size_t slot) const {return fTime.get() + slot * fFFTSize;}
+
+            /// Copies the deconvolved ticks [`first`, `last`[ of the window in `slot` into `dest`
+            void extract(size_t slot, size_t first, size_t last, float* dest) const;
+
+        private:
+            friend class BatchedDeconvolutionFFT;
+
+            struct FFTWDeleter { void operator()(void* ptr) const {fftwf_free(ptr);} };
+
+            Workspace(size_t fftSize, size_t batchSize);
+
+            size_t                                        fFFTSize;
+            std::unique_ptr<float[], FFTWDeleter>         fTime;      ///< Windows, contiguous
+            std::unique_ptr<fftwf_complex[], FFTWDeleter> fFrequency; ///< Their transforms
+            std::vector<size_t>                           fStartVec;  ///< First tick of each window after the offset
+        };
+
+        /// Prepares the plans for batches of `batchSize` windows of `fftSize` ticks
+        BatchedDeconvolutionFFT(size_t fftSize, size_t batchSize);
+
+        ~BatchedDeconvolutionFFT();
+
+        BatchedDeconvolutionFFT(BatchedDeconvolutionFFT const&)            = delete;
+        BatchedDeconvolutionFFT& operator=(BatchedDeconvolutionFFT const&) = delete;
+
+        size_t fftSize()         const {return fFFTSize;}
+        size_t batchSize()       const {return fBatchSize;}
+        size_t nFrequencyBins()  const {return fFFTSize / 2 + 1;}
+
+        /// Returns whether `kernel` has the number of bins of the transforms of this engine
+        bool accepts(icarusutil::FrequencyVec const& kernel) const {return kernel.size() == nFrequencyBins();}
+
+        /// Returns new buffers for a batch
+        Workspace makeWorkspace() const {return Workspace(fFFTSize, fBatchSize);}
+
+        /**
+         * @brief Deconvolves the first `kernelVec.size()` windows of `workspace`
+         * @param workspace the buffers with the windows to be deconvolved
+         * @param kernelVec the kernel of each window (at most `batchSize()`)
+         * @param scale factor applied to all the deconvolved windows
+         *
+         * The windows not covered by `kernelVec` are left with undefined content.
+         */
+        void deconvolute(Workspace& workspace, std::vector<Kernel> const& kernelVec, float scale) const;
+
+        /**
+         * @brief Deconvolves `nWindows` windows, one batch at a time
+         * @param workspace the buffers for the batches
+         * @param nWindows number of windows to deconvolve
+         * @param fill callable `Kernel fill(size_t window, float* buffer)`
+         * @param use callable `void use(size_t window, Workspace const&, size_t slot)`
+         * @param scale factor applied to all the deconvolved windows
+         *
+         * `fill` writes the input of the window into `buffer` (already zeroed)
+         * and returns its kernel; `use` is called after the deconvolution of
+         * each window, which is found in `slot` of the workspace.
+         */
+        template <typename Fill, typename Use>
+        void deconvoluteAll(Workspace& workspace, size_t nWindows, Fill fill, Use use, float scale) const;
+
+    private:
+        size_t        fFFTSize;
+        size_t        fBatchSize;
+        fftwf_plan    fForwardPlan;
+        fftwf_plan    fInversePlan;
+    };
+
+
+    template <typename Fill, typename Use>
+    void BatchedDeconvolutionFFT::deconvoluteAll(Workspace& workspace, size_t nWindows, Fill fill, Use use, float scale) const
+    {
+        std::vector<Kernel> kernelVec;
+
+        kernelVec.reserve(fBatchSize);
+
+        for(size_t first = 0; first < nWindows; first += fBatchSize)
+        {
+            size_t last = std::min(first + fBatchSize, nWindows);
+
+            kernelVec.clear();
+
+            for(size_t window = first; window < last; window++)
+            {
+                float* buffer = workspace.window(window - first);
+
+                std::fill(buffer, buffer + fFFTSize, 0.f);
+
+                kernelVec.push_back(fill(window, buffer));
+            }
+
+            deconvolute(workspace, kernelVec, scale);
+
+            for(size_t window = first; window < last; window++) use(window, std::as_const(workspace), window - first);
+        }
+
+        return;
+    }
+}
+
+#endif
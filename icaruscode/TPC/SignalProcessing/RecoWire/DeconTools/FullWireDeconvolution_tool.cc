@@ -18,9 +18,11 @@
 #include "art/Utilities/make_tool.h"
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h"
 
 #include "TH1D.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace icarus_tool
@@ -42,9 +44,21 @@ public:
                     IROIFinder::CandidateROIVec const&,
                     recob::Wire::RegionsOfInterest_t& )    const override;
     
+    void DeconvolveBatch(ChannelToDeconvolveVec const&,
+                         double samplingRate)                  const override;
+    
+    size_t preferredBatchSize()                                const override {return std::max(fFFTBatchSize, size_t(1));}
+    
 private:
     
+    // Baseline subtraction and calibration of a deconvolved (and normalized) ROI
+    void finishROI(std::vector<float>& holder, raw::ChannelID_t) const;
+    
+    // Returns the normalization to apply to the deconvolved waveforms (1 if none)
+    float getNormFactor() const;
+    
     // Member variables from the fhicl file
+    size_t                                                       fFFTBatchSize;               ///< Channels per batched float FFT (0: one at a time, double precision)
     bool                                                         fDodQdxCalib;                ///< Do we apply wire-by-wire calibration?
     std::string                                                  fdQdxCalibFileName;          ///< Text file for constants to do wire-by-wire calibration
     std::map<unsigned int, float>                                fdQdxCalib;                  ///< Map to do wire-by-wire calibration, key is channel
@@ -52,6 +66,7 @@ private:
     icarus_signal_processing::WaveformTools<float>               fWaveformTool;
 
     std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>> fFFT;                        ///< Object to handle thread safe FFT
+    std::unique_ptr<BatchedDeconvolutionFFT>                     fBatchedFFT;                 ///< Batched FFT (if FFTBatchSize is not 0)
 
     const geo::GeometryCore*                                     fGeometry           = lar::providerFrom<geo::Geometry>();
     art::ServiceHandle<icarusutil::SignalShapingICARUSService>   fSignalShaping;
@@ -71,6 +86,8 @@ FullWireDeconvolution::~FullWireDeconvolution()
 void FullWireDeconvolution::configure(const fhicl::ParameterSet& pset)
 {
     // Start by recovering the parameters
+    fFFTBatchSize  = pset.get< size_t >("FFTBatchSize", 0);
+    
     //wire-by-wire calibration
     fDodQdxCalib   = pset.get< bool >("DodQdxCalib", false);
     
@@ -109,12 +126,14 @@ void FullWireDeconvolution::configure(const fhicl::ParameterSet& pset)
     // Now set up our plans for doing the convolution
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
     fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(detProp.NumberTimeSamples());
+    
+    if (fFFTBatchSize > 0) fBatchedFFT = std::make_unique<BatchedDeconvolutionFFT>(detProp.NumberTimeSamples(), fFFTBatchSize);
      
     return;
 }
     
 void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        waveform,
-                                       double const                       samplingRate,
+                                       double const                       /* samplingRate */,
                                        raw::ChannelID_t                   channel,
                                        IROIFinder::CandidateROIVec const& roiVec,
                                        recob::Wire::RegionsOfInterest_t&  ROIVec) const
@@ -125,22 +144,21 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
     // The size of the input waveform **should** be the raw buffer size
     size_t dataSize = waveform.size();
     
-    // Make sure the deconvolution size is set correctly (this will probably be a noop after first call)
-    fSignalShaping->SetDecon(samplingRate, dataSize, channel);
+    // The kernel is built once by the service and never modified afterwards
+    const icarusutil::SignalShapingICARUSService::DeconKernel& deconKernel = fSignalShaping->GetDeconKernel(channel);
     
     // now make a buffer to contain the waveform which will be of the right size
     icarusutil::TimeVec rawAdcLessPedVec(dataSize,0.);
     
     size_t binOffset    = 0; //transformSize > dataSize ? (transformSize - dataSize) / 2 : 0;
-    float  deconNorm       = fSignalShaping->GetDeconNorm();
-    float  normFactor      = 1. / deconNorm; // This is what we had previously: (samplingRate * deconNorm);
-    bool   applyNormFactor = std::abs(normFactor - 1.) > std::numeric_limits<float>::epsilon() ? true : false;
+    float  normFactor      = getNormFactor();
+    bool   applyNormFactor = normFactor != 1.;
     
     // Copy the input (assumed pedestal subtracted) waveforms into our zero padded deconvolution buffer
     std::copy(waveform.begin(),waveform.end(),rawAdcLessPedVec.begin()+binOffset);
     
     // Strategy is to run deconvolution on the entire channel and then pick out the ROI's we found above
-    fFFT->deconvolute(rawAdcLessPedVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
+    fFFT->deconvolute(rawAdcLessPedVec, deconKernel.kernel, deconKernel.tOffset);
     
     std::vector<float> holder;
 
@@ -156,32 +174,103 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
         std::copy(rawAdcLessPedVec.begin()+binOffset+roi.first, rawAdcLessPedVec.begin()+binOffset+roiLen, holder.begin());
         if (applyNormFactor) std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::multiplies<float>(),std::placeholders::_1,normFactor));
         
-        // Get the truncated mean and rms
-        float truncMean;
-        int   nTrunc;
-        int   range;
+        finishROI(holder, channel);
         
-        fWaveformTool.getTruncatedMean(holder, truncMean, nTrunc, range);
+        // add the range into ROIVec
+        ROIVec.add_range(roi.first, std::move(holder));
+    }
+    
+    return;
+}
+
+void FullWireDeconvolution::DeconvolveBatch(ChannelToDeconvolveVec const& channelVec,
+                                            double const                  samplingRate) const
+{
+    if (!fBatchedFFT)
+    {
+        IDeconvolution::DeconvolveBatch(channelVec, samplingRate);
+        return;
+    }
+    
+    // Channels with a waveform or a kernel not matching the batched transforms are deconvolved on their own
+    std::vector<const ChannelToDeconvolve*> batchedVec;
+    
+    batchedVec.reserve(channelVec.size());
+    
+    for(auto const& chan : channelVec)
+    {
+        if (chan.waveform->size() == fBatchedFFT->fftSize() && fBatchedFFT->accepts(fSignalShaping->GetDeconKernel(chan.channel).kernel))
+            batchedVec.push_back(&chan);
+        else
+            Deconvolve(*chan.waveform, samplingRate, chan.channel, *chan.roiVec, *chan.ROIVec);
+    }
+    
+    auto fill = [this,&batchedVec](size_t window, float* buffer)
+    {
+        const ChannelToDeconvolve&                                 chan        = *batchedVec[window];
+        const icarusutil::SignalShapingICARUSService::DeconKernel& deconKernel = fSignalShaping->GetDeconKernel(chan.channel);
         
-        std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::minus<float>(),std::placeholders::_1,truncMean));
-
-        // apply wire-by-wire calibration
-        if (fDodQdxCalib){
-            if(fdQdxCalib.find(channel) != fdQdxCalib.end()){
-                float constant = fdQdxCalib.at(channel);
-                //std::cout<<channel<<" "<<constant<<std::endl;
-                for (size_t iholder = 0; iholder < holder.size(); ++iholder){
-                    holder[iholder] *= constant;
-                }
+        std::copy(chan.waveform->begin(), chan.waveform->end(), buffer);
+        
+        return BatchedDeconvolutionFFT::Kernel{&deconKernel.kernel, deconKernel.tOffset};
+    };
+    
+    // The ROI's are written directly from the deconvolved waveform into the output
+    auto use = [this,&batchedVec](size_t window, const BatchedDeconvolutionFFT::Workspace& workspace, size_t slot)
+    {
+        const ChannelToDeconvolve& chan = *batchedVec[window];
+        
+        for(const auto& roi : *chan.roiVec)
+        {
+            std::vector<float> holder(roi.second - roi.first + 1);
+            
+            workspace.extract(slot, roi.first, roi.second + 1, holder.data());
+            
+            finishROI(holder, chan.channel);
+            
+            chan.ROIVec->add_range(roi.first, std::move(holder));
+        }
+    };
+    
+    BatchedDeconvolutionFFT::Workspace workspace = fBatchedFFT->makeWorkspace();
+    
+    fBatchedFFT->deconvoluteAll(workspace, batchedVec.size(), fill, use, getNormFactor());
+    
+    return;
+}
+
+void FullWireDeconvolution::finishROI(std::vector<float>& holder, raw::ChannelID_t channel) const
+{
+    // Get the truncated mean and rms
+    float truncMean;
+    int   nTrunc;
+    int   range;
+    
+    fWaveformTool.getTruncatedMean(holder, truncMean, nTrunc, range);
+    
+    std::transform(holder.begin(),holder.end(),holder.begin(), std::bind(std::minus<float>(),std::placeholders::_1,truncMean));
+
+    // apply wire-by-wire calibration
+    if (fDodQdxCalib){
+        if(fdQdxCalib.find(channel) != fdQdxCalib.end()){
+            float constant = fdQdxCalib.at(channel);
+            //std::cout<<channel<<" "<<constant<<std::endl;
+            for (size_t iholder = 0; iholder < holder.size(); ++iholder){
+                holder[iholder] *= constant;
             }
         }
-        
-        // add the range into ROIVec
-        ROIVec.add_range(roi.first, std::move(holder));
     }
     
     return;
 }
+
+float FullWireDeconvolution::getNormFactor() const
+{
+    float  deconNorm       = fSignalShaping->GetDeconNorm();
+    float  normFactor      = 1. / deconNorm; // This is what we had previously: (samplingRate * deconNorm);
+    
+    return std::abs(normFactor - 1.) > std::numeric_limits<float>::epsilon() ? normFactor : 1.;
+}
     
 void FullWireDeconvolution::initializeHistograms(art::TFileDirectory& histDir) const
 {
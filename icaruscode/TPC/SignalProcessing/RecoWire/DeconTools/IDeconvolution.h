@@ -18,6 +18,8 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "lardataobj/RecoBase/Wire.h"
 
+#include <vector>
+
 namespace art
 {
     class TFileDirectory;
@@ -39,6 +41,27 @@ namespace icarus_tool
                                 raw::ChannelID_t,
                                 IROIFinder::CandidateROIVec const&,
                                 recob::Wire::RegionsOfInterest_t& ) const = 0;
+        
+        // One channel to be deconvolved by DeconvolveBatch
+        struct ChannelToDeconvolve
+        {
+            IROIFinder::Waveform const*        waveform;
+            raw::ChannelID_t                   channel;
+            IROIFinder::CandidateROIVec const* roiVec;
+            recob::Wire::RegionsOfInterest_t*  ROIVec;    ///< Output
+        };
+        
+        using ChannelToDeconvolveVec = std::vector<ChannelToDeconvolve>;
+        
+        // Deconvolve many channels in one go; by default this is done one channel at a time,
+        // tools which can share the work among channels override it
+        virtual void DeconvolveBatch(ChannelToDeconvolveVec const& channelVec, double samplingRate) const
+        {
+            for(auto const& chan : channelVec) Deconvolve(*chan.waveform, samplingRate, chan.channel, *chan.roiVec, *chan.ROIVec);
+        }
+        
+        // Number of channels the tool would like to receive in each DeconvolveBatch call
+        virtual size_t preferredBatchSize() const {return 1;}
     };
 }
 
@@ -16,10 +16,12 @@
 #include "icaruscode/TPC/Utilities/SignalShapingICARUSService_service.h"
 
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
 
 #include "TH1D.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace icarus_tool
@@ -41,9 +43,30 @@ public:
                     IROIFinder::CandidateROIVec const&,
                     recob::Wire::RegionsOfInterest_t& )    const override;
     
+    void DeconvolveBatch(ChannelToDeconvolveVec const&,
+                         double samplingRate)                  const override;
+    
+    size_t preferredBatchSize()                                const override {return std::max(fFFTBatchSize, size_t(1));}
+    
 private:
+    // Window of the waveform which an ROI is deconvolved in
+    struct ROIWindow
+    {
+        size_t roiLen;          ///< Length of the ROI
+        size_t roiStart;        ///< Start of the ROI in the window
+        size_t roiStop;         ///< Stop of the ROI in the window
+        int    firstOffset;     ///< Start of the window in the waveform
+        int    secondOffset;    ///< End of the window in the waveform
+    };
+    
+    ROIWindow getWindow(IROIFinder::CandidateROI const&, size_t waveformSize) const;
+    
+    // Baseline subtraction and calibration of a deconvolved (and normalized) ROI
+    void finishROI(std::vector<float>& holder, raw::ChannelID_t) const;
+    
     // Member variables from the fhicl file
     size_t                                                     fFFTSize;                    ///< FFT size for ROI deconvolution
+    size_t                                                     fFFTBatchSize;               ///< Windows per batched float FFT (0: one at a time, double precision)
     bool                                                       fDodQdxCalib;                ///< Do we apply wire-by-wire calibration?
     std::string                                                fdQdxCalibFileName;          ///< Text file for constants to do wire-by-wire calibration
     std::map<unsigned int, float>                              fdQdxCalib;                  ///< Map to do wire-by-wire calibration, key is channel
@@ -54,6 +77,7 @@ private:
     const geo::GeometryCore*                                   fGeometry = lar::providerFrom<geo::Geometry>();
     art::ServiceHandle<icarusutil::SignalShapingICARUSService> fSignalShaping;
     std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>          fFFT;                  ///< Object to handle thread safe FFT
+    std::unique_ptr<BatchedDeconvolutionFFT>                   fBatchedFFT;                 ///< Batched FFT (if FFTBatchSize is not 0)
 };
     
 //----------------------------------------------------------------------
@@ -70,7 +94,8 @@ ROIDeconvolution::~ROIDeconvolution()
 void ROIDeconvolution::configure(const fhicl::ParameterSet& pset)
 {
     // Start by recovering the parameters
-    fFFTSize    = pset.get< size_t >("FFTSize"                );
+    fFFTSize      = pset.get< size_t >("FFTSize"                );
+    fFFTBatchSize = pset.get< size_t >("FFTBatchSize",        0);
     
     //wire-by-wire calibration
     fDodQdxCalib = pset.get< bool >("DodQdxCalib", false);
@@ -114,116 +139,209 @@ void ROIDeconvolution::configure(const fhicl::ParameterSet& pset)
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
     fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(detProp.NumberTimeSamples());
     
+    if (fFFTBatchSize > 0) fBatchedFFT = std::make_unique<BatchedDeconvolutionFFT>(fFFTSize, fFFTBatchSize);
+    
     return;
 }
 void ROIDeconvolution::Deconvolve(const IROIFinder::Waveform&        waveform,
-                                  double const                       samplingRate,
+                                  double const                       /* samplingRate */,
                                   raw::ChannelID_t                   channel,
                                   IROIFinder::CandidateROIVec const& roiVec,
                                   recob::Wire::RegionsOfInterest_t&  ROIVec) const
 {
     double deconNorm = fSignalShaping->GetDeconNorm();
+    
+    // The kernel is the same for all the ROI's of this channel (and immutable)
+    const icarusutil::SignalShapingICARUSService::DeconKernel& deconKernel = fSignalShaping->GetDeconKernel(channel);
+    
+    // The deconvolution buffer has a fixed size
+    size_t deconSize = fFFTSize;
+    
+    // ROI's are deconvolved within a window of the waveform centered on them. Neighbouring
+    // ROI's often end up with the very same window (always, when the buffer covers the whole
+    // waveform), in which case the deconvolved buffer of the previous ROI is reused as is.
+    icarusutil::TimeVec deconVec;
+    int                 deconFirstOffset(-1);   // Window of the waveform in deconVec
+    int                 deconSecondOffset(-1);
 
     // And now process them
     for(auto const& roi : roiVec)
     {
-        // First up: copy out the relevent ADC bins into the ROI holder
-        size_t roiLen = roi.second - roi.first;
+        ROIWindow window = getWindow(roi, waveform.size());
         
-        // We want the deconvolution buffer size to be a power of 2 in length
-        // to facilitate the FFT
-        size_t deconSize = fFFTSize;
+        size_t holderOffset = 0; //deconSize > waveform.size() ? (deconSize - waveform.size()) / 2 : 0;
         
-        while(1)
+        // Fill the buffer and do the deconvolution, unless we already have this window
+        if (window.firstOffset != deconFirstOffset || window.secondOffset != deconSecondOffset)
         {
-            if (roiLen > deconSize  ) deconSize *= 2;
-            else break;
-        }
-        
-        // In theory, most ROI's are around the same size so this should mostly be a noop
-        fSignalShaping->SetDecon(samplingRate, deconSize, channel);
+            // Pad with zeroes if the deconvolution buffer is larger than the input waveform
+            deconVec.assign(deconSize, 0.);
+            
+            std::copy(waveform.begin()+window.firstOffset, waveform.begin()+window.secondOffset, deconVec.begin() + holderOffset);
         
-        deconSize = fFFTSize;
+            // Deconvolute the raw signal using the channel's nominal response
+            fFFT->deconvolute(deconVec, deconKernel.kernel, deconKernel.tOffset);
+            
+            deconFirstOffset  = window.firstOffset;
+            deconSecondOffset = window.secondOffset;
+        }
 
-        icarusutil::TimeVec deconVec(deconSize);
-        
-        // Pad with zeroes if the deconvolution buffer is larger than the input waveform
-        if (deconSize > waveform.size()) deconVec.resize(deconSize, 0.);
-        
-        // Watch for the case where the input ROI is long enough to want an deconvolution buffer that is
-        // larger than the input waveform.
-        size_t maxActualSize = std::min(deconSize, waveform.size());
+        // Get rid of the leading and trailing "extra" bins needed to keep the FFT happy
+        std::vector<float>  holder(window.roiLen, 0.);
         
-        // Extend the ROI to accommodate the extra bins for the FFT
-        // The idea is to try to center the desired ROI in the buffer used by deconvolution
-        size_t halfLeftOver = (maxActualSize - roiLen) / 2;           // Number bins either side of ROI
-        int    roiStartInt  = halfLeftOver;                           // Start in the buffer of the ROI
-        int    roiStopInt   = halfLeftOver + roiLen;                  // Stop in the buffer of the ROI
-        int    firstOffset  = roi.first - halfLeftOver;               // Offset into the ADC vector of buffer start
-        int    secondOffset = roi.second + halfLeftOver + roiLen % 2; // Offset into the ADC vector of buffer end
+        if (window.roiStart > 0 || holderOffset > 0) std::copy(deconVec.begin() + holderOffset + window.roiStart, deconVec.begin() + holderOffset + window.roiStop, holder.begin());
+       
+        // "normalize" the vector
+        std::transform(holder.begin(),holder.end(),holder.begin(),[deconNorm](auto& deconVal){return deconVal/deconNorm;});
         
-        // Check for the two edge conditions - starting before the ADC vector or running off the end
-        // In either case we shift the actual roi within the FFT buffer
-        // First is the case where we would be starting before the ADC vector
-        if (firstOffset < 0)
+        finishROI(holder, channel);
+
+        // add the range into ROIVec
+        ROIVec.add_range(roi.first, std::move(holder));
+    } // loop over candidate roi's
+    
+    return;
+}
+
+void ROIDeconvolution::DeconvolveBatch(ChannelToDeconvolveVec const& channelVec,
+                                       double const                  samplingRate) const
+{
+    if (!fBatchedFFT)
+    {
+        IDeconvolution::DeconvolveBatch(channelVec, samplingRate);
+        return;
+    }
+    
+    // Collect the windows to deconvolve, each with the (consecutive) ROI's which are extracted from it.
+    // Channels with a kernel not matching the batched transforms are deconvolved on their own
+    struct WindowToDeconvolve
+    {
+        const ChannelToDeconvolve* chan;
+        int                        firstOffset;
+        int                        secondOffset;
+        size_t                     firstROI;
+        size_t                     lastROI;
+    };
+    
+    std::vector<WindowToDeconvolve> windowVec;
+    
+    for(auto const& chan : channelVec)
+    {
+        if (!fBatchedFFT->accepts(fSignalShaping->GetDeconKernel(chan.channel).kernel))
         {
-            roiStartInt  += firstOffset;  // remember that firstOffset is negative
-            roiStopInt   += firstOffset;
-            secondOffset -= firstOffset;
-            firstOffset   = 0;
+            Deconvolve(*chan.waveform, samplingRate, chan.channel, *chan.roiVec, *chan.ROIVec);
+            continue;
         }
-        // Second is the case where we would overshoot the end
-        else if (size_t(secondOffset) > waveform.size())
+        
+        for(size_t roiIdx = 0; roiIdx < chan.roiVec->size(); roiIdx++)
         {
-            size_t overshoot = secondOffset - waveform.size();
+            ROIWindow window = getWindow((*chan.roiVec)[roiIdx], chan.waveform->size());
             
-            roiStartInt  += overshoot;
-            roiStopInt   += overshoot;
-            firstOffset  -= overshoot;
-            secondOffset  = waveform.size();
+            if (!windowVec.empty() && windowVec.back().chan == &chan &&
+                windowVec.back().firstOffset == window.firstOffset && windowVec.back().secondOffset == window.secondOffset)
+                windowVec.back().lastROI = roiIdx + 1;
+            else
+                windowVec.push_back({&chan, window.firstOffset, window.secondOffset, roiIdx, roiIdx + 1});
         }
+    }
+    
+    auto fill = [this,&windowVec](size_t windowIdx, float* buffer)
+    {
+        const WindowToDeconvolve&                                  window      = windowVec[windowIdx];
+        const icarusutil::SignalShapingICARUSService::DeconKernel& deconKernel = fSignalShaping->GetDeconKernel(window.chan->channel);
         
-        size_t roiStart(roiStartInt);
-        size_t roiStop(roiStopInt);
-        size_t holderOffset = 0; //deconSize > waveform.size() ? (deconSize - waveform.size()) / 2 : 0;
+        std::copy(window.chan->waveform->begin() + window.firstOffset, window.chan->waveform->begin() + window.secondOffset, buffer);
         
-        // Fill the buffer and do the deconvolution
-        std::copy(waveform.begin()+firstOffset, waveform.begin()+secondOffset, deconVec.begin() + holderOffset);
+        return BatchedDeconvolutionFFT::Kernel{&deconKernel.kernel, deconKernel.tOffset};
+    };
+    
+    // The ROI's are written directly from the deconvolved windows into the output
+    auto use = [this,&windowVec](size_t windowIdx, const BatchedDeconvolutionFFT::Workspace& workspace, size_t slot)
+    {
+        const WindowToDeconvolve& window = windowVec[windowIdx];
         
-        // Deconvolute the raw signal using the channel's nominal response
-        fFFT->deconvolute(deconVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
+        for(size_t roiIdx = window.firstROI; roiIdx < window.lastROI; roiIdx++)
+        {
+            const auto& roi       = (*window.chan->roiVec)[roiIdx];
+            ROIWindow   roiWindow = getWindow(roi, window.chan->waveform->size());
+            
+            std::vector<float> holder(roiWindow.roiLen, 0.);
+            
+            // Same as the one-at-a-time deconvolution
+            if (roiWindow.roiStart > 0) workspace.extract(slot, roiWindow.roiStart, roiWindow.roiStop, holder.data());
+            
+            finishROI(holder, window.chan->channel);
+            
+            window.chan->ROIVec->add_range(roi.first, std::move(holder));
+        }
+    };
+    
+    BatchedDeconvolutionFFT::Workspace workspace = fBatchedFFT->makeWorkspace();
+    
+    fBatchedFFT->deconvoluteAll(workspace, windowVec.size(), fill, use, 1. / fSignalShaping->GetDeconNorm());
+    
+    return;
+}
 
-        std::vector<float>  holder(deconVec.size());
-        
-        // Get rid of the leading and trailing "extra" bins needed to keep the FFT happy
-        if (roiStart > 0 || holderOffset > 0) std::copy(deconVec.begin() + holderOffset + roiStart, deconVec.begin() + holderOffset + roiStop, holder.begin());
-        
-        // Resize the holder to the ROI length
-        holder.resize(roiLen);
-       
-        // "normalize" the vector
-        std::transform(holder.begin(),holder.end(),holder.begin(),[deconNorm](auto& deconVal){return deconVal/deconNorm;});
-        
-        // Now we do the baseline determination and correct the ROI
-        //float base = fBaseline->GetBaseline(holder, channel, roiStart, roiLen);
-        float base = fBaseline->GetBaseline(holder, channel, 0, roiLen);
-        
-        std::transform(holder.begin(),holder.end(),holder.begin(),[base](const auto& adcVal){return adcVal - base;});
+ROIDeconvolution::ROIWindow ROIDeconvolution::getWindow(IROIFinder::CandidateROI const& roi, size_t waveformSize) const
+{
+    // Number of ADC bins copied into the ROI holder
+    size_t roiLen = roi.second - roi.first;
+    
+    // Watch for the case where the input ROI is long enough to want an deconvolution buffer that is
+    // larger than the input waveform.
+    size_t maxActualSize = std::min(fFFTSize, waveformSize);
+    
+    // Extend the ROI to accommodate the extra bins for the FFT
+    // The idea is to try to center the desired ROI in the buffer used by deconvolution
+    size_t halfLeftOver = (maxActualSize - roiLen) / 2;           // Number bins either side of ROI
+    int    roiStartInt  = halfLeftOver;                           // Start in the buffer of the ROI
+    int    roiStopInt   = halfLeftOver + roiLen;                  // Stop in the buffer of the ROI
+    int    firstOffset  = roi.first - halfLeftOver;               // Offset into the ADC vector of buffer start
+    int    secondOffset = roi.second + halfLeftOver + roiLen % 2; // Offset into the ADC vector of buffer end
+    
+    // Check for the two edge conditions - starting before the ADC vector or running off the end
+    // In either case we shift the actual roi within the FFT buffer
+    // First is the case where we would be starting before the ADC vector
+    if (firstOffset < 0)
+    {
+        roiStartInt  += firstOffset;  // remember that firstOffset is negative
+        roiStopInt   += firstOffset;
+        secondOffset -= firstOffset;
+        firstOffset   = 0;
+    }
+    // Second is the case where we would overshoot the end
+    else if (size_t(secondOffset) > waveformSize)
+    {
+        size_t overshoot = secondOffset - waveformSize;
         
-        // apply wire-by-wire calibration
-        if (fDodQdxCalib)
+        roiStartInt  += overshoot;
+        roiStopInt   += overshoot;
+        firstOffset  -= overshoot;
+        secondOffset  = waveformSize;
+    }
+    
+    return {roiLen, size_t(roiStartInt), size_t(roiStopInt), firstOffset, secondOffset};
+}
+
+void ROIDeconvolution::finishROI(std::vector<float>& holder, raw::ChannelID_t channel) const
+{
+    // Now we do the baseline determination and correct the ROI
+    //float base = fBaseline->GetBaseline(holder, channel, roiStart, roiLen);
+    float base = fBaseline->GetBaseline(holder, channel, 0, holder.size());
+    
+    std::transform(holder.begin(),holder.end(),holder.begin(),[base](const auto& adcVal){return adcVal - base;});
+    
+    // apply wire-by-wire calibration
+    if (fDodQdxCalib)
+    {
+        if(fdQdxCalib.find(channel) != fdQdxCalib.end())
         {
-            if(fdQdxCalib.find(channel) != fdQdxCalib.end())
-            {
-                float constant = fdQdxCalib.at(channel);
-                
-                for (size_t iholder = 0; iholder < holder.size(); ++iholder) holder[iholder] *= constant;
-            }
+            float constant = fdQdxCalib.at(channel);
+            
+            for (size_t iholder = 0; iholder < holder.size(); ++iholder) holder[iholder] *= constant;
         }
-
-        // add the range into ROIVec
-        ROIVec.add_range(roi.first, std::move(holder));
-    } // loop over candidate roi's
+    }
     
     return;
 }
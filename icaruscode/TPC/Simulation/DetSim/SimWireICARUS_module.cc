@@ -18,6 +18,11 @@
 #include <functional>
 #include <random>
 #include <chrono>
+#include <mutex>
+// TBB libraries
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_pipeline.h"
+#include "tbb/task_arena.h"
 // CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandGaussQ.h"
@@ -67,6 +72,13 @@ using namespace util;
 namespace detsim {
     
 // Base class for creation of raw signals on wires.
+//
+// With ParallelMotherboards the motherboards are simulated in a TBB pipeline. The noise tools and the
+// random engines are not thread safe, so the pedestal and the noise of the channels are still generated
+// one motherboard at a time, in order, and consume the random streams exactly as the serial loop does;
+// the signal convolution, the ADC conversion and the compression of the motherboards are done
+// concurrently, each thread with its own FFT, and the digits are collected in motherboard order. The
+// output is then the same as without ParallelMotherboards, whatever the number of threads.
 class SimWireICARUS : public art::EDProducer
 {
 public:
@@ -84,6 +96,28 @@ private:
     
     void MakeADCVec(std::vector<short>& adc, icarusutil::TimeVec const& noise,
                     icarusutil::TimeVec const& charge, float ped_mean) const;
+    bool FillChargeWork(sim::SimChannel const& simChan, std::vector<int> const& tickTDCVec,
+                        double gain, icarusutil::TimeVec& chargeWork) const;
+
+    // Everything needed to make the digit of a channel once its pedestal and noise are generated
+    struct ChannelWork
+    {
+        raw::ChannelID_t              channel;
+        geo::WireID                   wireID;
+        float                         pedMean;
+        double                        gain;        //< electrons/tick
+        int                           timeOffset;
+        const icarus_tool::IResponse* response;
+        const sim::SimChannel*        simChan;     //< null if no signal is added to the channel
+        icarusutil::TimeVec           noise;
+    };
+
+    // The channels of a motherboard and their digits, passed along the pipeline of the parallel mode
+    struct MotherboardWork
+    {
+        std::vector<ChannelWork>      channels;
+        std::vector<raw::RawDigit>    digits;
+    };
 
     using TPCIDVec  = std::vector<geo::TPCID>;
     
@@ -100,6 +134,7 @@ private:
     bool                         fSuppressNoSignal;  ///< If no signal on wire (simchannel) then suppress the channel
     bool                         fSmearPedestals;    ///< If True then we smear the pedestals
     int                          fNumChanPerMB;      ///< Number of channels per motherboard
+    bool                         fParallelMotherboards; ///< If true the motherboards are simulated concurrently
     
     std::vector<std::unique_ptr<icarus_tool::IGenNoise>> fNoiseToolVec; ///< Tool for generating noise
     
@@ -135,6 +170,18 @@ private:
 
     using FFTPointer = std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>;
     FFTPointer                              fFFT;                   //< Object to handle thread safe FFT
+
+    // FFT and work buffers of one thread in the parallel mode
+    struct SignalWorkspace
+    {
+        explicit SignalWorkspace(size_t nTimeSamples);
+
+        FFTPointer                          fft;
+        icarusutil::TimeVec                 chargeWork;
+        std::vector<short>                  adcvec;
+    };
+
+    tbb::enumerable_thread_specific<SignalWorkspace> fSignalWorkspaces;
     
     //services
     const geo::GeometryCore&                fGeometry;
@@ -149,6 +196,7 @@ SimWireICARUS::SimWireICARUS(fhicl::ParameterSet const& pset)
     , fPedestalEngine(art::ServiceHandle<rndm::NuRandomService>()->registerAndSeedEngine(createEngine(0, "HepJamesRandom", "pedestal"), "HepJamesRandom", "pedestal", pset, "SeedPedestal"))
     , fUncNoiseEngine(art::ServiceHandle<rndm::NuRandomService>()->registerAndSeedEngine(createEngine(0, "HepJamesRandom", "noise"   ), "HepJamesRandom", "noise",    pset, "Seed"))
     , fCorNoiseEngine(art::ServiceHandle<rndm::NuRandomService>()->registerAndSeedEngine(createEngine(0, "HepJamesRandom", "cornoise"), "HepJamesRandom", "cornoise", pset, "Seed"))
+    , fSignalWorkspaces([this](){return SignalWorkspace(fNTimeSamples);})
     , fGeometry(*lar::providerFrom<geo::Geometry>())
 {
     this->reconfigure(pset);
@@ -174,6 +222,7 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     fMakeHistograms    = p.get< bool                >("MakeHistograms",                     false);
     fSmearPedestals    = p.get< bool                >("SmearPedestals",                      true);
     fNumChanPerMB      = p.get< int                 >("NumChanPerMB",                          32);
+    fParallelMotherboards = p.get< bool             >("ParallelMotherboards",               false);
     fTest              = p.get< bool                >("Test",                               false);
     fTestWire          = p.get< size_t              >("TestWire",                               0);
     fTestIndex         = p.get< std::vector<size_t> >("TestIndex",          std::vector<size_t>());
@@ -212,6 +261,18 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     return;
 }
 //-------------------------------------------------
+SimWireICARUS::SignalWorkspace::SignalWorkspace(size_t nTimeSamples)
+    : chargeWork(nTimeSamples, 0.)
+    , adcvec(nTimeSamples, 0)
+{
+    // Workspaces are made by the threads which use them, and the FFTW planner is not thread safe
+    static std::mutex planMutex;
+
+    std::lock_guard<std::mutex> lock(planMutex);
+
+    fft = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(nTimeSamples);
+}
+//-------------------------------------------------
 void SimWireICARUS::beginJob()
 {
     // get access to the TFile service
@@ -298,18 +359,17 @@ void SimWireICARUS::produce(art::Event& evt)
     //
     //--------------------------------------------------------------------
     
-    // vectors for working in the following for loop
-    std::vector<short>  adcvec(fNTimeSamples, 0);
-    icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
+    // vector for working in the following for loop
     icarusutil::TimeVec zeroCharge(fNTimeSamples,0.);
-    icarusutil::TimeVec noisetmp(fNTimeSamples,0.);
-    
-    // make sure chargeWork is correct size
-    if (chargeWork.size() < fNTimeSamples) throw std::range_error("SimWireICARUS: chargeWork vector too small");
     
     //detector properties information
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt);
     
+    // TDC of each readout tick; since it increases with the tick, the charge of a SimChannel can be
+    // binned by walking its (sorted) TDC entries instead of looking up the charge of every tick
+    std::vector<int> tickTDCVec(fNTimeSamples);
+    for(size_t tick = 0; tick < fNTimeSamples; tick++) tickTDCVec[tick] = clockData.TPCTick2TDC(tick);
+    
     // Let the tools know to update to the next event
     for(const auto& noiseTool : fNoiseToolVec) noiseTool->nextEvent();
 
@@ -365,120 +425,202 @@ void SimWireICARUS::produce(art::Event& evt)
         }
     }
     
-    // Ok, now we can simply loop over MB's...
-    for(const auto& mb : mbWithSignalSet)
+    // The serial part of the simulation of a channel: pedestal, noise and the parameters of its response.
+    // The random engines and the noise tools are only used here
+    auto prepareChannel = [&](raw::ChannelID_t channel, ChannelWork& work)
     {
-        raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
+        work.noise.resize(fNTimeSamples, 0.);     //just in case
+        
+        //use channel number to set some useful numbers
+        std::vector<geo::WireID> widVec  = fGeometry.ChannelToWire(channel);
+        size_t                   plane   = widVec[0].Plane;
+        size_t                   wire    = widVec[0].Wire;
+        size_t                   board   = wire / 32;
         
-        // And for a given MB we can loop over the channels it contains
-        for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
+        work.channel = channel;
+        work.wireID  = widVec[0];
+        
+        //Get pedestal with random gaussian variation
+        work.pedMean = pedestalRetrievalAlg.PedMean(channel);
+        
+        if (fSmearPedestals )
         {
-            //clean up working vectors from previous iteration of loop
-            adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
-            noisetmp.resize(fNTimeSamples, 0.);     //just in case
-            
-            //use channel number to set some useful numbers
-            std::vector<geo::WireID> widVec  = fGeometry.ChannelToWire(channel);
-            size_t                   plane   = widVec[0].Plane;
-            size_t                   wire    = widVec[0].Wire;
-            size_t                   board   = wire / 32;
-            
-            //Get pedestal with random gaussian variation
-            float ped_mean = pedestalRetrievalAlg.PedMean(channel);
+            CLHEP::RandGaussQ rGaussPed(fPedestalEngine, 0.0, pedestalRetrievalAlg.PedRms(channel));
+            work.pedMean += rGaussPed.fire();
+        }
+        
+        //Generate Noise
+        double noise_factor(0.);
+        auto   tempNoiseVec = fSignalShapingService->GetNoiseFactVec();
+        double shapingTime  = fSignalShapingService->GetShapingTime(plane);
+        work.gain           = fSignalShapingService->GetASICGain(channel) * sampling_rate(clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
+        work.timeOffset     = fSignalShapingService->ResponseTOffset(channel);
+        
+        // Recover the response function information for this channel
+        work.response = &fSignalShapingService->GetResponse(channel);
+
+        if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
+            noise_factor = tempNoiseVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
+        //Throw exception...
+        else
+        {
+            throw cet::exception("SimWireICARUS")
+            << "\033[93m"
+            << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
+            << std::endl
+            << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
+            << "\033[00m"
+            << std::endl;
+        }
+        
+        // Use the desired noise tool to actually generate the noise on this wire
+        fNoiseToolVec[plane]->generateNoise(fUncNoiseEngine,
+                                            fCorNoiseEngine,
+                                            work.noise,
+                                            detProp,
+                                            noise_factor,
+                                            widVec[0],
+                                            board);
+        
+        // Recover the SimChannel (if one) for this channel; if the channel is dead no signal is added
+        work.simChan = channels[channel];
+        
+        if (fSimDeadChannels && (ChannelStatusProvider.IsBad(channel) || !ChannelStatusProvider.IsPresent(channel)))
+            work.simChan = nullptr;
+    };
+    
+    // Adds the signal to the noise of a channel and makes its digit; this only reads shared data
+    auto makeDigit = [&](ChannelWork const& work, icarus_signal_processing::ICARUSFFT<double>& fft,
+                         icarusutil::TimeVec& chargeWork, std::vector<short>& adcvec)
+    {
+        //clean up working vector from previous iteration of loop
+        adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
+        
+        // If there is something on this wire, and it is not dead, then add the signal to the wire
+        bool hasCharge(false);
+        
+        if(work.simChan)
+        {
+            std::fill(chargeWork.begin(), chargeWork.end(), 0.);
             
-            if (fSmearPedestals )
-            {
-                CLHEP::RandGaussQ rGaussPed(fPedestalEngine, 0.0, pedestalRetrievalAlg.PedRms(channel));
-                ped_mean += rGaussPed.fire();
-            }
+            hasCharge = FillChargeWork(*work.simChan, tickTDCVec, work.gain, chargeWork);
+        }
+        
+        // Channels with no charge in the readout window skip the convolution
+        if (hasCharge)
+        {
+            // now we have the tempWork for the adjacent wire of interest
+            // convolve it with the appropriate response function
+            fft.convolute(chargeWork, work.response->getConvKernel(), work.timeOffset);
             
-            //Generate Noise
-            double noise_factor(0.);
-            auto   tempNoiseVec = fSignalShapingService->GetNoiseFactVec();
-            double shapingTime  = fSignalShapingService->GetShapingTime(plane);
-            double gain         = fSignalShapingService->GetASICGain(channel) * sampling_rate(clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
-            int    timeOffset   = fSignalShapingService->ResponseTOffset(channel);
+            // "Make" the ADC vector
+            MakeADCVec(adcvec, work.noise, chargeWork, work.pedMean);
+        }
+        // "Make" an ADC vector with zero charge added
+        else MakeADCVec(adcvec, work.noise, zeroCharge, work.pedMean);
+        
+        // adcvec is copied, not moved: in case of compression, adcvec will show
+        // less data: e.g. if the uncompressed adcvec has 9600 items, after
+        // compression it will have maybe 5000, but the memory of the other 4600
+        // is still there, although unused; a copy of adcvec will instead have
+        // only 5000 items. All 9600 items of adcvec will be recovered for free
+        // and used on the next loop.
+        raw::RawDigit rd(work.channel, fNTimeSamples, adcvec, fCompression);
+        
+        rd.SetPedestal(work.pedMean);
+        
+        return rd;
+    };
+    
+    // Fills the histograms and adds the digit to the collection
+    auto storeDigit = [&](raw::RawDigit& rd, geo::WireID const& wid)
+    {
+        if(fMakeHistograms && wid.Plane==2)
+        {
+            short area = std::accumulate(rd.ADCs().begin(),rd.ADCs().end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
             
-            // Recover the response function information for this channel
-            const icarus_tool::IResponse& response = fSignalShapingService->GetResponse(channel);
-
-            if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
-                noise_factor = tempNoiseVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
-            //Throw exception...
-            else
+            if(area>0)
             {
-                throw cet::exception("SimWireICARUS")
-                << "\033[93m"
-                << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
-                << std::endl
-                << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
-                << "\033[00m"
-                << std::endl;
+                fSimCharge->Fill(area);
+                fSimChargeWire->Fill(wid.Wire,area);
             }
+        }
+        
+        digcol->push_back(std::move(rd)); // we do move the raw digit copy, though
+    };
+    
+    if (!fParallelMotherboards)
+    {
+        // vectors for working in the following for loop
+        std::vector<short>  adcvec(fNTimeSamples, 0);
+        icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
+        ChannelWork         work;
+        
+        // Ok, now we can simply loop over MB's...
+        for(const auto& mb : mbWithSignalSet)
+        {
+            raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
             
-            // Use the desired noise tool to actually generate the noise on this wire
-            fNoiseToolVec[plane]->generateNoise(fUncNoiseEngine,
-                                                fCorNoiseEngine,
-                                                noisetmp,
-                                                detProp,
-                                                noise_factor,
-                                                widVec[0],
-                                                board);
-            
-            // Recover the SimChannel (if one) for this channel
-            const sim::SimChannel* simChan = channels[channel];
-            
-            // If there is something on this wire, and it is not dead, then add the signal to the wire
-            if(simChan && !(fSimDeadChannels && (ChannelStatusProvider.IsBad(channel) || !ChannelStatusProvider.IsPresent(channel))))
+            // And for a given MB we can loop over the channels it contains
+            for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
             {
-                std::fill(chargeWork.begin(), chargeWork.end(), 0.);
+                prepareChannel(channel, work);
+                
+                raw::RawDigit rd = makeDigit(work, *fFFT, chargeWork, adcvec);
                 
-                // loop over the tdcs and grab the number of electrons for each
-                for(size_t tick = 0; tick < fNTimeSamples; tick++)
+                storeDigit(rd, work.wireID);
+            }
+        }
+    }
+    else
+    {
+        // The motherboards go through a pipeline: pedestals and noise in motherboard order, then the
+        // digits concurrently, then the digits are stored in motherboard order
+        size_t maxTokens = 2 * tbb::this_task_arena::max_concurrency();
+        
+        // At most maxTokens motherboards are in the pipeline and they leave it in order, so the buffers
+        // of a motherboard can be reused by the one maxTokens positions later
+        std::vector<MotherboardWork> mbWorkRing(maxTokens);
+        
+        auto   mbItr   = mbWithSignalSet.begin();
+        size_t mbCount = 0;
+        
+        tbb::parallel_pipeline(maxTokens,
+            tbb::make_filter<void, MotherboardWork*>(tbb::filter_mode::serial_in_order,
+                [&](tbb::flow_control& control) -> MotherboardWork*
                 {
-                    int tdc = clockData.TPCTick2TDC(tick);
+                    if (mbItr == mbWithSignalSet.end())
+                    {
+                        control.stop();
+                        return nullptr;
+                    }
                     
-                    // continue if tdc < 0
-                    if( tdc < 0 ) continue;
+                    MotherboardWork& mbWork      = mbWorkRing[mbCount++ % maxTokens];
+                    raw::ChannelID_t baseChannel = fNumChanPerMB * *mbItr++;
                     
-                    double charge = simChan->Charge(tdc);  // Charge returned in number of electrons
+                    mbWork.channels.resize(fNumChanPerMB);
                     
-                    chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
-                } // loop over tdcs
-                // now we have the tempWork for the adjacent wire of interest
-                // convolve it with the appropriate response function
-                fFFT->convolute(chargeWork, response.getConvKernel(), timeOffset);
-                
-                // "Make" the ADC vector
-                MakeADCVec(adcvec, noisetmp, chargeWork, ped_mean);
-            }
-            // "Make" an ADC vector with zero charge added
-            else MakeADCVec(adcvec, noisetmp, zeroCharge, ped_mean);
-            
-            // add this digit to the collection;
-            // adcvec is copied, not moved: in case of compression, adcvec will show
-            // less data: e.g. if the uncompressed adcvec has 9600 items, after
-            // compression it will have maybe 5000, but the memory of the other 4600
-            // is still there, although unused; a copy of adcvec will instead have
-            // only 5000 items. All 9600 items of adcvec will be recovered for free
-            // and used on the next loop.
-            raw::RawDigit rd(channel, fNTimeSamples, adcvec, fCompression);
-            
-            if(fMakeHistograms && plane==2)
-            {
-                short area = std::accumulate(adcvec.begin(),adcvec.end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
-                
-                if(area>0)
+                    for(int idx = 0; idx < fNumChanPerMB; idx++) prepareChannel(baseChannel + idx, mbWork.channels[idx]);
+                    
+                    return &mbWork;
+                }) &
+            tbb::make_filter<MotherboardWork*, MotherboardWork*>(tbb::filter_mode::parallel,
+                [&](MotherboardWork* mbWork)
                 {
-                    fSimCharge->Fill(area);
-                    fSimChargeWire->Fill(widVec[0].Wire,area);
-                }
-            }
-            
-            rd.SetPedestal(ped_mean);
-            digcol->push_back(std::move(rd)); // we do move the raw digit copy, though
-
-        }
+                    SignalWorkspace& workspace = fSignalWorkspaces.local();
+                    
+                    mbWork->digits.clear();
+                    
+                    for(const auto& work : mbWork->channels)
+                        mbWork->digits.push_back(makeDigit(work, *workspace.fft, workspace.chargeWork, workspace.adcvec));
+                    
+                    return mbWork;
+                }) &
+            tbb::make_filter<MotherboardWork*, void>(tbb::filter_mode::serial_in_order,
+                [&](MotherboardWork* mbWork)
+                {
+                    for(size_t idx = 0; idx < mbWork->digits.size(); idx++) storeDigit(mbWork->digits[idx], mbWork->channels[idx].wireID);
+                }));
     }
     
     evt.put(std::move(digcol), fOutInstanceLabel);
@@ -486,6 +628,40 @@ void SimWireICARUS::produce(art::Event& evt)
     return;
 }
 //-------------------------------------------------
+bool SimWireICARUS::FillChargeWork(sim::SimChannel const& simChan, std::vector<int> const& tickTDCVec,
+                                   double gain, icarusutil::TimeVec& chargeWork) const
+{
+    // Both the SimChannel TDC entries and the TDC of the ticks are sorted, so we can walk them together;
+    // ticks with a negative TDC receive no charge
+    auto const tickEnd = tickTDCVec.end();
+    auto       tickItr = std::lower_bound(tickTDCVec.begin(), tickEnd, 0);
+    bool       hasCharge(false);
+    
+    for(const auto& tdcIDEs : simChan.TDCIDEMap())
+    {
+        long tdc = tdcIDEs.first;
+        
+        tickItr = std::lower_bound(tickItr, tickEnd, tdc);
+        
+        if (tickItr == tickEnd) break;
+        
+        if (*tickItr != tdc) continue;
+        
+        // Charge in number of electrons, summed as sim::SimChannel::Charge() does
+        double charge = 0.;
+        
+        for(const auto& ide : tdcIDEs.second) charge += ide.numElectrons;
+        
+        // More than one tick may map to the same TDC
+        for(auto itr = tickItr; itr != tickEnd && *itr == tdc; itr++)
+            chargeWork[itr - tickTDCVec.begin()] += charge/gain;  // # electrons / (# electrons/tick)
+        
+        hasCharge = true;
+    }
+    
+    return hasCharge;
+}
+//-------------------------------------------------
 void SimWireICARUS::MakeADCVec(std::vector<short>& adcvec, icarusutil::TimeVec const& noisevec,
                                icarusutil::TimeVec const& chargevec, float ped_mean) const
 {
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   CoherentNoiseCache.h
+///
+/// \brief  Per-event store of the coherent noise waveforms generated
+///         by the noise tools, one per readout board
+///
+///         All the channels of a readout board receive the same
+///         coherent noise waveform: the random engine is reseeded with
+///         the board number before each generation, so the waveform
+///         only depends on the event seed, the board (and the index of
+///         the noise spectrum, when the tool has more than one) and
+///         the amplitude scale. This class keeps the waveform from the
+///         first channel of a board and hands it back for the other
+///         channels, avoiding one inverse FFT per channel.
+///         The cache must be cleared at each new event.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef CoherentNoiseCache_H
+#define CoherentNoiseCache_H
+
+#include "icaruscode/TPC/Utilities/tools/SignalProcessingDefs.h"
+
+#include <map>
+#include <utility>
+#include <cstddef>
+
+namespace icarus_tool
+{
+    class CoherentNoiseCache
+    {
+    public:
+        /// Forgets all the waveforms (to be called at each new event)
+        void clear() { fWaveforms.clear(); }
+
+        /// Returns the coherent noise waveform of `board`.
+        ///
+        /// If no waveform with the same `index`, `scaleFactor` and
+        /// `nSamples` is stored, `generate(waveform)` is called to fill
+        /// a new one with `nSamples` samples, which replaces the stored one.
+        template <typename Generate>
+        const icarusutil::TimeVec& get(unsigned int board,
+                                       unsigned int index,
+                                       double       scaleFactor,
+                                       std::size_t  nSamples,
+                                       Generate&&   generate)
+        {
+            Entry& entry = fWaveforms[Key(board, index)];
+
+            if (!entry.valid                      ||
+                entry.scaleFactor != scaleFactor  ||
+                entry.waveform.size() != nSamples)
+            {
+                entry.waveform.assign(nSamples, 0.);
+                generate(entry.waveform);
+                entry.scaleFactor = scaleFactor;
+                entry.valid       = true;
+            }
+
+            return entry.waveform;
+        }
+
+    private:
+        using Key = std::pair<unsigned int, unsigned int>; ///< board, index
+
+        struct Entry
+        {
+            bool                valid       = false;
+            double              scaleFactor = 0.;
+            icarusutil::TimeVec waveform;
+        };
+
+        std::map<Key, Entry> fWaveforms;
+    };
+}
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "IGenNoise.h"
+#include "CoherentNoiseCache.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
@@ -103,6 +104,9 @@ private:
 
     // Container for doing the work
     icarusutil::FrequencyVec                    fNoiseFrequencyVec;
+
+    // Coherent noise waveforms of the current event, by board
+    CoherentNoiseCache                          fCoherentNoiseCache;
     
     // Keep track of seed initialization for uncorrelated noise
     bool                                        fNeedFirstSeed=true;
@@ -273,6 +277,9 @@ void SBNDataNoise::nextEvent()
 {
     // We update the correlated seed because we want to see different noise event-by-event
     fCorrelatedSeed   = (333 * fCorrelatedSeed) % 900000000;
+
+    // The coherent noise waveforms of the previous event are no longer valid
+    fCoherentNoiseCache.clear();
        SampleCorrelatedRMSs();
     return;
 }
@@ -313,7 +320,6 @@ if(cryostat==1&&tpc>1) index=3;
 //std::cout <<  " index " << index << " generating noise totalRMS " << totalRMS[index] << std::endl;
     // Define a couple of vectors to hold intermediate work
     icarusutil::TimeVec noise_unc(noise.size(),0.);
-    icarusutil::TimeVec noise_corr(noise.size(),0.);
     
     // Make sure the work vector is size right with the output
     if (fNoiseFrequencyVec.size() != noise.size()) fNoiseFrequencyVec.resize(noise.size(),std::complex<float>(0.,0.));
@@ -334,7 +340,9 @@ if (corrFactorItr == fCorrFactorsMap.end()) std::cout << "**********************
 float cf = fCoherentNoiseService->getCoherentNoiseFactor(board,index);
 
 
-   GenerateCorrelatedNoise(engine_corr, noise_corr, noise_factor*cf, board, index);
+    // All the channels of a board share the same coherent noise waveform
+    const icarusutil::TimeVec& noise_corr = fCoherentNoiseCache.get(board, index, noise_factor*cf, noise.size(),
+        [&](icarusutil::TimeVec& corrNoise){GenerateCorrelatedNoise(engine_corr, corrNoise, noise_factor*cf, board, index);});
 
    // std::cout <<  " summing noise " << std::endl;
     // Take the noise as the simple sum of the two contributions
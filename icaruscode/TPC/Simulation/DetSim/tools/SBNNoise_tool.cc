@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "IGenNoise.h"
+#include "CoherentNoiseCache.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
@@ -95,6 +96,9 @@ private:
 
     // Container for doing the work
     icarusutil::FrequencyVec                    fNoiseFrequencyVec;
+
+    // Coherent noise waveforms of the current event, by board
+    CoherentNoiseCache                          fCoherentNoiseCache;
     
     // Keep track of seed initialization for uncorrelated noise
     bool                                        fNeedFirstSeed=true;
@@ -232,6 +236,9 @@ void SBNNoise::nextEvent()
 {
     // We update the correlated seed because we want to see different noise event-by-event
     fCorrelatedSeed   = (333 * fCorrelatedSeed) % 900000000;
+
+    // The coherent noise waveforms of the previous event are no longer valid
+    fCoherentNoiseCache.clear();
     
     return;
 }
@@ -248,7 +255,6 @@ noise_factor=totalRMS;
 //std::cout <<  " generating noise " << std::endl;
     // Define a couple of vectors to hold intermediate work
     icarusutil::TimeVec noise_unc(noise.size(),0.);
-    icarusutil::TimeVec noise_corr(noise.size(),0.);
     
     // Make sure the work vector is size right with the output
     if (fNoiseFrequencyVec.size() != noise.size()) fNoiseFrequencyVec.resize(noise.size(),std::complex<float>(0.,0.));
@@ -259,7 +265,9 @@ noise_factor=totalRMS;
 //    int board=channel/64;
 //std::cout <<  " generating correlated noise " << std::endl;
     // If applying coherent noise call the generator
-    if (fIncoherentNoiseFrac < 1.) GenerateCorrelatedNoise(engine_corr, noise_corr, noise_factor, board);
+    // All the channels of a board share the same coherent noise waveform
+    const icarusutil::TimeVec& noise_corr = fCoherentNoiseCache.get(board, 0, noise_factor, noise.size(),
+        [&](icarusutil::TimeVec& corrNoise){if (fIncoherentNoiseFrac < 1.) GenerateCorrelatedNoise(engine_corr, corrNoise, noise_factor, board);});
    // std::cout <<  " summing noise " << std::endl;
     // Take the noise as the simple sum of the two contributions
     std::transform(noise_unc.begin(),noise_unc.end(),noise_corr.begin(),noise.begin(),std::plus<float>());
@@ -55,6 +55,7 @@ void SignalShapingICARUSService::reconfigure(const fhicl::ParameterSet& pset)
     
     // If called again, then we need to clear out the existing tools...
     fPlaneToResponseMap.clear();
+    fDeconKernels.clear();
     
     // Implement the tools for handling the responses
     const fhicl::ParameterSet& responseTools = pset.get<fhicl::ParameterSet>("ResponseTools");
@@ -134,6 +135,21 @@ void SignalShapingICARUSService::init()
           fPlaneToResponseMap[planeIdx].front().get()->setResponse(samplingRate, weight);
         }
         
+        // Freeze the deconvolution kernels so that deconvolution never needs to touch the
+        // (mutable) response tools again
+        fDeconKernels.clear();
+        fDeconKernels.reserve(geo->Nplanes());
+        
+        for(size_t planeIdx = 0; planeIdx < geo->Nplanes(); planeIdx++)
+        {
+            const icarus_tool::IResponse& response = *fPlaneToResponseMap.at(planeIdx).front();
+            
+            fDeconKernels.push_back({planeIdx,
+                                     response.getDeconvKernel().size(),
+                                     response.getDeconvKernel(),
+                                     static_cast<int>(response.getTOffset())});
+        }
+        
         // Check to see if we want histogram output
         if (fStoreHistograms)
         {
@@ -156,21 +172,23 @@ void SignalShapingICARUSService::init()
     return;
 }
 
-void SignalShapingICARUSService::SetDecon(double const samplingRate,
-                                          size_t fftsize, size_t channel)
+void SignalShapingICARUSService::SetDecon(double const /* samplingRate */,
+                                          size_t /* fftsize */, size_t /* channel */)
+{
+    // The responses are computed only once (at initialization), and the kernels are
+    // frozen right after: nothing is left to do here
+    if (!fInit) init();
+}
+
+const SignalShapingICARUSService::DeconKernel& SignalShapingICARUSService::GetDeconKernel(size_t channel) const
 {
-    art::ServiceHandle<geo::Geometry> geo;
-    
     if (!fInit) init();
     
-    // Assume we need to reset the kernels
-    double integral = fPlaneToResponseMap.at(fPlaneForNormalization).front().get()->getFieldResponse()->getIntegral();
-    double weight   = 1. / integral;
+    art::ServiceHandle<geo::Geometry> geom;
+    
+    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
     
-    for(size_t planeIdx = 0; planeIdx < geo->Nplanes(); planeIdx++)
-    {
-        fPlaneToResponseMap.at(planeIdx).front()->setResponse(samplingRate, weight);
-    }
+    return fDeconKernels.at(planeIdx);
 }
 
 //-----Give Gain Settings to SimWire-----
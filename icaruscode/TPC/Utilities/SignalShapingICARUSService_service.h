@@ -80,6 +80,7 @@
 
 #include <vector>
 #include <map>
+#include <atomic>
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
@@ -117,6 +118,21 @@ public:
      
     int                           ResponseTOffset(unsigned int const channel)        const;
     
+    /// Deconvolution kernel of one plane, computed once per configuration.
+    struct DeconKernel
+    {
+        size_t                   plane;    ///< Plane the kernel applies to
+        size_t                   fftSize;  ///< Number of frequency bins of the kernel
+        icarusutil::FrequencyVec kernel;   ///< Deconvolution kernel (frequency domain)
+        int                      tOffset;  ///< Time offset of the response
+    };
+    
+    /// Returns the (immutable) deconvolution kernel for the plane of `channel`;
+    /// safe to call concurrently, the reference is valid until reconfiguration
+    const DeconKernel&            GetDeconKernel(size_t channel)                     const;
+    
+    /// Prepares the deconvolution kernels; kept for backward compatibility,
+    /// since the kernels are now all built once at initialization
     void                          SetDecon(double samplingRate, size_t fftsize, size_t channel);
     double                        GetDeconNorm() {return fDeconNorm;};
     
@@ -133,7 +149,7 @@ private:
     void init();
     
     // Attributes.
-    bool fInit;                                                 ///< Initialization flag
+    std::atomic<bool> fInit;                                    ///< Initialization flag
     
     // Fcl parameters.
     size_t             fPlaneForNormalization; ///< Normalize responses to this plane
@@ -145,6 +161,9 @@ private:
     
     // Field response tools
     PlaneToResponseMap fPlaneToResponseMap;
+    
+    // Deconvolution kernels by plane, filled by init() and then never modified
+    std::vector<DeconKernel> fDeconKernels;
 };
 
 } // end of namespace
@@ -12,6 +12,7 @@
 #define SignalProcessingDefs_H
 
 #include <complex>
+#include <vector>
 
 namespace icarusutil
 {
@@ -0,0 +1,156 @@
+/**
+ * @file   test/Decode/ChannelMapping/ChannelMapCacheFile_test.cc
+ * @brief  Unit test for `ChannelMapCacheFile` class.
+ * @date   October 16, 2026
+ * @see    `icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h`
+ *
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ChannelMapCacheFile.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ChannelMapCacheFile_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+// --- ChannelMapCacheFile tests
+// -----------------------------------------------------------------------------
+struct TestMaps_t {
+  icarusDB::TPCFragmentIDToReadoutIDMap TPCfragments;
+  icarusDB::TPCReadoutBoardToChannelMap TPCboards;
+  icarusDB::PMTFragmentToDigitizerChannelMap PMTfragments;
+  icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap CRTside;
+  icarusDB::TopCRTHWtoSimMacAddressPairMap CRTtop;
+  icarusDB::SideCRTChannelToCalibrationMap CRTcalibration;
+
+  icarusDB::ChannelMapCacheFile::Content content()
+    {
+      return
+        { TPCfragments, TPCboards, PMTfragments, CRTside, CRTtop, CRTcalibration };
+    }
+}; // TestMaps_t
+
+
+TestMaps_t makeTestMaps() {
+
+  TestMaps_t maps;
+  maps.TPCfragments[0x1000] = { "EE01T", { 12, 11, 10 } };
+  maps.TPCfragments[0x1001] = { "EE01M", {} };
+  maps.TPCboards[10] = { 2, { { 100, 0 }, { 101, 1 } } };
+  maps.TPCboards[11] = { 1, { { 102, 2 } } };
+
+  icarusDB::PMTChannelInfo_t info;
+  info.digitizerLabel = "EE-BOT-C";
+  info.digitizerChannelNo = 3;
+  info.channelID = 42;
+  info.laserChannelNo = 7;
+  info.LVDSconnector = 1;
+  info.LVDSbit = 5;
+  maps.PMTfragments[2].push_back(info);
+  maps.PMTfragments[2].emplace_back(); // all defaults
+
+  maps.CRTside[18] = { 0x55, 0x66 };
+  maps.CRTtop[0x77] = 0x88;
+  maps.CRTcalibration[{ 5, 31 }] = { 1.25, -3.5 };
+
+  return maps;
+} // makeTestMaps()
+
+
+void checkSameMaps(TestMaps_t const& maps, TestMaps_t const& expected) {
+
+  BOOST_TEST((maps.TPCfragments == expected.TPCfragments));
+  BOOST_TEST((maps.TPCboards == expected.TPCboards));
+  BOOST_TEST((maps.CRTside == expected.CRTside));
+  BOOST_TEST((maps.CRTtop == expected.CRTtop));
+  BOOST_TEST((maps.CRTcalibration == expected.CRTcalibration));
+
+  BOOST_TEST(maps.PMTfragments.size() == expected.PMTfragments.size());
+  for (auto const& [ key, channels ]: expected.PMTfragments) {
+    BOOST_TEST_CONTEXT("PMT fragment key " << key) {
+      auto const it = maps.PMTfragments.find(key);
+      BOOST_TEST_REQUIRE((it != maps.PMTfragments.end()));
+      BOOST_TEST_REQUIRE(it->second.size() == channels.size());
+      for (std::size_t i = 0; i < channels.size(); ++i) {
+        icarusDB::PMTChannelInfo_t const& info = it->second[i];
+        BOOST_TEST(info.digitizerLabel == channels[i].digitizerLabel);
+        BOOST_TEST(info.digitizerChannelNo == channels[i].digitizerChannelNo);
+        BOOST_TEST(info.channelID == channels[i].channelID);
+        BOOST_TEST(info.laserChannelNo == channels[i].laserChannelNo);
+        BOOST_TEST(info.LVDSconnector == channels[i].LVDSconnector);
+        BOOST_TEST(info.LVDSbit == channels[i].LVDSbit);
+        BOOST_TEST(info.adderConnector == channels[i].adderConnector);
+        BOOST_TEST(info.adderBit == channels[i].adderBit);
+      }
+    }
+  }
+
+} // checkSameMaps()
+
+
+void ChannelMapCacheFile_roundtrip_test() {
+
+  std::filesystem::path const path
+    = std::filesystem::temp_directory_path() / "ChannelMapCacheFile_test.bin";
+
+  TestMaps_t original = makeTestMaps();
+  icarusDB::ChannelMapCacheFile const file{ path.string() };
+  file.write("test key", original.content());
+
+  // correct key: full content back
+  TestMaps_t loaded;
+  auto loadedContent = loaded.content();
+  BOOST_TEST(file.read("test key", loadedContent));
+  checkSameMaps(loaded, original);
+
+  // wrong key: miss, and the content is untouched
+  TestMaps_t untouched;
+  untouched.CRTtop[1] = 2;
+  auto untouchedContent = untouched.content();
+  BOOST_TEST(!file.read("other key", untouchedContent));
+  BOOST_TEST(untouched.CRTtop.size() == 1U);
+  BOOST_TEST(untouched.TPCfragments.empty());
+
+  // corrupted payload: miss
+  std::uintmax_t const size = std::filesystem::file_size(path);
+  {
+    std::fstream corrupt{ path, std::ios::in | std::ios::out | std::ios::binary };
+    corrupt.seekp(size - 3);
+    corrupt.put('\x5A');
+  }
+  TestMaps_t corrupted;
+  auto corruptedContent = corrupted.content();
+  BOOST_TEST(!file.read("test key", corruptedContent));
+  BOOST_TEST(corrupted.TPCfragments.empty());
+
+  // truncated file: miss
+  std::filesystem::resize_file(path, size / 2);
+  BOOST_TEST(!file.read("test key", corruptedContent));
+
+  // missing file: miss
+  std::filesystem::remove(path);
+  BOOST_TEST(!file.read("test key", corruptedContent));
+
+} // ChannelMapCacheFile_roundtrip_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ChannelMapCacheFile_roundtrip_testcase) {
+
+  ChannelMapCacheFile_roundtrip_test();
+
+} // BOOST_AUTO_TEST_CASE(ChannelMapCacheFile_roundtrip_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
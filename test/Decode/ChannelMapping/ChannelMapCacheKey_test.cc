@@ -0,0 +1,215 @@
+/**
+ * @file   test/Decode/ChannelMapping/ChannelMapCacheKey_test.cc
+ * @brief  Unit test for the use of the cache keys of channel mapping backends.
+ * @date   October 16, 2026
+ * @see    `icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h`
+ *
+ * The persistent cache of the channel mapping is only as good as the key of
+ * the database backend: the test checks that a backend whose content changes
+ * under the same key is never cached (as the PostgreSQL one), and that with a
+ * backend with a content version in its key (as the SQLite one) a changed
+ * payload misses the cache.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapPostGres.h"
+#include "icaruscode/Decode/ChannelMapping/IChannelMapping.h"
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
+
+// framework libraries
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Table.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ChannelMapCacheKey_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <filesystem>
+#include <iterator>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+// --- a channel mapping backend serving a "database" which can be changed
+// -----------------------------------------------------------------------------
+struct TestDatabase_t {
+  unsigned int firstChannel = 100; ///< First channel of the only board.
+  unsigned int version = 1;        ///< Version of the content.
+  bool versioned = true;           ///< Whether the version goes in the key.
+}; // TestDatabase_t
+
+TestDatabase_t TestDatabase;
+
+
+class TestChannelMapping: public icarusDB::IChannelMapping {
+
+    public:
+
+  struct Config {
+    fhicl::Atom<std::string> LogCategory {
+      fhicl::Name{ "LogCategory" },
+      fhicl::Comment{ "name of the category for messages" },
+      "ChannelMapCacheKey_test"
+      };
+  }; // Config
+
+  static constexpr unsigned int FragmentID = 0x1000;
+  static constexpr unsigned int BoardID = 10;
+
+  explicit TestChannelMapping(Config const&) {}
+
+  virtual bool SelectPeriod(icarusDB::RunPeriod period) override
+    {
+      if (period == fPeriod) return false;
+      fPeriod = period;
+      return true;
+    }
+
+  virtual std::string CacheKey() const override
+    {
+      if (!TestDatabase.versioned) return {};
+      return "Test;" + std::to_string(static_cast<unsigned int>(fPeriod))
+        + ";v" + std::to_string(TestDatabase.version);
+    }
+
+  virtual int BuildTPCFragmentIDToReadoutIDMap
+    (icarusDB::TPCFragmentIDToReadoutIDMap& fragments) const override
+    {
+      fragments[FragmentID] = { "EE01T", { BoardID } };
+      return 0;
+    }
+
+  virtual int BuildTPCReadoutBoardToChannelMap
+    (icarusDB::TPCReadoutBoardToChannelMap& boards) const override
+    {
+      unsigned int const first = TestDatabase.firstChannel;
+      boards[BoardID] = { 0, { { first, 0 }, { first + 1, 0 } } };
+      return 0;
+    }
+
+  virtual int BuildPMTFragmentToDigitizerChannelMap
+    (icarusDB::PMTFragmentToDigitizerChannelMap&) const override
+    { return 0; }
+
+  virtual int BuildCRTChannelIDToHWtoSimMacAddressPairMap
+    (icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap&) const override
+    { return 0; }
+
+  virtual int BuildTopCRTHWtoSimMacAddressPairMap
+    (icarusDB::TopCRTHWtoSimMacAddressPairMap&) const override
+    { return 0; }
+
+  virtual int BuildSideCRTCalibrationMap
+    (icarusDB::SideCRTChannelToCalibrationMap&) const override
+    { return 0; }
+
+    private:
+  icarusDB::RunPeriod fPeriod = icarusDB::RunPeriod::NPeriods;
+
+}; // TestChannelMapping
+
+
+using TestProvider_t = icarusDB::ICARUSChannelMapProviderBase<TestChannelMapping>;
+
+
+// -----------------------------------------------------------------------------
+/// Returns the first channel of the test board in the current mapping.
+unsigned int firstChannel(TestProvider_t const& provider) {
+  auto const compiledMap = provider.compiledMap();
+  BOOST_TEST_REQUIRE(compiledMap);
+  icarusDB::ChannelPlanePairVec const* channels
+    = compiledMap->findChannelPlanePairs(TestChannelMapping::BoardID);
+  BOOST_TEST_REQUIRE(channels);
+  BOOST_TEST_REQUIRE(!channels->empty());
+  return channels->front().first;
+} // firstChannel()
+
+
+/// Reads the mapping of a run of the first period, after one of another.
+unsigned int readFirstPeriod(TestProvider_t& provider) {
+  provider.forRun(12000);
+  provider.forRun(5000);
+  return firstChannel(provider);
+} // readFirstPeriod()
+
+
+std::size_t countFiles(std::filesystem::path const& dir) {
+  if (!std::filesystem::exists(dir)) return 0;
+  return std::distance(std::filesystem::directory_iterator{ dir }, {});
+} // countFiles()
+
+
+// -----------------------------------------------------------------------------
+void postGresCacheKeyTest() {
+
+  // no database access happens before the maps are built
+  icarusDB::ChannelMapPostGres postGres{
+    fhicl::Table<icarusDB::ChannelMapPostGres::Config>{ fhicl::ParameterSet{} }()
+    };
+  BOOST_TEST(postGres.CacheKey().empty());
+  postGres.SelectPeriod(icarusDB::RunPeriod::Runs0to2);
+  BOOST_TEST(postGres.CacheKey().empty());
+
+} // postGresCacheKeyTest()
+
+
+// -----------------------------------------------------------------------------
+void changedPayloadTest(bool versioned) {
+
+  std::filesystem::path const cacheDir
+    = std::filesystem::temp_directory_path()
+    / ("ChannelMapCacheKey_test_" + std::to_string(versioned));
+  std::filesystem::remove_all(cacheDir);
+
+  fhicl::ParameterSet pset;
+  pset.put("ChannelMappingTool", fhicl::ParameterSet{});
+  pset.put("CacheDirectory", cacheDir.string());
+
+  TestDatabase = TestDatabase_t{};
+  TestDatabase.versioned = versioned;
+
+  {
+    TestProvider_t provider{ TestProvider_t::Parameters{ pset } };
+    BOOST_TEST(readFirstPeriod(provider) == 100U);
+  }
+  BOOST_TEST(countFiles(cacheDir) == (versioned? 2U: 0U));
+
+  // the database changes its content for the same period
+  TestDatabase.firstChannel = 200;
+  ++TestDatabase.version;
+
+  {
+    TestProvider_t provider{ TestProvider_t::Parameters{ pset } };
+    BOOST_TEST(readFirstPeriod(provider) == 200U);
+  }
+
+  if (versioned) {
+    // the old content is still served if the version is (wrongly) not bumped:
+    // that is the cache being used, and why unversioned content is not cached
+    TestDatabase.firstChannel = 300;
+    TestProvider_t provider{ TestProvider_t::Parameters{ pset } };
+    BOOST_TEST(readFirstPeriod(provider) == 200U);
+  }
+  else BOOST_TEST(countFiles(cacheDir) == 0U);
+
+  std::filesystem::remove_all(cacheDir);
+
+} // changedPayloadTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PostGresCacheKeyTestCase) {
+  postGresCacheKeyTest();
+}
+
+BOOST_AUTO_TEST_CASE(UnversionedPayloadTestCase) {
+  changedPayloadTest(false);
+}
+
+BOOST_AUTO_TEST_CASE(VersionedPayloadTestCase) {
+  changedPayloadTest(true);
+}
@@ -0,0 +1,207 @@
+/**
+ * @file   test/Decode/ChannelMapping/CompiledChannelMapPeriods_test.cc
+ * @brief  Unit test for the update of `CompiledChannelMap` across run periods.
+ * @date   October 16, 2026
+ * @see    `icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h`
+ *
+ * The test follows what the TPC decoder (`DaqDecoderICARUSTPCwROI`) does:
+ * it keeps a snapshot of the channel map, refreshes it via `util::CacheGuard`
+ * at each event, and looks up the boards of a fragment and their channels.
+ * The two runs being decoded belong to run periods with different mappings.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h"
+#include "icaruscode/Decode/ChannelMapping/IChannelMapping.h"
+#include "icaruscode/Decode/ChannelMapping/CompiledChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
+#include "icaruscode/Utilities/CacheCounter.h"
+
+// framework libraries
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Table.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( CompiledChannelMapPeriods_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <memory>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+// --- a channel mapping backend with a different TPC mapping in each period
+// -----------------------------------------------------------------------------
+class TestChannelMapping: public icarusDB::IChannelMapping {
+
+    public:
+
+  struct Config {
+    fhicl::Atom<std::string> LogCategory {
+      fhicl::Name{ "LogCategory" },
+      fhicl::Comment{ "name of the category for messages" },
+      "CompiledChannelMapPeriods_test"
+      };
+  }; // Config
+
+  static constexpr unsigned int FragmentID = 0x1000;
+
+  explicit TestChannelMapping(Config const&) {}
+
+  virtual bool SelectPeriod(icarusDB::RunPeriod period) override
+    {
+      if (period == fPeriod) return false;
+      fPeriod = period;
+      return true;
+    }
+
+  virtual int BuildTPCFragmentIDToReadoutIDMap
+    (icarusDB::TPCFragmentIDToReadoutIDMap& fragments) const override
+    {
+      fragments[FragmentID]
+        = isFirstPeriod()
+        ? icarusDB::CrateNameReadoutIDPair{ "EE01T", { 11, 10 } }
+        : icarusDB::CrateNameReadoutIDPair{ "EE01T", { 20, 21 } }
+        ;
+      return 0;
+    }
+
+  virtual int BuildTPCReadoutBoardToChannelMap
+    (icarusDB::TPCReadoutBoardToChannelMap& boards) const override
+    {
+      if (isFirstPeriod()) {
+        boards[10] = { 0, { { 100, 0 }, { 101, 0 } } };
+        boards[11] = { 1, { { 102, 1 }, { 103, 1 } } };
+      }
+      else {
+        boards[20] = { 1, { { 200, 2 }, { 201, 2 } } };
+        boards[21] = { 0, { { 202, 2 }, { 203, 2 } } };
+      }
+      return 0;
+    }
+
+  virtual int BuildPMTFragmentToDigitizerChannelMap
+    (icarusDB::PMTFragmentToDigitizerChannelMap&) const override
+    { return 0; }
+
+  virtual int BuildCRTChannelIDToHWtoSimMacAddressPairMap
+    (icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap&) const override
+    { return 0; }
+
+  virtual int BuildTopCRTHWtoSimMacAddressPairMap
+    (icarusDB::TopCRTHWtoSimMacAddressPairMap&) const override
+    { return 0; }
+
+  virtual int BuildSideCRTCalibrationMap
+    (icarusDB::SideCRTChannelToCalibrationMap&) const override
+    { return 0; }
+
+    private:
+  icarusDB::RunPeriod fPeriod = icarusDB::RunPeriod::NPeriods;
+
+  bool isFirstPeriod() const
+    { return fPeriod == icarusDB::RunPeriod::Runs0to2; }
+
+}; // TestChannelMapping
+
+
+using TestProvider_t = icarusDB::ICARUSChannelMapProviderBase<TestChannelMapping>;
+
+
+// -----------------------------------------------------------------------------
+/// Keeps a snapshot of the channel map like the TPC decoder does.
+struct DecoderLike_t {
+
+  icarusDB::IICARUSChannelMapProvider const& channelMap;
+  util::CacheGuard cacheGuard{ "TPC" };
+  std::shared_ptr<icarusDB::CompiledChannelMap const> compiledMap;
+
+  DecoderLike_t(icarusDB::IICARUSChannelMapProvider const& channelMap)
+    : channelMap{ channelMap }
+    { cacheGuard.setCache(channelMap); }
+
+  /// Same as `DaqDecoderICARUSTPCwROI::updateChannelMapSnapshot()`.
+  bool update()
+    {
+      if (!cacheGuard.update()) return false;
+      compiledMap = channelMap.compiledMap();
+      return true;
+    }
+
+  /// Returns all the channels of the fragment, in board slot order.
+  icarusDB::ChannelPlanePairVec decode(unsigned int fragmentID) const
+    {
+      BOOST_TEST_REQUIRE(compiledMap);
+      icarusDB::ReadoutIDVec const* boardIDs
+        = compiledMap->boardsInSlotOrder(fragmentID);
+      BOOST_TEST_REQUIRE(boardIDs);
+      icarusDB::ChannelPlanePairVec channels;
+      for (unsigned int const boardID: *boardIDs) {
+        icarusDB::ChannelPlanePairVec const* boardChannels
+          = compiledMap->findChannelPlanePairs(boardID);
+        BOOST_TEST_REQUIRE(boardChannels);
+        channels.insert
+          (channels.end(), boardChannels->begin(), boardChannels->end());
+      }
+      return channels;
+    }
+
+}; // DecoderLike_t
+
+
+// -----------------------------------------------------------------------------
+void twoPeriodTest() {
+
+  fhicl::ParameterSet pset;
+  pset.put("ChannelMappingTool", fhicl::ParameterSet{});
+
+  TestProvider_t provider{ TestProvider_t::Parameters{ pset } };
+
+  icarusDB::ChannelPlanePairVec const expectedFirst
+    = { { 100, 0 }, { 101, 0 }, { 102, 1 }, { 103, 1 } };
+  icarusDB::ChannelPlanePairVec const expectedSecond
+    = { { 202, 2 }, { 203, 2 }, { 200, 2 }, { 201, 2 } };
+
+  // first run, first period
+  BOOST_TEST(provider.forRun(5000));
+
+  DecoderLike_t decoder{ provider };
+  DecoderLike_t staleDecoder{ provider }; // never updates after the first run
+
+  BOOST_TEST(decoder.update());
+  BOOST_TEST(staleDecoder.update());
+  BOOST_TEST((decoder.decode(TestChannelMapping::FragmentID) == expectedFirst));
+
+  // second event of the same run: no update
+  BOOST_TEST(!decoder.update());
+  BOOST_TEST((decoder.decode(TestChannelMapping::FragmentID) == expectedFirst));
+
+  // another run in the same period: no update
+  BOOST_TEST(!provider.forRun(5001));
+  BOOST_TEST(!decoder.update());
+
+  // new run in a new period: the snapshot must follow
+  BOOST_TEST(provider.forRun(12000));
+  BOOST_TEST(decoder.update());
+  BOOST_TEST(decoder.compiledMap->cacheID() == provider.cacheID(""));
+  BOOST_TEST((decoder.decode(TestChannelMapping::FragmentID) == expectedSecond));
+
+  // the old snapshot is still valid for whoever holds it
+  BOOST_TEST
+    ((staleDecoder.decode(TestChannelMapping::FragmentID) == expectedFirst));
+  BOOST_TEST(staleDecoder.compiledMap->cacheID() != provider.cacheID(""));
+
+  // back to the first period
+  BOOST_TEST(provider.forRun(6000));
+  BOOST_TEST(decoder.update());
+  BOOST_TEST((decoder.decode(TestChannelMapping::FragmentID) == expectedFirst));
+
+} // twoPeriodTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(TwoPeriodTestCase) {
+  twoPeriodTest();
+}
@@ -0,0 +1,145 @@
+/**
+ * @file   NoiseGeneratorAlg_benchmark.cc
+ * @brief  Timing of the PMT noise and pedestal generators.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Algorithms/GaussianNoiseGeneratorAlg.h
+ * @see    icaruscode/PMT/Algorithms/FastGaussianNoiseGeneratorAlg.h
+ * @see    icaruscode/PMT/Algorithms/PedestalGeneratorAlg.h
+ * @see    test/PMT/Algorithms/NoiseGeneratorAlg_test.cc
+ *
+ * Prints the time per sample of the bulk and one-sample-at-a-time generation
+ * of noise, and of the rounded pedestal filling compared to filling a
+ * temporary buffer and rounding it.
+ * This program checks nothing and it is not run as a test.
+ *
+ * Usage: `NoiseGeneratorAlg_benchmark [NSamples]`
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/GaussianNoiseGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/FastGaussianNoiseGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/ConstantPedestalGeneratorAlg.h"
+
+// LArSoft libraries
+#include "lardataalg/Utilities/quantities/electronics.h" // counts_f
+
+// CLHEP libraries
+#include "CLHEP/Random/JamesRandom.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <chrono>
+#include <memory> // std::make_unique()
+#include <vector>
+#include <string>
+#include <cmath> // std::round()
+#include <cstdlib> // std::stoul()
+
+
+// -----------------------------------------------------------------------------
+using ADCcount_t = util::quantities::counts_f;
+
+constexpr long Seed = 12345L;
+
+
+// -----------------------------------------------------------------------------
+/// Returns the nanoseconds per sample taken by `fillOnce()` on `n` samples.
+template <typename Func>
+double nanosecondsPerSample(std::size_t n, Func fillOnce) {
+  auto const start = std::chrono::steady_clock::now();
+  fillOnce();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / n;
+} // nanosecondsPerSample()
+
+
+// -----------------------------------------------------------------------------
+/// Prints the time per sample of bulk and one-sample-at-a-time filling.
+template <typename Generator>
+void noiseTiming(
+  std::string const& name, typename Generator::Params_t const& params,
+  std::size_t nSamples
+) {
+  CLHEP::HepJamesRandom engine{ Seed };
+  Generator gen{ params, engine };
+
+  std::vector<ADCcount_t> samples(nSamples);
+
+  double const bulkTime = nanosecondsPerSample
+    (nSamples, [&gen,&samples](){ gen.fill(0, 0, samples); });
+
+  double const singleTime = nanosecondsPerSample(nSamples,
+    [&gen,&samples]()
+      { for (ADCcount_t& sample: samples) gen.fill(0, 0, &sample, 1U); }
+    );
+
+  std::cout << name << ": " << bulkTime << " ns/sample in bulk, "
+    << singleTime << " ns/sample one at a time" << std::endl;
+
+} // noiseTiming()
+
+
+// -----------------------------------------------------------------------------
+/// Prints the time per sample of `fillRounded()` and of explicit rounding.
+template <typename NoiseGenerator>
+void fillRoundedTiming(
+  std::string const& name, typename NoiseGenerator::Params_t const& params,
+  std::size_t nSamples
+) {
+  using PedestalGenerator_t
+    = icarus::opdet::ConstantPedestalGeneratorAlg<ADCcount_t>;
+  using RoundedADC_t = PedestalGenerator_t::RoundedADC_t;
+
+  ADCcount_t const level{ 14999.5f };
+
+  CLHEP::HepJamesRandom engine{ Seed };
+  PedestalGenerator_t gen
+    { { level }, std::make_unique<NoiseGenerator>(params, engine) };
+
+  std::vector<RoundedADC_t> output(nSamples);
+  double const roundedTime = nanosecondsPerSample(nSamples,
+    [&gen,&output]()
+      { gen.fillRounded(0, 0, output.data(), output.size()); }
+    );
+  double const explicitTime = nanosecondsPerSample(nSamples,
+    [&gen,&output]()
+      {
+        std::vector<ADCcount_t> noise(output.size());
+        gen.fill(0, 0, noise);
+        auto itOut = output.begin();
+        for (ADCcount_t const sample: noise)
+          *(itOut++) = static_cast<RoundedADC_t>(std::round(sample.value()));
+      }
+    );
+  std::cout << "ConstantPedestalGeneratorAlg with " << name << ": "
+    << roundedTime << " ns/sample with fillRounded(), " << explicitTime
+    << " ns/sample with temporary buffer" << std::endl;
+
+} // fillRoundedTiming()
+
+
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const nSamples = (argc > 1)? std::stoul(argv[1]): 2'000'000U;
+
+  using GaussianNoise_t = icarus::opdet::GaussianNoiseGeneratorAlg<ADCcount_t>;
+  using FastNoise_t = icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCcount_t>;
+
+  GaussianNoise_t::Params_t const gaussParams{ ADCcount_t{ 3.5f } };
+  FastNoise_t::Params_t const fastParams{ ADCcount_t{ 3.5f } };
+
+  std::cout << "Timing on " << nSamples << " samples." << std::endl;
+
+  noiseTiming<GaussianNoise_t>
+    ("GaussianNoiseGeneratorAlg", gaussParams, nSamples);
+  noiseTiming<FastNoise_t>
+    ("FastGaussianNoiseGeneratorAlg", fastParams, nSamples);
+
+  fillRoundedTiming<GaussianNoise_t>
+    ("GaussianNoiseGeneratorAlg", gaussParams, nSamples);
+  fillRoundedTiming<FastNoise_t>
+    ("FastGaussianNoiseGeneratorAlg", fastParams, nSamples);
+
+  return 0;
+} // main()
@@ -0,0 +1,186 @@
+/**
+ * @file   NoiseGeneratorAlg_test.cc
+ * @brief  Unit test of the PMT noise and pedestal generators.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Algorithms/GaussianNoiseGeneratorAlg.h
+ * @see    icaruscode/PMT/Algorithms/FastGaussianNoiseGeneratorAlg.h
+ * @see    icaruscode/PMT/Algorithms/NoNoiseGeneratorAlg.h
+ * @see    icaruscode/PMT/Algorithms/PedestalGeneratorAlg.h
+ *
+ * The bulk generation is checked against the generation of one sample per
+ * call, using two random engines with the same seed.
+ * The time per sample of each generation mode is measured by
+ * `NoiseGeneratorAlg_benchmark`, which is not run as a test.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/GaussianNoiseGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/FastGaussianNoiseGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/NoNoiseGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/ConstantPedestalGeneratorAlg.h"
+
+// LArSoft libraries
+#include "lardataalg/Utilities/quantities/electronics.h" // counts_f
+
+// CLHEP libraries
+#include "CLHEP/Random/JamesRandom.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( NoiseGeneratorAlg_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <memory> // std::make_unique()
+#include <vector>
+#include <cmath> // std::round()
+
+
+// -----------------------------------------------------------------------------
+using ADCcount_t = util::quantities::counts_f;
+using NoiseGenerator_t = icarus::opdet::NoiseGeneratorAlg<ADCcount_t>;
+
+constexpr long Seed = 12345L;
+constexpr std::size_t NSamples = 5000U; // not a multiple of the block size
+
+
+// -----------------------------------------------------------------------------
+/// Checks that bulk `fill()` and `add()` match one-sample-at-a-time filling.
+template <typename Generator>
+void bulkVsSingleSample_test(typename Generator::Params_t const& params) {
+
+  CLHEP::HepJamesRandom bulkEngine{ Seed }, singleEngine{ Seed };
+  Generator bulkGen{ params, bulkEngine }, singleGen{ params, singleEngine };
+
+  std::vector<ADCcount_t> bulk(NSamples), single(NSamples);
+  BOOST_TEST(bulkGen.fill(0, 0, bulk) == NSamples);
+  for (ADCcount_t& sample: single)
+    BOOST_TEST_REQUIRE(singleGen.fill(0, 0, &sample, 1U) == 1U);
+
+  for (std::size_t i = 0; i < NSamples; ++i) {
+    BOOST_TEST_CONTEXT("sample #" << i) {
+      BOOST_TEST(bulk[i].value() == single[i].value());
+    }
+  }
+
+  // adding: both buffers receive the same noise again
+  BOOST_TEST(bulkGen.add(0, 0, bulk) == NSamples);
+  for (ADCcount_t& sample: single)
+    BOOST_TEST_REQUIRE(singleGen.add(0, 0, &sample, 1U) == 1U);
+
+  for (std::size_t i = 0; i < NSamples; ++i) {
+    BOOST_TEST_CONTEXT("sample #" << i) {
+      BOOST_TEST(bulk[i].value() == single[i].value());
+    }
+  }
+
+  // the engines have been advanced by the same amount
+  BOOST_TEST(bulkEngine.flat() == singleEngine.flat());
+
+} // bulkVsSingleSample_test()
+
+
+// -----------------------------------------------------------------------------
+/// Checks `fillRounded()` against filling and rounding explicitly.
+template <typename NoiseGenerator>
+void fillRounded_test(typename NoiseGenerator::Params_t const& params) {
+
+  using PedestalGenerator_t
+    = icarus::opdet::ConstantPedestalGeneratorAlg<ADCcount_t>;
+  using RoundedADC_t = PedestalGenerator_t::RoundedADC_t;
+
+  ADCcount_t const level{ 14999.5f };
+
+  CLHEP::HepJamesRandom roundedEngine{ Seed }, referenceEngine{ Seed };
+  PedestalGenerator_t roundedGen{
+    { level }, std::make_unique<NoiseGenerator>(params, roundedEngine)
+    };
+  PedestalGenerator_t referenceGen{
+    { level }, std::make_unique<NoiseGenerator>(params, referenceEngine)
+    };
+
+  std::vector<RoundedADC_t> rounded(NSamples);
+  BOOST_TEST
+    (roundedGen.fillRounded(0, 0, rounded.data(), rounded.size()) == NSamples);
+
+  std::vector<ADCcount_t> reference(NSamples);
+  BOOST_TEST(referenceGen.fill(0, 0, reference) == NSamples);
+
+  for (std::size_t i = 0; i < NSamples; ++i) {
+    BOOST_TEST_CONTEXT("sample #" << i) {
+      BOOST_TEST(rounded[i]
+        == static_cast<RoundedADC_t>(std::round(reference[i].value())));
+    }
+  }
+
+  // a second, shorter request continues the same sequence
+  BOOST_TEST(roundedGen.fillRounded(0, 0, rounded.data(), 10U) == 10U);
+  BOOST_TEST(referenceGen.fill(0, 0, reference.data(), 10U) == 10U);
+  for (std::size_t i = 0; i < 10U; ++i) {
+    BOOST_TEST(rounded[i]
+      == static_cast<RoundedADC_t>(std::round(reference[i].value())));
+  }
+
+  // the engines have been advanced by the same amount
+  BOOST_TEST(roundedEngine.flat() == referenceEngine.flat());
+
+} // fillRounded_test()
+
+
+/// Checks `fillRounded()` of a pedestal generator without noise.
+void fillRoundedNoNoise_test() {
+
+  using PedestalGenerator_t
+    = icarus::opdet::ConstantPedestalGeneratorAlg<ADCcount_t>;
+  using RoundedADC_t = PedestalGenerator_t::RoundedADC_t;
+
+  PedestalGenerator_t gen{ { ADCcount_t{ 14999.7f } }, nullptr };
+
+  std::vector<RoundedADC_t> rounded(NSamples, 0);
+  BOOST_TEST(gen.fillRounded(0, 0, rounded.data(), rounded.size()) == NSamples);
+  for (std::size_t i = 0; i < NSamples; ++i) {
+    BOOST_TEST_CONTEXT("sample #" << i) {
+      BOOST_TEST(rounded[i] == 15000);
+    }
+  }
+
+} // fillRoundedNoNoise_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(GaussianNoiseGeneratorAlg_testcase) {
+
+  using Generator_t = icarus::opdet::GaussianNoiseGeneratorAlg<ADCcount_t>;
+  Generator_t::Params_t const params{ ADCcount_t{ 3.5f } };
+
+  bulkVsSingleSample_test<Generator_t>(params);
+  fillRounded_test<Generator_t>(params);
+
+} // BOOST_AUTO_TEST_CASE(GaussianNoiseGeneratorAlg_testcase)
+
+
+BOOST_AUTO_TEST_CASE(FastGaussianNoiseGeneratorAlg_testcase) {
+
+  using Generator_t = icarus::opdet::FastGaussianNoiseGeneratorAlg<ADCcount_t>;
+  Generator_t::Params_t const params{ ADCcount_t{ 3.5f } };
+
+  bulkVsSingleSample_test<Generator_t>(params);
+  fillRounded_test<Generator_t>(params);
+
+} // BOOST_AUTO_TEST_CASE(FastGaussianNoiseGeneratorAlg_testcase)
+
+
+BOOST_AUTO_TEST_CASE(NoNoiseGeneratorAlg_testcase) {
+
+  using Generator_t = icarus::opdet::NoNoiseGeneratorAlg<ADCcount_t>;
+
+  fillRounded_test<Generator_t>(Generator_t::Params_t{});
+  fillRoundedNoNoise_test();
+
+} // BOOST_AUTO_TEST_CASE(NoNoiseGeneratorAlg_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
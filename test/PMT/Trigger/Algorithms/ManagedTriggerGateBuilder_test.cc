@@ -0,0 +1,461 @@
+/**
+ * @file   ManagedTriggerGateBuilder_test.cc
+ * @brief  Unit test for `icarus::trigger::ManagedTriggerGateBuilder`.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.h
+ *
+ * The threshold crossings and the gate openings and closings of the builder
+ * are compared with a reference which walks the waveforms one sample at a
+ * time, subtracting the baseline from each sample and comparing it with all
+ * the thresholds (as the builder did before scanning the raw samples in
+ * blocks). The comparison covers random waveforms and edge cases: level changes
+ * at the boundaries of the 32-sample blocks of the scan, waveforms starting
+ * above threshold, empty waveforms and consecutive waveforms on the same
+ * channel. The gates are also built with more than one thread, and they must
+ * match the ones built with a single thread.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.h"
+#include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // ADCCounts_t
+#include "icarusalg/Utilities/WaveformOperations.h"
+#include "sbnobj/ICARUS/PMT/Data/WaveformBaseline.h"
+
+// LArSoft libraries
+#include "lardataalg/DetectorInfo/DetectorTimings.h"
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
+#include "lardataalg/DetectorInfo/ElecClock.h"
+#include "lardataobj/RawData/OpDetWaveform.h"
+
+// framework libraries
+#include "fhiclcpp/types/Table.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// TBB libraries
+#include "tbb/global_control.h"
+#include "tbb/task_arena.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ManagedTriggerGateBuilder_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <algorithm> // std::count_if()
+#include <cmath> // std::round()
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <map>
+#include <random>
+#include <utility> // std::pair
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+using icarus::trigger::ADCCounts_t;
+using icarus::trigger::WaveformWithBaseline;
+
+using Sample_t = raw::OpDetWaveform::value_type;
+
+constexpr float Baseline = 14900.3f; // not an integer: rounding matters
+constexpr unsigned int Seed = 12345U;
+
+/// Thresholds [ADC counts] (two are equal on purpose).
+std::vector<int> const Thresholds = { 2, 6, 12, 12, 30 };
+
+
+/// An opening or closing of a gate.
+struct GateEvent_t {
+  std::ptrdiff_t tick;
+  bool open;
+  bool operator== (GateEvent_t const& other) const
+    { return (tick == other.tick) && (open == other.open); }
+}; // GateEvent_t
+
+/// Opening and closings of each gate, by channel and threshold index.
+using GateEvents_t
+  = std::map<std::pair<raw::Channel_t, std::size_t>, std::vector<GateEvent_t>>;
+
+
+// -----------------------------------------------------------------------------
+/// A builder recording the openings and closings of the gates.
+class TestGateBuilder: public icarus::trigger::ManagedTriggerGateBuilder {
+
+  using Base_t = icarus::trigger::ManagedTriggerGateBuilder;
+
+  class RecordingGateManager: private GateManager {
+
+    struct RecordingGateInfo: public GateInfoBase {
+      std::vector<GateEvent_t>* events;
+
+      RecordingGateInfo(TriggerGate_t& gate, std::vector<GateEvent_t>& events)
+        : GateInfoBase(gate), events(&events) {}
+
+      void belowThresholdAt(icarus::trigger::optical_tick tick)
+        { events->push_back({ static_cast<std::ptrdiff_t>(tick.value()), false }); }
+      void aboveThresholdAt(icarus::trigger::optical_tick tick)
+        { events->push_back({ static_cast<std::ptrdiff_t>(tick.value()), true }); }
+
+    }; // struct RecordingGateInfo
+
+    GateEvents_t* fEvents;
+    std::map<raw::Channel_t, std::size_t> fNGates; ///< Gates made per channel.
+
+      public:
+    using GateInfo_t = RecordingGateInfo;
+
+    RecordingGateManager(GateEvents_t& events): fEvents(&events) {}
+
+    // gates are created serially, channel by channel in threshold order
+    GateInfo_t create(GateInfo_t::TriggerGate_t& gate)
+      {
+        raw::Channel_t const channel = gate.channels().front();
+        return { gate, (*fEvents)[{ channel, fNGates[channel]++ }] };
+      }
+
+  }; // struct RecordingGateManager
+
+    public:
+
+  using Base_t::Base_t;
+  using Base_t::ThresholdCrossing_t;
+  using Base_t::findThresholdCrossings;
+
+  virtual std::vector<TriggerGates> build
+    (std::vector<WaveformWithBaseline> const& waveforms) const override
+    {
+      GateEvents_t events;
+      return unifiedBuild(RecordingGateManager{ events }, waveforms);
+    }
+
+  /// Builds the gates and returns their openings and closings.
+  GateEvents_t record(std::vector<WaveformWithBaseline> const& waveforms) const
+    {
+      GateEvents_t events;
+      unifiedBuild(RecordingGateManager{ events }, waveforms);
+      return events;
+    }
+
+}; // class TestGateBuilder
+
+
+// -----------------------------------------------------------------------------
+/// A set of waveforms sorted by channel and time, with their baselines.
+struct TestWaveforms_t {
+  std::vector<raw::OpDetWaveform> waveforms;
+  icarus::WaveformBaseline baseline{ Baseline };
+
+  void add
+    (raw::Channel_t channel, raw::TimeStamp_t time, std::vector<Sample_t> samples)
+    {
+      raw::OpDetWaveform& waveform = waveforms.emplace_back(time, channel);
+      waveform.assign(samples.begin(), samples.end());
+    }
+
+  std::vector<WaveformWithBaseline> withBaselines() const
+    {
+      std::vector<WaveformWithBaseline> result;
+      for (raw::OpDetWaveform const& waveform: waveforms)
+        result.emplace_back(&waveform, &baseline);
+      return result;
+    }
+}; // TestWaveforms_t
+
+
+/// Returns the raw sample with the specified baseline-subtracted value.
+Sample_t sampleAt(int relSample)
+  { return static_cast<Sample_t>(std::round(Baseline - relSample)); }
+
+
+/// Returns a waveform of `nSamples` samples with noise and negative pulses.
+std::vector<Sample_t> randomSamples(std::mt19937& engine, std::size_t nSamples) {
+  std::normal_distribution<float> noise{ 0.f, 2.f };
+  std::uniform_int_distribution<int> nPulses{ 0, 4 };
+  std::uniform_real_distribution<float> peak{ 0.f, float(nSamples) };
+  std::uniform_real_distribution<float> amplitude{ 3.f, 50.f };
+
+  std::vector<float> signal(nSamples, 0.f);
+  for (float& sample: signal) sample = noise(engine);
+  for (int pulse = nPulses(engine); pulse > 0; --pulse) {
+    float const t0 = peak(engine), A = amplitude(engine);
+    for (std::size_t i = 0; i < nSamples; ++i) {
+      float const x = (i - t0) / 4.f;
+      if (std::abs(x) < 6.f) signal[i] += A * std::exp(-0.5f * x * x);
+    }
+  }
+
+  std::vector<Sample_t> samples;
+  for (float const s: signal)
+    samples.push_back(static_cast<Sample_t>(std::round(Baseline - s)));
+  return samples;
+} // randomSamples()
+
+
+// -----------------------------------------------------------------------------
+/// Reference: number of thresholds each sample is at or above of.
+std::vector<std::size_t> referenceLevels(raw::OpDetWaveform const& waveform) {
+  using ops = icarus::waveform_operations::NegativePolarityOperations<float>;
+  ops const waveOps { Baseline };
+
+  std::vector<std::size_t> levels;
+  for (Sample_t const sample: waveform) {
+    ADCCounts_t const relSample
+      = ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)));
+    levels.push_back(std::count_if(Thresholds.begin(), Thresholds.end(),
+      [relSample](int thr){ return relSample >= ADCCounts_t(thr); }));
+  }
+  return levels;
+} // referenceLevels()
+
+
+/// Reference: gate openings and closings walking one sample at a time.
+GateEvents_t referenceGateEvents
+  (TestGateBuilder const& builder, TestWaveforms_t const& data)
+{
+  GateEvents_t events;
+  for (raw::OpDetWaveform const& waveform: data.waveforms) {
+    raw::Channel_t const channel = waveform.ChannelNumber();
+    for (std::size_t iThr = 0; iThr < Thresholds.size(); ++iThr)
+      events[{ channel, iThr }]; // all gates exist, even if never opened
+
+    std::ptrdiff_t const start
+      = builder.timeStampToOpticalTick(waveform.TimeStamp()).value();
+
+    // each waveform starts with all the gates below threshold
+    std::size_t level = 0U;
+    std::vector<std::size_t> const levels = referenceLevels(waveform);
+    for (std::size_t iSample = 0; iSample < levels.size(); ++iSample) {
+      std::ptrdiff_t const tick = start + iSample;
+      while (level < levels[iSample])
+        events[{ channel, level++ }].push_back({ tick, true });
+      while (level > levels[iSample])
+        events[{ channel, --level }].push_back({ tick, false });
+    } // for samples
+  } // for waveforms
+  return events;
+} // referenceGateEvents()
+
+
+// -----------------------------------------------------------------------------
+/// Returns a builder set up with an optical clock of 500 MHz.
+TestGateBuilder makeBuilder() {
+
+  fhicl::ParameterSet pset;
+  pset.put("ChannelThresholds", Thresholds);
+  fhicl::Table<icarus::trigger::TriggerGateBuilder::Config> const config{ pset };
+
+  detinfo::ElecClock const clock{ 0.0, 1600.0, 500.0 };
+  static detinfo::DetectorClocksData const clockData
+    { 0.0, 0.0, 0.0, 0.0, clock, clock, clock, clock };
+
+  TestGateBuilder builder{ config() };
+  builder.setup(detinfo::makeDetectorTimings(clockData));
+  return builder;
+} // makeBuilder()
+
+
+/// Waveforms on a few channels, with all the edge cases.
+TestWaveforms_t makeEdgeCaseWaveforms() {
+
+  // 1000 samples are 2 us, so that waveforms can be exactly back to back
+  std::vector<Sample_t> const flat(1000, sampleAt(0));
+  TestWaveforms_t data;
+
+  // level changes right before, at and after the 32-sample block boundaries;
+  // the waveform ends above threshold
+  std::vector<Sample_t> blocks = flat;
+  blocks[31] = sampleAt(2); // exactly at the first threshold
+  blocks[32] = sampleAt(1);
+  blocks[63] = sampleAt(12); // two pulses, across a block boundary
+  blocks[64] = sampleAt(30);
+  blocks[65] = sampleAt(11);
+  blocks[95] = sampleAt(6);
+  blocks[96] = sampleAt(7);
+  blocks.back() = sampleAt(40);
+  data.add(1, 10.0, blocks);
+
+  // a waveform starting above all the thresholds, with the same channel as
+  // the previous one and starting right when the previous one ends;
+  // it starts again with all the gates closed
+  std::vector<Sample_t> startAbove = flat;
+  std::fill(startAbove.begin(), startAbove.begin() + 40, sampleAt(35));
+  data.add(1, 12.0, startAbove);
+
+  // an empty waveform, alone in its channel and in another one
+  data.add(2, 10.0, {});
+  data.add(3, 10.0, startAbove);
+  data.add(3, 12.0, {});
+  data.add(3, 14.0, blocks);
+
+  // a waveform shorter than a block, always above threshold
+  data.add(4, 10.0, std::vector<Sample_t>(20, sampleAt(12)));
+
+  return data;
+} // makeEdgeCaseWaveforms()
+
+
+/// Random waveforms on `nChannels` channels, a few per channel.
+TestWaveforms_t makeRandomWaveforms(std::size_t nChannels) {
+
+  std::mt19937 engine{ Seed };
+  std::uniform_int_distribution<int> nWaveforms{ 1, 4 };
+  std::uniform_int_distribution<std::size_t> nSamples{ 1, 600 };
+
+  TestWaveforms_t data;
+  for (raw::Channel_t channel = 0; channel < nChannels; ++channel) {
+    raw::TimeStamp_t time = 5.0; // us
+    for (int i = nWaveforms(engine); i > 0; --i) {
+      std::size_t const n = nSamples(engine);
+      data.add(channel, time, randomSamples(engine, n));
+      time += 2.0 + n * 0.002; // not overlapping
+    }
+  }
+  return data;
+} // makeRandomWaveforms()
+
+
+// -----------------------------------------------------------------------------
+void checkCrossings(TestGateBuilder const& builder, TestWaveforms_t const& data)
+{
+  for (WaveformWithBaseline const& waveformData: data.withBaselines()) {
+    raw::OpDetWaveform const& waveform = waveformData.waveform();
+    BOOST_TEST_CONTEXT("waveform on channel " << waveform.ChannelNumber()
+      << " at " << waveform.TimeStamp() << " us")
+    {
+      std::vector<std::size_t> const levels = referenceLevels(waveform);
+      std::vector<TestGateBuilder::ThresholdCrossing_t> expected;
+      std::size_t level = 0U;
+      for (std::size_t iSample = 0; iSample < levels.size(); ++iSample) {
+        if (levels[iSample] == level) continue;
+        level = levels[iSample];
+        expected.push_back({ static_cast<std::ptrdiff_t>(iSample), level });
+      }
+
+      auto const crossings = builder.findThresholdCrossings(waveformData);
+      BOOST_TEST_REQUIRE(crossings.size() == expected.size());
+      for (std::size_t i = 0; i < crossings.size(); ++i) {
+        BOOST_TEST_CONTEXT("crossing #" << i) {
+          BOOST_TEST(crossings[i].sample == expected[i].sample);
+          BOOST_TEST(crossings[i].level == expected[i].level);
+        }
+      }
+    }
+  } // for waveforms
+} // checkCrossings()
+
+
+void checkGateEvents
+  (GateEvents_t const& events, GateEvents_t const& expected)
+{
+  BOOST_TEST_REQUIRE(events.size() == expected.size());
+  for (auto const& [ key, expectedEvents ]: expected) {
+    BOOST_TEST_CONTEXT
+      ("channel " << key.first << ", threshold #" << key.second)
+    {
+      auto const it = events.find(key);
+      BOOST_TEST_REQUIRE((it != events.end()));
+      std::vector<GateEvent_t> const& gateEvents = it->second;
+      BOOST_TEST_REQUIRE(gateEvents.size() == expectedEvents.size());
+      for (std::size_t i = 0; i < gateEvents.size(); ++i) {
+        BOOST_TEST_CONTEXT("event #" << i) {
+          BOOST_TEST(gateEvents[i].tick == expectedEvents[i].tick);
+          BOOST_TEST(gateEvents[i].open == expectedEvents[i].open);
+        }
+      }
+    }
+  } // for gates
+} // checkGateEvents()
+
+
+// -----------------------------------------------------------------------------
+void edgeCaseTest() {
+
+  TestGateBuilder const builder = makeBuilder();
+  TestWaveforms_t const data = makeEdgeCaseWaveforms();
+
+  checkCrossings(builder, data);
+
+  GateEvents_t const expected = referenceGateEvents(builder, data);
+  checkGateEvents(builder.record(data.withBaselines()), expected);
+
+  // a few explicit checks on the reference itself:
+  // first waveform, first threshold: open at 31, close at 32, ...
+  std::ptrdiff_t const start = builder.timeStampToOpticalTick(10.0).value();
+  std::vector<GateEvent_t> const& firstGate = expected.at({ 1, 0 });
+  BOOST_TEST_REQUIRE(firstGate.size() >= 2U);
+  BOOST_TEST((firstGate[0] == GateEvent_t{ start + 31, true }));
+  BOOST_TEST((firstGate[1] == GateEvent_t{ start + 32, false }));
+  // ... the gates are all opened at the start of the second waveform
+  std::ptrdiff_t const secondStart = start + 1000;
+  for (std::size_t iThr = 0; iThr < Thresholds.size(); ++iThr) {
+    BOOST_TEST_CONTEXT("threshold #" << iThr) {
+      std::vector<GateEvent_t> const& gate = expected.at({ 1, iThr });
+      BOOST_TEST((std::count(gate.begin(), gate.end(),
+        GateEvent_t{ secondStart, true }) == 1));
+    }
+  }
+  // ... the empty waveforms open no gate
+  for (std::size_t iThr = 0; iThr < Thresholds.size(); ++iThr)
+    BOOST_TEST(expected.at({ 2, iThr }).empty());
+
+} // edgeCaseTest()
+
+
+// -----------------------------------------------------------------------------
+void randomWaveformTest() {
+
+  TestGateBuilder const builder = makeBuilder();
+  TestWaveforms_t const data = makeRandomWaveforms(40U);
+
+  checkCrossings(builder, data);
+  checkGateEvents
+    (builder.record(data.withBaselines()), referenceGateEvents(builder, data));
+
+} // randomWaveformTest()
+
+
+// -----------------------------------------------------------------------------
+void parallelBuildTest() {
+
+  constexpr int NThreads = 4;
+
+  TestGateBuilder const builder = makeBuilder();
+  TestWaveforms_t data = makeRandomWaveforms(60U);
+  TestWaveforms_t const edgeCases = makeEdgeCaseWaveforms();
+  for (raw::OpDetWaveform const& waveform: edgeCases.waveforms) {
+    data.add(waveform.ChannelNumber() + 100, waveform.TimeStamp(),
+      { waveform.begin(), waveform.end() });
+  }
+  std::vector<WaveformWithBaseline> const waveforms = data.withBaselines();
+
+  GateEvents_t serialEvents;
+  tbb::task_arena{ 1 }.execute
+    ([&](){ serialEvents = builder.record(waveforms); });
+
+  // let TBB use more threads than the cores of the test machine, if needed
+  tbb::global_control const threadLimit
+    { tbb::global_control::max_allowed_parallelism, NThreads };
+  for (int iTry = 0; iTry < 5; ++iTry) {
+    BOOST_TEST_CONTEXT("parallel build #" << iTry) {
+      GateEvents_t parallelEvents;
+      tbb::task_arena{ NThreads }.execute
+        ([&](){ parallelEvents = builder.record(waveforms); });
+      checkGateEvents(parallelEvents, serialEvents);
+    }
+  }
+
+  checkGateEvents(serialEvents, referenceGateEvents(builder, data));
+
+} // parallelBuildTest()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(EdgeCaseTestCase) {
+  edgeCaseTest();
+}
+
+BOOST_AUTO_TEST_CASE(RandomWaveformTestCase) {
+  randomWaveformTest();
+}
+
+BOOST_AUTO_TEST_CASE(ParallelBuildTestCase) {
+  parallelBuildTest();
+}
@@ -0,0 +1,165 @@
+/**
+ * @file   WindowGateBitsets_test.cc
+ * @brief  Unit test for `icarus::trigger::WindowGateBitsets`.
+ * @date   October 16, 2026
+ * @see    icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/WindowGateBitsets.h"
+#include "sbnobj/ICARUS/PMT/Trigger/Data/OpticalTriggerGate.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( WindowGateBitsets_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <algorithm> // std::max(), std::min()
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+using GateData_t = icarus::trigger::OpticalTriggerGateData_t;
+using ClockTick_t = GateData_t::ClockTick_t;
+using icarus::trigger::WindowGateBitsets;
+
+constexpr ClockTick_t FirstTestTick = -20;
+constexpr ClockTick_t LastTestTick = 60;
+
+
+/// Returns whether the bucket `iBucket` is set in `bits`.
+bool isSet(WindowGateBitsets::Bits_t const& bits, std::size_t iBucket) {
+  constexpr std::size_t WordBits = 64U;
+  return (bits[iBucket / WordBits] >> (iBucket % WordBits)) & 1U;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector<GateData_t> TestGates() {
+  
+  std::vector<GateData_t> gates(3U);
+  
+  /*
+   *   ^                     12                    34
+   * 4 |                       ===   20              ===
+   * 3 |     -4       4    10     ==   === 26
+   * 2 |       ===  2  ===   ==  15 ===      ===
+   * 1 |             ==  7===      17   23=== 29==     37
+   * 0-*=======---=|=---,----,----,----,----,----,===-,-==================
+   *    -10  -5    0    5   10        20        30        40        50
+   */
+  GateData_t& gate0 = gates[0];
+  gate0.openBetween(-4, -1, 2);
+  gate0.openAt ( 2);
+  gate0.openAt ( 4);
+  gate0.closeAt( 7);
+  gate0.openAt (10);
+  gate0.openAt (12, 2);
+  gate0.closeAt(15);
+  gate0.closeAt(17);
+  gate0.openAt (20);
+  gate0.closeAt(23, 2);
+  gate0.openAt (26);
+  gate0.closeAt(29);
+  gate0.closeAt(31);
+  gate0.openAt (34, 4);
+  gate0.closeAt(37, 4);
+  
+  // open from the beginning of time, then back and forth
+  GateData_t& gate1 = gates[1];
+  gate1.openAt(GateData_t::MinTick, 1);
+  gate1.openAt ( 5, 2); // -> 3
+  gate1.closeAt(11, 3); // -> 0
+  gate1.openAt (30);    // -> 1
+  gate1.openAt (40);    // -> 2
+  gate1.closeAt(45);    // -> 1, open until the end of time
+  
+  // gates[2] is always closed
+  
+  return gates;
+} // TestGates()
+
+
+// -----------------------------------------------------------------------------
+void WindowGateBitsets_test() {
+  
+  std::vector<GateData_t> const gates = TestGates();
+  std::vector<GateData_t const*> gatePtrs;
+  for (GateData_t const& gate: gates) gatePtrs.push_back(&gate);
+  
+  GateData_t::OpeningCount_t const maxLevel = 4U;
+  WindowGateBitsets const bits{ gatePtrs, maxLevel };
+  
+  BOOST_TEST(bits.nWindows() == gates.size());
+  BOOST_TEST(bits.maxLevel() == maxLevel);
+  BOOST_TEST_REQUIRE(bits.nBuckets() > 0U);
+  BOOST_TEST(bits.bucketStart(0) == GateData_t::MinTick);
+  BOOST_TEST(bits.bucketEnd(bits.nBuckets() - 1) == GateData_t::MaxTick);
+  
+  // check each bit against the gate levels at each tick of its bucket
+  for (std::size_t iBucket = 0; iBucket < bits.nBuckets(); ++iBucket) {
+    ClockTick_t const first
+      = std::max(bits.bucketStart(iBucket), FirstTestTick);
+    ClockTick_t const last = std::min(bits.bucketEnd(iBucket), LastTestTick);
+    for (ClockTick_t tick = first; tick < last; ++tick) {
+      for (std::size_t w1 = 0; w1 < gates.size(); ++w1) {
+        auto const level1 = gates[w1].openingCount(tick);
+        for (GateData_t::OpeningCount_t k = 1; k <= maxLevel; ++k) {
+          BOOST_TEST_CONTEXT
+            ("bucket " << iBucket << " tick " << tick << " window " << w1
+            << " level " << k)
+          {
+            BOOST_TEST(isSet(bits.atLeast(w1, k), iBucket) == (level1 >= k));
+            for (std::size_t w2 = 0; w2 < gates.size(); ++w2) {
+              auto const level2 = gates[w2].openingCount(tick);
+              BOOST_TEST_CONTEXT("plus window " << w2) {
+                BOOST_TEST(isSet(bits.sumAtLeast(w1, w2, k), iBucket)
+                  == (level1 + level2 >= k));
+              }
+            } // for second window
+          }
+        } // for levels
+      } // for first window
+    } // for ticks
+  } // for buckets
+  
+  // the always closed window has no bit set at any level
+  BOOST_TEST(bits.findSet(bits.atLeast(2, 1)) == WindowGateBitsets::NoBucket);
+  
+  // window 1 is open from the start
+  BOOST_TEST(bits.findSet(bits.atLeast(1, 1)) == 0U);
+  
+  // window 1 at level 3: open in [ 5, 11 [ only
+  WindowGateBitsets::Bits_t const& level3 = bits.atLeast(1, 3);
+  std::size_t const iOpen = bits.findSet(level3);
+  BOOST_TEST_REQUIRE(iOpen != WindowGateBitsets::NoBucket);
+  BOOST_TEST(bits.bucketStart(iOpen) == 5);
+  std::size_t const iClose = bits.findUnset(level3, iOpen);
+  BOOST_TEST_REQUIRE(iClose < bits.nBuckets());
+  BOOST_TEST(bits.bucketStart(iClose) == 11);
+  BOOST_TEST(bits.findSet(level3, iClose) == WindowGateBitsets::NoBucket);
+  
+  // window 0 at level 4 and window 1 at level 1: only [ 34, 37 [
+  WindowGateBitsets::Bits_t both = bits.atLeast(0, 4);
+  WindowGateBitsets::intersect(both, bits.atLeast(1, 1));
+  std::size_t const iBoth = bits.findSet(both);
+  BOOST_TEST_REQUIRE(iBoth != WindowGateBitsets::NoBucket);
+  BOOST_TEST(bits.bucketStart(iBoth) == 34);
+  BOOST_TEST(bits.bucketStart(bits.findUnset(both, iBoth)) == 37);
+  
+} // WindowGateBitsets_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(WindowGateBitsets_testcase) {
+  
+  WindowGateBitsets_test();
+  
+} // BOOST_AUTO_TEST_CASE(WindowGateBitsets_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+/**
+ * @file   A2795CodecReference.h
+ * @brief  Reference implementation and test data for the A2795 codec tests.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/Compression/A2795Codec.h
+ *
+ * Shared by `A2795Codec_test` and `A2795Codec_benchmark`.
+ */
+
+#ifndef TEST_TPC_COMPRESSION_A2795CODECREFERENCE_H
+#define TEST_TPC_COMPRESSION_A2795CODECREFERENCE_H
+
+// C/C++ standard libraries
+#include <random>
+#include <vector>
+#include <algorithm> // std::min(), std::max()
+#include <cstdlib> // std::abs()
+#include <cstdint> // std::uint16_t, std::int16_t
+
+
+// -----------------------------------------------------------------------------
+/// Encodes one sample of one channel at a time (`adcs[sample][channel]`).
+inline std::vector<std::uint16_t> referenceEncode
+  (std::vector<std::uint16_t> const& adcs, std::size_t nChannels)
+{
+  std::size_t const nSamples = adcs.size() / nChannels;
+  auto adc = [&adcs,nChannels](std::size_t c, std::size_t s)
+    { return adcs[s * nChannels + c]; };
+
+  std::vector<std::uint16_t> out;
+  for (std::size_t c = 0; c < nChannels; ++c)
+    out.push_back((adc(c, 0) & 0x0FFF) + 0x8000);
+
+  for (std::size_t s = 1; s < nSamples; ++s) {
+    bool oddCompressions = false;
+    for (std::size_t block = 0; block < nChannels / 4; ++block) {
+      std::int16_t diff[4];
+      bool isComp = true;
+      for (std::size_t i = 0; i < 4; ++i) {
+        diff[i] = adc(4*block + i, s) - adc(4*block + i, s - 1);
+        isComp = isComp && (std::abs(diff[i]) < 8);
+      }
+      if (isComp) {
+        oddCompressions = !oddCompressions;
+        std::uint16_t word = (diff[3] & 0x000F);
+        word <<= 4;
+        word += (diff[2] & 0x000F);
+        word <<= 4;
+        word += (diff[1] & 0x000F);
+        word <<= 4;
+        word += (diff[0] & 0x000F);
+        out.push_back(word);
+      }
+      else {
+        for (std::size_t i = 0; i < 4; ++i)
+          out.push_back((diff[i] & 0x0FFF) + 0x8000);
+      }
+    } // for blocks
+    if (oddCompressions) out.push_back(0);
+  } // for samples
+  return out;
+} // referenceEncode()
+
+
+/// Decodes one sample of one channel at a time (`adcs[sample][channel]`).
+inline std::vector<std::uint16_t> referenceDecode(
+  std::vector<std::uint16_t> const& data,
+  std::size_t nChannels, std::size_t nSamples
+) {
+  std::vector<std::uint16_t> adcs(nChannels * nSamples, 0);
+  std::size_t iWord = 0;
+  for (std::size_t s = 0; s < nSamples; ++s) {
+    std::size_t keyCount = 0;
+    for (std::size_t block = 0; block < nChannels / 4; ++block) {
+      std::uint16_t const word = data[iWord];
+      bool const isCompressed = ((word & 0xF000) != 0x8000);
+      for (std::size_t i = 0; i < 4; ++i) {
+        std::size_t const c = 4*block + i;
+        std::uint16_t const prev = (s != 0)? adcs[(s - 1) * nChannels + c]: 0;
+        if (!isCompressed) {
+          std::int16_t const diff = data[iWord + i] & 0x0FFF;
+          bool const isNeg = (diff >> 11) && (s != 0);
+          adcs[s * nChannels + c] = isNeg*0xF000 + diff + prev;
+        }
+        else {
+          std::int16_t const diff = (word >> (4*i)) & 0x000F;
+          bool const isNeg = (diff >> 3);
+          adcs[s * nChannels + c] = isNeg*0xFFF0 + diff + prev;
+        }
+      }
+      iWord += isCompressed? 1: 4;
+      keyCount += isCompressed;
+    } // for blocks
+    if (keyCount % 2) ++iWord;
+  } // for samples
+  return adcs;
+} // referenceDecode()
+
+
+// -----------------------------------------------------------------------------
+/// Returns 12-bit waveforms with noise and jumps which fit the 12-bit format.
+inline std::vector<std::uint16_t> makeWaveforms
+  (std::mt19937& engine, std::size_t nChannels, std::size_t nSamples)
+{
+  std::normal_distribution<double> noise{ 0.0, 3.0 };
+  std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+  std::uniform_int_distribution<int> jump{ -900, 900 };
+
+  std::vector<std::uint16_t> adcs(nChannels * nSamples);
+  for (std::size_t c = 0; c < nChannels; ++c) {
+    int baseline = 2048;
+    for (std::size_t s = 0; s < nSamples; ++s) {
+      if (uniform(engine) < 0.01) baseline = 2048 + jump(engine);
+      int const value = baseline + static_cast<int>(noise(engine));
+      adcs[s * nChannels + c] = std::min(std::max(value, 0), 4095);
+    }
+  }
+  return adcs;
+} // makeWaveforms()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // TEST_TPC_COMPRESSION_A2795CODECREFERENCE_H
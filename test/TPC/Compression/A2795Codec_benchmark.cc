@@ -0,0 +1,90 @@
+/**
+ * @file   A2795Codec_benchmark.cc
+ * @brief  Timing of the A2795 TPC compression codec.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/Compression/A2795Codec.h
+ * @see    test/TPC/Compression/A2795Codec_test.cc
+ *
+ * Prints the time per sample of the board codec and of the sample-by-sample
+ * reference implementation, on random waveforms.
+ * This program checks nothing and it is not run as a test.
+ *
+ * Usage: `A2795Codec_benchmark [NSamples]`
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Compression/A2795Codec.h"
+#include "A2795CodecReference.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t NChannels = 64U;
+constexpr unsigned int Seed = 12345U;
+
+
+// -----------------------------------------------------------------------------
+/// Returns the nanoseconds per sample taken by `doOnce()`.
+template <typename Func>
+double nanosecondsPerSample(std::size_t n, Func doOnce) {
+  auto const start = std::chrono::steady_clock::now();
+  doOnce();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / n;
+} // nanosecondsPerSample()
+
+
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const nSamples = (argc > 1)? std::stoul(argv[1]): 4096U;
+
+  std::mt19937 engine{ Seed };
+  std::vector<std::uint16_t> const adcs
+    = makeWaveforms(engine, NChannels, nSamples);
+  std::size_t const n = adcs.size();
+
+  std::vector<std::uint16_t> encoded(NChannels * nSamples + nSamples);
+  std::vector<std::uint16_t> decoded(n);
+  std::vector<float> plane(n);
+  std::size_t nWords = 0;
+
+  double const encodeTime = nanosecondsPerSample(n, [&]()
+    {
+      nWords = icarus::compression::encodeBoard
+        (adcs.data(), NChannels, nSamples, encoded.data());
+    });
+  double const referenceEncodeTime = nanosecondsPerSample
+    (n, [&adcs](){ referenceEncode(adcs, NChannels); });
+
+  encoded.resize(nWords);
+  double const decodeTime = nanosecondsPerSample(n, [&]()
+    {
+      icarus::compression::decodeBoard
+        (encoded.data(), NChannels, nSamples, decoded.data());
+    });
+  double const decodePlaneTime = nanosecondsPerSample(n, [&]()
+    {
+      icarus::compression::decodeBoard
+        (encoded.data(), NChannels, nSamples, plane.data());
+    });
+  double const referenceDecodeTime = nanosecondsPerSample
+    (n, [&encoded,nSamples](){ referenceDecode(encoded, NChannels, nSamples); });
+
+  std::cout << "Board of " << NChannels << " channels x " << nSamples
+    << " samples compressed into " << nWords << " words"
+    << "\nEncoding: " << encodeTime << " ns/sample ("
+    << referenceEncodeTime << " ns/sample with the reference)"
+    << "\nDecoding: " << decodeTime << " ns/sample, " << decodePlaneTime
+    << " ns/sample into waveforms (" << referenceDecodeTime
+    << " ns/sample with the reference)" << std::endl;
+
+  return 0;
+} // main()
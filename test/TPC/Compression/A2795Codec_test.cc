@@ -0,0 +1,133 @@
+/**
+ * @file   A2795Codec_test.cc
+ * @brief  Unit test of the A2795 TPC compression codec.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/Compression/A2795Codec.h
+ *
+ * The codec is checked against a sample-by-sample reference implementation
+ * of the same scheme (as in `ICARUSProduceCompressed` module) on random data,
+ * and the round trip is checked on data whose differences fit the format.
+ * The time per sample of the codec and of the reference is measured by
+ * `A2795Codec_benchmark`, which is not run as a test.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Compression/A2795Codec.h"
+#include "A2795CodecReference.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( A2795Codec_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t NChannels = 64U;
+constexpr std::size_t NSamples = 4096U;
+constexpr unsigned int Seed = 12345U;
+constexpr unsigned int NFuzzBoards = 20U;
+
+
+// -----------------------------------------------------------------------------
+/// Compares encoding and decoding of random data with the reference.
+void referenceComparison_test() {
+
+  std::mt19937 engine{ Seed };
+  std::uniform_int_distribution<int> anyWord{ 0, 0xFFFF };
+  std::uniform_int_distribution<int> smallStep{ -9, +9 };
+
+  std::size_t const nSamples = 200;
+  for (unsigned int iBoard = 0; iBoard < NFuzzBoards; ++iBoard) {
+    // alternate realistic waveforms and values with arbitrary steps
+    std::vector<std::uint16_t> adcs;
+    if (iBoard % 2) adcs = makeWaveforms(engine, NChannels, nSamples);
+    else {
+      adcs.resize(NChannels * nSamples);
+      for (std::size_t i = 0; i < adcs.size(); ++i) {
+        adcs[i] = (i < NChannels || (iBoard % 4 == 0))
+          ? anyWord(engine): (adcs[i - NChannels] + smallStep(engine));
+      }
+    }
+
+    BOOST_TEST_CONTEXT("board #" << iBoard) {
+      std::vector<std::uint16_t> const expected
+        = referenceEncode(adcs, NChannels);
+
+      std::vector<std::uint16_t> encoded(NChannels * nSamples + nSamples);
+      std::size_t const nWords = icarus::compression::encodeBoard
+        (adcs.data(), NChannels, nSamples, encoded.data());
+      encoded.resize(nWords);
+      BOOST_TEST(encoded == expected, boost::test_tools::per_element());
+
+      std::vector<std::uint16_t> decoded(NChannels * nSamples);
+      BOOST_TEST(icarus::compression::decodeBoard
+        (encoded.data(), NChannels, nSamples, decoded.data()) == nWords
+        );
+      std::vector<std::uint16_t> const expectedDecoded
+        = referenceDecode(encoded, NChannels, nSamples);
+      BOOST_TEST(decoded == expectedDecoded, boost::test_tools::per_element());
+    }
+  } // for boards
+
+} // referenceComparison_test()
+
+
+// -----------------------------------------------------------------------------
+/// Checks that the data is decoded back, as integers and in waveforms.
+void roundTrip_test() {
+
+  std::mt19937 engine{ Seed };
+  std::vector<std::uint16_t> const adcs
+    = makeWaveforms(engine, NChannels, NSamples);
+
+  std::vector<std::uint16_t> encoded(NChannels * NSamples + NSamples);
+  std::size_t const nWords = icarus::compression::encodeBoard
+    (adcs.data(), NChannels, NSamples, encoded.data());
+  BOOST_TEST(nWords < adcs.size());
+  std::cout << "Compressed " << adcs.size() << " samples into " << nWords
+    << " words" << std::endl;
+
+  std::vector<std::uint16_t> decoded(NChannels * NSamples);
+  BOOST_TEST(icarus::compression::decodeBoard
+    (encoded.data(), NChannels, NSamples, decoded.data()) == nWords);
+  BOOST_TEST(decoded == adcs, boost::test_tools::per_element());
+
+  std::vector<float> plane(NChannels * NSamples);
+  BOOST_TEST(icarus::compression::decodeBoard
+    (encoded.data(), NChannels, NSamples, plane.data()) == nWords);
+  for (std::size_t c = 0; c < NChannels; ++c) {
+    for (std::size_t s = 0; s < NSamples; ++s) {
+      BOOST_TEST_CONTEXT("channel " << c << " sample " << s) {
+        BOOST_TEST(plane[c * NSamples + s] == adcs[s * NChannels + c]);
+      }
+    }
+  }
+
+} // roundTrip_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(referenceComparison_testcase) {
+
+  referenceComparison_test();
+
+} // BOOST_AUTO_TEST_CASE(referenceComparison_testcase)
+
+
+BOOST_AUTO_TEST_CASE(roundTrip_testcase) {
+
+  roundTrip_test();
+
+} // BOOST_AUTO_TEST_CASE(roundTrip_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
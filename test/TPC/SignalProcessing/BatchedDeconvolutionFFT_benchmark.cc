@@ -0,0 +1,189 @@
+/**
+ * @file   BatchedDeconvolutionFFT_benchmark.cc
+ * @brief  Timing of the batched deconvolution against the one-at-a-time one.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h
+ * @see    test/TPC/SignalProcessing/BatchedDeconvolutionFFT_test.cc
+ *
+ * Deconvolves the same waveforms the way `FullWireDeconvolution` does:
+ * one waveform at a time with `icarus_signal_processing::ICARUSFFT<double>`,
+ * copying each into a `double` buffer and then into the ROI holder, and with
+ * `icarus_tool::BatchedDeconvolutionFFT`, extracting each waveform straight
+ * into the ROI holder. It prints the time per waveform of both and the
+ * largest difference between their results.
+ * This program checks nothing and it is not run as a test.
+ *
+ * Usage: `BatchedDeconvolutionFFT_benchmark [BatchSize] [WaveformFile]`
+ *
+ * The waveform file is a text file with one pedestal subtracted waveform per
+ * line (e.g. dumped from the raw digits of a recorded run); all waveforms must
+ * have the same number of ticks. Without it, 2000 waveforms of 4096 ticks with
+ * noise and a few pulses are made up. The kernel is also made up (a low pass
+ * filter with a phase shift): the timing does not depend on its values.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h"
+#include "icarus_signal_processing/Filters/ICARUSFFT.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib> // std::stoul()
+#include <stdexcept>
+
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t NTicks = 4096U;
+constexpr std::size_t NWaveforms = 2000U;
+constexpr int TOffset = 40;
+constexpr float Norm = 0.5f;
+constexpr unsigned int Seed = 12345U;
+
+using Waveforms_t = std::vector<std::vector<float>>;
+
+
+// -----------------------------------------------------------------------------
+/// Returns the microseconds per waveform taken by `doOnce()`.
+template <typename Func>
+double microsecondsPerWaveform(std::size_t n, Func doOnce) {
+  auto const start = std::chrono::steady_clock::now();
+  doOnce();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count() / n;
+} // microsecondsPerWaveform()
+
+
+// -----------------------------------------------------------------------------
+/// Reads one waveform per line from `path`.
+Waveforms_t readWaveforms(std::string const& path) {
+  std::ifstream file{ path };
+  if (!file) throw std::runtime_error("Can't open '" + path + "'");
+
+  Waveforms_t waveforms;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream sstr{ line };
+    std::vector<float> waveform;
+    float sample;
+    while (sstr >> sample) waveform.push_back(sample);
+    if (waveform.empty()) continue;
+    if (!waveforms.empty() && (waveform.size() != waveforms.front().size()))
+      throw std::runtime_error("Waveforms of different size in '" + path + "'");
+    waveforms.push_back(std::move(waveform));
+  }
+  if (waveforms.empty()) throw std::runtime_error("No waveform in '" + path + "'");
+  return waveforms;
+} // readWaveforms()
+
+
+/// Returns waveforms with noise and a few unipolar pulses.
+Waveforms_t makeWaveforms(std::size_t nWaveforms, std::size_t nTicks) {
+  std::mt19937 engine{ Seed };
+  std::normal_distribution<float> noise{ 0.f, 2.5f };
+  std::uniform_int_distribution<int> nPulses{ 0, 3 };
+  std::uniform_real_distribution<float> peak{ 0.f, float(nTicks) };
+  std::uniform_real_distribution<float> amplitude{ 10.f, 60.f };
+
+  Waveforms_t waveforms(nWaveforms, std::vector<float>(nTicks));
+  for (std::vector<float>& waveform: waveforms) {
+    for (float& sample: waveform) sample = noise(engine);
+    for (int pulse = nPulses(engine); pulse > 0; --pulse) {
+      float const t0 = peak(engine), A = amplitude(engine);
+      for (std::size_t tick = 0; tick < nTicks; ++tick) {
+        float const x = (tick - t0) / 5.f;
+        if (std::abs(x) < 6.f) waveform[tick] += A * std::exp(-0.5f * x * x);
+      }
+    }
+  }
+  return waveforms;
+} // makeWaveforms()
+
+
+/// Returns a low pass kernel with a phase shift.
+icarusutil::FrequencyVec makeKernel(std::size_t nTicks) {
+  std::size_t const nBins = nTicks / 2 + 1;
+  double const twoPi = 2. * std::acos(-1.);
+  icarusutil::FrequencyVec kernel(nBins);
+  for (std::size_t bin = 0; bin < nBins; ++bin) {
+    double const f = double(bin) / nBins;
+    kernel[bin] = std::polar
+      ((1. + 2. * f) * std::exp(-0.5 * f * f / 0.09), -twoPi * bin * 7. / nTicks);
+  }
+  return kernel;
+} // makeKernel()
+
+
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const batchSize = (argc > 1)? std::stoul(argv[1]): 64U;
+  Waveforms_t const waveforms = (argc > 2)
+    ? readWaveforms(argv[2]): makeWaveforms(NWaveforms, NTicks);
+
+  std::size_t const nWaveforms = waveforms.size();
+  std::size_t const nTicks = waveforms.front().size();
+  icarusutil::FrequencyVec const kernel = makeKernel(nTicks);
+
+  // one waveform at a time, in double precision
+  icarus_signal_processing::ICARUSFFT<double> fft{ nTicks };
+  Waveforms_t reference(nWaveforms);
+  double const referenceTime = microsecondsPerWaveform(nWaveforms, [&]()
+    {
+      for (std::size_t i = 0; i < nWaveforms; ++i) {
+        icarusutil::TimeVec deconVec(waveforms[i].begin(), waveforms[i].end());
+        fft.deconvolute(deconVec, kernel, TOffset);
+        std::vector<float> holder(deconVec.begin(), deconVec.end());
+        for (float& sample: holder) sample *= Norm;
+        reference[i] = std::move(holder);
+      }
+    });
+
+  // in batches, in single precision
+  icarus_tool::BatchedDeconvolutionFFT const batchedFFT{ nTicks, batchSize };
+  Waveforms_t batched(nWaveforms);
+  double const batchedTime = microsecondsPerWaveform(nWaveforms, [&]()
+    {
+      auto workspace = batchedFFT.makeWorkspace();
+      batchedFFT.deconvoluteAll(workspace, nWaveforms,
+        [&](std::size_t i, float* buffer)
+          {
+            std::copy(waveforms[i].begin(), waveforms[i].end(), buffer);
+            return icarus_tool::BatchedDeconvolutionFFT::Kernel{ &kernel, TOffset };
+          },
+        [&](std::size_t i, auto const& workspace, std::size_t slot)
+          {
+            std::vector<float> holder(nTicks);
+            workspace.extract(slot, 0, nTicks, holder.data());
+            batched[i] = std::move(holder);
+          },
+        Norm
+        );
+    });
+
+  double maxDiff = 0., sumSq = 0.;
+  for (std::size_t i = 0; i < nWaveforms; ++i) {
+    for (std::size_t tick = 0; tick < nTicks; ++tick) {
+      maxDiff = std::max
+        (maxDiff, double(std::abs(batched[i][tick] - reference[i][tick])));
+      sumSq += double(reference[i][tick]) * reference[i][tick];
+    }
+  }
+  double const rms = std::sqrt(sumSq / (nWaveforms * nTicks));
+
+  std::cout << nWaveforms << " waveforms of " << nTicks << " ticks"
+    << "\nOne at a time (ICARUSFFT<double>): " << referenceTime << " us/waveform"
+    << "\nBatched (float, " << batchSize << " per batch): " << batchedTime
+    << " us/waveform"
+    << "\nLargest difference: " << maxDiff << " (RMS of the deconvolved waveforms: "
+    << rms << ")" << std::endl;
+
+  return 0;
+} // main()
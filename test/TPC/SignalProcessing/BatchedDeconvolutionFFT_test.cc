@@ -0,0 +1,151 @@
+/**
+ * @file   BatchedDeconvolutionFFT_test.cc
+ * @brief  Unit test of the batched single precision deconvolution.
+ * @date   October 16, 2026
+ * @see    icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h
+ *
+ * The deconvolution of random windows with random kernels is compared with a
+ * direct (double precision) discrete Fourier transform, including the time
+ * offset, the scale factor and batches which are not full.
+ * The comparison with the one-window-at-a-time `ICARUSFFT` deconvolution is
+ * done by `BatchedDeconvolutionFFT_benchmark`, which is not run as a test.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/BatchedDeconvolutionFFT.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( BatchedDeconvolutionFFT_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard libraries
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t FFTSize = 64U;
+constexpr std::size_t BatchSize = 3U;
+constexpr unsigned int Seed = 12345U;
+
+
+// -----------------------------------------------------------------------------
+/// Deconvolution by direct transforms, with the time offset as a rotation.
+std::vector<double> referenceDeconvolution(
+  std::vector<float> const& window, icarusutil::FrequencyVec const& kernel,
+  int tOffset, double scale
+) {
+  std::size_t const N = window.size();
+  double const twoPi = 2. * std::acos(-1.);
+
+  std::vector<std::complex<double>> freq(N / 2 + 1);
+  for (std::size_t k = 0; k < freq.size(); ++k) {
+    for (std::size_t n = 0; n < N; ++n)
+      freq[k] += static_cast<double>(window[n]) * std::polar(1., -twoPi * k * n / N);
+    freq[k] *= std::complex<double>(kernel[k]);
+  }
+
+  // real transform: the imaginary parts of the first and last bins are ignored
+  std::vector<double> time(N);
+  for (std::size_t n = 0; n < N; ++n) {
+    double sum = freq.front().real() + freq.back().real() * ((n % 2)? -1.: 1.);
+    for (std::size_t k = 1; k < N / 2; ++k)
+      sum += 2. * (freq[k] * std::polar(1., twoPi * k * n / N)).real();
+    time[n] = sum * scale / N;
+  }
+
+  std::size_t const start = (tOffset % long(N) + long(N)) % long(N);
+  std::rotate(time.begin(), time.begin() + start, time.end());
+  return time;
+} // referenceDeconvolution()
+
+
+// -----------------------------------------------------------------------------
+void batchedDeconvolution_test() {
+
+  std::mt19937 engine{ Seed };
+  std::normal_distribution<float> noise{ 0.f, 3.f };
+  std::uniform_real_distribution<double> gain{ 0.5, 1.5 };
+  std::uniform_real_distribution<double> phase{ -3.1, +3.1 };
+
+  icarus_tool::BatchedDeconvolutionFFT const deconvolver{ FFTSize, BatchSize };
+  BOOST_TEST(deconvolver.fftSize() == FFTSize);
+  BOOST_TEST(deconvolver.batchSize() == BatchSize);
+  BOOST_TEST(deconvolver.nFrequencyBins() == FFTSize / 2 + 1);
+
+  // windows are shorter than the transform, like ROI's are, and are zero padded
+  std::vector<int> const tOffsets = { 0, 5, -3, int(FFTSize) + 2, 17 };
+  std::size_t const nWindows = tOffsets.size(); // two batches, one not full
+  std::vector<std::vector<float>> windows;
+  std::vector<icarusutil::FrequencyVec> kernels;
+  for (std::size_t i = 0; i < nWindows; ++i) {
+    std::vector<float> window(FFTSize - i);
+    for (float& sample: window) sample = noise(engine);
+    window.resize(FFTSize, 0.f);
+    windows.push_back(std::move(window));
+
+    icarusutil::FrequencyVec kernel(deconvolver.nFrequencyBins());
+    for (auto& bin: kernel) bin = std::polar(gain(engine), phase(engine));
+    BOOST_TEST(deconvolver.accepts(kernel));
+    kernels.push_back(std::move(kernel));
+  }
+  BOOST_TEST(!deconvolver.accepts(icarusutil::FrequencyVec(FFTSize)));
+
+  double const scale = 0.25;
+  std::vector<std::size_t> seen;
+  auto workspace = deconvolver.makeWorkspace();
+
+  auto fill = [&](std::size_t window, float* buffer)
+    {
+      BOOST_TEST(std::all_of(buffer, buffer + FFTSize, [](float v){ return v == 0.f; }));
+      std::copy(windows[window].begin(), windows[window].end(), buffer);
+      return icarus_tool::BatchedDeconvolutionFFT::Kernel
+        { &kernels[window], tOffsets[window] };
+    };
+  auto use = [&](
+    std::size_t window,
+    icarus_tool::BatchedDeconvolutionFFT::Workspace const& workspace,
+    std::size_t slot
+  ) {
+    BOOST_TEST_CONTEXT("window #" << window) {
+      BOOST_TEST(slot == window % BatchSize);
+      seen.push_back(window);
+
+      std::vector<double> const expected = referenceDeconvolution
+        (windows[window], kernels[window], tOffsets[window], scale);
+      double const tolerance = 1e-5 * std::abs(*std::max_element(
+        expected.begin(), expected.end(),
+        [](double a, double b){ return std::abs(a) < std::abs(b); }
+        ));
+
+      // all of it
+      std::vector<float> result(FFTSize);
+      workspace.extract(slot, 0, FFTSize, result.data());
+      for (std::size_t tick = 0; tick < FFTSize; ++tick) {
+        BOOST_TEST_CONTEXT("tick #" << tick)
+          BOOST_TEST(std::abs(result[tick] - expected[tick]) <= tolerance);
+      }
+
+      // a piece in the middle
+      std::vector<float> piece(10);
+      workspace.extract(slot, 40, 50, piece.data());
+      for (std::size_t i = 0; i < piece.size(); ++i)
+        BOOST_TEST(piece[i] == result[40 + i]);
+    }
+  };
+
+  deconvolver.deconvoluteAll(workspace, nWindows, fill, use, scale);
+
+  BOOST_TEST(seen.size() == nWindows);
+  BOOST_TEST(std::is_sorted(seen.begin(), seen.end()));
+
+} // batchedDeconvolution_test()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(BatchedDeconvolutionTestCase) {
+  batchedDeconvolution_test();
+}